@@ -0,0 +1,1058 @@
+/*
+ * Batch Decoding
+ *
+ * Streams alert codes through the decoder.  Lines are split straight out
+ * of large input blocks and records are formatted into a large output
+ * buffer, so there is one read and one write per block instead of one per
+ * code.
+ *
+ * After meditiation comes... Insight
+ *
+ * Copyright (c) 2025-26 amigazen project
+ * Licensed under BSD 2-Clause License
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "error_codes.h"
+#include "hexparse.h"
+#include "decompose.h"
+#include "summary.h"
+#include "search.h"
+#include "nearest.h"
+#include "names.h"
+#include "batch.h"
+
+/* Longest piece of an invalid line echoed back in its record */
+#define INVALID_ECHO_LENGTH 64
+
+/* Lines gathered before their codes are converted in one ParseHexFields call */
+#define DECODE_QUEUE_SIZE 64
+
+/* Trimmed input lines waiting to be decoded, in input order */
+struct DecodeQueue {
+    ULONG count;                              /* Lines queued */
+    ULONG fieldCount;                         /* Lines shaped like a code */
+    const char *text[DECODE_QUEUE_SIZE];      /* Line, pointing into the input block */
+    ULONG length[DECODE_QUEUE_SIZE];
+    LONG field[DECODE_QUEUE_SIZE];            /* Index into fields, -1 if not code shaped */
+    const char *fields[DECODE_QUEUE_SIZE];    /* The 8 digits of each code shaped line */
+    ULONG codes[DECODE_QUEUE_SIZE];
+    UBYTE status[DECODE_QUEUE_SIZE];
+};
+
+/* Output format names, indexed by BATCH_FORMAT_xxx */
+static const CONST_STRPTR formatNames[BATCH_FORMATS] = {
+    "tsv", "json"
+};
+
+/* Forward declarations */
+static BOOL GrowBatchWriter(struct BatchWriter *writer, ULONG needed);
+static VOID PutBytes(struct BatchWriter *writer, const char *data, ULONG length);
+static VOID PutField(struct BatchWriter *writer, const char *text, ULONG length);
+static VOID PutHexCode(struct BatchWriter *writer, ULONG alertCode);
+static VOID PutHexDigits(struct BatchWriter *writer, ULONG value, ULONG digits);
+static VOID PutDecimal(struct BatchWriter *writer, ULONG value);
+static VOID PutCount(struct BatchWriter *writer, SUMMARYCOUNT value);
+static BOOL ReadBatchLines(FILE *input, struct BatchWriter *writer, struct BatchStats *stats);
+static VOID QueueLine(struct DecodeQueue *queue, struct BatchWriter *writer, const char *line, ULONG length,
+                      struct BatchStats *stats);
+static VOID DecodeQueuedLines(struct DecodeQueue *queue, struct BatchWriter *writer, struct BatchStats *stats);
+
+/*
+ * Set up a writer with its output block
+ * A NULL file keeps the records in memory; the caller takes them from
+ * buffer and resets used.
+ */
+BOOL OpenBatchWriter(struct BatchWriter *writer, FILE *file, ULONG format)
+{
+    if (format >= BATCH_FORMATS) {
+        return FALSE;
+    }
+
+    writer->buffer = (char *)malloc(BATCH_BUFFER_SIZE);
+    if (writer->buffer == NULL) {
+        return FALSE;
+    }
+
+    writer->file = file;
+    writer->format = format;
+    writer->used = 0;
+    writer->size = BATCH_BUFFER_SIZE;
+    writer->failed = FALSE;
+    writer->summary = NULL;
+
+    return TRUE;
+}
+
+/*
+ * Flush and release a writer
+ * Returns FALSE if any write failed
+ */
+BOOL CloseBatchWriter(struct BatchWriter *writer)
+{
+    BOOL success;
+
+    success = FlushBatchWriter(writer);
+    if (writer->file != NULL && fflush(writer->file) != 0) {
+        success = FALSE;
+    }
+
+    free(writer->buffer);
+    writer->buffer = NULL;
+
+    return success;
+}
+
+/*
+ * Write out whatever is buffered
+ * A memory writer keeps its records until the caller takes them
+ */
+BOOL FlushBatchWriter(struct BatchWriter *writer)
+{
+    if (writer->file == NULL) {
+        return (BOOL)!writer->failed;
+    }
+
+    if (writer->used > 0 && !writer->failed) {
+        if (fwrite(writer->buffer, 1, writer->used, writer->file) != writer->used) {
+            writer->failed = TRUE;
+        }
+    }
+    writer->used = 0;
+
+    return (BOOL)!writer->failed;
+}
+
+/*
+ * Decode an alert code and write its record
+ * Returns the ALERT_MATCH_xxx level it was decoded at
+ */
+ULONG WriteAlertRecord(struct BatchWriter *writer, ULONG alertCode)
+{
+    return WriteSourcedAlertRecord(writer, alertCode, NULL);
+}
+
+/*
+ * Decode an alert code and write its record, led by where it was found
+ * TSV records gain line (or time), kind, producer, task and task name
+ * columns in front; JSON records gain the same fields.  kind and task name
+ * are left out when NULL and producer unless hasProducer is set.  source
+ * may be NULL for a plain record.
+ */
+ULONG WriteSourcedAlertRecord(struct BatchWriter *writer, ULONG alertCode, const struct RecordSource *source)
+{
+    struct AlertDecoding decoding;
+    CONST_STRPTR match;
+    ULONG length;
+
+    length = DecodeAlertInto(alertCode, &decoding, writer->text, sizeof(writer->text));
+    if (length >= sizeof(writer->text)) {
+        length = sizeof(writer->text) - 1;
+    }
+    match = AlertMatchName(decoding.match);
+
+    if (writer->format == BATCH_FORMAT_JSON) {
+        PutBytes(writer, "{", 1);
+        if (source != NULL) {
+            if (source->time != NULL) {
+                PutBytes(writer, "\"time\":\"", 8);
+                PutBytes(writer, source->time, strlen(source->time));
+                PutBytes(writer, "\",", 2);
+            } else {
+                PutBytes(writer, "\"line\":", 7);
+                PutDecimal(writer, source->line);
+                PutBytes(writer, ",", 1);
+            }
+            if (source->kind != NULL) {
+                PutBytes(writer, "\"kind\":\"", 8);
+                PutBytes(writer, source->kind, strlen(source->kind));
+                PutBytes(writer, "\",", 2);
+            }
+            if (source->hasProducer) {
+                PutBytes(writer, "\"producer\":", 11);
+                PutDecimal(writer, source->producer);
+                PutBytes(writer, ",", 1);
+            }
+            if (source->hasTask) {
+                PutBytes(writer, "\"task\":\"", 8);
+                PutHexCode(writer, source->task);
+                PutBytes(writer, "\",", 2);
+            }
+            if (source->taskName != NULL) {
+                PutBytes(writer, "\"taskName\":\"", 12);
+                PutField(writer, source->taskName, strlen(source->taskName));
+                PutBytes(writer, "\",", 2);
+            }
+        }
+        PutBytes(writer, "\"code\":\"", 8);
+        PutHexCode(writer, alertCode);
+        PutBytes(writer, "\",\"match\":\"", 11);
+        PutBytes(writer, match, strlen(match));
+        PutBytes(writer, "\",\"description\":\"", 17);
+        PutField(writer, decoding.description, strlen(decoding.description));
+        PutBytes(writer, "\",\"insight\":\"", 13);
+        PutField(writer, writer->text, length);
+        PutBytes(writer, "\"}\n", 3);
+    } else {
+        if (source != NULL) {
+            if (source->time != NULL) {
+                PutBytes(writer, source->time, strlen(source->time));
+            } else {
+                PutDecimal(writer, source->line);
+            }
+            PutBytes(writer, "\t", 1);
+            if (source->kind != NULL) {
+                PutBytes(writer, source->kind, strlen(source->kind));
+                PutBytes(writer, "\t", 1);
+            }
+            if (source->hasProducer) {
+                PutDecimal(writer, source->producer);
+                PutBytes(writer, "\t", 1);
+            }
+            if (source->hasTask) {
+                PutHexCode(writer, source->task);
+            }
+            PutBytes(writer, "\t", 1);
+            if (source->taskName != NULL) {
+                PutField(writer, source->taskName, strlen(source->taskName));
+                PutBytes(writer, "\t", 1);
+            }
+        }
+        PutHexCode(writer, alertCode);
+        PutBytes(writer, "\t", 1);
+        PutBytes(writer, match, strlen(match));
+        PutBytes(writer, "\t", 1);
+        PutField(writer, decoding.description, strlen(decoding.description));
+        PutBytes(writer, "\t", 1);
+        PutField(writer, writer->text, length);
+        PutBytes(writer, "\n", 1);
+    }
+
+    return decoding.match;
+}
+
+/*
+ * Write the record for a line that is not an alert code
+ * Only the start of the line is echoed back.  A summarising writer just
+ * counts the line.
+ */
+VOID WriteInvalidRecord(struct BatchWriter *writer, CONST_STRPTR text, ULONG length)
+{
+    if (writer->summary != NULL) {
+        writer->summary->invalid++;
+        return;
+    }
+
+    if (length > INVALID_ECHO_LENGTH) {
+        length = INVALID_ECHO_LENGTH;
+    }
+
+    if (writer->format == BATCH_FORMAT_JSON) {
+        PutBytes(writer, "{\"input\":\"", 10);
+        PutField(writer, text, length);
+        PutBytes(writer, "\",\"match\":\"invalid\"}\n", 21);
+    } else {
+        PutField(writer, text, length);
+        PutBytes(writer, "\tinvalid\t\t\n", 11);
+    }
+}
+
+/*
+ * Write the record for the first block of a line too long to be an alert code
+ * The block is trimmed like any other line.  Returns FALSE, writing and
+ * counting nothing, if it is all blank.
+ */
+BOOL WriteOverlongRecord(struct BatchWriter *writer, const char *text, ULONG length, struct BatchStats *stats)
+{
+    while (length > 0 && (*text == ' ' || *text == '\t')) {
+        text++;
+        length--;
+    }
+    if (length == 0) {
+        return FALSE;
+    }
+
+    WriteInvalidRecord(writer, text, length);
+    stats->lines++;
+    stats->invalid++;
+
+    return TRUE;
+}
+
+/*
+ * Decode every line of a block of text and write a record for each
+ * A last line without a newline is decoded too.  Blank lines are
+ * skipped; totals are added to stats.  Queued lines are converted
+ * DECODE_QUEUE_SIZE at a time.
+ */
+VOID DecodeBatchText(struct BatchWriter *writer, const char *text, ULONG length, struct BatchStats *stats)
+{
+    struct DecodeQueue queue;
+    const char *newline;
+    ULONG lineLength;
+
+    queue.count = 0;
+    queue.fieldCount = 0;
+
+    while (length > 0) {
+        newline = (const char *)memchr(text, '\n', length);
+        lineLength = (newline != NULL) ? (ULONG)(newline - text) : length;
+
+        QueueLine(&queue, writer, text, lineLength, stats);
+
+        if (newline == NULL) {
+            break;
+        }
+        text += lineLength + 1;
+        length -= lineLength + 1;
+    }
+
+    DecodeQueuedLines(&queue, writer, stats);
+}
+
+/*
+ * Decode every line of input and write a record for each
+ * Blank lines are skipped.  Returns FALSE on a read or write error;
+ * invalid lines are reported in the output and counted in stats.
+ * Each block is decoded up to its last complete line.
+ */
+BOOL DecodeBatch(FILE *input, FILE *output, ULONG format, struct BatchStats *stats)
+{
+    struct BatchWriter writer;
+    BOOL success;
+
+    memset(stats, 0, sizeof(struct BatchStats));
+
+    if (!OpenBatchWriter(&writer, output, format)) {
+        return FALSE;
+    }
+
+    success = ReadBatchLines(input, &writer, stats);
+    if (!CloseBatchWriter(&writer)) {
+        success = FALSE;
+    }
+
+    return success;
+}
+
+/*
+ * Count every line of input in a summary instead of writing records
+ * The counts are added to what summary already holds, so several inputs
+ * can be summarised together.  Returns FALSE on a read error.
+ */
+BOOL SummarizeBatch(FILE *input, struct AlertSummary *summary, struct BatchStats *stats)
+{
+    struct BatchWriter writer;
+    BOOL success;
+
+    memset(stats, 0, sizeof(struct BatchStats));
+
+    if (!OpenBatchWriter(&writer, NULL, BATCH_FORMAT_TSV)) {
+        return FALSE;
+    }
+    writer.summary = summary;
+
+    success = ReadBatchLines(input, &writer, stats);
+    if (!CloseBatchWriter(&writer)) {
+        success = FALSE;
+    }
+
+    return success;
+}
+
+/*
+ * Write the report of a summary
+ * One total record, one record per subsystem seen with its deadend and
+ * recoverable counts, then the top most counted codes with the most each
+ * count can overstate.  Returns FALSE if the write failed.
+ */
+BOOL WriteSummaryReport(FILE *output, ULONG format, const struct AlertSummary *summary, ULONG top)
+{
+    struct BatchWriter writer;
+    struct AlertDecoding decoding;
+    struct HeavyHitter *hitters;
+    SUMMARYCOUNT deadend;
+    SUMMARYCOUNT recoverable;
+    CONST_STRPTR name;
+    CONST_STRPTR match;
+    ULONG count;
+    ULONG i;
+    BOOL json;
+
+    if (top > SUMMARY_SLOTS) {
+        top = SUMMARY_SLOTS;
+    }
+    hitters = (struct HeavyHitter *)malloc((top + 1) * sizeof(struct HeavyHitter));
+    if (hitters == NULL) {
+        return FALSE;
+    }
+    if (!OpenBatchWriter(&writer, output, format)) {
+        free(hitters);
+        return FALSE;
+    }
+    json = (BOOL)(format == BATCH_FORMAT_JSON);
+
+    deadend = 0;
+    for (i = 0; i < ALERT_SUBSYSTEMS; i++) {
+        deadend += summary->subsystems[i][1];
+    }
+    recoverable = summary->codes - deadend;
+
+    PutBytes(&writer, json ? "{\"report\":\"total\",\"codes\":" : "total\t", json ? 26 : 6);
+    PutCount(&writer, summary->codes);
+    PutBytes(&writer, json ? ",\"deadend\":" : "\t", json ? 11 : 1);
+    PutCount(&writer, deadend);
+    PutBytes(&writer, json ? ",\"recoverable\":" : "\t", json ? 15 : 1);
+    PutCount(&writer, recoverable);
+    PutBytes(&writer, json ? ",\"invalid\":" : "\t", json ? 11 : 1);
+    PutCount(&writer, summary->invalid);
+    PutBytes(&writer, json ? "}\n" : "\n", json ? 2 : 1);
+
+    for (i = 0; i < ALERT_SUBSYSTEMS; i++) {
+        if (summary->subsystems[i][0] == 0 && summary->subsystems[i][1] == 0) {
+            continue;
+        }
+        name = AlertSubsystemName(i);
+
+        PutBytes(&writer, json ? "{\"report\":\"subsystem\",\"subsystem\":\"0x" : "subsystem\t0x", json ? 37 : 12);
+        PutHexDigits(&writer, i, 2);
+        PutBytes(&writer, json ? "\",\"codes\":" : "\t", json ? 10 : 1);
+        PutCount(&writer, summary->subsystems[i][0] + summary->subsystems[i][1]);
+        PutBytes(&writer, json ? ",\"deadend\":" : "\t", json ? 11 : 1);
+        PutCount(&writer, summary->subsystems[i][1]);
+        PutBytes(&writer, json ? ",\"recoverable\":" : "\t", json ? 15 : 1);
+        PutCount(&writer, summary->subsystems[i][0]);
+        if (json) {
+            if (name != NULL) {
+                PutBytes(&writer, ",\"name\":\"", 9);
+                PutField(&writer, name, strlen(name));
+                PutBytes(&writer, "\"", 1);
+            }
+            PutBytes(&writer, "}\n", 2);
+        } else {
+            PutBytes(&writer, "\t", 1);
+            if (name != NULL) {
+                PutField(&writer, name, strlen(name));
+            }
+            PutBytes(&writer, "\n", 1);
+        }
+    }
+
+    count = TopAlertCodes(summary, hitters, top);
+    for (i = 0; i < count; i++) {
+        DecodeAlertInto(hitters[i].code, &decoding, NULL, 0);
+        match = AlertMatchName(decoding.match);
+
+        PutBytes(&writer, json ? "{\"report\":\"code\",\"code\":\"" : "code\t", json ? 25 : 5);
+        PutHexCode(&writer, hitters[i].code);
+        PutBytes(&writer, json ? "\",\"count\":" : "\t", json ? 10 : 1);
+        PutCount(&writer, hitters[i].count);
+        PutBytes(&writer, json ? ",\"error\":" : "\t", json ? 9 : 1);
+        PutCount(&writer, hitters[i].error);
+        PutBytes(&writer, json ? ",\"match\":\"" : "\t", json ? 10 : 1);
+        PutBytes(&writer, match, strlen(match));
+        PutBytes(&writer, json ? "\",\"description\":\"" : "\t", json ? 17 : 1);
+        PutField(&writer, decoding.description, strlen(decoding.description));
+        PutBytes(&writer, json ? "\"}\n" : "\n", json ? 3 : 1);
+    }
+
+    free(hitters);
+
+    return CloseBatchWriter(&writer);
+}
+
+/*
+ * Search the database and write the top matches, best first
+ * Records give the rank, the number of query terms the entry holds, its
+ * score, code, description and expanded insight.  totals, which may be
+ * NULL, receives the query's term and match counts.  Returns FALSE if the
+ * write failed.
+ */
+BOOL WriteSearchResults(FILE *output, ULONG format, CONST_STRPTR query, ULONG top, struct SearchTotals *totals)
+{
+    struct BatchWriter writer;
+    struct SearchHit *hits;
+    struct ErrorView view;
+    ULONG length;
+    ULONG count;
+    ULONG i;
+    BOOL json;
+
+    hits = (struct SearchHit *)malloc((top + 1) * sizeof(struct SearchHit));
+    if (hits == NULL) {
+        return FALSE;
+    }
+    if (!OpenBatchWriter(&writer, output, format)) {
+        free(hits);
+        return FALSE;
+    }
+    json = (BOOL)(format == BATCH_FORMAT_JSON);
+
+    count = SearchInsights(query, hits, top, totals);
+    for (i = 0; i < count; i++) {
+        InsightEntryView(hits[i].entry, &view);
+        length = ExpandExplanationInto(view.insight, writer.text, sizeof(writer.text));
+        if (length >= sizeof(writer.text)) {
+            length = sizeof(writer.text) - 1;
+        }
+
+        if (json) {
+            PutBytes(&writer, "{\"rank\":", 8);
+        }
+        PutDecimal(&writer, i + 1);
+        PutBytes(&writer, json ? ",\"terms\":" : "\t", json ? 9 : 1);
+        PutDecimal(&writer, hits[i].terms);
+        PutBytes(&writer, json ? ",\"score\":" : "\t", json ? 9 : 1);
+        PutDecimal(&writer, hits[i].score);
+        PutBytes(&writer, json ? ",\"code\":\"" : "\t", json ? 9 : 1);
+        PutHexCode(&writer, view.code);
+        PutBytes(&writer, json ? "\",\"description\":\"" : "\t", json ? 17 : 1);
+        PutField(&writer, view.description, strlen(view.description));
+        PutBytes(&writer, json ? "\",\"insight\":\"" : "\t", json ? 13 : 1);
+        PutField(&writer, writer.text, length);
+        PutBytes(&writer, json ? "\"}\n" : "\n", json ? 3 : 1);
+    }
+
+    free(hits);
+
+    return CloseBatchWriter(&writer);
+}
+
+
+/*
+ * Write the database codes nearest to a code, nearest first
+ * Records give the rank, the digit and bit distances, and the code,
+ * description and expanded insight of the match.  found, which may be
+ * NULL, receives the number of matches written.  Returns FALSE if the
+ * write failed.
+ */
+BOOL WriteNearestCodes(FILE *output, ULONG format, ULONG code, ULONG top, ULONG *found)
+{
+    struct BatchWriter writer;
+    struct NearMatch *matches;
+    struct ErrorView view;
+    ULONG length;
+    ULONG count;
+    ULONG i;
+    BOOL json;
+
+    matches = (struct NearMatch *)malloc((top + 1) * sizeof(struct NearMatch));
+    if (matches == NULL) {
+        return FALSE;
+    }
+    if (!OpenBatchWriter(&writer, output, format)) {
+        free(matches);
+        return FALSE;
+    }
+    json = (BOOL)(format == BATCH_FORMAT_JSON);
+
+    count = FindNearestCodes(code, NEAR_MAX_DIGITS, matches, top);
+    for (i = 0; i < count; i++) {
+        InsightEntryView(matches[i].entry, &view);
+        length = ExpandExplanationInto(view.insight, writer.text, sizeof(writer.text));
+        if (length >= sizeof(writer.text)) {
+            length = sizeof(writer.text) - 1;
+        }
+
+        if (json) {
+            PutBytes(&writer, "{\"rank\":", 8);
+        }
+        PutDecimal(&writer, i + 1);
+        PutBytes(&writer, json ? ",\"digits\":" : "\t", json ? 10 : 1);
+        PutDecimal(&writer, matches[i].digits);
+        PutBytes(&writer, json ? ",\"bits\":" : "\t", json ? 8 : 1);
+        PutDecimal(&writer, matches[i].bits);
+        PutBytes(&writer, json ? ",\"code\":\"" : "\t", json ? 9 : 1);
+        PutHexCode(&writer, view.code);
+        PutBytes(&writer, json ? "\",\"description\":\"" : "\t", json ? 17 : 1);
+        PutField(&writer, view.description, strlen(view.description));
+        PutBytes(&writer, json ? "\",\"insight\":\"" : "\t", json ? 13 : 1);
+        PutField(&writer, writer.text, length);
+        PutBytes(&writer, json ? "\"}\n" : "\n", json ? 3 : 1);
+    }
+
+    free(matches);
+    if (found != NULL) {
+        *found = count;
+    }
+
+    return CloseBatchWriter(&writer);
+}
+
+/*
+ * Write the entries whose names contain a word starting with name
+ * Records give the rank and the code, description and expanded insight
+ * of the match, names that start with the query first.  found, which may
+ * be NULL, receives the number of matches written.  Returns FALSE if the
+ * write failed.
+ */
+BOOL WriteNameResults(FILE *output, ULONG format, CONST_STRPTR name, ULONG top, ULONG *found)
+{
+    struct BatchWriter writer;
+    struct NameHit *hits;
+    struct ErrorView view;
+    ULONG length;
+    ULONG count;
+    ULONG i;
+    BOOL json;
+
+    hits = (struct NameHit *)malloc((top + 1) * sizeof(struct NameHit));
+    if (hits == NULL) {
+        return FALSE;
+    }
+    if (!OpenBatchWriter(&writer, output, format)) {
+        free(hits);
+        return FALSE;
+    }
+    json = (BOOL)(format == BATCH_FORMAT_JSON);
+
+    count = FindInsightNames(name, hits, top);
+    for (i = 0; i < count; i++) {
+        InsightEntryView(hits[i].entry, &view);
+        length = ExpandExplanationInto(view.insight, writer.text, sizeof(writer.text));
+        if (length >= sizeof(writer.text)) {
+            length = sizeof(writer.text) - 1;
+        }
+
+        if (json) {
+            PutBytes(&writer, "{\"rank\":", 8);
+        }
+        PutDecimal(&writer, i + 1);
+        PutBytes(&writer, json ? ",\"code\":\"" : "\t", json ? 9 : 1);
+        PutHexCode(&writer, view.code);
+        PutBytes(&writer, json ? "\",\"description\":\"" : "\t", json ? 17 : 1);
+        PutField(&writer, view.description, strlen(view.description));
+        PutBytes(&writer, json ? "\",\"insight\":\"" : "\t", json ? 13 : 1);
+        PutField(&writer, writer.text, length);
+        PutBytes(&writer, json ? "\"}\n" : "\n", json ? 3 : 1);
+    }
+
+    free(hits);
+    if (found != NULL) {
+        *found = count;
+    }
+
+    return CloseBatchWriter(&writer);
+}
+
+/*
+ * Write a daemon's database record, or a record of why a reload failed
+ * With no error the record gives the file served from, its version,
+ * entry count and checksum and the reload counts.  The compiled-in tables
+ * have an empty file and version "built-in".
+ */
+VOID WriteDatabaseRecord(struct BatchWriter *writer, const struct DatabaseStats *stats, CONST_STRPTR error)
+{
+    CONST_STRPTR file;
+    BOOL json;
+
+    json = (BOOL)(writer->format == BATCH_FORMAT_JSON);
+    file = (stats->file != NULL) ? stats->file : "";
+
+    if (error != NULL) {
+        PutBytes(writer, json ? "{\"stats\":\"reload\",\"file\":\"" : "reload\t", json ? 26 : 7);
+        PutField(writer, file, strlen(file));
+        PutBytes(writer, json ? "\",\"error\":\"" : "\t", json ? 11 : 1);
+        PutField(writer, error, strlen(error));
+        PutBytes(writer, json ? "\"}\n" : "\n", json ? 3 : 1);
+        return;
+    }
+
+    PutBytes(writer, json ? "{\"stats\":\"database\",\"file\":\"" : "database\t", json ? 28 : 9);
+    PutField(writer, file, strlen(file));
+    PutBytes(writer, json ? "\",\"version\":\"" : "\t", json ? 13 : 1);
+    if (stats->file == NULL) {
+        PutBytes(writer, "built-in", 8);
+    } else {
+        PutDecimal(writer, stats->version >> 16);
+        PutBytes(writer, ".", 1);
+        PutDecimal(writer, stats->version & 0xFFFF);
+    }
+    PutBytes(writer, json ? "\",\"entries\":" : "\t", json ? 12 : 1);
+    PutDecimal(writer, stats->entries);
+    PutBytes(writer, json ? ",\"checksum\":\"" : "\t", json ? 13 : 1);
+    PutHexCode(writer, stats->checksum);
+    PutBytes(writer, json ? "\",\"reloads\":" : "\t", json ? 12 : 1);
+    PutDecimal(writer, stats->reloads);
+    PutBytes(writer, json ? ",\"failedReloads\":" : "\t", json ? 17 : 1);
+    PutDecimal(writer, stats->failedReloads);
+    PutBytes(writer, json ? "}\n" : "\n", json ? 2 : 1);
+}
+
+/*
+ * Find an output format by name, ignoring case
+ * Returns the BATCH_FORMAT_xxx number or -1
+ */
+LONG FindBatchFormat(CONST_STRPTR name)
+{
+    CONST_STRPTR a;
+    CONST_STRPTR b;
+    ULONG i;
+
+    if (name == NULL) {
+        return -1;
+    }
+
+    for (i = 0; i < BATCH_FORMATS; i++) {
+        a = name;
+        b = formatNames[i];
+        while (*a != '\0' && (*a | 0x20) == *b) {
+            a++;
+            b++;
+        }
+        if (*a == '\0' && *b == '\0') {
+            return (LONG)i;
+        }
+    }
+
+    return -1;
+}
+
+/*
+ * Decode or count every line of input through a writer
+ * Blank lines are skipped.  Returns FALSE on a read error or if the
+ * input buffer cannot be allocated; the writer is left open.  Each block
+ * is decoded up to its last complete line.
+ */
+static BOOL ReadBatchLines(FILE *input, struct BatchWriter *writer, struct BatchStats *stats)
+{
+    char *buffer;
+    char *newline;
+    ULONG start;
+    ULONG end;
+    ULONG last;
+    ULONG got;
+    BOOL endOfInput;
+    BOOL skipping;
+    BOOL success;
+
+    buffer = (char *)malloc(BATCH_BUFFER_SIZE);
+    if (buffer == NULL) {
+        return FALSE;
+    }
+
+    start = 0;
+    end = 0;
+    endOfInput = FALSE;
+    skipping = FALSE;
+    success = TRUE;
+
+    for (;;) {
+        if (skipping) {
+            /* Tail of an overlong line that was already reported */
+            newline = (char *)memchr(buffer + start, '\n', end - start);
+            if (newline != NULL) {
+                start = (ULONG)(newline - buffer) + 1;
+                skipping = FALSE;
+            } else {
+                start = end;
+            }
+        }
+
+        if (!skipping) {
+            last = end;
+            if (!endOfInput) {
+                while (last > start && buffer[last - 1] != '\n') {
+                    last--;
+                }
+            }
+            if (last > start) {
+                DecodeBatchText(writer, buffer + start, last - start, stats);
+                start = last;
+            }
+        }
+
+        if (endOfInput) {
+            break;
+        }
+
+        /* Keep the partial line and refill behind it */
+        if (start > 0) {
+            memmove(buffer, buffer + start, end - start);
+            end -= start;
+            start = 0;
+        }
+        if (end == BATCH_BUFFER_SIZE) {
+            /* A line longer than the whole block cannot be an alert code */
+            if (!skipping) {
+                /* An all blank block is just dropped */
+                skipping = WriteOverlongRecord(writer, buffer, end, stats);
+            }
+            start = 0;
+            end = 0;
+        }
+
+        got = (ULONG)fread(buffer + end, 1, BATCH_BUFFER_SIZE - end, input);
+        if (got == 0) {
+            if (ferror(input)) {
+                success = FALSE;
+            }
+            endOfInput = TRUE;
+        }
+        end += got;
+    }
+
+    free(buffer);
+
+    return success;
+}
+
+/*
+ * Trim one input line and queue it for decoding
+ * A line is code shaped if it is 8 characters, or 10 with a 0x prefix;
+ * anything else is invalid without looking at the digits.
+ */
+static VOID QueueLine(struct DecodeQueue *queue, struct BatchWriter *writer, const char *line, ULONG length,
+                      struct BatchStats *stats)
+{
+    ULONG slot;
+
+    while (length > 0 && (line[0] == ' ' || line[0] == '\t')) {
+        line++;
+        length--;
+    }
+    while (length > 0 && (line[length - 1] == ' ' || line[length - 1] == '\t' || line[length - 1] == '\r')) {
+        length--;
+    }
+    if (length == 0) {
+        return;
+    }
+
+    stats->lines++;
+
+    slot = queue->count++;
+    queue->text[slot] = line;
+    queue->length[slot] = length;
+    queue->field[slot] = -1;
+
+    if (length == 10 && line[0] == '0' && (line[1] == 'x' || line[1] == 'X')) {
+        line += 2;
+        length = 8;
+    }
+    if (length == 8) {
+        queue->field[slot] = (LONG)queue->fieldCount;
+        queue->fields[queue->fieldCount++] = line;
+    }
+
+    if (queue->count == DECODE_QUEUE_SIZE) {
+        DecodeQueuedLines(queue, writer, stats);
+    }
+}
+
+/*
+ * Convert the codes of all queued lines at once, then write their
+ * records in input order (or count them in the writer's summary) and
+ * empty the queue
+ */
+static VOID DecodeQueuedLines(struct DecodeQueue *queue, struct BatchWriter *writer, struct BatchStats *stats)
+{
+    ULONG i;
+    LONG field;
+
+    ParseHexFields(queue->fields, queue->fieldCount, queue->codes, queue->status);
+
+    for (i = 0; i < queue->count; i++) {
+        field = queue->field[i];
+        if (field < 0 || queue->status[field] != HEX_OK) {
+            WriteInvalidRecord(writer, queue->text[i], queue->length[i]);
+            stats->invalid++;
+        } else if (writer->summary != NULL) {
+            CountAlertCode(writer->summary, queue->codes[field]);
+        } else if (WriteAlertRecord(writer, queue->codes[field]) == ALERT_MATCH_EXACT) {
+            stats->exact++;
+        } else {
+            stats->decoded++;
+        }
+    }
+
+    queue->count = 0;
+    queue->fieldCount = 0;
+}
+
+/*
+ * Make room for needed bytes in a memory writer, doubling the buffer
+ */
+static BOOL GrowBatchWriter(struct BatchWriter *writer, ULONG needed)
+{
+    char *buffer;
+    ULONG size;
+
+    if (writer->failed) {
+        return FALSE;
+    }
+
+    size = writer->size;
+    while (size < needed) {
+        size *= 2;
+    }
+
+    buffer = (char *)realloc(writer->buffer, size);
+    if (buffer == NULL) {
+        writer->failed = TRUE;
+        return FALSE;
+    }
+
+    writer->buffer = buffer;
+    writer->size = size;
+
+    return TRUE;
+}
+
+/*
+ * Append raw bytes to the output block, writing it out when full
+ */
+static VOID PutBytes(struct BatchWriter *writer, const char *data, ULONG length)
+{
+    if (writer->used + length > writer->size) {
+        if (writer->file == NULL) {
+            if (!GrowBatchWriter(writer, writer->used + length)) {
+                return;
+            }
+        } else {
+            FlushBatchWriter(writer);
+        }
+        if (length > writer->size) {
+            if (!writer->failed && fwrite(data, 1, length, writer->file) != length) {
+                writer->failed = TRUE;
+            }
+            return;
+        }
+    }
+
+    memcpy(writer->buffer + writer->used, data, length);
+    writer->used += length;
+}
+
+/*
+ * Append text as a field of the current format
+ * Runs of plain characters are copied in one go; TSV turns control
+ * characters into spaces and JSON escapes quotes, backslashes, control
+ * characters and (as Latin-1) anything above 7-bit ASCII.
+ */
+static VOID PutField(struct BatchWriter *writer, const char *text, ULONG length)
+{
+    static const char hexDigits[] = "0123456789abcdef";
+    char escape[6];
+    ULONG run;
+    UBYTE c;
+
+    while (length > 0) {
+        run = 0;
+        while (run < length) {
+            c = (UBYTE)text[run];
+            if (c < 0x20 || (writer->format == BATCH_FORMAT_JSON && (c == '"' || c == '\\' || c >= 0x7F))) {
+                break;
+            }
+            run++;
+        }
+        PutBytes(writer, text, run);
+        text += run;
+        length -= run;
+        if (length == 0) {
+            break;
+        }
+
+        c = (UBYTE)*text;
+        if (writer->format != BATCH_FORMAT_JSON) {
+            PutBytes(writer, " ", 1);
+        } else if (c == '"' || c == '\\') {
+            escape[0] = '\\';
+            escape[1] = (char)c;
+            PutBytes(writer, escape, 2);
+        } else {
+            escape[0] = '\\';
+            escape[1] = 'u';
+            escape[2] = '0';
+            escape[3] = '0';
+            escape[4] = hexDigits[c >> 4];
+            escape[5] = hexDigits[c & 0xF];
+            PutBytes(writer, escape, 6);
+        }
+        text++;
+        length--;
+    }
+}
+
+/*
+ * Append an alert code as 0xXXXXXXXX
+ */
+static VOID PutHexCode(struct BatchWriter *writer, ULONG alertCode)
+{
+    PutBytes(writer, "0x", 2);
+    PutHexDigits(writer, alertCode, 8);
+}
+
+/*
+ * Append the low digits of a value in upper case hex, up to 8
+ */
+static VOID PutHexDigits(struct BatchWriter *writer, ULONG value, ULONG digits)
+{
+    char hex[8];
+    ULONG i;
+
+    for (i = 0; i < digits; i++) {
+        hex[digits - 1 - i] = "0123456789ABCDEF"[(value >> (i * 4)) & 0xF];
+    }
+
+    PutBytes(writer, hex, digits);
+}
+
+/*
+ * Append an unsigned decimal number
+ */
+static VOID PutDecimal(struct BatchWriter *writer, ULONG value)
+{
+    char digits[10];
+    ULONG count;
+
+    count = 0;
+    do {
+        digits[sizeof(digits) - 1 - count] = (char)('0' + value % 10);
+        value /= 10;
+        count++;
+    } while (value != 0);
+
+    PutBytes(writer, digits + sizeof(digits) - count, count);
+}
+
+/*
+ * Append a summary count in decimal
+ */
+static VOID PutCount(struct BatchWriter *writer, SUMMARYCOUNT value)
+{
+    char digits[20];
+    ULONG count;
+
+    count = 0;
+    do {
+        digits[sizeof(digits) - 1 - count] = (char)('0' + (int)(value % 10));
+        value /= 10;
+        count++;
+    } while (value != 0);
+
+    PutBytes(writer, digits + sizeof(digits) - count, count);
+}
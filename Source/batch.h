@@ -0,0 +1,122 @@
+/*
+ * Batch Decoding
+ *
+ * Decodes a stream of alert codes, one per line, from a file or stdin and
+ * writes one TSV or JSON record per code.  Input is read in large blocks
+ * and output is collected in a buffer that is written out in large blocks,
+ * so the cost per code is the decode itself rather than I/O calls.
+ *
+ * After meditiation comes... Insight
+ *
+ * Copyright (c) 2025-26 amigazen project
+ * Licensed under BSD 2-Clause License
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef BATCH_H
+#define BATCH_H
+
+#include <stdio.h>
+#include "platform.h"
+#include "error_codes.h"
+#include "summary.h"
+#include "search.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Output formats */
+#define BATCH_FORMAT_TSV  0  /* code, match, description, insight - tab separated */
+#define BATCH_FORMAT_JSON 1  /* One JSON object per line */
+#define BATCH_FORMATS     2
+
+/* Size of the input and output blocks */
+#define BATCH_BUFFER_SIZE 65536
+
+/* Buffered record writer - with no file, records collect in the buffer, which grows */
+struct BatchWriter {
+    FILE *file;
+    ULONG format;
+    char *buffer;
+    ULONG used;
+    ULONG size;                        /* Bytes allocated for buffer */
+    BOOL failed;                       /* A write failed - later output is dropped */
+    struct AlertSummary *summary;      /* When set, batch codes are counted here instead of written */
+    char text[INSIGHT_MAX_LENGTH];     /* Decoded insight of the current record */
+};
+
+/* Where a code came from, for records of codes found in logs or the crash history */
+struct RecordSource {
+    ULONG line;
+    CONST_STRPTR time;        /* Written instead of line when set */
+    CONST_STRPTR kind;        /* Left out when NULL */
+    BOOL hasProducer;         /* Left out when FALSE */
+    ULONG producer;
+    BOOL hasTask;
+    ULONG task;
+    CONST_STRPTR taskName;    /* Left out when NULL */
+};
+
+/* Totals for a batch run - a summarised run leaves exact and decoded at 0 */
+struct BatchStats {
+    ULONG lines;       /* Non-blank input lines */
+    ULONG exact;       /* Codes found in the database */
+    ULONG decoded;     /* Codes explained from their fields */
+    ULONG invalid;     /* Lines that are not an alert code */
+};
+
+/* The database a daemon serves from, for its database records */
+struct DatabaseStats {
+    CONST_STRPTR file;        /* NULL for the compiled-in tables */
+    ULONG version;            /* Format version, major << 16 | minor - 0 for the compiled-in tables */
+    ULONG entries;
+    ULONG checksum;
+    ULONG reloads;            /* Reloads that replaced the database */
+    ULONG failedReloads;      /* Reloads that left it in place */
+};
+
+/* Function declarations */
+BOOL OpenBatchWriter(struct BatchWriter *writer, FILE *file, ULONG format);
+BOOL CloseBatchWriter(struct BatchWriter *writer);
+BOOL FlushBatchWriter(struct BatchWriter *writer);
+ULONG WriteAlertRecord(struct BatchWriter *writer, ULONG alertCode);
+ULONG WriteSourcedAlertRecord(struct BatchWriter *writer, ULONG alertCode, const struct RecordSource *source);
+VOID WriteInvalidRecord(struct BatchWriter *writer, CONST_STRPTR text, ULONG length);
+BOOL WriteOverlongRecord(struct BatchWriter *writer, const char *text, ULONG length, struct BatchStats *stats);
+VOID DecodeBatchText(struct BatchWriter *writer, const char *text, ULONG length, struct BatchStats *stats);
+BOOL DecodeBatch(FILE *input, FILE *output, ULONG format, struct BatchStats *stats);
+BOOL SummarizeBatch(FILE *input, struct AlertSummary *summary, struct BatchStats *stats);
+BOOL WriteSummaryReport(FILE *output, ULONG format, const struct AlertSummary *summary, ULONG top);
+BOOL WriteSearchResults(FILE *output, ULONG format, CONST_STRPTR query, ULONG top, struct SearchTotals *totals);
+BOOL WriteNearestCodes(FILE *output, ULONG format, ULONG code, ULONG top, ULONG *found);
+BOOL WriteNameResults(FILE *output, ULONG format, CONST_STRPTR name, ULONG top, ULONG *found);
+VOID WriteDatabaseRecord(struct BatchWriter *writer, const struct DatabaseStats *stats, CONST_STRPTR error);
+LONG FindBatchFormat(CONST_STRPTR name);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* BATCH_H */
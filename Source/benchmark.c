@@ -0,0 +1,790 @@
+/*
+ * Decoding Benchmarks
+ *
+ * Host micro-benchmarks for the decoding core.  Each benchmark runs one
+ * core function over a ring of prepared inputs - database hits, misses or
+ * an even mix - and reports the median and best time per call over several
+ * trials, and the heap allocations per call.  Lookup benchmarks run once
+ * per lookup engine so the engines can be compared on the same inputs.
+ * Results are written as TSV or JSON lines to track releases against each
+ * other.
+ *
+ * Usage: insight_bench [FORMAT=tsv|json] [FILTER=<name>] [TIME=<ms>]
+ *                      [SEED=<n>] [DATABASE=<file.idb>]
+ *
+ * After meditiation comes... Insight
+ *
+ * Copyright (c) 2025-26 amigazen project
+ * Licensed under BSD 2-Clause License
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "libinsight.h"
+#include "batch.h"
+#include "hosttools.h"
+
+/* Prepared inputs per benchmark - a power of two so the ring index is a mask */
+#define BENCH_INPUTS 4096
+#define BENCH_MASK   (BENCH_INPUTS - 1)
+
+/* Timed trials per benchmark - the median and best are reported */
+#define BENCH_TRIALS 5
+
+/* Default time per trial in milliseconds */
+#define BENCH_DEFAULT_TIME 20
+
+/* Input distributions */
+#define BENCH_HIT   0  /* Codes in the database, well formed text */
+#define BENCH_MISS  1  /* Codes not in the database, malformed text */
+#define BENCH_MIXED 2  /* Even mix of the two, shuffled */
+#define BENCH_DISTRIBUTIONS 3
+
+/* Distribution masks - which distributions a benchmark runs on */
+#define BENCH_ALL_DISTRIBUTIONS 0x7
+#define BENCH_HIT_ONLY          0x1
+
+/* Requester messages for the word wrap benchmark, as ShowErrorDialog builds them */
+#define BENCH_MESSAGES      64
+#define BENCH_MESSAGE_MASK  (BENCH_MESSAGES - 1)
+#define BENCH_MESSAGE_SIZE  (INSIGHT_MAX_LENGTH + 256)
+
+/* Wrap width in pixels - 80% of a 640 pixel screen */
+#define BENCH_WRAP_WIDTH    512
+
+/* Every distribution of inputs, prepared once */
+struct BenchInput {
+    ULONG codes[BENCH_INPUTS];               /* Alert codes */
+    ULONG tokens[BENCH_INPUTS];              /* Token numbers */
+    STRPTR strings[BENCH_INPUTS];            /* Command line style code text */
+    CONST_STRPTR insights[BENCH_INPUTS];     /* Compressed insight text - hits only */
+    CONST_STRPTR queries[BENCH_INPUTS];      /* Search queries - descriptions of database entries */
+    char text[BENCH_INPUTS][16];
+    char names[BENCH_INPUTS][8];             /* Name queries - the first letters of descriptions */
+    char messages[BENCH_MESSAGES][BENCH_MESSAGE_SIZE];
+};
+
+/* A benchmark - run performs iterations calls and returns a value to keep */
+struct Benchmark {
+    CONST_STRPTR name;
+    ULONG distributions;     /* BENCH_xxx_DISTRIBUTIONS mask */
+    BOOL perEngine;          /* Run once with each lookup engine */
+    ULONG (*run)(const struct BenchInput *input, ULONG engine, ULONG iterations);
+};
+
+/* Result of one benchmark on one distribution */
+struct BenchResult {
+    double median;           /* Nanoseconds per call */
+    double best;
+    double allocations;      /* Heap allocations per call, negative if not counted */
+    ULONG iterations;        /* Calls per trial */
+};
+
+/* Distribution names, indexed by BENCH_xxx */
+static const CONST_STRPTR distributionNames[BENCH_DISTRIBUTIONS] = {
+    "hit", "miss", "mixed"
+};
+
+/* Keeps results alive so the compiler cannot drop the calls */
+static volatile ULONG benchSink;
+
+/* Heap allocations by the core, counted through the linker's --wrap */
+static ULONG allocationCount;
+
+/* Glyph widths of a stand-in proportional font for the word wrap benchmark */
+static struct GlyphMetrics benchMetrics;
+
+/* Forward declarations */
+static ULONG RandomMissCode(VOID);
+static VOID PrepareInput(struct BenchInput *input, ULONG distribution);
+static VOID MeasureBenchmark(const struct Benchmark *benchmark, const struct BenchInput *input, ULONG engine,
+                             ULONG trialTime, struct BenchResult *result);
+static double TimeCalls(const struct Benchmark *benchmark, const struct BenchInput *input, ULONG engine,
+                        ULONG iterations);
+static double NowNanoseconds(VOID);
+static int CompareDoubles(const VOID *a, const VOID *b);
+static VOID WriteResult(ULONG format, const struct Benchmark *benchmark, ULONG distribution, ULONG engine,
+                        const struct BenchResult *result);
+static ULONG BenchGainInsight(const struct BenchInput *input, ULONG engine, ULONG iterations);
+static ULONG BenchGainInsightInto(const struct BenchInput *input, ULONG engine, ULONG iterations);
+static ULONG BenchPeekInsight(const struct BenchInput *input, ULONG engine, ULONG iterations);
+static ULONG BenchLookupWithEngine(const struct BenchInput *input, ULONG engine, ULONG iterations);
+static ULONG BenchDecodeAlertInto(const struct BenchInput *input, ULONG engine, ULONG iterations);
+static ULONG BenchExpandExplanation(const struct BenchInput *input, ULONG engine, ULONG iterations);
+static ULONG BenchExpandExplanationInto(const struct BenchInput *input, ULONG engine, ULONG iterations);
+static ULONG BenchLookupToken(const struct BenchInput *input, ULONG engine, ULONG iterations);
+static ULONG BenchHexStringToULong(const struct BenchInput *input, ULONG engine, ULONG iterations);
+static ULONG BenchLooksLikeHexNumber(const struct BenchInput *input, ULONG engine, ULONG iterations);
+static ULONG BenchParseHexCode(const struct BenchInput *input, ULONG engine, ULONG iterations);
+static ULONG BenchWrapTextInto(const struct BenchInput *input, ULONG engine, ULONG iterations);
+static ULONG BenchSearchInsights(const struct BenchInput *input, ULONG engine, ULONG iterations);
+static ULONG BenchFindNearestCodes(const struct BenchInput *input, ULONG engine, ULONG iterations);
+static ULONG BenchFindInsightNames(const struct BenchInput *input, ULONG engine, ULONG iterations);
+static ULONG BenchGlyphWidth(UBYTE glyph, APTR font);
+
+/* The benchmarks, in report order */
+static const struct Benchmark benchmarks[] = {
+    { "GainInsight",           BENCH_ALL_DISTRIBUTIONS, TRUE,  BenchGainInsight },
+    { "GainInsightInto",       BENCH_ALL_DISTRIBUTIONS, TRUE,  BenchGainInsightInto },
+    { "PeekInsight",           BENCH_ALL_DISTRIBUTIONS, TRUE,  BenchPeekInsight },
+    { "LookupWithEngine",      BENCH_ALL_DISTRIBUTIONS, TRUE,  BenchLookupWithEngine },
+    { "DecodeAlertInto",       BENCH_ALL_DISTRIBUTIONS, FALSE, BenchDecodeAlertInto },
+    { "ExpandExplanation",     BENCH_HIT_ONLY,          FALSE, BenchExpandExplanation },
+    { "ExpandExplanationInto", BENCH_HIT_ONLY,          FALSE, BenchExpandExplanationInto },
+    { "LookupToken",           BENCH_ALL_DISTRIBUTIONS, FALSE, BenchLookupToken },
+    { "HexStringToULong",      BENCH_ALL_DISTRIBUTIONS, FALSE, BenchHexStringToULong },
+    { "LooksLikeHexNumber",    BENCH_ALL_DISTRIBUTIONS, FALSE, BenchLooksLikeHexNumber },
+    { "ParseHexCode",          BENCH_ALL_DISTRIBUTIONS, FALSE, BenchParseHexCode },
+    { "WrapTextInto",          BENCH_HIT_ONLY,          FALSE, BenchWrapTextInto },
+    { "SearchInsights",        BENCH_HIT_ONLY,          FALSE, BenchSearchInsights },
+    { "FindNearestCodes",      BENCH_ALL_DISTRIBUTIONS, FALSE, BenchFindNearestCodes },
+    { "FindInsightNames",      BENCH_HIT_ONLY,          FALSE, BenchFindInsightNames }
+};
+
+#define BENCHMARK_COUNT (sizeof(benchmarks) / sizeof(benchmarks[0]))
+
+#ifdef INSIGHT_BENCH_ALLOCATIONS
+/* Linked with --wrap, so the core's heap calls come here first */
+VOID *__real_malloc(size_t size);
+VOID *__real_calloc(size_t count, size_t size);
+VOID *__real_realloc(VOID *block, size_t size);
+VOID *__wrap_malloc(size_t size);
+VOID *__wrap_calloc(size_t count, size_t size);
+VOID *__wrap_realloc(VOID *block, size_t size);
+
+VOID *__wrap_malloc(size_t size)
+{
+    allocationCount++;
+    return __real_malloc(size);
+}
+
+VOID *__wrap_calloc(size_t count, size_t size)
+{
+    allocationCount++;
+    return __real_calloc(count, size);
+}
+
+VOID *__wrap_realloc(VOID *block, size_t size)
+{
+    allocationCount++;
+    return __real_realloc(block, size);
+}
+#endif /* INSIGHT_BENCH_ALLOCATIONS */
+
+int main(int argc, char *argv[])
+{
+    struct BenchInput *inputs;
+    struct BenchResult result;
+    struct InsightDatabase *database;
+    const struct Benchmark *benchmark;
+    const char *filter;
+    const char *databaseArg;
+    const char *value;
+    ULONG databaseError;
+    ULONG trialTime;
+    ULONG seed;
+    ULONG distribution;
+    ULONG engine;
+    ULONG engines;
+    ULONG defaultEngine;
+    ULONG i;
+    LONG format;
+    int arg;
+
+    format = BATCH_FORMAT_TSV;
+    filter = NULL;
+    databaseArg = NULL;
+    trialTime = BENCH_DEFAULT_TIME;
+    seed = 1;
+
+    for (arg = 1; arg < argc; arg++) {
+        if (MatchKeyword(argv[arg], "FORMAT", &value) && value != NULL) {
+            format = FindBatchFormat(value);
+            if (format < 0) {
+                fprintf(stderr, "Error: Unknown output format. Use tsv or json.\n");
+                return EXIT_FAILURE;
+            }
+        } else if (MatchKeyword(argv[arg], "FILTER", &value) && value != NULL) {
+            filter = value;
+        } else if (MatchKeyword(argv[arg], "TIME", &value) && value != NULL && atol(value) > 0) {
+            trialTime = (ULONG)atol(value);
+        } else if (MatchKeyword(argv[arg], "SEED", &value) && value != NULL) {
+            seed = (ULONG)strtoul(value, NULL, 10);
+        } else if (MatchKeyword(argv[arg], "DATABASE", &value) && value != NULL) {
+            databaseArg = value;
+        } else {
+            fprintf(stderr, "Usage: insight_bench [FORMAT=tsv|json] [FILTER=<name>] [TIME=<ms>] [SEED=<n>] "
+                            "[DATABASE=<file.idb>]\n");
+            return EXIT_FAILURE;
+        }
+    }
+
+    database = NULL;
+    if (databaseArg != NULL) {
+        database = OpenInsightDatabase(databaseArg, 0, &databaseError);
+        if (database == NULL) {
+            fprintf(stderr, "Error: Cannot load database %s: %s\n", databaseArg, IdbErrorText(databaseError));
+            return EXIT_FAILURE;
+        }
+        UseInsightDatabase(database);
+    }
+
+    /* Every distribution is prepared up front so each benchmark sees the same inputs */
+    inputs = (struct BenchInput *)malloc(BENCH_DISTRIBUTIONS * sizeof(struct BenchInput));
+    if (inputs == NULL) {
+        fprintf(stderr, "Error: Out of memory\n");
+        return EXIT_FAILURE;
+    }
+    SeedRandom(seed);
+    InitGlyphMetrics(&benchMetrics, BenchGlyphWidth, NULL);
+    for (distribution = 0; distribution < BENCH_DISTRIBUTIONS; distribution++) {
+        PrepareInput(&inputs[distribution], distribution);
+    }
+
+    defaultEngine = GetLookupEngine();
+    if (format == BATCH_FORMAT_JSON) {
+        printf("{\"version\":\"%s\",\"entries\":%lu,\"database\":\"%s\",\"seed\":%lu,\"trials\":%d,"
+               "\"trialTime\":%lu,\"allocationsCounted\":%s}\n",
+               InsightVersionString(), (unsigned long)InsightEntryCount(), database != NULL ? "file" : "built-in",
+               (unsigned long)seed, BENCH_TRIALS, (unsigned long)trialTime,
+#ifdef INSIGHT_BENCH_ALLOCATIONS
+               "true"
+#else
+               "false"
+#endif
+               );
+    } else {
+        printf("# %s, %lu entries, %s database, seed %lu\n", InsightVersionString(),
+               (unsigned long)InsightEntryCount(), database != NULL ? "file" : "built-in", (unsigned long)seed);
+        printf("# benchmark\tdistribution\tengine\tns/op\tbest ns/op\tallocations/op\tcalls/trial\n");
+    }
+
+    for (i = 0; i < BENCHMARK_COUNT; i++) {
+        benchmark = &benchmarks[i];
+        if (filter != NULL && strstr(benchmark->name, filter) == NULL) {
+            continue;
+        }
+
+        engines = benchmark->perEngine ? LOOKUP_ENGINES : 1;
+        for (engine = 0; engine < engines; engine++) {
+            if (!benchmark->perEngine) {
+                engine = defaultEngine;
+            }
+            SetLookupEngine(engine);
+
+            for (distribution = 0; distribution < BENCH_DISTRIBUTIONS; distribution++) {
+                if ((benchmark->distributions & (1UL << distribution)) == 0) {
+                    continue;
+                }
+                MeasureBenchmark(benchmark, &inputs[distribution], engine, trialTime, &result);
+                WriteResult((ULONG)format, benchmark, distribution, engine, &result);
+            }
+
+            if (!benchmark->perEngine) {
+                break;
+            }
+        }
+        SetLookupEngine(defaultEngine);
+    }
+
+    free(inputs);
+    if (database != NULL) {
+        UseInsightDatabase(NULL);
+        CloseInsightDatabase(database);
+    }
+
+    return (fflush(stdout) == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+/*
+ * A random code that is not in the active database
+ */
+static ULONG RandomMissCode(VOID)
+{
+    ULONG code;
+
+    do {
+        code = NextRandom();
+    } while (InsightIsKnownCode(code));
+
+    return code;
+}
+
+/*
+ * Fill the inputs of one distribution
+ * Hits are database codes, valid token numbers and well formed 8 digit
+ * text, a quarter of it with 0x.  Misses are unknown codes, token
+ * numbers past the dictionary and text with a bad digit, a wrong length
+ * or no digits at all.  The mix takes each input from one or the other at
+ * random.
+ */
+static VOID PrepareInput(struct BenchInput *input, ULONG distribution)
+{
+    struct ErrorView view;
+    ULONG entries;
+    ULONG code;
+    ULONG kind;
+    ULONG length;
+    ULONG i;
+    BOOL hit;
+
+    entries = InsightEntryCount();
+
+    for (i = 0; i < BENCH_INPUTS; i++) {
+        if (distribution == BENCH_MIXED) {
+            hit = (BOOL)((NextRandom() & 1) != 0);
+        } else {
+            hit = (BOOL)(distribution == BENCH_HIT);
+        }
+
+        if (hit) {
+            code = InsightEntryAt(NextRandom() % entries)->code;
+            input->codes[i] = code;
+            input->tokens[i] = NextRandom() % TOKEN_TABLE_SIZE;
+            sprintf(input->text[i], (NextRandom() & 3) == 0 ? "0x%08lX" : "%08lX", (unsigned long)code);
+        } else {
+            code = RandomMissCode();
+            input->codes[i] = code;
+            input->tokens[i] = TOKEN_TABLE_SIZE + NextRandom() % 256;
+            kind = NextRandom() % 3;
+            if (kind == 0) {
+                sprintf(input->text[i], "%08lX", (unsigned long)code);
+                input->text[i][NextRandom() % 8] = 'G';
+            } else if (kind == 1) {
+                sprintf(input->text[i], "%07lX", (unsigned long)(code >> 4));
+            } else {
+                strcpy(input->text[i], "FORMAT=json");
+            }
+        }
+        input->strings[i] = input->text[i];
+
+        /* Expansion always needs real insight text */
+        PeekInsight(InsightEntryAt(NextRandom() % entries)->code, &view);
+        input->insights[i] = view.insight;
+
+        PeekInsight(InsightEntryAt(NextRandom() % entries)->code, &view);
+        input->queries[i] = view.description;
+
+        /* A name as it is typed - one to six letters of a description */
+        PeekInsight(InsightEntryAt(NextRandom() % entries)->code, &view);
+        length = 1 + NextRandom() % 6;
+        strncpy(input->names[i], view.description, length);
+        input->names[i][length] = '\0';
+    }
+
+    /* Messages are built from hits whatever the distribution, like the requester's */
+    for (i = 0; i < BENCH_MESSAGES; i++) {
+        PeekInsight(InsightEntryAt(NextRandom() % entries)->code, &view);
+        snprintf(input->messages[i], sizeof(input->messages[i]),
+                 "\n\nError Code: 0x%08lX \n\nTask ID: (Test Mode) \n\nError: %s \n\n\33i%s\33n \n\n",
+                 (unsigned long)view.code, view.description, ExpandExplanation((STRPTR)view.insight));
+    }
+}
+
+/*
+ * Time a benchmark on one distribution
+ * The call count is doubled until a run takes a tenth of trialTime, then
+ * scaled so a trial takes about trialTime milliseconds.
+ */
+static VOID MeasureBenchmark(const struct Benchmark *benchmark, const struct BenchInput *input, ULONG engine,
+                             ULONG trialTime, struct BenchResult *result)
+{
+    double trials[BENCH_TRIALS];
+    double target;
+    double elapsed;
+    double scaled;
+    ULONG iterations;
+    ULONG allocations;
+    ULONG i;
+
+    target = (double)trialTime * 1e6;
+    iterations = BENCH_INPUTS;
+    for (;;) {
+        elapsed = TimeCalls(benchmark, input, engine, iterations);
+        if (elapsed >= target / 10 || iterations >= 0x40000000UL) {
+            break;
+        }
+        iterations *= 2;
+    }
+    scaled = (elapsed > 0) ? (double)iterations * target / elapsed : (double)iterations;
+    if (scaled > 4e9) {
+        scaled = 4e9;
+    }
+    iterations = (scaled < 1) ? 1 : (ULONG)scaled;
+
+    allocationCount = 0;
+    for (i = 0; i < BENCH_TRIALS; i++) {
+        trials[i] = TimeCalls(benchmark, input, engine, iterations) / (double)iterations;
+    }
+    allocations = allocationCount;
+    qsort(trials, BENCH_TRIALS, sizeof(double), CompareDoubles);
+
+    result->median = trials[BENCH_TRIALS / 2];
+    result->best = trials[0];
+    result->iterations = iterations;
+#ifdef INSIGHT_BENCH_ALLOCATIONS
+    result->allocations = (double)allocations / ((double)iterations * BENCH_TRIALS);
+#else
+    result->allocations = -1;
+    (VOID)allocations;
+#endif
+}
+
+/*
+ * Nanoseconds taken by iterations calls
+ */
+static double TimeCalls(const struct Benchmark *benchmark, const struct BenchInput *input, ULONG engine,
+                        ULONG iterations)
+{
+    double start;
+
+    start = NowNanoseconds();
+    benchSink += benchmark->run(input, engine, iterations);
+
+    return NowNanoseconds() - start;
+}
+
+/*
+ * Monotonic clock in nanoseconds
+ */
+static double NowNanoseconds(VOID)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return (double)now.tv_sec * 1e9 + (double)now.tv_nsec;
+}
+
+/*
+ * qsort order of doubles, lowest first
+ */
+static int CompareDoubles(const VOID *a, const VOID *b)
+{
+    double first;
+    double second;
+
+    first = *(const double *)a;
+    second = *(const double *)b;
+
+    return (first < second) ? -1 : (first > second) ? 1 : 0;
+}
+
+/*
+ * Write one result as a TSV line or a JSON object
+ */
+static VOID WriteResult(ULONG format, const struct Benchmark *benchmark, ULONG distribution, ULONG engine,
+                        const struct BenchResult *result)
+{
+    if (format == BATCH_FORMAT_JSON) {
+        printf("{\"benchmark\":\"%s\",\"distribution\":\"%s\",\"engine\":\"%s\",\"nsPerOp\":%.2f,"
+               "\"bestNsPerOp\":%.2f,", benchmark->name, distributionNames[distribution],
+               LookupEngineName(engine), result->median, result->best);
+        if (result->allocations >= 0) {
+            printf("\"allocationsPerOp\":%.2f,", result->allocations);
+        } else {
+            printf("\"allocationsPerOp\":null,");
+        }
+        printf("\"callsPerTrial\":%lu}\n", (unsigned long)result->iterations);
+    } else {
+        printf("%s\t%s\t%s\t%.2f\t%.2f\t", benchmark->name, distributionNames[distribution],
+               LookupEngineName(engine), result->median, result->best);
+        if (result->allocations >= 0) {
+            printf("%.2f", result->allocations);
+        }
+        printf("\t%lu\n", (unsigned long)result->iterations);
+    }
+}
+
+/*
+ * GainInsight and FreeErrorInfo - the allocating lookup
+ */
+static ULONG BenchGainInsight(const struct BenchInput *input, ULONG engine, ULONG iterations)
+{
+    struct ErrorInfo *info;
+    ULONG sum;
+    ULONG i;
+
+    sum = 0;
+    for (i = 0; i < iterations; i++) {
+        info = GainInsight(input->codes[i & BENCH_MASK]);
+        if (info != NULL) {
+            sum += (ULONG)(UBYTE)info->insight[0];
+            FreeErrorInfo(info);
+        }
+    }
+
+    return sum;
+}
+
+/*
+ * GainInsightInto - lookup and expansion into a caller buffer
+ */
+static ULONG BenchGainInsightInto(const struct BenchInput *input, ULONG engine, ULONG iterations)
+{
+    char buffer[INSIGHT_MAX_LENGTH];
+    ULONG sum;
+    ULONG i;
+
+    sum = 0;
+    for (i = 0; i < iterations; i++) {
+        sum += (ULONG)GainInsightInto(input->codes[i & BENCH_MASK], NULL, buffer, sizeof(buffer));
+    }
+
+    return sum;
+}
+
+/*
+ * PeekInsight - lookup alone through the active engine
+ */
+static ULONG BenchPeekInsight(const struct BenchInput *input, ULONG engine, ULONG iterations)
+{
+    struct ErrorView view;
+    ULONG sum;
+    ULONG i;
+
+    sum = 0;
+    for (i = 0; i < iterations; i++) {
+        sum += (ULONG)PeekInsight(input->codes[i & BENCH_MASK], &view);
+    }
+
+    return sum;
+}
+
+/*
+ * LookupWithEngine - the engine search without the database layer
+ */
+static ULONG BenchLookupWithEngine(const struct BenchInput *input, ULONG engine, ULONG iterations)
+{
+    ULONG sum;
+    ULONG i;
+
+    sum = 0;
+    for (i = 0; i < iterations; i++) {
+        sum += (ULONG)LookupWithEngine(engine, input->codes[i & BENCH_MASK]);
+    }
+
+    return sum;
+}
+
+/*
+ * DecodeAlertInto - misses take the decomposition path
+ */
+static ULONG BenchDecodeAlertInto(const struct BenchInput *input, ULONG engine, ULONG iterations)
+{
+    char buffer[INSIGHT_MAX_LENGTH];
+    struct AlertDecoding decoding;
+    ULONG sum;
+    ULONG i;
+
+    sum = 0;
+    for (i = 0; i < iterations; i++) {
+        sum += DecodeAlertInto(input->codes[i & BENCH_MASK], &decoding, buffer, sizeof(buffer));
+    }
+
+    return sum;
+}
+
+/*
+ * ExpandExplanation - expansion into the static buffer
+ */
+static ULONG BenchExpandExplanation(const struct BenchInput *input, ULONG engine, ULONG iterations)
+{
+    ULONG sum;
+    ULONG i;
+
+    sum = 0;
+    for (i = 0; i < iterations; i++) {
+        sum += (ULONG)(UBYTE)ExpandExplanation((STRPTR)input->insights[i & BENCH_MASK])[0];
+    }
+
+    return sum;
+}
+
+/*
+ * ExpandExplanationInto - expansion into a caller buffer
+ */
+static ULONG BenchExpandExplanationInto(const struct BenchInput *input, ULONG engine, ULONG iterations)
+{
+    char buffer[INSIGHT_MAX_LENGTH];
+    ULONG sum;
+    ULONG i;
+
+    sum = 0;
+    for (i = 0; i < iterations; i++) {
+        sum += ExpandExplanationInto(input->insights[i & BENCH_MASK], buffer, sizeof(buffer));
+    }
+
+    return sum;
+}
+
+/*
+ * LookupToken - misses are past the end of the dictionary
+ */
+static ULONG BenchLookupToken(const struct BenchInput *input, ULONG engine, ULONG iterations)
+{
+    STRPTR token;
+    ULONG sum;
+    ULONG i;
+
+    sum = 0;
+    for (i = 0; i < iterations; i++) {
+        token = LookupToken(input->tokens[i & BENCH_MASK]);
+        if (token != NULL) {
+            sum += (ULONG)(UBYTE)token[0];
+        }
+    }
+
+    return sum;
+}
+
+/*
+ * HexStringToULong - the legacy converter
+ */
+static ULONG BenchHexStringToULong(const struct BenchInput *input, ULONG engine, ULONG iterations)
+{
+    ULONG sum;
+    ULONG i;
+
+    sum = 0;
+    for (i = 0; i < iterations; i++) {
+        sum += HexStringToULong(input->strings[i & BENCH_MASK]);
+    }
+
+    return sum;
+}
+
+/*
+ * LooksLikeHexNumber - the implicit ERROR argument test
+ */
+static ULONG BenchLooksLikeHexNumber(const struct BenchInput *input, ULONG engine, ULONG iterations)
+{
+    ULONG sum;
+    ULONG i;
+
+    sum = 0;
+    for (i = 0; i < iterations; i++) {
+        sum += (ULONG)LooksLikeHexNumber(input->strings[i & BENCH_MASK]);
+    }
+
+    return sum;
+}
+
+/*
+ * ParseHexCode - validation and conversion in one pass
+ */
+static ULONG BenchParseHexCode(const struct BenchInput *input, ULONG engine, ULONG iterations)
+{
+    ULONG value;
+    ULONG sum;
+    ULONG i;
+
+    sum = 0;
+    value = 0;
+    for (i = 0; i < iterations; i++) {
+        sum += (ULONG)ParseHexCode(input->strings[i & BENCH_MASK], &value);
+    }
+
+    return sum + value;
+}
+
+/*
+ * WrapTextInto - requester messages wrapped to a 640 pixel screen
+ */
+static ULONG BenchWrapTextInto(const struct BenchInput *input, ULONG engine, ULONG iterations)
+{
+    char buffer[BENCH_MESSAGE_SIZE];
+    ULONG sum;
+    ULONG i;
+
+    sum = 0;
+    for (i = 0; i < iterations; i++) {
+        sum += WrapTextInto(&benchMetrics, input->messages[i & BENCH_MESSAGE_MASK], BENCH_WRAP_WIDTH,
+                            buffer, sizeof(buffer));
+    }
+
+    return sum;
+}
+
+/*
+ * SearchInsights - a database entry's description as the query, top ten results
+ */
+static ULONG BenchSearchInsights(const struct BenchInput *input, ULONG engine, ULONG iterations)
+{
+    struct SearchHit hits[SEARCH_TOP_DEFAULT];
+    ULONG sum;
+    ULONG i;
+
+    sum = 0;
+    for (i = 0; i < iterations; i++) {
+        sum += SearchInsights(input->queries[i & BENCH_MASK], hits, SEARCH_TOP_DEFAULT, NULL);
+    }
+
+    return sum;
+}
+
+/*
+ * FindNearestCodes - the NEAR_TOP_DEFAULT closest codes over the whole database
+ */
+static ULONG BenchFindNearestCodes(const struct BenchInput *input, ULONG engine, ULONG iterations)
+{
+    struct NearMatch matches[NEAR_TOP_DEFAULT];
+    ULONG sum;
+    ULONG i;
+
+    sum = 0;
+    for (i = 0; i < iterations; i++) {
+        sum += FindNearestCodes(input->codes[i & BENCH_MASK], NEAR_MAX_DIGITS, matches, NEAR_TOP_DEFAULT);
+    }
+
+    return sum;
+}
+
+/*
+ * FindInsightNames - the first letters of a description, top ten names
+ */
+static ULONG BenchFindInsightNames(const struct BenchInput *input, ULONG engine, ULONG iterations)
+{
+    struct NameHit hits[NAME_TOP_DEFAULT];
+    ULONG sum;
+    ULONG i;
+
+    sum = 0;
+    for (i = 0; i < iterations; i++) {
+        sum += FindInsightNames(input->names[i & BENCH_MASK], hits, NAME_TOP_DEFAULT);
+    }
+
+    return sum;
+}
+
+/*
+ * Stand-in proportional font - 4 pixel spaces, 5 to 8 pixel glyphs
+ */
+static ULONG BenchGlyphWidth(UBYTE glyph, APTR font)
+{
+    return (glyph == ' ') ? 4 : 5 + (glyph & 3);
+}
@@ -0,0 +1,3138 @@
+/*
+ * Insight Checks
+ *
+ * Repeatable checks for the parts of Insight that are hard to see go
+ * wrong by hand.  Each check builds its own input from SEED, runs the
+ * code under test and compares the results with a plain, obviously
+ * correct pass over the same input.  A check prints one line of results
+ * and exits non-zero if anything differs.  ctest runs each of them.
+ *
+ * BATCH decodes one input on the work-stealing pool at several thread
+ * counts and in both formats and compares every byte of the records, and
+ * the stats and summary counts, with a single-threaded run.  Lines around
+ * a block long, blank blocks and a last line of several blocks with no
+ * newline check that the pool cuts long lines where DecodeBatch does.
+ *
+ * HISTORY appends to a crash history through a torn header, duplicates,
+ * a torn tail and damaged slots, checking each result and reading the
+ * whole file back after every step.
+ *
+ * QUERY answers random SINCE, UNTIL, CODE and DEADEND queries over a
+ * history of many index blocks, with and without its index, after
+ * appends and after the index or the history are replaced, and compares
+ * the matches with a plain filter over every record.
+ *
+ * SUMMARY counts a skewed stream with far more distinct codes than
+ * heavy hitter slots, in one summary and in eight merged ones, and
+ * checks every reported count against the exact counts: no count may
+ * be low or high by more than its error, no error may pass the
+ * Space-Saving bound, and no code above the bound may be missing.
+ *
+ * NEAREST checks the digit and bit distances against plain versions
+ * on pairs a few edits apart, then ranks codes near database codes
+ * with a digit changed, two neighbours swapped or worse, and compares
+ * each list with a sort of every entry.  DATABASE= runs it, like the
+ * others, against a database file instead of the compiled-in tables.
+ *
+ * RELOAD starts a daemon on a copy of the DATABASE= file and has four
+ * clients stream lookups while the copy is replaced by rename and
+ * overwritten in place, and reloaded by RELOAD lines and SIGHUP.  Every
+ * record must match what DecodeBatch writes, every reload must be
+ * answered, and the daemon must stop cleanly at the end.  A daemon on
+ * the compiled-in tables is started first and must count the same
+ * entries STATS counts for the file.
+ *
+ * SCAN writes a log of guru, software failure, recoverable and bare
+ * alerts with 0x, $, # or no prefix, task words and look-alikes, with
+ * codes across every chunk boundary, and checks that the scanner finds
+ * exactly the alerts written.
+ *
+ * HEX converts mixed-case fields cut from one long run of digits, and
+ * fields with every byte value at every digit, with ParseHexFields at
+ * every count up to a few vectors, and compares each status and value
+ * with a plain conversion.
+ *
+ * SEARCH runs random queries built from the database's own words, in
+ * any case and with stop words, unknown and overlong words, and compares
+ * the ranked results and totals with a plain filter over every entry.
+ *
+ * NAME cuts random queries from the descriptions, running on over
+ * words or past the end of a name, in any case, and compares the
+ * entries found with a plain filter that tries every word start.
+ *
+ * insight_checks_scalar runs the checks on a core built without its
+ * SSE2 and AVX2 paths.
+ *
+ * Usage: insight_checks <check> [SEED=<n>] [DATABASE=<file.idb>]
+ *
+ * After meditiation comes... Insight
+ *
+ * Copyright (c) 2025-26 amigazen project
+ * Licensed under BSD 2-Clause License
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <signal.h>
+#include <pthread.h>
+#include <sys/wait.h>
+#include "libinsight.h"
+#include "batch.h"
+#include "summary.h"
+#include "parallel.h"
+#include "history.h"
+#include "histquery.h"
+#include "decompose.h"
+#include "idb.h"
+#include "nearest.h"
+#include "daemon.h"
+#include "logscan.h"
+#include "search.h"
+#include "search_terms.h"
+#include "names.h"
+#include "hosttools.h"
+
+/* BATCH input - enough lines for dozens of chunks, with some about a block long or more */
+#define CHECK_BATCH_LINES    200000
+#define CHECK_BATCH_LONG     10         /* Long lines, dealt round the kinds WriteLongLine writes */
+#define CHECK_BATCH_KINDS    5
+#define CHECK_COMPARE_BLOCK  65536
+
+/* HISTORY records - the first are appended one by one, the rest step by step */
+#define CHECK_HISTORY_RECORDS 100
+#define CHECK_HISTORY_MAXIMUM (CHECK_HISTORY_RECORDS + 8)
+#define CHECK_HISTORY_START   1514764800UL     /* 1 January 2026 in seconds since 1978 */
+
+/* QUERY history - whole index blocks and a partial one, then appends */
+#define CHECK_QUERY_RECORDS   (20 * HISTORY_INDEX_BLOCK + 77)
+#define CHECK_QUERY_APPENDS   300
+#define CHECK_QUERY_MAXIMUM   (CHECK_QUERY_RECORDS + CHECK_QUERY_APPENDS)
+#define CHECK_QUERY_ROUNDS    200      /* Random queries in each state of the index */
+#define CHECK_QUERY_DAMAGED   100      /* One slot in this many is damaged */
+
+/* SUMMARY stream - two in five codes from a skewed set, the rest from anywhere */
+#define CHECK_SUMMARY_CODES   1000000
+#define CHECK_SUMMARY_HEAVY   200
+#define CHECK_SUMMARY_PARTS   8        /* Summaries merged, as eight threads would */
+
+/* NEAREST - pairs for the distances, then queries near database codes */
+#define CHECK_NEAREST_PAIRS   200000
+#define CHECK_NEAREST_QUERIES 3000
+#define CHECK_NEAREST_MATCHES 10
+
+/* RELOAD - clients streaming requests while the database file changes under the daemon */
+#define CHECK_RELOAD_CLIENTS  4
+#define CHECK_RELOAD_ROUNDS   20       /* Requests each client sends */
+#define CHECK_RELOAD_LINES    20000    /* Lines in each request */
+#define CHECK_RELOAD_PIECES   4        /* Writes an overwrite in place is split into */
+
+/* SCAN log - each line one alert or look-alike, codes starting at every byte of a chunk */
+#define CHECK_SCAN_LINES      60000
+#define CHECK_SCAN_LINE_MAX   128      /* Longest line the log is built from, with room to spare */
+#define CHECK_SCAN_CHUNK      16       /* Bytes the scanner takes per mask */
+
+/* The scanner the library was built with - a scalar build has the byte class table alone */
+#if defined(__SSE2__) && !defined(INSIGHT_NO_SIMD)
+#define CHECK_SCAN_PATH "SSE2"
+#else
+#define CHECK_SCAN_PATH "scalar"
+#endif
+
+/* HEX fields - random ones back to back in one long run of digits, and every byte at every digit */
+#define CHECK_HEX_RUN         4096
+#define CHECK_HEX_BAD         (256 * 8)
+#define CHECK_HEX_FIELDS      (CHECK_HEX_RUN + CHECK_HEX_BAD)
+#define CHECK_HEX_COUNTS      40       /* Every count up to this is converted from several starts */
+#define CHECK_HEX_STARTS      8
+#define CHECK_HEX_UNTOUCHED   0xEE     /* Status past the last field, which must be left alone */
+
+/* SEARCH queries, built from the words of random entries */
+#define CHECK_SEARCH_QUERIES  1000
+#define CHECK_SEARCH_WORDS    10       /* Most words in a query - more than SEARCH_MAX_TERMS */
+#define CHECK_SEARCH_TOP      20       /* Most results asked for, unless all of them */
+#define CHECK_QUERY_TEXT      512
+
+/* NAME queries, cut from random places in the descriptions */
+#define CHECK_NAME_QUERIES    3000
+#define CHECK_NAME_TOP        20
+
+/* How ParseHexFields converts in this build */
+#if defined(__AVX2__) && !defined(INSIGHT_NO_SIMD)
+#define CHECK_HEX_PATH "AVX2"
+#elif defined(__SSE2__) && !defined(INSIGHT_NO_SIMD)
+#define CHECK_HEX_PATH "SSE2"
+#else
+#define CHECK_HEX_PATH "scalar"
+#endif
+
+/* A check - returns TRUE if it passed */
+struct Check {
+    CONST_STRPTR name;
+    BOOL (*run)(VOID);
+};
+
+/* A use of a term by a SEARCH entry, counted as the index counts it */
+struct TermUse {
+    char term[SEARCH_TERM_SIZE];
+    ULONG entry;
+    ULONG frequency;
+};
+
+/* A scan being run - its hits must be the ones the log was written with, in order */
+struct ScanCheck {
+    CONST_STRPTR kind;
+    ULONG flags;
+    ULONG next;
+    BOOL same;
+};
+
+/* Forward declarations */
+static ULONG RandomCode(VOID);
+static BOOL CheckBatch(VOID);
+static VOID WriteBatchInput(FILE *input);
+static VOID WriteLongLine(FILE *input, ULONG kind);
+static BOOL SameFiles(FILE *a, FILE *b);
+static BOOL SameStats(const struct BatchStats *a, const struct BatchStats *b);
+static BOOL CheckHistory(VOID);
+static BOOL AppendExpected(CONST_STRPTR path, const struct CrashRecord *record, ULONG result, CONST_STRPTR step);
+static VOID MakeCrashRecord(struct CrashRecord *record, ULONG number);
+static BOOL WriteAt(CONST_STRPTR path, long offset, const UBYTE *data, ULONG length);
+static long FileSize(CONST_STRPTR path);
+static BOOL SameHistory(CONST_STRPTR path, CONST_STRPTR step);
+static BOOL MakeCheckPath(char *path, CONST_STRPTR name);
+static BOOL CheckQuery(VOID);
+static BOOL WriteQueryHistory(CONST_STRPTR path, ULONG firstTask);
+static BOOL ReadQueryHistory(CONST_STRPTR path);
+static VOID RandomQuery(struct HistoryQuery *query);
+static BOOL RunQueries(CONST_STRPTR path, CONST_STRPTR state);
+static BOOL RunQuery(CONST_STRPTR path, const struct HistoryQuery *query, CONST_STRPTR state,
+                     struct HistoryQueryStats *stats);
+static BOOL QueryMatches(const struct HistoryQuery *query, const struct CrashRecord *record);
+static BOOL CheckQueryMatch(const struct CrashRecord *record, APTR userData);
+static BOOL CheckQueryParsing(VOID);
+static BOOL CheckSummary(VOID);
+static BOOL CheckSummaryBounds(const struct AlertSummary *summary, const ULONG *sorted, CONST_STRPTR kind);
+static SUMMARYCOUNT ExactCount(const ULONG *sorted, ULONG code);
+static int CompareCodes(const void *a, const void *b);
+static BOOL CheckNearest(VOID);
+static BOOL CheckDistances(VOID);
+static BOOL CheckNearestQuery(ULONG code, ULONG original, ULONG maxDigits, ULONG maxMatches, struct NearMatch *all);
+static ULONG PerturbCode(ULONG code, ULONG edits);
+static ULONG PlainDigitDistance(ULONG a, ULONG b);
+static ULONG PlainBitDistance(ULONG a, ULONG b);
+static int CompareNearMatches(const void *a, const void *b);
+static ULONG EntryCount(VOID);
+static ULONG EntryCode(ULONG index);
+static BOOL CheckReload(VOID);
+static VOID WriteReloadInput(FILE *input);
+static BOOL ReadWholeFile(CONST_STRPTR path, UBYTE **data, ULONG *size);
+static BOOL ReplaceDatabaseFile(CONST_STRPTR path, CONST_STRPTR newPath, const UBYTE *image, ULONG size,
+                                BOOL inPlace);
+static BOOL StartCheckDaemon(CONST_STRPTR path, pid_t *daemon);
+static BOOL StopCheckDaemon(pid_t daemon);
+static VOID *RunReloadClient(VOID *arg);
+static VOID *RunReloader(VOID *arg);
+static BOOL CheckReloadReplies(FILE *replies, ULONG *loaded, ULONG *failed);
+static BOOL ReadDaemonStats(ULONG *entries, ULONG *reloads, ULONG *failedReloads);
+static BOOL CheckScan(VOID);
+static VOID WriteScanLine(ULONG offset);
+static VOID WriteScanTask(ULONG code, ULONG kind);
+static VOID WriteScanNoise(ULONG offset);
+static VOID AddScanText(CONST_STRPTR text);
+static VOID PadScanText(ULONG offset, CONST_STRPTR prefix);
+static VOID ExpectScanHit(ULONG code, ULONG kind, BOOL hasTask, ULONG task);
+static BOOL RunScan(FILE *log, ULONG flags, BOOL stream, CONST_STRPTR kind);
+static BOOL CheckScanHit(const struct AlertHit *hit, APTR userData);
+static VOID SkipScanBare(struct ScanCheck *check);
+static BOOL CheckHexFields(VOID);
+static VOID WriteHexField(char *field, ULONG code);
+static BOOL CompareHexFields(ULONG start, ULONG count, ULONG converted, const ULONG *values, const UBYTE *status);
+static BOOL PlainHexField(const char *field, ULONG *value);
+static BOOL CheckSearch(VOID);
+static BOOL CollectTermUses(VOID);
+static VOID AddTermUses(CONST_STRPTR text, ULONG entry, ULONG frequency);
+static VOID RandomSearchQuery(char *query);
+static VOID AddQueryWord(char *query, CONST_STRPTR word);
+static BOOL CheckSearchQuery(CONST_STRPTR query, ULONG maxHits, struct SearchHit *hits, struct SearchHit *plain);
+static LONG PlainSearch(CONST_STRPTR query, struct SearchHit *plain, struct SearchTotals *totals);
+static int CompareSearchHits(const void *a, const void *b);
+static BOOL CheckNames(VOID);
+static VOID RandomNameQuery(char *query);
+static BOOL CheckNameQuery(CONST_STRPTR query, ULONG maxHits, struct NameHit *hits, struct NameHit *plain);
+static ULONG PlainNames(CONST_STRPTR query, struct NameHit *plain);
+static BOOL PlainNameStart(CONST_STRPTR description, ULONG offset);
+static ULONG NameCharacterKind(char c);
+static BOOL PlainNameMatch(CONST_STRPTR description, ULONG offset, CONST_STRPTR query);
+static CONST_STRPTR EntryDescription(ULONG index);
+
+static const struct Check checks[] = {
+    { "BATCH", CheckBatch },
+    { "HISTORY", CheckHistory },
+    { "QUERY", CheckQuery },
+    { "SUMMARY", CheckSummary },
+    { "NEAREST", CheckNearest },
+    { "RELOAD", CheckReload },
+    { "SCAN", CheckScan },
+    { "HEX", CheckHexFields },
+    { "SEARCH", CheckSearch },
+    { "NAME", CheckNames }
+};
+
+#define CHECK_COUNT (sizeof(checks) / sizeof(checks[0]))
+
+/* DATABASE= file, NULL for the compiled-in tables */
+static CONST_STRPTR databaseFile;
+
+/* What a HISTORY read should give, oldest first */
+static struct CrashRecord historyExpected[CHECK_HISTORY_MAXIMUM];
+static ULONG historyCount;
+static ULONG historyDamaged;
+
+/* Every intact record of the QUERY history, oldest first */
+static struct CrashRecord *queryRecords;
+static ULONG queryCount;
+
+/* First and last times of each index block as written, where the index summaries must be exact */
+static ULONG queryEdges[2 * (CHECK_QUERY_RECORDS / HISTORY_INDEX_BLOCK + 1)];
+static ULONG queryEdgeCount;
+
+/* A RELOAD client - its records are compared once every client has finished */
+struct ReloadClient {
+    pthread_t thread;
+    FILE *input;
+    FILE *expected;
+    FILE *output;
+    ULONG invalid;          /* Lines the daemon said were not codes, over every request */
+    ULONG error;            /* DAEMON_OK or the first request's failure */
+};
+
+/* The RELOAD reloader - sends RELOAD lines until the clients are done */
+struct Reloader {
+    pthread_t thread;
+    FILE *replies;
+    ULONG requests;
+    ULONG error;
+};
+
+/* RELOAD daemon socket and database copy */
+static char reloadSocket[64];
+static char reloadDatabase[64];
+static ULONG reloadClientsDone;     /* Clients finished - atomic */
+
+/* SCAN log as written, and every alert in it in the order it appears */
+static char *scanText;
+static ULONG scanLength;
+static ULONG scanLine;
+static struct AlertHit *scanHits;
+static ULONG scanHitCount;
+
+/* HEX fields in the order they are converted, and what a plain conversion makes of each */
+static const char *hexFields[CHECK_HEX_FIELDS];
+static ULONG hexValues[CHECK_HEX_FIELDS];
+static BOOL hexValid[CHECK_HEX_FIELDS];
+
+/* Every term use of every SEARCH entry, in entry order */
+static struct TermUse *termUses;
+static ULONG termUseCount;
+static ULONG termUseCapacity;
+
+/* A query being answered - its matches must be the records listed, in order */
+struct QueryCheck {
+    const ULONG *wanted;
+    ULONG count;
+    ULONG next;
+    BOOL same;
+};
+
+int main(int argc, char *argv[])
+{
+    const struct Check *check;
+    struct InsightDatabase *database;
+    const char *value;
+    ULONG error;
+    ULONG i;
+    int arg;
+    BOOL known;
+
+    check = NULL;
+    databaseFile = NULL;
+    SeedRandom(1);
+    known = TRUE;
+    for (arg = 1; arg < argc && known; arg++) {
+        if (MatchKeyword(argv[arg], "SEED", &value) && value != NULL) {
+            SeedRandom((ULONG)strtoul(value, NULL, 10));
+            continue;
+        }
+        if (MatchKeyword(argv[arg], "DATABASE", &value) && value != NULL) {
+            databaseFile = value;
+            continue;
+        }
+        known = FALSE;
+        for (i = 0; i < CHECK_COUNT; i++) {
+            if (check == NULL && MatchKeyword(argv[arg], checks[i].name, &value) && value == NULL) {
+                check = &checks[i];
+                known = TRUE;
+            }
+        }
+    }
+
+    if (check == NULL || !known) {
+        fprintf(stderr, "Usage: insight_checks <check> [SEED=<n>] [DATABASE=<file.idb>]\n");
+        fprintf(stderr, "Checks:");
+        for (i = 0; i < CHECK_COUNT; i++) {
+            fprintf(stderr, " %s", checks[i].name);
+        }
+        fprintf(stderr, "\n");
+        return EXIT_FAILURE;
+    }
+
+    /* Checks of the database search run against a loaded file as well as the compiled-in tables */
+    database = NULL;
+    if (databaseFile != NULL) {
+        database = OpenInsightDatabase(databaseFile, 0, &error);
+        if (database == NULL) {
+            fprintf(stderr, "Error: Cannot load database %s: %s\n", databaseFile, IdbErrorText(error));
+            return EXIT_FAILURE;
+        }
+        UseInsightDatabase(database);
+    }
+
+    error = check->run() ? EXIT_SUCCESS : EXIT_FAILURE;
+    CloseInsightDatabase(database);
+
+    return (int)error;
+}
+
+/*
+ * A database code three times in four, otherwise any code
+ */
+static ULONG RandomCode(VOID)
+{
+    if ((NextRandom() & 3) != 0) {
+        return EntryCode(NextRandom() % EntryCount());
+    }
+
+    return NextRandom();
+}
+
+/*
+ * BATCH - the pool must write what DecodeBatch writes, in the same order
+ * Three and eight threads leave some workers stealing while others
+ * still hold chunks; both formats are compared, and so are the stats
+ * and the exact counts of a summary.
+ */
+static BOOL CheckBatch(VOID)
+{
+    static const ULONG threadCounts[] = { 2, 3, 8 };
+    struct AlertSummary *expectedSummary;
+    struct AlertSummary *summary;
+    struct BatchStats expectedStats;
+    struct BatchStats stats;
+    FILE *input;
+    FILE *expected;
+    FILE *output;
+    ULONG format;
+    ULONG runs;
+    ULONG failures;
+    ULONG i;
+
+    input = tmpfile();
+    expected = tmpfile();
+    output = tmpfile();
+    expectedSummary = AllocAlertSummary();
+    summary = AllocAlertSummary();
+    if (input == NULL || expected == NULL || output == NULL || expectedSummary == NULL || summary == NULL) {
+        fprintf(stderr, "Error: Cannot set up the batch check\n");
+        return FALSE;
+    }
+    WriteBatchInput(input);
+
+    runs = 0;
+    failures = 0;
+    for (format = 0; format < BATCH_FORMATS; format++) {
+        rewind(input);
+        rewind(expected);
+        if (!DecodeBatch(input, expected, format, &expectedStats) || fflush(expected) != 0) {
+            fprintf(stderr, "Error: Cannot decode the batch check input\n");
+            return FALSE;
+        }
+        for (i = 0; i < sizeof(threadCounts) / sizeof(threadCounts[0]); i++) {
+            rewind(input);
+            rewind(output);
+            runs++;
+            if (!ParallelDecodeBatch(input, output, format, threadCounts[i], &stats) || fflush(output) != 0 ||
+                !SameFiles(expected, output) || !SameStats(&expectedStats, &stats)) {
+                fprintf(stderr, "FAIL: %lu threads, format %lu: records or stats differ\n",
+                        (unsigned long)threadCounts[i], (unsigned long)format);
+                failures++;
+            }
+        }
+    }
+
+    /* Heavy hitters depend on how chunks fell once slots run out, but the counts are exact */
+    rewind(input);
+    SummarizeBatch(input, expectedSummary, &expectedStats);
+    rewind(input);
+    runs++;
+    if (!ParallelSummarizeBatch(input, 8, summary, &stats) || !SameStats(&expectedStats, &stats) ||
+        summary->codes != expectedSummary->codes || summary->invalid != expectedSummary->invalid ||
+        memcmp(summary->subsystems, expectedSummary->subsystems, sizeof(summary->subsystems)) != 0) {
+        fprintf(stderr, "FAIL: 8 threads: summary counts differ\n");
+        failures++;
+    }
+
+    printf("batch: %lu lines, %lu runs, %lu failures\n", (unsigned long)expectedStats.lines,
+           (unsigned long)runs, (unsigned long)failures);
+
+    FreeAlertSummary(summary);
+    FreeAlertSummary(expectedSummary);
+    fclose(output);
+    fclose(expected);
+    fclose(input);
+
+    return (BOOL)(failures == 0);
+}
+
+/*
+ * Write the BATCH input - codes in several spellings, invalid and blank lines
+ * The last line is several blocks long and has no newline.
+ */
+static VOID WriteBatchInput(FILE *input)
+{
+    ULONG longLine;
+    ULONG i;
+
+    longLine = 0;
+    for (i = 0; i < CHECK_BATCH_LINES; i++) {
+        if (longLine < CHECK_BATCH_LONG && i == (longLine + 1) * (CHECK_BATCH_LINES / (CHECK_BATCH_LONG + 1))) {
+            WriteLongLine(input, longLine % CHECK_BATCH_KINDS);
+            fputc('\n', input);
+            longLine++;
+            continue;
+        }
+        switch (NextRandom() % 8) {
+        case 0:
+            fprintf(input, "0x%08lX\n", (unsigned long)RandomCode());
+            break;
+        case 1:
+            fprintf(input, "  %08lx\r\n", (unsigned long)RandomCode());
+            break;
+        case 2:
+            fprintf(input, "not a code %lu\n", (unsigned long)i);
+            break;
+        case 3:
+            fprintf(input, "\n");
+            break;
+        default:
+            fprintf(input, "%08lX\n", (unsigned long)RandomCode());
+            break;
+        }
+    }
+    WriteLongLine(input, 0);
+    fflush(input);
+}
+
+/*
+ * Write one long BATCH line, without its newline
+ * 0 runs over several blocks, 1 and 2 end a byte before and at a block,
+ * 3 is a code padded to a block with blanks, which makes it invalid, and
+ * 4 is a code after two blocks of blanks, which are dropped.
+ */
+static VOID WriteLongLine(FILE *input, ULONG kind)
+{
+    ULONG j;
+
+    switch (kind) {
+    case 0:
+    case 1:
+    case 2:
+        for (j = 0; j < ((kind == 0) ? 3 * BATCH_BUFFER_SIZE : BATCH_BUFFER_SIZE + kind - 2); j++) {
+            fputc('0' + (int)(j % 10), input);
+        }
+        break;
+    case 3:
+        fprintf(input, "%08lX", (unsigned long)RandomCode());
+        for (j = 8; j < BATCH_BUFFER_SIZE; j++) {
+            fputc(' ', input);
+        }
+        break;
+    default:
+        for (j = 0; j < 2 * BATCH_BUFFER_SIZE; j++) {
+            fputc((j & 1) ? '\t' : ' ', input);
+        }
+        fprintf(input, "  %08lX", (unsigned long)RandomCode());
+        break;
+    }
+}
+
+/*
+ * Compare two files from the start
+ */
+static BOOL SameFiles(FILE *a, FILE *b)
+{
+    static char blockA[CHECK_COMPARE_BLOCK];
+    static char blockB[CHECK_COMPARE_BLOCK];
+    size_t gotA;
+    size_t gotB;
+
+    rewind(a);
+    rewind(b);
+    do {
+        gotA = fread(blockA, 1, sizeof(blockA), a);
+        gotB = fread(blockB, 1, sizeof(blockB), b);
+        if (gotA != gotB || memcmp(blockA, blockB, gotA) != 0) {
+            return FALSE;
+        }
+    } while (gotA > 0);
+
+    return TRUE;
+}
+
+/*
+ * Compare two sets of batch stats
+ */
+static BOOL SameStats(const struct BatchStats *a, const struct BatchStats *b)
+{
+    return (BOOL)(a->lines == b->lines && a->exact == b->exact && a->decoded == b->decoded &&
+                  a->invalid == b->invalid);
+}
+
+/*
+ * HISTORY - appends must survive resets and skip repeats of the same alert
+ * Every append is checked for the result it should give, and after each
+ * step the file is read back and must hold exactly the intact records
+ * expected, with the damaged slots counted.
+ */
+static BOOL CheckHistory(VOID)
+{
+    struct CrashRecord record;
+    UBYTE data[HISTORY_RECORD_SIZE];
+    char path[64];
+    char otherPath[64];
+    long size;
+    ULONG i;
+    BOOL passed;
+
+    if (!MakeCheckPath(path, "history") || !MakeCheckPath(otherPath, "other")) {
+        fprintf(stderr, "Error: Cannot create the history check files\n");
+        return FALSE;
+    }
+    historyCount = 0;
+    historyDamaged = 0;
+
+    /* A reset while the file was being created leaves part of the header */
+    EncodeCrashHeader(data);
+    passed = WriteAt(path, 0, data, HISTORY_HEADER_SIZE / 3);
+    for (i = 0; i < CHECK_HISTORY_RECORDS && passed; i++) {
+        MakeCrashRecord(&record, i);
+        passed = AppendExpected(path, &record, HISTORY_OK, "append");
+    }
+    passed = passed && SameHistory(path, "append");
+
+    /* The same LastAlert again, even at another time and with another name, is skipped */
+    if (passed) {
+        record = historyExpected[historyCount - 1];
+        record.timestamp += 3600;
+        SetCrashTaskName(&record, "Other Task");
+        passed = AppendExpected(path, &record, HISTORY_DUPLICATE, "duplicate") && SameHistory(path, "duplicate");
+    }
+
+    /* A record torn by a reset is ignored, then overwritten by the next append */
+    if (passed) {
+        MakeCrashRecord(&record, historyCount);
+        EncodeCrashRecord(&record, data);
+        size = FileSize(path);
+        passed = WriteAt(path, size, data, HISTORY_RECORD_SIZE / 2) && SameHistory(path, "torn tail");
+        MakeCrashRecord(&record, historyCount);
+        passed = passed && AppendExpected(path, &record, HISTORY_OK, "torn tail");
+        if (passed && FileSize(path) != size + HISTORY_RECORD_SIZE) {
+            fprintf(stderr, "FAIL: torn tail: the append did not overwrite the torn record\n");
+            passed = FALSE;
+        }
+        passed = passed && SameHistory(path, "torn tail");
+    }
+
+    /* A damaged last record is looked past for the duplicate check */
+    if (passed) {
+        size = FileSize(path);
+        data[0] = 0xFF;
+        passed = WriteAt(path, size - HISTORY_RECORD_SIZE + HISTORY_FIELD_TIMESTAMP * 4, data, 1);
+        historyCount--;
+        historyDamaged++;
+        record = historyExpected[historyCount - 1];
+        passed = passed && SameHistory(path, "damaged") &&
+                 AppendExpected(path, &record, HISTORY_DUPLICATE, "damaged") && SameHistory(path, "damaged");
+    }
+
+    /* But only HISTORY_DEDUP_SCAN slots back, so appends stay constant time */
+    if (passed) {
+        memset(data, 0xA5, sizeof(data));
+        for (i = 0; i < HISTORY_DEDUP_SCAN && passed; i++) {
+            passed = WriteAt(path, FileSize(path), data, HISTORY_RECORD_SIZE);
+            historyDamaged++;
+        }
+        record = historyExpected[historyCount - 1];
+        passed = passed && AppendExpected(path, &record, HISTORY_OK, "dedup window") &&
+                 SameHistory(path, "dedup window");
+    }
+
+    /* Anything but a history file, or part of a header, is never written to */
+    if (passed) {
+        memset(data, 'x', sizeof(data));
+        passed = WriteAt(otherPath, 0, data, HISTORY_HEADER_SIZE / 2);
+        MakeCrashRecord(&record, historyCount);
+        if (passed && (AppendCrashRecord(otherPath, &record) != HISTORY_ERROR_FORMAT ||
+                       FileSize(otherPath) != HISTORY_HEADER_SIZE / 2)) {
+            fprintf(stderr, "FAIL: other file: appended to a file that is not a history\n");
+            passed = FALSE;
+        }
+    }
+
+    printf("history: %lu records, %lu damaged slots, %s\n", (unsigned long)historyCount,
+           (unsigned long)historyDamaged, passed ? "passed" : "failed");
+
+    remove(path);
+    remove(otherPath);
+
+    return passed;
+}
+
+/*
+ * Append a record and check the result, keeping it as expected if it was written
+ */
+static BOOL AppendExpected(CONST_STRPTR path, const struct CrashRecord *record, ULONG result, CONST_STRPTR step)
+{
+    ULONG got;
+
+    got = AppendCrashRecord(path, record);
+    if (got != result) {
+        fprintf(stderr, "FAIL: %s: append gave %lu (%s), not %lu\n", step, (unsigned long)got,
+                HistoryErrorText(got), (unsigned long)result);
+        return FALSE;
+    }
+    if (result == HISTORY_OK) {
+        historyExpected[historyCount++] = *record;
+    }
+
+    return TRUE;
+}
+
+/*
+ * Make a record - each number has its own task, so no two are the same alert
+ */
+static VOID MakeCrashRecord(struct CrashRecord *record, ULONG number)
+{
+    memset(record, 0, sizeof(struct CrashRecord));
+    record->timestamp = CHECK_HISTORY_START + number * 60;
+    record->code = RandomCode();
+    record->taskID = 0x00C00000UL + number * 4;
+    record->lastAlert[0] = record->code;
+    record->lastAlert[1] = record->taskID;
+    SetCrashTaskName(record, (number & 1) ? "Shell Process" : NULL);
+}
+
+/*
+ * Write bytes into a file at an offset, creating it if needed
+ */
+static BOOL WriteAt(CONST_STRPTR path, long offset, const UBYTE *data, ULONG length)
+{
+    FILE *file;
+    BOOL written;
+
+    file = fopen(path, "r+b");
+    if (file == NULL) {
+        file = fopen(path, "w+b");
+    }
+    if (file == NULL) {
+        return FALSE;
+    }
+
+    written = (BOOL)(fseek(file, offset, SEEK_SET) == 0 && fwrite(data, 1, length, file) == length);
+    if (fclose(file) != 0) {
+        written = FALSE;
+    }
+
+    return written;
+}
+
+/*
+ * Size of a file in bytes, -1 if it cannot be read
+ */
+static long FileSize(CONST_STRPTR path)
+{
+    FILE *file;
+    long size;
+
+    file = fopen(path, "rb");
+    if (file == NULL) {
+        return -1;
+    }
+    size = (fseek(file, 0, SEEK_END) == 0) ? ftell(file) : -1;
+    fclose(file);
+
+    return size;
+}
+
+/*
+ * Read a history back and compare it with the records expected
+ */
+static BOOL SameHistory(CONST_STRPTR path, CONST_STRPTR step)
+{
+    struct CrashHistory *history;
+    struct CrashRecord record;
+    UBYTE got[HISTORY_RECORD_SIZE];
+    UBYTE wanted[HISTORY_RECORD_SIZE];
+    ULONG error;
+    ULONG count;
+    BOOL same;
+
+    history = OpenCrashHistory(path, &error);
+    if (history == NULL) {
+        fprintf(stderr, "FAIL: %s: cannot read the history: %s\n", step, HistoryErrorText(error));
+        return FALSE;
+    }
+
+    same = TRUE;
+    count = 0;
+    while (same && NextCrashRecord(history, &record)) {
+        EncodeCrashRecord(&record, got);
+        if (count < historyCount) {
+            EncodeCrashRecord(&historyExpected[count], wanted);
+        }
+        same = (BOOL)(count < historyCount && memcmp(got, wanted, sizeof(got)) == 0);
+        count++;
+    }
+    if (!same || count != historyCount || CrashHistoryDamaged(history) != historyDamaged) {
+        fprintf(stderr, "FAIL: %s: read back %lu records and %lu damaged slots, not %lu and %lu\n", step,
+                (unsigned long)count, (unsigned long)CrashHistoryDamaged(history), (unsigned long)historyCount,
+                (unsigned long)historyDamaged);
+        same = FALSE;
+    }
+    CloseCrashHistory(history);
+
+    return same;
+}
+
+/*
+ * Make a new, empty file name for a check in the current directory
+ */
+static BOOL MakeCheckPath(char *path, CONST_STRPTR name)
+{
+    int file;
+
+    sprintf(path, "insight-check-%s-XXXXXX", name);
+    file = mkstemp(path);
+    if (file < 0) {
+        return FALSE;
+    }
+    close(file);
+    remove(path);
+
+    return TRUE;
+}
+
+/*
+ * QUERY - indexed queries must match exactly what a plain filter finds
+ * The queries run first with no index, which builds it, then with it,
+ * then after appends extend the history, after the index is damaged and
+ * after the history is replaced by one the index does not describe.
+ */
+static BOOL CheckQuery(VOID)
+{
+    struct HistoryQuery query;
+    struct HistoryQueryStats stats;
+    struct CrashRecord record;
+    char path[64];
+    char indexPath[64 + sizeof(HISTORY_INDEX_SUFFIX)];
+    UBYTE flip;
+    ULONG i;
+    BOOL passed;
+
+    queryRecords = (struct CrashRecord *)malloc(CHECK_QUERY_MAXIMUM * sizeof(struct CrashRecord));
+    if (queryRecords == NULL || !MakeCheckPath(path, "query") || !WriteQueryHistory(path, 0)) {
+        fprintf(stderr, "Error: Cannot create the query check history\n");
+        return FALSE;
+    }
+    sprintf(indexPath, "%s%s", path, HISTORY_INDEX_SUFFIX);
+
+    passed = CheckQueryParsing() && ReadQueryHistory(path) && RunQueries(path, "no index") &&
+             RunQueries(path, "index");
+
+    /* A window inside one block reads at most the blocks it touches */
+    if (passed) {
+        InitHistoryQuery(&query);
+        query.since = queryRecords[5 * HISTORY_INDEX_BLOCK].timestamp;
+        query.until = queryRecords[5 * HISTORY_INDEX_BLOCK + 10].timestamp;
+        passed = RunQuery(path, &query, "window", &stats);
+        if (passed && stats.blocksRead > 2) {
+            fprintf(stderr, "FAIL: window: read %lu blocks for a window inside one\n",
+                    (unsigned long)stats.blocksRead);
+            passed = FALSE;
+        }
+    }
+
+    /* Appends fill the partial block and start another, which later queries index */
+    for (i = 0; i < CHECK_QUERY_APPENDS && passed; i++) {
+        MakeCrashRecord(&record, CHECK_QUERY_MAXIMUM + i);
+        record.timestamp = queryRecords[queryCount - 1].timestamp + 1 + NextRandom() % 600;
+        if (AppendCrashRecord(path, &record) != HISTORY_OK) {
+            fprintf(stderr, "FAIL: appends: cannot append to the history\n");
+            passed = FALSE;
+        }
+        queryRecords[queryCount++] = record;
+    }
+    passed = passed && RunQueries(path, "appended") && RunQueries(path, "appended index");
+
+    /* A damaged index is rebuilt, never trusted */
+    if (passed) {
+        flip = (UBYTE)0x5A;
+        passed = WriteAt(indexPath, HISTORY_INDEX_HEADER_SIZE + 4, &flip, 1) && RunQueries(path, "damaged index");
+    }
+
+    /* So is an index left over from another history */
+    passed = passed && WriteQueryHistory(path, 0x100) && ReadQueryHistory(path) &&
+             RunQueries(path, "replaced history") && RunQueries(path, "replaced index");
+
+    printf("query: %lu records, %lu queries, %s\n", (unsigned long)queryCount,
+           (unsigned long)(7 * CHECK_QUERY_ROUNDS + 1), passed ? "passed" : "failed");
+
+    remove(path);
+    remove(indexPath);
+    free(queryRecords);
+
+    return passed;
+}
+
+/*
+ * Write the QUERY history in one go
+ * Each block draws its codes from a few top bytes, as a machine's crashes
+ * tend to, with the odd one from anywhere, so the index can skip blocks.
+ * Times climb by up to ten minutes and sometimes stand still.
+ */
+static BOOL WriteQueryHistory(CONST_STRPTR path, ULONG firstTask)
+{
+    struct CrashRecord record;
+    UBYTE *data;
+    ULONG tops[3];
+    ULONG time;
+    ULONG i;
+    BOOL written;
+
+    data = (UBYTE *)malloc(HISTORY_HEADER_SIZE + CHECK_QUERY_RECORDS * HISTORY_RECORD_SIZE);
+    if (data == NULL) {
+        return FALSE;
+    }
+
+    EncodeCrashHeader(data);
+    time = CHECK_HISTORY_START;
+    queryEdgeCount = 0;
+    for (i = 0; i < CHECK_QUERY_RECORDS; i++) {
+        if (i % HISTORY_INDEX_BLOCK == 0) {
+            tops[0] = NextRandom() >> 24;
+            tops[1] = NextRandom() >> 24;
+            tops[2] = tops[0] ^ (ALERT_DEADEND >> 24);
+        }
+        MakeCrashRecord(&record, firstTask + i);
+        if (NextRandom() % 50 != 0) {
+            record.code = (record.code & 0x00FFFFFFUL) | (tops[NextRandom() % 3] << 24);
+            record.lastAlert[0] = record.code;
+        }
+        time += (NextRandom() % 4 == 0) ? 0 : NextRandom() % 600;
+        record.timestamp = time;
+        if (i % HISTORY_INDEX_BLOCK == 0 || i % HISTORY_INDEX_BLOCK == HISTORY_INDEX_BLOCK - 1) {
+            queryEdges[queryEdgeCount++] = time;
+        }
+        EncodeCrashRecord(&record, data + HISTORY_HEADER_SIZE + i * HISTORY_RECORD_SIZE);
+        if (NextRandom() % CHECK_QUERY_DAMAGED == 0) {
+            data[HISTORY_HEADER_SIZE + i * HISTORY_RECORD_SIZE + HISTORY_FIELD_CODE * 4] ^= 0xFF;
+        }
+    }
+
+    remove(path);
+    written = WriteAt(path, 0, data, HISTORY_HEADER_SIZE + CHECK_QUERY_RECORDS * HISTORY_RECORD_SIZE);
+    free(data);
+
+    return written;
+}
+
+/*
+ * Read every intact record of the QUERY history, without the index
+ */
+static BOOL ReadQueryHistory(CONST_STRPTR path)
+{
+    struct CrashHistory *history;
+    ULONG error;
+
+    history = OpenCrashHistory(path, &error);
+    if (history == NULL) {
+        fprintf(stderr, "Error: Cannot read the query check history: %s\n", HistoryErrorText(error));
+        return FALSE;
+    }
+
+    queryCount = 0;
+    while (queryCount < CHECK_QUERY_MAXIMUM && NextCrashRecord(history, &queryRecords[queryCount])) {
+        queryCount++;
+    }
+    CloseCrashHistory(history);
+
+    return TRUE;
+}
+
+/*
+ * Make a random query
+ * Times often fall on record times or end exactly at the edge of an index
+ * block, to test the bounds are inclusive; codes come from patterns of a
+ * record's code with some digits left as any, narrowed to deadend alerts
+ * now and then.
+ */
+static VOID RandomQuery(struct HistoryQuery *query)
+{
+    ULONG first;
+    ULONG last;
+    ULONG edge;
+    ULONG code;
+    ULONG mask;
+    ULONG digits;
+    ULONG i;
+
+    InitHistoryQuery(query);
+    first = queryRecords[0].timestamp;
+    last = queryRecords[queryCount - 1].timestamp;
+
+    switch (NextRandom() % 4) {
+    case 0:
+        query->since = queryRecords[NextRandom() % queryCount].timestamp;
+        query->until = query->since + NextRandom() % (24 * 3600);
+        break;
+    case 1:
+        query->since = first + NextRandom() % (last - first + 1);
+        query->until = query->since + NextRandom() % (last - first + 1);
+        break;
+    case 2:
+        edge = queryEdges[NextRandom() % queryEdgeCount];
+        if (NextRandom() & 1) {
+            query->until = edge;
+            query->since = edge - NextRandom() % (edge - first + 1);
+        } else {
+            query->since = edge;
+            query->until = edge + NextRandom() % (24 * 3600);
+        }
+        break;
+    default:
+        if (NextRandom() & 1) {
+            query->until = first + NextRandom() % (last - first + 1);
+        }
+        break;
+    }
+
+    if (NextRandom() % 4 != 0) {
+        code = queryRecords[NextRandom() % queryCount].code;
+        digits = 1 + NextRandom() % 8;
+        mask = 0;
+        for (i = 0; i < digits; i++) {
+            if (i == 0 || NextRandom() % 4 != 0) {
+                mask |= 0xF0000000UL >> (i * 4);
+            }
+        }
+        RestrictHistoryCodes(query, code & mask, mask);
+    }
+    if (NextRandom() % 5 == 0) {
+        RestrictHistoryCodes(query, ALERT_DEADEND, ALERT_DEADEND);
+    }
+}
+
+/*
+ * Run CHECK_QUERY_ROUNDS random queries
+ */
+static BOOL RunQueries(CONST_STRPTR path, CONST_STRPTR state)
+{
+    struct HistoryQuery query;
+    struct HistoryQueryStats stats;
+    ULONG i;
+
+    for (i = 0; i < CHECK_QUERY_ROUNDS; i++) {
+        RandomQuery(&query);
+        if (!RunQuery(path, &query, state, &stats)) {
+            return FALSE;
+        }
+    }
+
+    return TRUE;
+}
+
+/*
+ * Run one query and compare its matches with a plain filter over every record
+ */
+static BOOL RunQuery(CONST_STRPTR path, const struct HistoryQuery *query, CONST_STRPTR state,
+                     struct HistoryQueryStats *stats)
+{
+    struct QueryCheck check;
+    ULONG *wanted;
+    ULONG error;
+    ULONG i;
+
+    wanted = (ULONG *)malloc((queryCount + 1) * sizeof(ULONG));
+    if (wanted == NULL) {
+        fprintf(stderr, "Error: Out of memory\n");
+        return FALSE;
+    }
+
+    check.wanted = wanted;
+    check.count = 0;
+    check.next = 0;
+    check.same = TRUE;
+    for (i = 0; i < queryCount; i++) {
+        if (QueryMatches(query, &queryRecords[i])) {
+            wanted[check.count++] = i;
+        }
+    }
+
+    error = QueryCrashHistory(path, query, CheckQueryMatch, &check, stats);
+    free(wanted);
+
+    if (error != HISTORY_OK || !check.same || check.next != check.count || stats->matches != check.count) {
+        fprintf(stderr, "FAIL: %s: SINCE %lu UNTIL %lu CODE %08lX/%08lX gave %lu matches, not %lu (%s)\n", state,
+                (unsigned long)query->since, (unsigned long)query->until, (unsigned long)query->codeValue,
+                (unsigned long)query->codeMask, (unsigned long)stats->matches, (unsigned long)check.count,
+                (error != HISTORY_OK) ? HistoryErrorText(error) : (check.same ? "count" : "records differ"));
+        return FALSE;
+    }
+
+    return TRUE;
+}
+
+/*
+ * The plain filter - what QueryCrashHistory should match
+ */
+static BOOL QueryMatches(const struct HistoryQuery *query, const struct CrashRecord *record)
+{
+    return (BOOL)(record->timestamp >= query->since && record->timestamp <= query->until &&
+                  (record->code & query->codeMask) == query->codeValue);
+}
+
+/*
+ * Report function - each match must be the next record wanted
+ */
+static BOOL CheckQueryMatch(const struct CrashRecord *record, APTR userData)
+{
+    struct QueryCheck *check = (struct QueryCheck *)userData;
+    UBYTE got[HISTORY_RECORD_SIZE];
+    UBYTE wanted[HISTORY_RECORD_SIZE];
+
+    if (check->next >= check->count) {
+        check->same = FALSE;
+        return TRUE;
+    }
+
+    EncodeCrashRecord(record, got);
+    EncodeCrashRecord(&queryRecords[check->wanted[check->next]], wanted);
+    if (memcmp(got, wanted, sizeof(got)) != 0) {
+        check->same = FALSE;
+    }
+    check->next++;
+
+    return TRUE;
+}
+
+/*
+ * SINCE, UNTIL and CODE text must read as the bounds they name
+ */
+static BOOL CheckQueryParsing(VOID)
+{
+    ULONG time;
+    ULONG value;
+    ULONG mask;
+    BOOL passed;
+
+    passed = ParseHistoryTime("2026-01-01", 0, FALSE, &time) && time == CHECK_HISTORY_START &&
+             ParseHistoryTime("2026-01-01", 0, TRUE, &time) && time == CHECK_HISTORY_START + 86399 &&
+             ParseHistoryTime("2026-01-01T12:30", 0, FALSE, &time) && time == CHECK_HISTORY_START + 45000 &&
+             ParseHistoryTime("-2h", CHECK_HISTORY_START, FALSE, &time) && time == CHECK_HISTORY_START - 7200 &&
+             !ParseHistoryTime("2026-13-01", 0, FALSE, &time) &&
+             ParseHistoryCodePattern("81", &value, &mask) && value == 0x81000000UL && mask == 0xFF000000UL &&
+             ParseHistoryCodePattern("0x8x00000B", &value, &mask) && value == 0x8000000BUL &&
+             mask == 0xF0FFFFFFUL && !ParseHistoryCodePattern("81g", &value, &mask);
+    if (!passed) {
+        fprintf(stderr, "FAIL: parsing: a SINCE, UNTIL or CODE text was read wrongly\n");
+    }
+
+    return passed;
+}
+
+/*
+ * SUMMARY - heavy hitter counts must stay within the Space-Saving bounds
+ * The stream is counted into one summary, and in eighths into summaries
+ * that are merged, as ParallelSummarizeBatch does.  The subsystem counts
+ * must be exact either way.
+ */
+static BOOL CheckSummary(VOID)
+{
+    struct AlertSummary *summary;
+    struct AlertSummary *parts[CHECK_SUMMARY_PARTS];
+    ULONG heavy[CHECK_SUMMARY_HEAVY];
+    ULONG *stream;
+    ULONG *sorted;
+    ULONG pick;
+    ULONG total;
+    ULONG i;
+    BOOL passed;
+
+    stream = (ULONG *)malloc(CHECK_SUMMARY_CODES * sizeof(ULONG));
+    sorted = (ULONG *)malloc(CHECK_SUMMARY_CODES * sizeof(ULONG));
+    summary = AllocAlertSummary();
+    passed = (BOOL)(stream != NULL && sorted != NULL && summary != NULL);
+    for (i = 0; i < CHECK_SUMMARY_PARTS; i++) {
+        parts[i] = AllocAlertSummary();
+        passed = passed && parts[i] != NULL;
+    }
+    if (!passed) {
+        fprintf(stderr, "Error: Out of memory\n");
+        return FALSE;
+    }
+
+    /* Code k of the skewed set is drawn in proportion to 1 / (k + 1) */
+    total = 0;
+    for (i = 0; i < CHECK_SUMMARY_HEAVY; i++) {
+        heavy[i] = RandomCode();
+        total += CHECK_SUMMARY_HEAVY / (i + 1);
+    }
+    for (i = 0; i < CHECK_SUMMARY_CODES; i++) {
+        if (NextRandom() % 5 < 2) {
+            pick = NextRandom() % total;
+            for (stream[i] = 0; pick >= CHECK_SUMMARY_HEAVY / (stream[i] + 1); stream[i]++) {
+                pick -= CHECK_SUMMARY_HEAVY / (stream[i] + 1);
+            }
+            stream[i] = heavy[stream[i]];
+        } else {
+            stream[i] = NextRandom();
+        }
+        CountAlertCode(summary, stream[i]);
+        CountAlertCode(parts[i * CHECK_SUMMARY_PARTS / CHECK_SUMMARY_CODES], stream[i]);
+    }
+
+    memcpy(sorted, stream, CHECK_SUMMARY_CODES * sizeof(ULONG));
+    qsort(sorted, CHECK_SUMMARY_CODES, sizeof(ULONG), CompareCodes);
+
+    passed = CheckSummaryBounds(summary, sorted, "one summary");
+    for (i = 1; i < CHECK_SUMMARY_PARTS && passed; i++) {
+        passed = MergeAlertSummary(parts[0], parts[i]);
+    }
+    passed = passed && CheckSummaryBounds(parts[0], sorted, "merged summaries");
+    if (passed && memcmp(summary->subsystems, parts[0]->subsystems, sizeof(summary->subsystems)) != 0) {
+        fprintf(stderr, "FAIL: merged summaries: subsystem counts differ\n");
+        passed = FALSE;
+    }
+
+    printf("summary: %lu codes, %lu slots, %s\n", (unsigned long)CHECK_SUMMARY_CODES,
+           (unsigned long)SUMMARY_SLOTS, passed ? "passed" : "failed");
+
+    for (i = 0; i < CHECK_SUMMARY_PARTS; i++) {
+        FreeAlertSummary(parts[i]);
+    }
+    FreeAlertSummary(summary);
+    free(sorted);
+    free(stream);
+
+    return passed;
+}
+
+/*
+ * Check one summary's heavy hitters against the exact counts
+ * Each count may overstate by at most its error, never understate, and no
+ * error can pass codes / SUMMARY_SLOTS.  Any code counted more often than
+ * that must be listed, and the list must run from highest count down.
+ */
+static BOOL CheckSummaryBounds(const struct AlertSummary *summary, const ULONG *sorted, CONST_STRPTR kind)
+{
+    static struct HeavyHitter top[SUMMARY_SLOTS];
+    SUMMARYCOUNT bound;
+    SUMMARYCOUNT exact;
+    ULONG count;
+    ULONG start;
+    ULONG i;
+    ULONG j;
+
+    if (summary->codes != CHECK_SUMMARY_CODES) {
+        fprintf(stderr, "FAIL: %s: counted %llu codes\n", kind, (unsigned long long)summary->codes);
+        return FALSE;
+    }
+
+    bound = summary->codes / SUMMARY_SLOTS;
+    count = TopAlertCodes(summary, top, SUMMARY_SLOTS);
+    for (i = 0; i < count; i++) {
+        exact = ExactCount(sorted, top[i].code);
+        if (top[i].count < exact || top[i].count - top[i].error > exact || top[i].error > bound) {
+            fprintf(stderr, "FAIL: %s: code %08lX counted %llu with error %llu, exactly %llu\n", kind,
+                    (unsigned long)top[i].code, (unsigned long long)top[i].count,
+                    (unsigned long long)top[i].error, (unsigned long long)exact);
+            return FALSE;
+        }
+        if (i > 0 && (top[i].count > top[i - 1].count ||
+                      (top[i].count == top[i - 1].count && top[i].code < top[i - 1].code))) {
+            fprintf(stderr, "FAIL: %s: code %08lX is listed out of order\n", kind, (unsigned long)top[i].code);
+            return FALSE;
+        }
+    }
+
+    /* Every code above the bound, found as a run of the sorted stream */
+    for (start = 0; start < CHECK_SUMMARY_CODES; start = i) {
+        for (i = start; i < CHECK_SUMMARY_CODES && sorted[i] == sorted[start]; i++) {
+        }
+        if ((SUMMARYCOUNT)(i - start) <= bound) {
+            continue;
+        }
+        for (j = 0; j < count && top[j].code != sorted[start]; j++) {
+        }
+        if (j == count) {
+            fprintf(stderr, "FAIL: %s: code %08lX counted %lu times is not listed\n", kind,
+                    (unsigned long)sorted[start], (unsigned long)(i - start));
+            return FALSE;
+        }
+    }
+
+    return TRUE;
+}
+
+/*
+ * How often a code occurs in the sorted stream
+ */
+static SUMMARYCOUNT ExactCount(const ULONG *sorted, ULONG code)
+{
+    ULONG low;
+    ULONG high;
+    ULONG middle;
+    ULONG first;
+
+    low = 0;
+    high = CHECK_SUMMARY_CODES;
+    while (low < high) {
+        middle = low + (high - low) / 2;
+        if (sorted[middle] < code) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+    first = low;
+    while (low < CHECK_SUMMARY_CODES && sorted[low] == code) {
+        low++;
+    }
+
+    return (SUMMARYCOUNT)(low - first);
+}
+
+/*
+ * qsort order for codes
+ */
+static int CompareCodes(const void *a, const void *b)
+{
+    ULONG codeA = *(const ULONG *)a;
+    ULONG codeB = *(const ULONG *)b;
+
+    return (codeA > codeB) - (codeA < codeB);
+}
+
+/*
+ * NEAREST - FindNearestCodes must list what a sort of every entry lists
+ * Queries are database codes with one digit changed, two neighbours
+ * swapped, two digits changed, or left alone, and a few random codes.
+ * Each is asked for a random number of matches within a random digit
+ * distance, and a code one edit away must always find its original.
+ */
+static BOOL CheckNearest(VOID)
+{
+    struct NearMatch *all;
+    ULONG original;
+    ULONG code;
+    ULONG edits;
+    ULONG i;
+    BOOL passed;
+
+    passed = CheckDistances();
+
+    all = (struct NearMatch *)malloc(EntryCount() * sizeof(struct NearMatch));
+    if (all == NULL) {
+        fprintf(stderr, "Error: Out of memory\n");
+        return FALSE;
+    }
+
+    for (i = 0; i < CHECK_NEAREST_QUERIES && passed; i++) {
+        original = EntryCode(NextRandom() % EntryCount());
+        edits = NextRandom() % 5;
+        if (edits == 4) {
+            code = NextRandom();
+            original = code;
+        } else {
+            code = PerturbCode(original, edits);
+        }
+        passed = CheckNearestQuery(code, original, NextRandom() % (NEAR_MAX_DIGITS + 1),
+                                   1 + NextRandom() % CHECK_NEAREST_MATCHES, all);
+    }
+
+    printf("nearest: %lu pairs, %lu queries, %lu entries, %s database, %s\n",
+           (unsigned long)CHECK_NEAREST_PAIRS, (unsigned long)CHECK_NEAREST_QUERIES, (unsigned long)EntryCount(),
+           ActiveInsightDatabase() != NULL ? "file" : "built-in", passed ? "passed" : "failed");
+
+    free(all);
+
+    return passed;
+}
+
+/*
+ * HexDigitDistance and CodeBitDistance against plain versions
+ * Pairs are up to four random edits apart, so runs of swaps that share
+ * a digit come up as well as single changes.
+ */
+static BOOL CheckDistances(VOID)
+{
+    ULONG a;
+    ULONG b;
+    ULONG i;
+
+    for (i = 0; i < CHECK_NEAREST_PAIRS; i++) {
+        a = ((NextRandom() & 1) != 0) ? RandomCode() : (NextRandom() & 0x11111111UL) * (NextRandom() % 3);
+        b = PerturbCode(a, NextRandom() % 5);
+        if (HexDigitDistance(a, b) != PlainDigitDistance(a, b) ||
+            HexDigitDistance(b, a) != PlainDigitDistance(a, b)) {
+            fprintf(stderr, "FAIL: distances: %08lX and %08lX are %lu digits apart, not %lu\n",
+                    (unsigned long)a, (unsigned long)b, (unsigned long)PlainDigitDistance(a, b),
+                    (unsigned long)HexDigitDistance(a, b));
+            return FALSE;
+        }
+        if (CodeBitDistance(a, b) != PlainBitDistance(a, b)) {
+            fprintf(stderr, "FAIL: distances: %08lX and %08lX are %lu bits apart, not %lu\n",
+                    (unsigned long)a, (unsigned long)b, (unsigned long)PlainBitDistance(a, b),
+                    (unsigned long)CodeBitDistance(a, b));
+            return FALSE;
+        }
+    }
+
+    return TRUE;
+}
+
+/*
+ * Rank one query both ways and compare the lists
+ * all must hold an entry per database entry.
+ */
+static BOOL CheckNearestQuery(ULONG code, ULONG original, ULONG maxDigits, ULONG maxMatches, struct NearMatch *all)
+{
+    struct NearMatch matches[CHECK_NEAREST_MATCHES];
+    ULONG digits;
+    ULONG wanted;
+    ULONG found;
+    ULONG i;
+
+    wanted = 0;
+    for (i = 0; i < EntryCount(); i++) {
+        digits = PlainDigitDistance(code, EntryCode(i));
+        if (digits <= maxDigits) {
+            all[wanted].entry = i;
+            all[wanted].code = EntryCode(i);
+            all[wanted].digits = (UWORD)digits;
+            all[wanted].bits = (UWORD)PlainBitDistance(code, all[wanted].code);
+            wanted++;
+        }
+    }
+    qsort(all, wanted, sizeof(struct NearMatch), CompareNearMatches);
+    if (wanted > maxMatches) {
+        wanted = maxMatches;
+    }
+
+    found = FindNearestCodes(code, maxDigits, matches, maxMatches);
+    if (found != wanted) {
+        fprintf(stderr, "FAIL: nearest: %08lX within %lu digits found %lu codes, not %lu\n",
+                (unsigned long)code, (unsigned long)maxDigits, (unsigned long)found, (unsigned long)wanted);
+        return FALSE;
+    }
+    for (i = 0; i < found; i++) {
+        if (matches[i].entry != all[i].entry || matches[i].code != all[i].code ||
+            matches[i].digits != all[i].digits || matches[i].bits != all[i].bits) {
+            fprintf(stderr, "FAIL: nearest: %08lX match %lu is %08lX (%lu digits, %lu bits), not %08lX (%lu, %lu)\n",
+                    (unsigned long)code, (unsigned long)i, (unsigned long)matches[i].code,
+                    (unsigned long)matches[i].digits, (unsigned long)matches[i].bits, (unsigned long)all[i].code,
+                    (unsigned long)all[i].digits, (unsigned long)all[i].bits);
+            return FALSE;
+        }
+    }
+
+    /* One edit from a known code - the closest match is at most one away */
+    if (maxDigits >= 1 && PlainDigitDistance(code, original) == 1 && (found == 0 || matches[0].digits > 1)) {
+        fprintf(stderr, "FAIL: nearest: %08lX is one edit from %08lX but was not matched\n",
+                (unsigned long)code, (unsigned long)original);
+        return FALSE;
+    }
+
+    return TRUE;
+}
+
+/*
+ * Make edits random changes to a code, each one digit changed or two neighbours swapped
+ */
+static ULONG PerturbCode(ULONG code, ULONG edits)
+{
+    ULONG shift;
+    ULONG high;
+    ULONG low;
+
+    while (edits-- > 0) {
+        shift = (NextRandom() % 8) * 4;
+        if ((NextRandom() & 1) != 0 && shift < 28) {
+            low = (code >> shift) & 0x0F;
+            high = (code >> (shift + 4)) & 0x0F;
+            code &= ~(0xFFUL << shift);
+            code |= ((low << 4) | high) << shift;
+        } else {
+            code ^= (1 + NextRandom() % 15) << shift;
+        }
+    }
+
+    return code;
+}
+
+/*
+ * Digit distance the long way - a table over the digits from the top,
+ * each step changing one digit or swapping the last two
+ */
+static ULONG PlainDigitDistance(ULONG a, ULONG b)
+{
+    ULONG digitsA[8];
+    ULONG digitsB[8];
+    ULONG cost[9];
+    ULONG i;
+
+    for (i = 0; i < 8; i++) {
+        digitsA[i] = (a >> (28 - i * 4)) & 0x0F;
+        digitsB[i] = (b >> (28 - i * 4)) & 0x0F;
+    }
+
+    cost[0] = 0;
+    for (i = 1; i <= 8; i++) {
+        cost[i] = cost[i - 1] + (digitsA[i - 1] != digitsB[i - 1] ? 1 : 0);
+        if (i >= 2 && digitsA[i - 1] == digitsB[i - 2] && digitsA[i - 2] == digitsB[i - 1] &&
+            cost[i - 2] + 1 < cost[i]) {
+            cost[i] = cost[i - 2] + 1;
+        }
+    }
+
+    return cost[8];
+}
+
+/*
+ * Bit distance one bit at a time
+ */
+static ULONG PlainBitDistance(ULONG a, ULONG b)
+{
+    ULONG distance;
+    ULONG bit;
+
+    distance = 0;
+    for (bit = 0; bit < 32; bit++) {
+        if (((a ^ b) >> bit) & 1) {
+            distance++;
+        }
+    }
+
+    return distance;
+}
+
+/*
+ * qsort order for matches - digits, then bits, then database order
+ */
+static int CompareNearMatches(const void *a, const void *b)
+{
+    const struct NearMatch *matchA = (const struct NearMatch *)a;
+    const struct NearMatch *matchB = (const struct NearMatch *)b;
+
+    if (matchA->digits != matchB->digits) {
+        return (matchA->digits > matchB->digits) - (matchA->digits < matchB->digits);
+    }
+    if (matchA->bits != matchB->bits) {
+        return (matchA->bits > matchB->bits) - (matchA->bits < matchB->bits);
+    }
+
+    return (matchA->entry > matchB->entry) - (matchA->entry < matchB->entry);
+}
+
+/*
+ * Entries in the active database
+ */
+static ULONG EntryCount(VOID)
+{
+    struct InsightDatabase *database;
+
+    database = ActiveInsightDatabase();
+
+    return (database != NULL) ? database->entryCount : InsightEntryCount();
+}
+
+/*
+ * Code of an entry in the active database
+ */
+static ULONG EntryCode(ULONG index)
+{
+    struct ErrorView view;
+
+    InsightEntryView(index, &view);
+
+    return view.code;
+}
+
+/*
+ * RELOAD - a daemon must answer every lookup correctly while reloading
+ * The copy it serves alternates between the DATABASE= image and one
+ * that differs only in its minor version, so reloads can be told apart
+ * but every record stays the same.  Half the changes are renames and
+ * half overwrite the file in place in pieces, which a reload may catch
+ * half written and must then refuse.
+ */
+static BOOL CheckReload(VOID)
+{
+    struct ReloadClient clients[CHECK_RELOAD_CLIENTS];
+    struct Reloader reloader;
+    struct BatchStats stats;
+    struct sigaction action;
+    struct sigaction oldPipe;
+    char newPath[64];
+    UBYTE *images[2];
+    ULONG size;
+    ULONG crc;
+    ULONG changes;
+    ULONG expectedInvalid;
+    ULONG loaded;
+    ULONG failed;
+    ULONG entries;
+    ULONG reloads;
+    ULONG failedReloads;
+    ULONG round;
+    ULONG i;
+    pid_t daemon;
+    BOOL passed;
+
+    if (databaseFile == NULL) {
+        fprintf(stderr, "Error: RELOAD needs a database file to reload - give DATABASE=<file.idb>\n");
+        return FALSE;
+    }
+    if (!ReadWholeFile(databaseFile, &images[0], &size)) {
+        fprintf(stderr, "Error: Cannot read %s\n", databaseFile);
+        return FALSE;
+    }
+    images[1] = (UBYTE *)malloc(size);
+    if (images[1] == NULL) {
+        fprintf(stderr, "Error: Out of memory\n");
+        free(images[0]);
+        return FALSE;
+    }
+
+    /* The second image is a newer minor version of the same tables */
+    memcpy(images[1], images[0], size);
+    images[1][IDB_FIELD_VERSION * 4 + 3]++;
+    memset(images[1] + IDB_FIELD_CHECKSUM * 4, 0, 4);
+    crc = IdbChecksum(0, images[1], size);
+    images[1][IDB_FIELD_CHECKSUM * 4] = (UBYTE)(crc >> 24);
+    images[1][IDB_FIELD_CHECKSUM * 4 + 1] = (UBYTE)(crc >> 16);
+    images[1][IDB_FIELD_CHECKSUM * 4 + 2] = (UBYTE)(crc >> 8);
+    images[1][IDB_FIELD_CHECKSUM * 4 + 3] = (UBYTE)crc;
+
+    /* Each client sends its own input and expects what DecodeBatch writes, once per request */
+    passed = TRUE;
+    expectedInvalid = 0;
+    for (i = 0; i < CHECK_RELOAD_CLIENTS; i++) {
+        clients[i].input = tmpfile();
+        clients[i].expected = tmpfile();
+        clients[i].output = tmpfile();
+        if (clients[i].input == NULL || clients[i].expected == NULL || clients[i].output == NULL) {
+            passed = FALSE;
+            continue;
+        }
+        WriteReloadInput(clients[i].input);
+        for (round = 0; round < CHECK_RELOAD_ROUNDS && passed; round++) {
+            rewind(clients[i].input);
+            passed = DecodeBatch(clients[i].input, clients[i].expected, BATCH_FORMAT_TSV, &stats);
+            expectedInvalid += stats.invalid;
+        }
+        fflush(clients[i].expected);
+    }
+    reloader.replies = tmpfile();
+    passed = passed && reloader.replies != NULL;
+
+    if (passed) {
+        passed = MakeCheckPath(reloadSocket, "reload-socket") && MakeCheckPath(reloadDatabase, "reload-idb") &&
+                 MakeCheckPath(newPath, "reload-new") &&
+                 ReplaceDatabaseFile(reloadDatabase, newPath, images[0], size, FALSE);
+        if (!passed) {
+            fprintf(stderr, "Error: Cannot write %s\n", reloadDatabase);
+        }
+    }
+
+    /* Clients that hang up must not kill the check, whatever RunDaemonClient restores */
+    memset(&action, 0, sizeof(action));
+    sigemptyset(&action.sa_mask);
+    action.sa_handler = SIG_IGN;
+    sigaction(SIGPIPE, &action, &oldPipe);
+
+    /* The compiled-in tables must be counted without their end marker, as the file counts them */
+    if (passed && StartCheckDaemon(NULL, &daemon)) {
+        if (!ReadDaemonStats(&entries, &reloads, &failedReloads) || entries != InsightEntryCount()) {
+            fprintf(stderr, "FAIL: reload: STATS on the compiled-in tables did not count %lu entries\n",
+                    (unsigned long)InsightEntryCount());
+            passed = FALSE;
+        }
+        passed = (BOOL)(StopCheckDaemon(daemon) && passed);
+    } else {
+        passed = FALSE;
+    }
+
+    changes = 0;
+    loaded = 0;
+    failed = 0;
+    if (passed && StartCheckDaemon(reloadDatabase, &daemon)) {
+        reloadClientsDone = 0;
+        reloader.requests = 0;
+        reloader.error = DAEMON_OK;
+        for (i = 0; i < CHECK_RELOAD_CLIENTS; i++) {
+            if (pthread_create(&clients[i].thread, NULL, RunReloadClient, &clients[i]) != 0) {
+                fprintf(stderr, "Error: Cannot start client %lu\n", (unsigned long)i);
+                kill(daemon, SIGKILL);
+                exit(EXIT_FAILURE);
+            }
+        }
+        if (pthread_create(&reloader.thread, NULL, RunReloader, &reloader) != 0) {
+            fprintf(stderr, "Error: Cannot start the reloader\n");
+            kill(daemon, SIGKILL);
+            exit(EXIT_FAILURE);
+        }
+
+        /* Change the file until every client is done, signalling a reload now and then */
+        while (__atomic_load_n(&reloadClientsDone, __ATOMIC_SEQ_CST) < CHECK_RELOAD_CLIENTS) {
+            if (!ReplaceDatabaseFile(reloadDatabase, newPath, images[changes & 1], size,
+                                     (BOOL)((changes & 2) != 0))) {
+                fprintf(stderr, "FAIL: reload: cannot write %s\n", reloadDatabase);
+                passed = FALSE;
+            }
+            if ((changes & 7) == 0) {
+                kill(daemon, SIGHUP);
+            }
+            changes++;
+            usleep(200);
+        }
+
+        for (i = 0; i < CHECK_RELOAD_CLIENTS; i++) {
+            pthread_join(clients[i].thread, NULL);
+        }
+        pthread_join(reloader.thread, NULL);
+
+        for (i = 0; i < CHECK_RELOAD_CLIENTS && passed; i++) {
+            if (clients[i].error != DAEMON_OK) {
+                fprintf(stderr, "FAIL: reload: client %lu: %s\n", (unsigned long)i, DaemonErrorText(clients[i].error));
+                passed = FALSE;
+            } else if (!SameFiles(clients[i].expected, clients[i].output)) {
+                fprintf(stderr, "FAIL: reload: client %lu records differ from DecodeBatch\n", (unsigned long)i);
+                passed = FALSE;
+            }
+        }
+        for (i = 0; i < CHECK_RELOAD_CLIENTS; i++) {
+            expectedInvalid -= clients[i].invalid;
+        }
+        if (passed && expectedInvalid != 0) {
+            fprintf(stderr, "FAIL: reload: clients counted the wrong number of invalid lines\n");
+            passed = FALSE;
+        }
+        if (passed && reloader.error != DAEMON_OK) {
+            fprintf(stderr, "FAIL: reload: reloader: %s\n", DaemonErrorText(reloader.error));
+            passed = FALSE;
+        }
+        passed = passed && CheckReloadReplies(reloader.replies, &loaded, &failed);
+
+        /* Every reload asked for is counted, and some did load */
+        if (passed && !ReadDaemonStats(&entries, &reloads, &failedReloads)) {
+            fprintf(stderr, "FAIL: reload: no database record from STATS\n");
+            passed = FALSE;
+        }
+        if (passed && entries != EntryCount()) {
+            fprintf(stderr, "FAIL: reload: STATS counted %lu entries, not %lu\n", (unsigned long)entries,
+                    (unsigned long)EntryCount());
+            passed = FALSE;
+        }
+        if (passed && (loaded == 0 || reloads < loaded || failedReloads < failed ||
+                       reloads + failedReloads < reloader.requests)) {
+            fprintf(stderr, "FAIL: reload: %lu of %lu RELOAD lines loaded, daemon counted %lu and %lu failed\n",
+                    (unsigned long)loaded, (unsigned long)reloader.requests, (unsigned long)reloads,
+                    (unsigned long)failedReloads);
+            passed = FALSE;
+        }
+
+        if (!StopCheckDaemon(daemon)) {
+            passed = FALSE;
+        }
+    } else {
+        passed = FALSE;
+    }
+
+    sigaction(SIGPIPE, &oldPipe, NULL);
+
+    printf("reload: %lu clients, %lu requests, %lu file changes, %lu RELOAD lines, %lu loaded, %lu refused, %s\n",
+           (unsigned long)CHECK_RELOAD_CLIENTS, (unsigned long)(CHECK_RELOAD_CLIENTS * CHECK_RELOAD_ROUNDS),
+           (unsigned long)changes, (unsigned long)reloader.requests, (unsigned long)loaded, (unsigned long)failed,
+           passed ? "passed" : "failed");
+
+    /* A daemon that crashed leaves its socket behind */
+    remove(reloadSocket);
+    remove(reloadDatabase);
+    remove(newPath);
+    if (reloader.replies != NULL) {
+        fclose(reloader.replies);
+    }
+    for (i = 0; i < CHECK_RELOAD_CLIENTS; i++) {
+        if (clients[i].input != NULL) {
+            fclose(clients[i].input);
+        }
+        if (clients[i].expected != NULL) {
+            fclose(clients[i].expected);
+        }
+        if (clients[i].output != NULL) {
+            fclose(clients[i].output);
+        }
+    }
+    free(images[1]);
+    free(images[0]);
+
+    return passed;
+}
+
+/*
+ * Write one client's request - mostly database codes, some not codes at all
+ */
+static VOID WriteReloadInput(FILE *input)
+{
+    ULONG i;
+
+    for (i = 0; i < CHECK_RELOAD_LINES; i++) {
+        if (NextRandom() % 50 == 0) {
+            fprintf(input, "not a code %lu\n", (unsigned long)i);
+        } else {
+            fprintf(input, "%08lX\n", (unsigned long)RandomCode());
+        }
+    }
+    fflush(input);
+}
+
+/*
+ * Read a whole file into a malloc'd block
+ */
+static BOOL ReadWholeFile(CONST_STRPTR path, UBYTE **data, ULONG *size)
+{
+    FILE *file;
+    long length;
+
+    length = FileSize(path);
+    if (length <= 0) {
+        return FALSE;
+    }
+    *data = (UBYTE *)malloc((size_t)length);
+    file = fopen(path, "rb");
+    if (*data == NULL || file == NULL || fread(*data, 1, (size_t)length, file) != (size_t)length) {
+        if (file != NULL) {
+            fclose(file);
+        }
+        free(*data);
+        return FALSE;
+    }
+    fclose(file);
+    *size = (ULONG)length;
+
+    return TRUE;
+}
+
+/*
+ * Write a database image over path
+ * In place, the file is truncated and written in pieces, so a reload can
+ * find it short or half old; otherwise it is written to newPath and
+ * renamed over path in one step.
+ */
+static BOOL ReplaceDatabaseFile(CONST_STRPTR path, CONST_STRPTR newPath, const UBYTE *image, ULONG size,
+                                BOOL inPlace)
+{
+    FILE *file;
+    ULONG piece;
+    ULONG done;
+    BOOL written;
+
+    file = fopen(inPlace ? path : newPath, "wb");
+    if (file == NULL) {
+        return FALSE;
+    }
+    written = TRUE;
+    for (done = 0; done < size && written; done += piece) {
+        piece = size / CHECK_RELOAD_PIECES + 1;
+        if (piece > size - done) {
+            piece = size - done;
+        }
+        written = (BOOL)(fwrite(image + done, 1, piece, file) == piece && fflush(file) == 0);
+    }
+    if (fclose(file) != 0 || !written) {
+        return FALSE;
+    }
+
+    return (BOOL)(inPlace || rename(newPath, path) == 0);
+}
+
+/*
+ * Start a daemon in a child process serving the file at path, or the
+ * compiled-in tables if path is NULL
+ * Returns once it answers a STATS line.
+ */
+static BOOL StartCheckDaemon(CONST_STRPTR path, pid_t *daemon)
+{
+    FILE *output;
+    ULONG invalid;
+    ULONG tries;
+    ULONG error;
+
+    fflush(stdout);
+    fflush(stderr);
+    *daemon = fork();
+    if (*daemon < 0) {
+        fprintf(stderr, "Error: Cannot start the daemon\n");
+        return FALSE;
+    }
+    if (*daemon == 0) {
+        if (path == NULL) {
+            UseInsightDatabase(NULL);
+        }
+        _exit((RunDaemon(reloadSocket, BATCH_FORMAT_TSV, path, NULL) == DAEMON_OK) ? EXIT_SUCCESS : EXIT_FAILURE);
+    }
+
+    output = tmpfile();
+    error = DAEMON_ERROR_CONNECT;
+    for (tries = 0; tries < 500 && output != NULL && error == DAEMON_ERROR_CONNECT; tries++) {
+        error = RunDaemonClient(reloadSocket, BATCH_FORMAT_TSV, NULL, "STATS", output, &invalid);
+        if (error == DAEMON_ERROR_CONNECT) {
+            usleep(10000);
+        }
+    }
+    if (output != NULL) {
+        fclose(output);
+    }
+    if (error != DAEMON_OK) {
+        fprintf(stderr, "FAIL: reload: the daemon did not start: %s\n", DaemonErrorText(error));
+        kill(*daemon, SIGKILL);
+        waitpid(*daemon, NULL, 0);
+        remove(reloadSocket);
+        return FALSE;
+    }
+
+    return TRUE;
+}
+
+/*
+ * Stop the daemon with SIGTERM - it must exit cleanly, not crash
+ */
+static BOOL StopCheckDaemon(pid_t daemon)
+{
+    int status;
+
+    kill(daemon, SIGTERM);
+    if (waitpid(daemon, &status, 0) != daemon) {
+        fprintf(stderr, "FAIL: reload: lost the daemon\n");
+        return FALSE;
+    }
+    if (WIFSIGNALED(status)) {
+        fprintf(stderr, "FAIL: reload: the daemon was killed by signal %d\n", WTERMSIG(status));
+        return FALSE;
+    }
+    if (!WIFEXITED(status) || WEXITSTATUS(status) != EXIT_SUCCESS) {
+        fprintf(stderr, "FAIL: reload: the daemon stopped with an error\n");
+        return FALSE;
+    }
+
+    return TRUE;
+}
+
+/*
+ * RELOAD client thread - send the same request again and again
+ */
+static VOID *RunReloadClient(VOID *arg)
+{
+    struct ReloadClient *client = (struct ReloadClient *)arg;
+    ULONG invalid;
+    ULONG round;
+
+    client->invalid = 0;
+    client->error = DAEMON_OK;
+    for (round = 0; round < CHECK_RELOAD_ROUNDS && client->error == DAEMON_OK; round++) {
+        rewind(client->input);
+        client->error = RunDaemonClient(reloadSocket, BATCH_FORMAT_TSV, client->input, NULL, client->output,
+                                        &invalid);
+        client->invalid += invalid;
+    }
+
+    __atomic_add_fetch(&reloadClientsDone, 1, __ATOMIC_SEQ_CST);
+
+    return NULL;
+}
+
+/*
+ * RELOAD reloader thread - ask for a reload, of the file served or by name, until the clients are done
+ */
+static VOID *RunReloader(VOID *arg)
+{
+    struct Reloader *reloader = (struct Reloader *)arg;
+    char command[80];
+    ULONG invalid;
+
+    sprintf(command, "RELOAD=%s", reloadDatabase);
+    while (__atomic_load_n(&reloadClientsDone, __ATOMIC_SEQ_CST) < CHECK_RELOAD_CLIENTS) {
+        reloader->error = RunDaemonClient(reloadSocket, BATCH_FORMAT_TSV, NULL,
+                                          ((reloader->requests & 1) != 0) ? command : "RELOAD",
+                                          reloader->replies, &invalid);
+        if (reloader->error != DAEMON_OK) {
+            break;
+        }
+        reloader->requests++;
+    }
+
+    return NULL;
+}
+
+/*
+ * Check that every RELOAD line got a database record or a reload record
+ * A reload may only fail on a file caught half written.
+ */
+static BOOL CheckReloadReplies(FILE *replies, ULONG *loaded, ULONG *failed)
+{
+    char line[256];
+
+    *loaded = 0;
+    *failed = 0;
+    rewind(replies);
+    while (fgets(line, sizeof(line), replies) != NULL) {
+        if (strncmp(line, "database\t", 9) == 0) {
+            (*loaded)++;
+        } else if (strncmp(line, "reload\t", 7) == 0 &&
+                   (strstr(line, IdbErrorText(IDB_ERROR_CHECKSUM)) != NULL ||
+                    strstr(line, IdbErrorText(IDB_ERROR_FORMAT)) != NULL ||
+                    strstr(line, IdbErrorText(IDB_ERROR_CORRUPT)) != NULL ||
+                    strstr(line, IdbErrorText(IDB_ERROR_OPEN)) != NULL)) {
+            (*failed)++;
+        } else {
+            fprintf(stderr, "FAIL: reload: unexpected reply to RELOAD: %s", line);
+            return FALSE;
+        }
+    }
+
+    return TRUE;
+}
+
+/*
+ * Ask the daemon for its entry and reload counts
+ */
+static BOOL ReadDaemonStats(ULONG *entries, ULONG *reloads, ULONG *failedReloads)
+{
+    FILE *output;
+    char line[256];
+    char *field;
+    unsigned long count;
+    unsigned long loaded;
+    unsigned long failed;
+    ULONG invalid;
+    BOOL found;
+
+    output = tmpfile();
+    if (output == NULL) {
+        return FALSE;
+    }
+    found = FALSE;
+    if (RunDaemonClient(reloadSocket, BATCH_FORMAT_TSV, NULL, "STATS", output, &invalid) == DAEMON_OK) {
+        rewind(output);
+        /* database, file (empty for the compiled-in tables), version, then the counts */
+        field = NULL;
+        if (fgets(line, sizeof(line), output) != NULL && strncmp(line, "database\t", 9) == 0) {
+            field = strchr(line + 9, '\t');
+        }
+        if (field != NULL) {
+            field = strchr(field + 1, '\t');
+        }
+        found = (BOOL)(field != NULL && sscanf(field, "\t%lu\t%*x\t%lu\t%lu", &count, &loaded, &failed) == 3);
+    }
+    fclose(output);
+
+    if (found) {
+        *entries = (ULONG)count;
+        *reloads = (ULONG)loaded;
+        *failedReloads = (ULONG)failed;
+    }
+
+    return found;
+}
+
+/*
+ * SCAN - the scanner must find exactly the alerts the log was written with
+ * Each line is a guru, software failure, recoverable or bare alert with
+ * a 0x, $, # or no prefix and perhaps a task word, or something that
+ * only looks like a code.  The codes start one byte further into a
+ * chunk on each line, so every position across a chunk boundary is
+ * covered.  The log is scanned whole, in streamed blocks and with STRICT.
+ */
+static BOOL CheckScan(VOID)
+{
+    FILE *log;
+    ULONG i;
+    BOOL passed;
+
+    scanText = (char *)malloc(CHECK_SCAN_LINES * CHECK_SCAN_LINE_MAX);
+    scanHits = (struct AlertHit *)malloc(CHECK_SCAN_LINES * 2 * sizeof(struct AlertHit));
+    log = tmpfile();
+    if (scanText == NULL || scanHits == NULL || log == NULL) {
+        fprintf(stderr, "Error: Cannot create the scan log\n");
+        free(scanText);
+        free(scanHits);
+        if (log != NULL) {
+            fclose(log);
+        }
+        return FALSE;
+    }
+
+    scanLength = 0;
+    scanLine = 1;
+    scanHitCount = 0;
+    for (i = 0; i < CHECK_SCAN_LINES; i++) {
+        WriteScanLine(i % CHECK_SCAN_CHUNK);
+    }
+
+    passed = (BOOL)(fwrite(scanText, 1, scanLength, log) == scanLength && fflush(log) == 0);
+    if (!passed) {
+        fprintf(stderr, "Error: Cannot write the scan log\n");
+    }
+    passed = passed && RunScan(log, 0, FALSE, "whole log");
+    passed = passed && RunScan(log, 0, TRUE, "streamed log");
+    passed = passed && RunScan(log, SCAN_STRICT, TRUE, "strict");
+
+    printf("scan: %lu lines, %lu alerts, %s scanner, %s\n", (unsigned long)CHECK_SCAN_LINES,
+           (unsigned long)scanHitCount, CHECK_SCAN_PATH, passed ? "passed" : "failed");
+
+    fclose(log);
+    free(scanHits);
+    free(scanText);
+
+    return passed;
+}
+
+/*
+ * Write one log line, with its code starting offset bytes into a chunk
+ */
+static VOID WriteScanLine(ULONG offset)
+{
+    static const CONST_STRPTR prefixes[] = { "", "0x", "0X", "$", "#" };
+    char text[16];
+    CONST_STRPTR prefix;
+    ULONG code;
+    ULONG kind;
+
+    kind = NextRandom() % 5;
+    if (kind == SCAN_KINDS) {
+        WriteScanNoise(offset);
+        return;
+    }
+
+    prefix = prefixes[NextRandom() % (sizeof(prefixes) / sizeof(prefixes[0]))];
+    if (kind == SCAN_KIND_GURU) {
+        /* A # code is only a guru on the line of the text; on the next it is bare */
+        prefix = "#";
+        if ((NextRandom() & 3) == 0) {
+            AddScanText("Guru Meditation\n");
+            kind = SCAN_KIND_BARE;
+        } else {
+            AddScanText("Guru Meditation ");
+        }
+    } else if (kind == SCAN_KIND_BARE) {
+        AddScanText("alert ");
+    } else {
+        /* A # code after other alert text still belongs to it, on its line or the next */
+        AddScanText((kind == SCAN_KIND_SOFTWARE_FAILURE) ? "Software Failure" : "Recoverable Alert");
+        AddScanText((NextRandom() & 1) != 0 ? ".\n" : " ");
+    }
+
+    PadScanText(offset, prefix);
+    AddScanText(prefix);
+    code = RandomCode();
+    sprintf(text, (NextRandom() & 1) != 0 ? "%08lX" : "%08lx", (unsigned long)code);
+    AddScanText(text);
+
+    WriteScanTask(code, kind);
+    AddScanText("\n");
+}
+
+/*
+ * Write what follows a code - a task word, a word that only starts like
+ * one, or nothing - and expect the hit that gives
+ */
+static VOID WriteScanTask(ULONG code, ULONG kind)
+{
+    char text[32];
+    ULONG task;
+
+    task = NextRandom();
+    switch (NextRandom() % 7) {
+    case 0:
+        ExpectScanHit(code, kind, FALSE, 0);
+        break;
+    case 1:
+        sprintf(text, ".%08lX", (unsigned long)task);
+        AddScanText(text);
+        ExpectScanHit(code, kind, TRUE, task);
+        break;
+    case 2:
+        sprintf(text, " Task: 0x%08lx", (unsigned long)task);
+        AddScanText(text);
+        ExpectScanHit(code, kind, TRUE, task);
+        break;
+    case 3:
+        sprintf(text, " task $%08lX", (unsigned long)task);
+        AddScanText(text);
+        ExpectScanHit(code, kind, TRUE, task);
+        break;
+    case 4:
+        sprintf(text, "\tTASK:%08lX", (unsigned long)task);
+        AddScanText(text);
+        ExpectScanHit(code, kind, TRUE, task);
+        break;
+    default:
+        /* Not a task word, so the number after it is an alert of its own */
+        ExpectScanHit(code, kind, FALSE, 0);
+        sprintf(text, (task & 1) != 0 ? " Tasks %08lX" : " Taskforce %08lX", (unsigned long)task);
+        AddScanText(text);
+        ExpectScanHit(task, SCAN_KIND_BARE, FALSE, 0);
+        break;
+    }
+}
+
+/*
+ * Write a line with something that only looks like a code, which the
+ * scanner must pass over
+ */
+static VOID WriteScanNoise(ULONG offset)
+{
+    char text[32];
+    ULONG value;
+
+    value = NextRandom();
+    switch (NextRandom() % 7) {
+    case 0:
+        sprintf(text, "v%08lX", (unsigned long)value);           /* Letter in front */
+        break;
+    case 1:
+        sprintf(text, "%08lxg", (unsigned long)value);           /* Letter after */
+        break;
+    case 2:
+        sprintf(text, "%07lX", (unsigned long)(value >> 4));     /* Seven digits */
+        break;
+    case 3:
+        sprintf(text, "%09lX", (unsigned long)value);            /* Nine digits */
+        break;
+    case 4:
+        sprintf(text, "x0x%08lX", (unsigned long)value);         /* 0x inside a word */
+        break;
+    case 5:
+        sprintf(text, "%08lX%04lX", (unsigned long)value, (unsigned long)(value >> 16));  /* Twelve digits */
+        break;
+    default:
+        strcpy(text, "Task: none");                               /* A task word with no code */
+        break;
+    }
+
+    AddScanText("noise ");
+    PadScanText(offset, "");
+    AddScanText(text);
+    AddScanText("\n");
+}
+
+/*
+ * Add text to the SCAN log, counting its lines
+ */
+static VOID AddScanText(CONST_STRPTR text)
+{
+    while (*text != '\0') {
+        if (*text == '\n') {
+            scanLine++;
+        }
+        scanText[scanLength++] = *text++;
+    }
+}
+
+/*
+ * Add spaces so that what follows prefix starts offset bytes into a chunk
+ * There is always at least one, so the code never touches the text before.
+ */
+static VOID PadScanText(ULONG offset, CONST_STRPTR prefix)
+{
+    AddScanText(" ");
+    while ((scanLength + strlen(prefix)) % CHECK_SCAN_CHUNK != offset) {
+        AddScanText(" ");
+    }
+}
+
+/*
+ * Expect a hit on the line being written
+ */
+static VOID ExpectScanHit(ULONG code, ULONG kind, BOOL hasTask, ULONG task)
+{
+    struct AlertHit *hit;
+
+    hit = &scanHits[scanHitCount++];
+    hit->code = code;
+    hit->task = task;
+    hit->hasTask = hasTask;
+    hit->kind = kind;
+    hit->line = scanLine;
+}
+
+/*
+ * Scan the log in one buffer or as a stream and check every hit
+ * STRICT must give the same hits without the bare ones.
+ */
+static BOOL RunScan(FILE *log, ULONG flags, BOOL stream, CONST_STRPTR kind)
+{
+    struct LogScanner scanner;
+    struct ScanCheck check;
+    BOOL scanned;
+
+    check.kind = kind;
+    check.flags = flags;
+    check.next = 0;
+    check.same = TRUE;
+    InitLogScanner(&scanner, flags, CheckScanHit, &check);
+
+    if (stream) {
+        rewind(log);
+        scanned = ScanLogStream(&scanner, log);
+    } else {
+        scanned = ScanLogBuffer(&scanner, scanText, scanLength);
+    }
+    if (!check.same) {
+        return FALSE;
+    }
+    if (!scanned) {
+        fprintf(stderr, "FAIL: %s: the scan stopped\n", kind);
+        return FALSE;
+    }
+
+    SkipScanBare(&check);
+    if (check.next != scanHitCount) {
+        fprintf(stderr, "FAIL: %s: missed %08lX on line %lu\n", kind,
+                (unsigned long)scanHits[check.next].code, (unsigned long)scanHits[check.next].line);
+        return FALSE;
+    }
+    if (scanner.line != scanLine) {
+        fprintf(stderr, "FAIL: %s: counted %lu lines, wrote %lu\n", kind,
+                (unsigned long)scanner.line, (unsigned long)scanLine);
+        return FALSE;
+    }
+
+    return TRUE;
+}
+
+/*
+ * Report callback for RunScan - the hit must be the next one expected
+ */
+static BOOL CheckScanHit(const struct AlertHit *hit, APTR userData)
+{
+    struct ScanCheck *check;
+    const struct AlertHit *wanted;
+
+    check = (struct ScanCheck *)userData;
+    SkipScanBare(check);
+    if (check->next >= scanHitCount) {
+        fprintf(stderr, "FAIL: %s: found %08lX on line %lu after the last alert\n", check->kind,
+                (unsigned long)hit->code, (unsigned long)hit->line);
+        check->same = FALSE;
+        return FALSE;
+    }
+
+    wanted = &scanHits[check->next++];
+    if (hit->code != wanted->code || hit->line != wanted->line || hit->kind != wanted->kind ||
+        hit->hasTask != wanted->hasTask || hit->task != wanted->task) {
+        fprintf(stderr, "FAIL: %s: found %s %08lX task %08lX on line %lu, expected %s %08lX task %08lX on line %lu\n",
+                check->kind, AlertKindName(hit->kind), (unsigned long)hit->code, (unsigned long)hit->task,
+                (unsigned long)hit->line, AlertKindName(wanted->kind), (unsigned long)wanted->code,
+                (unsigned long)wanted->task, (unsigned long)wanted->line);
+        check->same = FALSE;
+        return FALSE;
+    }
+
+    return TRUE;
+}
+
+/*
+ * Step past the bare alerts a STRICT scan leaves out
+ */
+static VOID SkipScanBare(struct ScanCheck *check)
+{
+    if ((check->flags & SCAN_STRICT) == 0) {
+        return;
+    }
+    while (check->next < scanHitCount && scanHits[check->next].kind == SCAN_KIND_BARE) {
+        check->next++;
+    }
+}
+
+/*
+ * HEX - ParseHexFields must convert each field as a plain loop would
+ * Random fields in mixed case sit back to back in one long run of
+ * digits, so each must stop at its own eight.  Every byte value is put
+ * at every digit of a field, so NULs, spaces, bytes just outside the
+ * digit ranges and bytes with the top bit set are all tried in every
+ * lane.  The fields are converted at once and then in every count up
+ * to CHECK_HEX_COUNTS from several starts, and nothing past the last
+ * field may be written.
+ */
+static BOOL CheckHexFields(VOID)
+{
+    static char run[CHECK_HEX_RUN * 8];
+    static char bad[CHECK_HEX_BAD][8];
+    static ULONG values[CHECK_HEX_FIELDS + 1];
+    static UBYTE status[CHECK_HEX_FIELDS + 1];
+    const char *swap;
+    ULONG converted;
+    ULONG valid;
+    ULONG start;
+    ULONG count;
+    ULONG i;
+    ULONG j;
+    BOOL passed;
+
+    for (i = 0; i < CHECK_HEX_RUN; i++) {
+        WriteHexField(run + i * 8, NextRandom());
+        hexFields[i] = run + i * 8;
+    }
+    for (i = 0; i < CHECK_HEX_BAD; i++) {
+        WriteHexField(bad[i], NextRandom());
+        bad[i][i % 8] = (char)(i / 8);
+        hexFields[CHECK_HEX_RUN + i] = bad[i];
+    }
+
+    /* Shuffle, so the odd fields land in every lane */
+    for (i = CHECK_HEX_FIELDS - 1; i > 0; i--) {
+        j = NextRandom() % (i + 1);
+        swap = hexFields[i];
+        hexFields[i] = hexFields[j];
+        hexFields[j] = swap;
+    }
+
+    valid = 0;
+    for (i = 0; i < CHECK_HEX_FIELDS; i++) {
+        hexValid[i] = PlainHexField(hexFields[i], &hexValues[i]);
+        if (hexValid[i]) {
+            valid++;
+        }
+    }
+
+    status[CHECK_HEX_FIELDS] = CHECK_HEX_UNTOUCHED;
+    converted = ParseHexFields(hexFields, CHECK_HEX_FIELDS, values, status);
+    passed = CompareHexFields(0, CHECK_HEX_FIELDS, converted, values, status);
+
+    for (start = 0; start < CHECK_HEX_STARTS && passed; start++) {
+        for (count = 0; count <= CHECK_HEX_COUNTS && passed; count++) {
+            memset(status, CHECK_HEX_UNTOUCHED, count + 1);
+            converted = ParseHexFields(hexFields + start, count, values, status);
+            passed = CompareHexFields(start, count, converted, values, status);
+        }
+    }
+
+    printf("hex: %lu fields, %lu valid, %s conversion, %s\n", (unsigned long)CHECK_HEX_FIELDS,
+           (unsigned long)valid, CHECK_HEX_PATH, passed ? "passed" : "failed");
+
+    return passed;
+}
+
+/*
+ * Write the eight digits of code, each letter upper or lower case at random
+ */
+static VOID WriteHexField(char *field, ULONG code)
+{
+    static const char digits[] = "0123456789abcdef";
+    ULONG i;
+
+    for (i = 0; i < 8; i++) {
+        field[i] = digits[(code >> (28 - i * 4)) & 0x0F];
+        if (field[i] >= 'a' && (NextRandom() & 1) != 0) {
+            field[i] -= 'a' - 'A';
+        }
+    }
+}
+
+/*
+ * Compare one ParseHexFields call over count fields from start with the plain conversions
+ */
+static BOOL CompareHexFields(ULONG start, ULONG count, ULONG converted, const ULONG *values, const UBYTE *status)
+{
+    ULONG valid;
+    ULONG i;
+
+    valid = 0;
+    for (i = 0; i < count; i++) {
+        if (hexValid[start + i]) {
+            valid++;
+        }
+        if ((hexValid[start + i] && (status[i] != HEX_OK || values[i] != hexValues[start + i])) ||
+            (!hexValid[start + i] && status[i] != HEX_BAD_DIGIT)) {
+            fprintf(stderr, "FAIL: %lu fields from %lu: field %lu \"%.8s\" gave status %u value %08lX\n",
+                    (unsigned long)count, (unsigned long)start, (unsigned long)i, hexFields[start + i],
+                    (unsigned int)status[i], (unsigned long)values[i]);
+            return FALSE;
+        }
+    }
+
+    if (converted != valid) {
+        fprintf(stderr, "FAIL: %lu fields from %lu: %lu converted, %lu valid\n", (unsigned long)count,
+                (unsigned long)start, (unsigned long)converted, (unsigned long)valid);
+        return FALSE;
+    }
+    if (status[count] != CHECK_HEX_UNTOUCHED) {
+        fprintf(stderr, "FAIL: %lu fields from %lu: status written past the last field\n", (unsigned long)count,
+                (unsigned long)start);
+        return FALSE;
+    }
+
+    return TRUE;
+}
+
+/*
+ * Plain conversion of an eight digit field, one digit at a time
+ */
+static BOOL PlainHexField(const char *field, ULONG *value)
+{
+    static const char digits[] = "0123456789abcdef";
+    const char *digit;
+    ULONG i;
+    char c;
+
+    *value = 0;
+    for (i = 0; i < 8; i++) {
+        c = field[i];
+        if (c >= 'A' && c <= 'F') {
+            c += 'a' - 'A';
+        }
+        digit = (c != '\0') ? strchr(digits, c) : NULL;
+        if (digit == NULL) {
+            return FALSE;
+        }
+        *value = (*value << 4) | (ULONG)(digit - digits);
+    }
+
+    return TRUE;
+}
+
+/*
+ * SEARCH - indexed search must rank exactly what a plain filter finds
+ * The plain filter splits every entry's description and expanded
+ * insight into terms, and for each query counts the uses of each term
+ * in every entry and scores them as search.h describes, taking only the
+ * term weights from the index.  Queries are words of a random entry in
+ * any case, with stop words, unknown and repeated words, words cut at
+ * SEARCH_TERM_SIZE and more words than SEARCH_MAX_TERMS.
+ */
+static BOOL CheckSearch(VOID)
+{
+    struct SearchHit *hits;
+    struct SearchHit *plain;
+    char query[CHECK_QUERY_TEXT];
+    ULONG maxHits;
+    ULONG i;
+    BOOL passed;
+
+    hits = (struct SearchHit *)malloc(EntryCount() * sizeof(struct SearchHit));
+    plain = (struct SearchHit *)malloc(EntryCount() * sizeof(struct SearchHit));
+    termUses = NULL;
+    termUseCount = 0;
+    termUseCapacity = 0;
+    passed = (BOOL)(hits != NULL && plain != NULL && CollectTermUses());
+    if (!passed) {
+        fprintf(stderr, "Error: Out of memory\n");
+    }
+
+    for (i = 0; i < CHECK_SEARCH_QUERIES && passed; i++) {
+        RandomSearchQuery(query);
+        maxHits = ((i & 7) == 0) ? EntryCount() : NextRandom() % (CHECK_SEARCH_TOP + 1);
+        passed = CheckSearchQuery(query, maxHits, hits, plain);
+    }
+
+    printf("search: %lu queries, %lu term uses, %lu entries, %s database, %s\n",
+           (unsigned long)CHECK_SEARCH_QUERIES, (unsigned long)termUseCount, (unsigned long)EntryCount(),
+           ActiveInsightDatabase() != NULL ? "file" : "built-in", passed ? "passed" : "failed");
+
+    free(termUses);
+    free(plain);
+    free(hits);
+
+    return passed;
+}
+
+/*
+ * Split every entry's description and expanded insight into term uses
+ */
+static BOOL CollectTermUses(VOID)
+{
+    struct ErrorView view;
+    char *insight;
+    ULONG i;
+
+    for (i = 0; i < EntryCount(); i++) {
+        InsightEntryView(i, &view);
+        insight = (char *)malloc(view.insightLength + 1);
+        if (insight == NULL) {
+            return FALSE;
+        }
+        ExpandExplanationInto(view.insight, insight, view.insightLength + 1);
+        AddTermUses(view.description, i, SEARCH_DESCRIPTION_WEIGHT);
+        AddTermUses(insight, i, 1);
+        free(insight);
+        if (termUses == NULL) {
+            return FALSE;
+        }
+    }
+
+    return TRUE;
+}
+
+/*
+ * Add a use of each term in text, growing the list as needed
+ * The list is freed and left NULL if it cannot grow.
+ */
+static VOID AddTermUses(CONST_STRPTR text, ULONG entry, ULONG frequency)
+{
+    struct TermUse *grown;
+    char term[SEARCH_TERM_SIZE];
+
+    while (NextSearchTerm(&text, term) > 0) {
+        if (termUseCount == termUseCapacity) {
+            termUseCapacity = (termUseCapacity == 0) ? 4096 : termUseCapacity * 2;
+            grown = (struct TermUse *)realloc(termUses, termUseCapacity * sizeof(struct TermUse));
+            if (grown == NULL) {
+                free(termUses);
+                termUses = NULL;
+                return;
+            }
+            termUses = grown;
+        }
+        strcpy(termUses[termUseCount].term, term);
+        termUses[termUseCount].entry = entry;
+        termUses[termUseCount].frequency = frequency;
+        termUseCount++;
+    }
+}
+
+/*
+ * Build a query from the words around a random term use
+ */
+static VOID RandomSearchQuery(char *query)
+{
+    static const CONST_STRPTR extras[] = { "the", "of", "a", "zqxjv", "x9", "--", "" };
+    char word[2 * SEARCH_TERM_SIZE];
+    ULONG words;
+    ULONG use;
+    ULONG i;
+    ULONG k;
+
+    query[0] = '\0';
+    words = 1 + NextRandom() % CHECK_SEARCH_WORDS;
+    if ((NextRandom() & 3) != 0) {
+        words = 1 + words % 3;
+    }
+    use = NextRandom() % termUseCount;
+
+    for (i = 0; i < words; i++) {
+        if ((NextRandom() % 6) == 0) {
+            AddQueryWord(query, extras[NextRandom() % (sizeof(extras) / sizeof(extras[0]))]);
+            continue;
+        }
+
+        /* Mostly the next word of the same entry, sometimes one from anywhere */
+        if ((NextRandom() % 5) == 0 || use + 1 >= termUseCount) {
+            use = NextRandom() % termUseCount;
+        } else if ((NextRandom() % 4) != 0) {
+            use++;
+        }
+        strcpy(word, termUses[use].term);
+        switch (NextRandom() % 6) {
+        case 0:
+            /* Capitalised */
+            if (word[0] >= 'a' && word[0] <= 'z') {
+                word[0] -= 'a' - 'A';
+            }
+            break;
+        case 1:
+            /* Upper case */
+            for (k = 0; word[k] != '\0'; k++) {
+                if (word[k] >= 'a' && word[k] <= 'z') {
+                    word[k] -= 'a' - 'A';
+                }
+            }
+            break;
+        case 2:
+            /* Run on past SEARCH_TERM_SIZE - 1, where a term is cut */
+            strcat(word, "abcdefghijklmnopqrstuvwxyz012345");
+            break;
+        default:
+            break;
+        }
+        AddQueryWord(query, word);
+    }
+}
+
+/*
+ * Append a word to a query with a random separator
+ */
+static VOID AddQueryWord(char *query, CONST_STRPTR word)
+{
+    static const CONST_STRPTR separators[] = { " ", "  ", ", ", "/", "\t" };
+
+    if (query[0] != '\0') {
+        strcat(query, separators[NextRandom() % (sizeof(separators) / sizeof(separators[0]))]);
+    }
+    strcat(query, word);
+}
+
+/*
+ * Run one query through the index and compare it with the plain filter
+ */
+static BOOL CheckSearchQuery(CONST_STRPTR query, ULONG maxHits, struct SearchHit *hits, struct SearchHit *plain)
+{
+    struct SearchTotals totals;
+    struct SearchTotals plainTotals;
+    ULONG count;
+    ULONG wanted;
+    ULONG i;
+    LONG matches;
+
+    matches = PlainSearch(query, plain, &plainTotals);
+    if (matches < 0) {
+        return FALSE;
+    }
+
+    count = SearchInsights(query, hits, maxHits, &totals);
+    wanted = ((ULONG)matches < maxHits) ? (ULONG)matches : maxHits;
+    if (totals.terms != plainTotals.terms || totals.matches != plainTotals.matches || count != wanted) {
+        fprintf(stderr, "FAIL: search \"%s\": %lu terms, %lu matches, %lu results, plainly %lu, %lu and %lu\n",
+                query, (unsigned long)totals.terms, (unsigned long)totals.matches, (unsigned long)count,
+                (unsigned long)plainTotals.terms, (unsigned long)plainTotals.matches, (unsigned long)wanted);
+        return FALSE;
+    }
+
+    for (i = 0; i < count; i++) {
+        if (hits[i].entry != plain[i].entry || hits[i].score != plain[i].score || hits[i].terms != plain[i].terms) {
+            fprintf(stderr, "FAIL: search \"%s\": result %lu is entry %lu score %lu with %lu terms, "
+                    "plainly entry %lu score %lu with %lu terms\n", query, (unsigned long)i,
+                    (unsigned long)hits[i].entry, (unsigned long)hits[i].score, (unsigned long)hits[i].terms,
+                    (unsigned long)plain[i].entry, (unsigned long)plain[i].score, (unsigned long)plain[i].terms);
+            return FALSE;
+        }
+    }
+
+    return TRUE;
+}
+
+/*
+ * Plain search - score every entry by its term uses and sort them all
+ * Returns the number of matching entries, or -1 if a term of the query
+ * is missing from the index or its entry count is wrong.
+ */
+static LONG PlainSearch(CONST_STRPTR query, struct SearchHit *plain, struct SearchTotals *totals)
+{
+    struct SearchIndex index;
+    char terms[SEARCH_MAX_TERMS][SEARCH_TERM_SIZE];
+    char term[SEARCH_TERM_SIZE];
+    ULONG documents[SEARCH_MAX_TERMS];
+    ULONG weights[SEARCH_MAX_TERMS];
+    ULONG frequencies[SEARCH_MAX_TERMS];
+    const UBYTE *record;
+    CONST_STRPTR text;
+    ULONG termCount;
+    ULONG matches;
+    ULONG entry;
+    ULONG frequency;
+    ULONG u;
+    ULONG k;
+    LONG found;
+
+    /* The query's terms, once each, as many as the index would take */
+    text = query;
+    termCount = 0;
+    while (termCount < SEARCH_MAX_TERMS && NextSearchTerm(&text, term) > 0) {
+        k = 0;
+        while (k < termCount && strcmp(terms[k], term) != 0) {
+            k++;
+        }
+        if (k == termCount) {
+            strcpy(terms[termCount++], term);
+        }
+    }
+
+    /* Entries using each term, and its weight from the index */
+    for (k = 0; k < termCount; k++) {
+        documents[k] = 0;
+        entry = 0xFFFFFFFFUL;
+        for (u = 0; u < termUseCount; u++) {
+            if (termUses[u].entry != entry && strcmp(termUses[u].term, terms[k]) == 0) {
+                entry = termUses[u].entry;
+                documents[k]++;
+            }
+        }
+
+        weights[k] = 0;
+        found = (ActiveSearchIndex(&index)) ? FindSearchTerm(&index, terms[k]) : -1;
+        if (found >= 0) {
+            record = index.terms + (ULONG)found * SEARCH_TERM_RECORD;
+            weights[k] = IdbGetWord(record + 10);
+            if (IdbGetWord(record + 8) != documents[k]) {
+                fprintf(stderr, "FAIL: search \"%s\": the index has \"%s\" in %lu entries, plainly %lu\n", query,
+                        terms[k], (unsigned long)IdbGetWord(record + 8), (unsigned long)documents[k]);
+                return -1;
+            }
+        } else if (documents[k] > 0) {
+            fprintf(stderr, "FAIL: search \"%s\": \"%s\" is missing from the index\n", query, terms[k]);
+            return -1;
+        }
+    }
+
+    /* Score each entry from its uses of the terms - the uses are in entry order */
+    matches = 0;
+    u = 0;
+    while (u < termUseCount) {
+        entry = termUses[u].entry;
+        for (k = 0; k < termCount; k++) {
+            frequencies[k] = 0;
+        }
+        for (; u < termUseCount && termUses[u].entry == entry; u++) {
+            for (k = 0; k < termCount; k++) {
+                if (strcmp(termUses[u].term, terms[k]) == 0) {
+                    frequencies[k] += termUses[u].frequency;
+                }
+            }
+        }
+
+        plain[matches].entry = entry;
+        plain[matches].score = 0;
+        plain[matches].terms = 0;
+        for (k = 0; k < termCount; k++) {
+            if (frequencies[k] > 0) {
+                frequency = (frequencies[k] < 255) ? frequencies[k] : 255;
+                plain[matches].score += weights[k] * frequency * (SEARCH_SATURATION + 1) /
+                                        (frequency + SEARCH_SATURATION);
+                plain[matches].terms++;
+            }
+        }
+        if (plain[matches].terms > 0) {
+            matches++;
+        }
+    }
+
+    qsort(plain, matches, sizeof(struct SearchHit), CompareSearchHits);
+
+    totals->terms = termCount;
+    totals->matches = matches;
+
+    return (LONG)matches;
+}
+
+/*
+ * Sort order for plain search results - more terms, then higher score, then entry order
+ */
+static int CompareSearchHits(const void *a, const void *b)
+{
+    const struct SearchHit *left = (const struct SearchHit *)a;
+    const struct SearchHit *right = (const struct SearchHit *)b;
+
+    if (left->terms != right->terms) {
+        return (left->terms > right->terms) ? -1 : 1;
+    }
+    if (left->score != right->score) {
+        return (left->score > right->score) ? -1 : 1;
+    }
+    if (left->entry != right->entry) {
+        return (left->entry < right->entry) ? -1 : 1;
+    }
+
+    return 0;
+}
+
+/*
+ * NAME - indexed name lookup must find exactly what a plain filter finds
+ * The plain filter tries the query at every word start of every
+ * description, ignoring case.  Queries are cut from random word starts
+ * and run on over several words or past the end of the name, in any
+ * case, with leading blanks, or are text no name holds.
+ */
+static BOOL CheckNames(VOID)
+{
+    struct NameHit *hits;
+    struct NameHit *plain;
+    char query[CHECK_QUERY_TEXT];
+    ULONG maxHits;
+    ULONG i;
+    BOOL passed;
+
+    hits = (struct NameHit *)malloc(EntryCount() * sizeof(struct NameHit));
+    plain = (struct NameHit *)malloc(EntryCount() * sizeof(struct NameHit));
+    passed = (BOOL)(hits != NULL && plain != NULL);
+    if (!passed) {
+        fprintf(stderr, "Error: Out of memory\n");
+    }
+
+    for (i = 0; i < CHECK_NAME_QUERIES && passed; i++) {
+        RandomNameQuery(query);
+        maxHits = ((i & 7) == 0) ? EntryCount() : NextRandom() % (CHECK_NAME_TOP + 1);
+        passed = CheckNameQuery(query, maxHits, hits, plain);
+    }
+
+    printf("name: %lu queries, %lu entries, %s database, %s\n", (unsigned long)CHECK_NAME_QUERIES,
+           (unsigned long)EntryCount(), ActiveInsightDatabase() != NULL ? "file" : "built-in",
+           passed ? "passed" : "failed");
+
+    free(plain);
+    free(hits);
+
+    return passed;
+}
+
+/*
+ * Cut a query from a word start of a random description
+ */
+static VOID RandomNameQuery(char *query)
+{
+    static const CONST_STRPTR others[] = { "", "  ", "zqxj", "free  twice", "0x", "-" };
+    CONST_STRPTR description;
+    ULONG length;
+    ULONG offset;
+    ULONG used;
+    ULONG k;
+
+    if ((NextRandom() % 10) == 0) {
+        strcpy(query, others[NextRandom() % (sizeof(others) / sizeof(others[0]))]);
+        return;
+    }
+
+    description = EntryDescription(NextRandom() % EntryCount());
+    length = (ULONG)strlen(description);
+    offset = (length > 0) ? NextRandom() % length : 0;
+    while (offset > 0 && !PlainNameStart(description, offset)) {
+        offset--;
+    }
+
+    /* Leading blanks are skipped; a query past the end of the name matches only longer names */
+    used = 0;
+    if ((NextRandom() & 7) == 0) {
+        strcpy(query, " \t");
+        used = 2;
+    }
+    k = 1 + NextRandom() % 12;
+    if (offset + k > length) {
+        k = length - offset;
+    }
+    memcpy(query + used, description + offset, k);
+    used += k;
+    if ((NextRandom() % 20) == 0) {
+        query[used++] = 's';
+    }
+    query[used] = '\0';
+
+    switch (NextRandom() % 4) {
+    case 0:
+        for (k = 0; query[k] != '\0'; k++) {
+            if (query[k] >= 'a' && query[k] <= 'z') {
+                query[k] -= 'a' - 'A';
+            }
+        }
+        break;
+    case 1:
+        for (k = 0; query[k] != '\0'; k++) {
+            if (query[k] >= 'A' && query[k] <= 'Z') {
+                query[k] += 'a' - 'A';
+            }
+        }
+        break;
+    default:
+        break;
+    }
+}
+
+/*
+ * Run one query through the index and compare it with the plain filter
+ * Each entry must be the one the filter lists, and the place it gives
+ * must be a word start where the query matches - the start of the name
+ * whenever it matches there.
+ */
+static BOOL CheckNameQuery(CONST_STRPTR query, ULONG maxHits, struct NameHit *hits, struct NameHit *plain)
+{
+    ULONG matches;
+    ULONG wanted;
+    ULONG count;
+    ULONG i;
+
+    matches = PlainNames(query, plain);
+    wanted = (matches < maxHits) ? matches : maxHits;
+    count = FindInsightNames(query, hits, maxHits);
+    if (count != wanted) {
+        fprintf(stderr, "FAIL: name \"%s\": %lu results, plainly %lu\n", query, (unsigned long)count,
+                (unsigned long)wanted);
+        return FALSE;
+    }
+
+    for (i = 0; i < count; i++) {
+        if (hits[i].entry != plain[i].entry || (plain[i].offset == 0 && hits[i].offset != 0) ||
+            hits[i].offset >= strlen(EntryDescription(hits[i].entry)) ||
+            !PlainNameStart(EntryDescription(hits[i].entry), hits[i].offset) ||
+            !PlainNameMatch(EntryDescription(hits[i].entry), hits[i].offset, query)) {
+            fprintf(stderr, "FAIL: name \"%s\": result %lu is entry %lu at %lu, plainly entry %lu at %lu\n",
+                    query, (unsigned long)i, (unsigned long)hits[i].entry, (unsigned long)hits[i].offset,
+                    (unsigned long)plain[i].entry, (unsigned long)plain[i].offset);
+            return FALSE;
+        }
+    }
+
+    return TRUE;
+}
+
+/*
+ * Plain name lookup - try the query at every word start of every entry
+ * Names starting with the query come first, then the rest, each in
+ * entry order.  Returns the number of entries that match.
+ */
+static ULONG PlainNames(CONST_STRPTR query, struct NameHit *plain)
+{
+    CONST_STRPTR description;
+    ULONG matches;
+    ULONG pass;
+    ULONG entry;
+    ULONG offset;
+
+    while (*query == ' ' || *query == '\t') {
+        query++;
+    }
+    if (*query == '\0') {
+        return 0;
+    }
+
+    matches = 0;
+    for (pass = 0; pass < 2; pass++) {
+        for (entry = 0; entry < EntryCount(); entry++) {
+            description = EntryDescription(entry);
+            offset = 0;
+            while (description[offset] != '\0' &&
+                   !(PlainNameStart(description, offset) && PlainNameMatch(description, offset, query))) {
+                offset++;
+            }
+            if (description[offset] == '\0' || (offset == 0) != (pass == 0)) {
+                continue;
+            }
+            plain[matches].entry = entry;
+            plain[matches].offset = offset;
+            matches++;
+        }
+    }
+
+    return matches;
+}
+
+/*
+ * Whether a word starts at offset - a letter or digit after anything
+ * else, a capital after a small letter, or a digit after a letter or
+ * the other way round
+ */
+static BOOL PlainNameStart(CONST_STRPTR description, ULONG offset)
+{
+    ULONG kind;
+    ULONG previous;
+
+    kind = NameCharacterKind(description[offset]);
+    if (kind == 0) {
+        return FALSE;
+    }
+    if (offset == 0) {
+        return TRUE;
+    }
+    previous = NameCharacterKind(description[offset - 1]);
+
+    return (BOOL)(previous == 0 || (previous == 1 && kind == 2) || ((previous == 3) != (kind == 3)));
+}
+
+/*
+ * 1 for a small letter, 2 for a capital, 3 for a digit, 0 for anything else
+ */
+static ULONG NameCharacterKind(char c)
+{
+    if (c >= 'a' && c <= 'z') {
+        return 1;
+    }
+    if (c >= 'A' && c <= 'Z') {
+        return 2;
+    }
+    if (c >= '0' && c <= '9') {
+        return 3;
+    }
+
+    return 0;
+}
+
+/*
+ * Whether the description from offset starts with query, ignoring the case of ASCII letters
+ */
+static BOOL PlainNameMatch(CONST_STRPTR description, ULONG offset, CONST_STRPTR query)
+{
+    char a;
+    char b;
+
+    while (*query == ' ' || *query == '\t') {
+        query++;
+    }
+    for (; *query != '\0'; query++, offset++) {
+        a = description[offset];
+        b = *query;
+        if (a >= 'A' && a <= 'Z') {
+            a += 'a' - 'A';
+        }
+        if (b >= 'A' && b <= 'Z') {
+            b += 'a' - 'A';
+        }
+        if (a != b) {
+            return FALSE;
+        }
+    }
+
+    return TRUE;
+}
+
+/*
+ * Description of an entry in the active database
+ */
+static CONST_STRPTR EntryDescription(ULONG index)
+{
+    struct ErrorView view;
+
+    InsightEntryView(index, &view);
+
+    return view.description;
+}
@@ -0,0 +1,101 @@
+/*
+ * C++ Linkage Check
+ *
+ * C++ consumer of the decoding library.  Includes every public header
+ * from C++, calls into the core and takes the address of a function from
+ * each module, so a declaration left without C linkage fails the link
+ * instead of the first C++ program that uses it.  ctest runs it.
+ *
+ * Usage: insight_cplusplus
+ *
+ * After meditiation comes... Insight
+ *
+ * Copyright (c) 2025-26 amigazen project
+ * Licensed under BSD 2-Clause License
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <cstdio>
+#include <cstring>
+#include "libinsight.h"
+#include "batch.h"
+#include "parallel.h"
+#include "daemon.h"
+#include "ring.h"
+#include "ringdecode.h"
+#include "logscan.h"
+
+/* One function from each module - each must resolve to its C symbol, so
+   the table has external linkage and cannot be optimised away */
+extern const void *const linked[];
+const void *const linked[] = {
+    (const void *)&GainInsightInto,
+    (const void *)&ParseHexCode,
+    (const void *)&SetLookupEngine,
+    (const void *)&DecodeAlertInto,
+    (const void *)&OpenInsightDatabase,
+    (const void *)&AppendCrashRecord,
+    (const void *)&QueryCrashHistory,
+    (const void *)&CountAlertCode,
+    (const void *)&SearchInsights,
+    (const void *)&FindNearestCodes,
+    (const void *)&FindInsightNames,
+    (const void *)&BeginPhase,
+    (const void *)&WrapTextInto,
+    (const void *)&DecodeBatch,
+    (const void *)&ParallelDecodeBatch,
+    (const void *)&RunDaemon,
+    (const void *)&PostAlert,
+    (const void *)&DecodeAlertRing,
+    (const void *)&ScanLogToRecords,
+    (const void *)&InsightEntryCount
+};
+
+int main(void)
+{
+    struct ErrorView view;
+    struct AlertDecoding decoding;
+    char insight[INSIGHT_MAX_LENGTH];
+    ULONG code;
+
+    if (ParseHexCode("0x8100000C", &code) != HEX_OK || code != 0x8100000CUL) {
+        std::fprintf(stderr, "FAIL: ParseHexCode\n");
+        return 1;
+    }
+    code = InsightEntryAt(0)->code;
+    if (GainInsightInto(code, &view, insight, sizeof(insight)) < 0 || view.code != code ||
+        !InsightIsKnownCode(code)) {
+        std::fprintf(stderr, "FAIL: GainInsightInto %08lX\n", (unsigned long)code);
+        return 1;
+    }
+    if (DecodeAlertInto(0x8100000CUL, &decoding, insight, sizeof(insight)) == 0 || decoding.code != 0x8100000CUL) {
+        std::fprintf(stderr, "FAIL: DecodeAlertInto\n");
+        return 1;
+    }
+
+    std::printf("cplusplus: %s, %lu entries, %lu modules linked, passed\n", InsightVersionString(),
+                (unsigned long)InsightEntryCount(), (unsigned long)(sizeof(linked) / sizeof(linked[0])));
+
+    return 0;
+}
@@ -0,0 +1,1380 @@
+/*
+ * Insight Daemon
+ *
+ * Both daemons answer a request with ServeLines, which decodes the runs of
+ * code lines between commands with DecodeBatchText into a memory
+ * BatchWriter.  The host daemon serves each connection on its own thread,
+ * answering whatever complete lines have arrived and sending the records
+ * before reading more, so a client can keep many requests in flight.  The
+ * lookup core only reads the database, so the threads share it without
+ * locks.  The Amiga daemon serves the messages put to its port one at a
+ * time and hands each client its records in a block of public memory.
+ *
+ * A reload opens and checks the new file beside the one being served,
+ * then makes it current with one pointer swap.  Each block of requests
+ * pins the version that was current when it started, so lookups in
+ * flight finish on the old version and never wait for the reload.  On
+ * the host the replaced version is kept until no connection is still in
+ * the epoch it was replaced in; the Amiga daemon serves one request at a
+ * time, so it can close the old version at once.
+ *
+ * After meditiation comes... Insight
+ *
+ * Copyright (c) 2025-26 amigazen project
+ * Licensed under BSD 2-Clause License
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "platform.h"
+#ifdef INSIGHT_AMIGA
+#include <exec/memory.h>
+#include <dos/dos.h>
+#include <proto/exec.h>
+#else
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <pthread.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#endif
+#include "error_codes.h"
+#include "idb.h"
+#include "batch.h"
+#include "daemon.h"
+
+/* Request lines that are commands - names are lower case, and end in = if they take a value */
+#define DAEMON_COMMAND_FORMAT      0
+#define DAEMON_COMMAND_RELOAD_FILE 1
+#define DAEMON_COMMAND_RELOAD      2
+#define DAEMON_COMMAND_STATS       3
+#define DAEMON_COMMANDS            4
+
+static const CONST_STRPTR commandNames[DAEMON_COMMANDS] = {
+    "format=", "reload=", "reload", "stats"
+};
+
+static const CONST_STRPTR errorTexts[] = {
+    "no error",
+    "the name is in use or cannot be used",
+    "no daemon is running there",
+    "the connection, input or output failed",
+    "out of memory"
+};
+
+/* Ends of the TSV and JSON records for invalid lines, without the newline */
+#define INVALID_TSV_TAIL  "\tinvalid\t\t"
+#define INVALID_JSON_TAIL "\"match\":\"invalid\"}"
+#define REPLY_TAIL_LENGTH 18      /* The longer of the two */
+
+/* A client's view of the records coming back, to count those for invalid lines */
+struct ReplyScan {
+    char tail[REPLY_TAIL_LENGTH];       /* End of the record read so far */
+    ULONG tailLength;
+    ULONG invalid;
+};
+
+/* One loaded version of the database */
+struct DatabaseVersion {
+    struct DatabaseVersion *next;       /* Next replaced version still waiting to be closed */
+    struct InsightDatabase *database;   /* NULL for the compiled-in tables */
+    char *file;                         /* Where it was loaded from, NULL for the compiled-in tables */
+    BOOL owned;                         /* Opened by a reload, so closed once replaced */
+    ULONG retired;                      /* Epoch it was replaced in */
+};
+
+/* A running daemon */
+struct Daemon {
+    ULONG format;                       /* Record format until a client sends FORMAT= */
+    struct DatabaseVersion *current;    /* Version new requests pin - swapped atomically on the host */
+    struct DatabaseVersion *retired;    /* Replaced versions requests may still be reading */
+    ULONG reloads;
+    ULONG failedReloads;
+#ifndef INSIGHT_AMIGA
+    pthread_mutex_t lock;               /* Guards connections, retired and the reload counts */
+    pthread_cond_t idle;                /* The last connection has closed */
+    struct Connection *connections;     /* Open connections */
+    pthread_mutex_t reloadLock;         /* One reload at a time */
+    ULONG epoch;                        /* Advanced by each reload, never 0 */
+#endif
+};
+
+#ifndef INSIGHT_AMIGA
+/* A client being served by its own thread */
+struct Connection {
+    struct Connection *next;
+    struct Daemon *daemon;
+    int socket;
+    ULONG epoch;                        /* Epoch its current block of requests began in, 0 between blocks */
+};
+
+/* SIGINT and SIGTERM write to this pipe to wake the accept loop, and SIGHUP to reload */
+static int stopPipe[2];
+#endif
+
+/* Forward declarations */
+static ULONG ServeLines(struct Daemon *daemon, struct BatchWriter *writer, const char *text, ULONG length,
+                        BOOL final);
+static LONG FindCommand(const char *line, ULONG length, const char **value, ULONG *valueLength);
+static VOID ServeCommand(struct Daemon *daemon, struct BatchWriter *writer, LONG command, const char *value,
+                         ULONG valueLength, const char *line, ULONG length);
+static BOOL StartVersions(struct Daemon *daemon, ULONG format, CONST_STRPTR file);
+static VOID StopVersions(struct Daemon *daemon, ULONG format, FILE *report);
+static VOID ReloadDatabase(struct Daemon *daemon, struct BatchWriter *writer, const char *file, ULONG fileLength);
+static VOID WriteDaemonStats(struct Daemon *daemon, struct BatchWriter *writer, CONST_STRPTR file,
+                             CONST_STRPTR error);
+static struct DatabaseVersion *CurrentVersion(struct Daemon *daemon);
+static VOID ReplaceVersion(struct Daemon *daemon, struct DatabaseVersion *version);
+static VOID FreeVersion(struct DatabaseVersion *version);
+static VOID ScanReplies(struct ReplyScan *scan, const char *data, ULONG length);
+static BOOL TailIs(const struct ReplyScan *scan, CONST_STRPTR text);
+#ifdef INSIGHT_AMIGA
+static VOID ServeMessage(struct Daemon *daemon, struct BatchWriter *writer, struct DaemonMessage *message);
+static ULONG SendRequest(CONST_STRPTR address, struct DaemonMessage *message, const char *text, ULONG length,
+                         FILE *output, struct ReplyScan *scan);
+#else
+static int ListenAt(CONST_STRPTR address, ULONG *error);
+static int ConnectTo(CONST_STRPTR address);
+static BOOL FillAddress(struct sockaddr_un *name, CONST_STRPTR address);
+static VOID *ServeConnection(VOID *arg);
+static VOID BeginRequests(struct Connection *connection);
+static VOID EndRequests(struct Connection *connection);
+static VOID ReclaimVersions(struct Daemon *daemon);
+static BOOL SendAll(int to, const char *data, ULONG length);
+static VOID StopDaemon(int number);
+#endif
+
+/*
+ * Get a readable message for a RunDaemon or RunDaemonClient error
+ */
+CONST_STRPTR DaemonErrorText(ULONG error)
+{
+    if (error >= sizeof(errorTexts) / sizeof(errorTexts[0])) {
+        return "unknown error";
+    }
+
+    return errorTexts[error];
+}
+
+/*
+ * Answer the lines at the start of a block of request text
+ * Runs of code lines are decoded together, and commands are carried out
+ * between them.  Without final, a last line that lacks its newline is
+ * left for more text to complete.  Returns the bytes of text answered.
+ */
+static ULONG ServeLines(struct Daemon *daemon, struct BatchWriter *writer, const char *text, ULONG length,
+                        BOOL final)
+{
+    struct BatchStats stats;
+    const char *newline;
+    const char *value;
+    ULONG valueLength;
+    ULONG run;
+    ULONG start;
+    ULONG end;
+    LONG command;
+
+    memset(&stats, 0, sizeof(stats));
+    run = 0;
+    start = 0;
+    while (start < length) {
+        newline = (const char *)memchr(text + start, '\n', length - start);
+        if (newline == NULL && !final) {
+            break;
+        }
+        end = (newline != NULL) ? (ULONG)(newline - text) : length;
+
+        command = FindCommand(text + start, end - start, &value, &valueLength);
+        if (command >= 0) {
+            if (start > run) {
+                DecodeBatchText(writer, text + run, start - run, &stats);
+            }
+            ServeCommand(daemon, writer, command, value, valueLength, text + start, end - start);
+            run = (newline != NULL) ? end + 1 : end;
+        }
+
+        start = (newline != NULL) ? end + 1 : end;
+    }
+
+    if (start > run) {
+        DecodeBatchText(writer, text + run, start - run, &stats);
+    }
+
+    return start;
+}
+
+/*
+ * Find which command a request line holds, ignoring case and blanks around it
+ * Returns DAEMON_COMMAND_xxx, with the text after the = in value, or -1
+ * if the line is not a command.
+ */
+static LONG FindCommand(const char *line, ULONG length, const char **value, ULONG *valueLength)
+{
+    CONST_STRPTR name;
+    ULONG i;
+    LONG command;
+
+    while (length > 0 && (*line == ' ' || *line == '\t')) {
+        line++;
+        length--;
+    }
+    while (length > 0 && (line[length - 1] == ' ' || line[length - 1] == '\t' || line[length - 1] == '\r')) {
+        length--;
+    }
+
+    for (command = 0; command < DAEMON_COMMANDS; command++) {
+        name = commandNames[command];
+        i = 0;
+        while (name[i] != '\0' && i < length && (line[i] | 0x20) == name[i]) {
+            i++;
+        }
+        if (name[i] == '\0' && (name[i - 1] == '=' || i == length)) {
+            *value = line + i;
+            *valueLength = length - i;
+            return command;
+        }
+    }
+
+    return -1;
+}
+
+/*
+ * Carry out a command line
+ * A format that cannot be used is answered with an invalid record, like
+ * any other bad line.  A reload is answered with the database record of
+ * the new version, or a record of why the old one is still in use.
+ */
+static VOID ServeCommand(struct Daemon *daemon, struct BatchWriter *writer, LONG command, const char *value,
+                         ULONG valueLength, const char *line, ULONG length)
+{
+    char name[8];
+    LONG format;
+
+    switch (command) {
+        case DAEMON_COMMAND_FORMAT:
+            format = -1;
+            if (valueLength < sizeof(name)) {
+                memcpy(name, value, valueLength);
+                name[valueLength] = '\0';
+                format = FindBatchFormat(name);
+            }
+            if (format < 0) {
+                WriteInvalidRecord(writer, line, length);
+            } else {
+                writer->format = (ULONG)format;
+            }
+            break;
+
+        case DAEMON_COMMAND_RELOAD_FILE:
+        case DAEMON_COMMAND_RELOAD:
+            ReloadDatabase(daemon, writer, value, valueLength);
+            /* The rest of this request is answered from what it asked for */
+            PinInsightDatabase(CurrentVersion(daemon)->database);
+            break;
+
+        case DAEMON_COMMAND_STATS:
+            WriteDaemonStats(daemon, writer, NULL, NULL);
+            break;
+    }
+}
+
+/*
+ * Set up a daemon serving from the database UseInsightDatabase selected
+ * file is where that was loaded from, NULL for the compiled-in tables,
+ * and is what a plain RELOAD reads again.  Returns FALSE if out of memory.
+ */
+static BOOL StartVersions(struct Daemon *daemon, ULONG format, CONST_STRPTR file)
+{
+    struct DatabaseVersion *version;
+
+    memset(daemon, 0, sizeof(struct Daemon));
+    daemon->format = format;
+
+    version = (struct DatabaseVersion *)calloc(1, sizeof(struct DatabaseVersion));
+    if (version == NULL) {
+        return FALSE;
+    }
+    version->database = ActiveInsightDatabase();
+    if (file != NULL && version->database != NULL) {
+        version->file = (char *)malloc(strlen(file) + 1);
+        if (version->file == NULL) {
+            free(version);
+            return FALSE;
+        }
+        strcpy(version->file, file);
+    }
+    daemon->current = version;
+
+#ifndef INSIGHT_AMIGA
+    pthread_mutex_init(&daemon->lock, NULL);
+    pthread_cond_init(&daemon->idle, NULL);
+    pthread_mutex_init(&daemon->reloadLock, NULL);
+    daemon->epoch = 1;
+#endif
+
+    return TRUE;
+}
+
+/*
+ * Close every version a stopped daemon loaded
+ * The database the daemon started with belongs to the caller and is left
+ * open.  The last database record is written to report, if there is one.
+ */
+static VOID StopVersions(struct Daemon *daemon, ULONG format, FILE *report)
+{
+    struct DatabaseVersion *version;
+    struct BatchWriter writer;
+
+    if (report != NULL && OpenBatchWriter(&writer, report, format)) {
+        WriteDaemonStats(daemon, &writer, NULL, NULL);
+        CloseBatchWriter(&writer);
+    }
+
+    UnpinInsightDatabase();
+    while (daemon->retired != NULL) {
+        version = daemon->retired;
+        daemon->retired = version->next;
+        FreeVersion(version);
+    }
+    FreeVersion(daemon->current);
+    daemon->current = NULL;
+
+#ifndef INSIGHT_AMIGA
+    pthread_mutex_destroy(&daemon->reloadLock);
+    pthread_cond_destroy(&daemon->idle);
+    pthread_mutex_destroy(&daemon->lock);
+#endif
+}
+
+/*
+ * Load a database file and make it the one new requests are served from
+ * With no file, the file of the current version is read again.  The
+ * file is opened and checked in full before anything changes, so a bad
+ * file leaves the current version serving.  The outcome is written to
+ * writer when there is one.
+ */
+static VOID ReloadDatabase(struct Daemon *daemon, struct BatchWriter *writer, const char *file, ULONG fileLength)
+{
+    struct DatabaseVersion *version;
+    CONST_STRPTR error;
+    ULONG failure;
+
+#ifndef INSIGHT_AMIGA
+    pthread_mutex_lock(&daemon->reloadLock);
+#endif
+
+    error = NULL;
+    version = (struct DatabaseVersion *)calloc(1, sizeof(struct DatabaseVersion));
+    if (version == NULL) {
+        error = DaemonErrorText(DAEMON_ERROR_MEMORY);
+    } else if (fileLength == 0 && daemon->current->file == NULL) {
+        error = "no database file to reload";
+    } else {
+        /* Only reloads change current, so it cannot go while this one runs */
+        if (fileLength == 0) {
+            file = daemon->current->file;
+            fileLength = (ULONG)strlen(file);
+        }
+        version->file = (char *)malloc(fileLength + 1);
+        if (version->file == NULL) {
+            error = DaemonErrorText(DAEMON_ERROR_MEMORY);
+        } else {
+            memcpy(version->file, file, fileLength);
+            version->file[fileLength] = '\0';
+            /* A copy, so the file can be overwritten under a running daemon */
+            version->database = OpenInsightDatabase(version->file, IDB_PRIVATE_COPY, &failure);
+            if (version->database == NULL) {
+                error = IdbErrorText(failure);
+            }
+        }
+    }
+
+    if (error == NULL) {
+        version->owned = TRUE;
+        ReplaceVersion(daemon, version);
+        if (writer != NULL) {
+            WriteDaemonStats(daemon, writer, NULL, NULL);
+        }
+    } else {
+#ifndef INSIGHT_AMIGA
+        pthread_mutex_lock(&daemon->lock);
+#endif
+        daemon->failedReloads++;
+#ifndef INSIGHT_AMIGA
+        pthread_mutex_unlock(&daemon->lock);
+#endif
+        if (writer != NULL) {
+            WriteDaemonStats(daemon, writer, (version != NULL && version->file != NULL) ? version->file : "", error);
+        }
+        FreeVersion(version);
+    }
+
+#ifndef INSIGHT_AMIGA
+    pthread_mutex_unlock(&daemon->reloadLock);
+#endif
+}
+
+/*
+ * Write the database record of the current version, or why a reload of file failed
+ */
+static VOID WriteDaemonStats(struct Daemon *daemon, struct BatchWriter *writer, CONST_STRPTR file,
+                             CONST_STRPTR error)
+{
+    struct DatabaseStats stats;
+    struct DatabaseVersion *version;
+
+#ifndef INSIGHT_AMIGA
+    /* Holding the lock keeps a version replaced meanwhile from being closed */
+    pthread_mutex_lock(&daemon->lock);
+#endif
+    version = CurrentVersion(daemon);
+    stats.file = (error != NULL) ? file : version->file;
+    stats.version = 0;
+    stats.entries = ERROR_TABLE_SIZE - 1;
+    stats.checksum = 0;
+    if (version->database != NULL) {
+        stats.version = version->database->version;
+        stats.entries = version->database->entryCount;
+        stats.checksum = version->database->checksum;
+    }
+    stats.reloads = daemon->reloads;
+    stats.failedReloads = daemon->failedReloads;
+
+    WriteDatabaseRecord(writer, &stats, error);
+#ifndef INSIGHT_AMIGA
+    pthread_mutex_unlock(&daemon->lock);
+#endif
+}
+
+/*
+ * Close a version of the database, if the daemon opened it, and free it
+ */
+static VOID FreeVersion(struct DatabaseVersion *version)
+{
+    if (version == NULL) {
+        return;
+    }
+
+    if (version->owned) {
+        CloseInsightDatabase(version->database);
+    }
+    free(version->file);
+    free(version);
+}
+
+/*
+ * Count the records for invalid lines in a piece of the daemon's replies
+ * Records may be split anywhere between pieces, so the end of the last
+ * unfinished one is kept.
+ */
+static VOID ScanReplies(struct ReplyScan *scan, const char *data, ULONG length)
+{
+    const char *newline;
+    ULONG start;
+    ULONG end;
+    ULONG piece;
+    ULONG keep;
+
+    start = 0;
+    while (start < length) {
+        newline = (const char *)memchr(data + start, '\n', length - start);
+        end = (newline != NULL) ? (ULONG)(newline - data) : length;
+
+        piece = end - start;
+        if (piece >= REPLY_TAIL_LENGTH) {
+            memcpy(scan->tail, data + end - REPLY_TAIL_LENGTH, REPLY_TAIL_LENGTH);
+            scan->tailLength = REPLY_TAIL_LENGTH;
+        } else {
+            keep = REPLY_TAIL_LENGTH - piece;
+            if (keep > scan->tailLength) {
+                keep = scan->tailLength;
+            }
+            memmove(scan->tail, scan->tail + scan->tailLength - keep, keep);
+            memcpy(scan->tail + keep, data + start, piece);
+            scan->tailLength = keep + piece;
+        }
+
+        if (newline == NULL) {
+            break;
+        }
+        /* FORMAT= lines in the input can switch formats midway, so either record counts */
+        if (TailIs(scan, INVALID_TSV_TAIL) || TailIs(scan, INVALID_JSON_TAIL)) {
+            scan->invalid++;
+        }
+        scan->tailLength = 0;
+        start = end + 1;
+    }
+}
+
+/*
+ * Check whether the record read so far ends with text
+ */
+static BOOL TailIs(const struct ReplyScan *scan, CONST_STRPTR text)
+{
+    ULONG length = (ULONG)strlen(text);
+
+    return (BOOL)(scan->tailLength >= length && memcmp(scan->tail + scan->tailLength - length, text, length) == 0);
+}
+
+#ifdef INSIGHT_AMIGA
+
+/*
+ * Serve requests put to a public message port until Ctrl-C
+ * Fails if a port of that name already exists.  Ctrl-F reloads the
+ * database file.  Requests that arrive while the daemon stops are turned
+ * away with DAEMON_ERROR_CONNECT.
+ */
+ULONG RunDaemon(CONST_STRPTR address, ULONG format, CONST_STRPTR file, FILE *report)
+{
+    struct Daemon daemon;
+    struct BatchWriter writer;
+    struct DaemonMessage *message;
+    struct MsgPort *port;
+    ULONG signals;
+
+    if (!StartVersions(&daemon, format, file)) {
+        return DAEMON_ERROR_MEMORY;
+    }
+    if (!OpenBatchWriter(&writer, NULL, format)) {
+        StopVersions(&daemon, format, NULL);
+        return DAEMON_ERROR_MEMORY;
+    }
+    port = CreateMsgPort();
+    if (port == NULL) {
+        CloseBatchWriter(&writer);
+        StopVersions(&daemon, format, NULL);
+        return DAEMON_ERROR_MEMORY;
+    }
+    port->mp_Node.ln_Name = (char *)address;
+    port->mp_Node.ln_Pri = 0;
+
+    /* Only one port may have the name */
+    Forbid();
+    if (FindPort((STRPTR)address) != NULL) {
+        Permit();
+        DeleteMsgPort(port);
+        CloseBatchWriter(&writer);
+        StopVersions(&daemon, format, NULL);
+        return DAEMON_ERROR_ADDRESS;
+    }
+    AddPort(port);
+    Permit();
+
+    do {
+        signals = Wait((1UL << port->mp_SigBit) | SIGBREAKF_CTRL_C | SIGBREAKF_CTRL_F);
+        if ((signals & SIGBREAKF_CTRL_F) != 0) {
+            ReloadDatabase(&daemon, NULL, NULL, 0);
+        }
+        while ((message = (struct DaemonMessage *)GetMsg(port)) != NULL) {
+            ServeMessage(&daemon, &writer, message);
+            ReplyMsg(&message->message);
+        }
+    } while ((signals & SIGBREAKF_CTRL_C) == 0);
+
+    Forbid();
+    RemPort(port);
+    while ((message = (struct DaemonMessage *)GetMsg(port)) != NULL) {
+        message->reply = NULL;
+        message->replyLength = 0;
+        message->error = DAEMON_ERROR_CONNECT;
+        ReplyMsg(&message->message);
+    }
+    Permit();
+
+    DeleteMsgPort(port);
+    CloseBatchWriter(&writer);
+    StopVersions(&daemon, format, report);
+
+    return DAEMON_OK;
+}
+
+/*
+ * Send lines of codes to the daemon at a port and write its records to output
+ * With no input, codes is sent instead.  Input is sent a block of whole
+ * lines at a time.  *invalid is set to the number of lines that were not
+ * alert codes.
+ */
+ULONG RunDaemonClient(CONST_STRPTR address, ULONG format, FILE *input, CONST_STRPTR codes, FILE *output,
+                      ULONG *invalid)
+{
+    struct DaemonMessage message;
+    struct ReplyScan scan;
+    struct MsgPort *replyPort;
+    char *buffer;
+    char *newline;
+    ULONG start;
+    ULONG end;
+    ULONG last;
+    ULONG got;
+    ULONG error;
+    BOOL endOfInput;
+    BOOL skipping;
+
+    *invalid = 0;
+    replyPort = CreateMsgPort();
+    if (replyPort == NULL) {
+        return DAEMON_ERROR_MEMORY;
+    }
+    memset(&message, 0, sizeof(message));
+    message.message.mn_Node.ln_Type = NT_MESSAGE;
+    message.message.mn_ReplyPort = replyPort;
+    message.message.mn_Length = sizeof(struct DaemonMessage);
+    message.format = format;
+    scan.tailLength = 0;
+    scan.invalid = 0;
+
+    if (input == NULL) {
+        error = SendRequest(address, &message, codes, (ULONG)strlen(codes), output, &scan);
+        DeleteMsgPort(replyPort);
+        *invalid = scan.invalid;
+        return error;
+    }
+
+    buffer = (char *)malloc(BATCH_BUFFER_SIZE);
+    if (buffer == NULL) {
+        DeleteMsgPort(replyPort);
+        return DAEMON_ERROR_MEMORY;
+    }
+
+    end = 0;
+    endOfInput = FALSE;
+    skipping = FALSE;
+    error = DAEMON_OK;
+    while (error == DAEMON_OK && !endOfInput) {
+        got = (ULONG)fread(buffer + end, 1, BATCH_BUFFER_SIZE - end, input);
+        if (got == 0) {
+            if (ferror(input)) {
+                error = DAEMON_ERROR_IO;
+                break;
+            }
+            endOfInput = TRUE;
+        }
+        end += got;
+
+        start = 0;
+        if (skipping) {
+            /* Tail of an overlong line that was already sent */
+            newline = (char *)memchr(buffer, '\n', end);
+            start = (newline != NULL) ? (ULONG)(newline - buffer) + 1 : end;
+            skipping = (BOOL)(newline == NULL);
+        }
+
+        last = end;
+        if (!endOfInput) {
+            while (last > start && buffer[last - 1] != '\n') {
+                last--;
+            }
+        }
+        if (last == 0 && end == BATCH_BUFFER_SIZE) {
+            /* A line longer than the whole block is sent on its own, to be answered as invalid */
+            last = end;
+            skipping = TRUE;
+        }
+
+        if (last > start) {
+            error = SendRequest(address, &message, buffer + start, last - start, output, &scan);
+        }
+        memmove(buffer, buffer + last, end - last);
+        end -= last;
+    }
+
+    free(buffer);
+    DeleteMsgPort(replyPort);
+
+    *invalid = scan.invalid;
+    return error;
+}
+
+/*
+ * Answer one request message with a block of records
+ */
+static VOID ServeMessage(struct Daemon *daemon, struct BatchWriter *writer, struct DaemonMessage *message)
+{
+    message->reply = NULL;
+    message->replyLength = 0;
+    message->error = DAEMON_OK;
+
+    writer->format = (message->format < BATCH_FORMATS) ? message->format : BATCH_FORMAT_TSV;
+    writer->used = 0;
+    writer->failed = FALSE;
+    PinInsightDatabase(daemon->current->database);
+    ServeLines(daemon, writer, message->request, message->requestLength, TRUE);
+    if (writer->failed) {
+        message->error = DAEMON_ERROR_MEMORY;
+        return;
+    }
+
+    if (writer->used > 0) {
+        message->reply = (char *)AllocVec(writer->used, MEMF_PUBLIC);
+        if (message->reply == NULL) {
+            message->error = DAEMON_ERROR_MEMORY;
+            return;
+        }
+        CopyMem(writer->buffer, message->reply, writer->used);
+        message->replyLength = writer->used;
+    }
+}
+
+/*
+ * Put one request to the daemon's port, wait for the reply and write its records
+ * The port is looked up each time, as the daemon may have stopped.
+ */
+static ULONG SendRequest(CONST_STRPTR address, struct DaemonMessage *message, const char *text, ULONG length,
+                         FILE *output, struct ReplyScan *scan)
+{
+    struct MsgPort *port;
+    ULONG error;
+
+    message->request = text;
+    message->requestLength = length;
+    message->reply = NULL;
+    message->replyLength = 0;
+    message->error = DAEMON_OK;
+
+    Forbid();
+    port = FindPort((STRPTR)address);
+    if (port != NULL) {
+        PutMsg(port, &message->message);
+    }
+    Permit();
+    if (port == NULL) {
+        return DAEMON_ERROR_CONNECT;
+    }
+
+    WaitPort(message->message.mn_ReplyPort);
+    GetMsg(message->message.mn_ReplyPort);
+
+    error = message->error;
+    if (message->reply != NULL) {
+        if (error == DAEMON_OK &&
+            fwrite(message->reply, 1, message->replyLength, output) != message->replyLength) {
+            error = DAEMON_ERROR_IO;
+        }
+        ScanReplies(scan, message->reply, message->replyLength);
+        FreeVec(message->reply);
+    }
+
+    return error;
+}
+
+/*
+ * Find the version new requests are served from
+ */
+static struct DatabaseVersion *CurrentVersion(struct Daemon *daemon)
+{
+    return daemon->current;
+}
+
+/*
+ * Make a newly loaded version current and close the one it replaces
+ * Requests are served one at a time on this task, so none can still be
+ * reading the old version.
+ */
+static VOID ReplaceVersion(struct Daemon *daemon, struct DatabaseVersion *version)
+{
+    struct DatabaseVersion *old;
+
+    old = daemon->current;
+    daemon->current = version;
+    daemon->reloads++;
+    PinInsightDatabase(version->database);
+    FreeVersion(old);
+}
+
+#else /* host build */
+
+/*
+ * Serve connections to a Unix domain socket until SIGINT or SIGTERM
+ * SIGHUP reloads the database file.  The socket file is removed when the
+ * daemon stops, after the clients still connected have been cut off and
+ * their threads have finished.
+ */
+ULONG RunDaemon(CONST_STRPTR address, ULONG format, CONST_STRPTR file, FILE *report)
+{
+    struct Daemon daemon;
+    struct Connection *connection;
+    struct sigaction action;
+    struct sigaction oldInterrupt;
+    struct sigaction oldTerminate;
+    struct sigaction oldHangUp;
+    struct sigaction oldPipe;
+    struct pollfd waits[2];
+    pthread_t thread;
+    ULONG error;
+    int listener;
+    int client;
+    char number;
+
+    if (!StartVersions(&daemon, format, file)) {
+        return DAEMON_ERROR_MEMORY;
+    }
+    listener = ListenAt(address, &error);
+    if (listener < 0) {
+        StopVersions(&daemon, format, NULL);
+        return error;
+    }
+    if (pipe(stopPipe) != 0) {
+        close(listener);
+        unlink(address);
+        StopVersions(&daemon, format, NULL);
+        return DAEMON_ERROR_IO;
+    }
+
+    /* Clients that hang up early must not kill the daemon with SIGPIPE */
+    memset(&action, 0, sizeof(action));
+    sigemptyset(&action.sa_mask);
+    action.sa_handler = StopDaemon;
+    sigaction(SIGINT, &action, &oldInterrupt);
+    sigaction(SIGTERM, &action, &oldTerminate);
+    sigaction(SIGHUP, &action, &oldHangUp);
+    action.sa_handler = SIG_IGN;
+    sigaction(SIGPIPE, &action, &oldPipe);
+
+    waits[0].fd = listener;
+    waits[0].events = POLLIN;
+    waits[1].fd = stopPipe[0];
+    waits[1].events = POLLIN;
+    error = DAEMON_OK;
+    for (;;) {
+        if (poll(waits, 2, -1) < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            error = DAEMON_ERROR_IO;
+            break;
+        }
+        if (waits[1].revents != 0) {
+            if (read(stopPipe[0], &number, 1) == 1 && number == SIGHUP) {
+                ReloadDatabase(&daemon, NULL, NULL, 0);
+                continue;
+            }
+            break;
+        }
+        if ((waits[0].revents & POLLIN) == 0) {
+            continue;
+        }
+
+        client = accept(listener, NULL, NULL);
+        if (client < 0) {
+            continue;
+        }
+        connection = (struct Connection *)malloc(sizeof(struct Connection));
+        if (connection == NULL) {
+            close(client);
+            continue;
+        }
+        connection->daemon = &daemon;
+        connection->socket = client;
+        connection->epoch = 0;
+
+        /* Listed before its thread starts, as the thread unlists itself */
+        pthread_mutex_lock(&daemon.lock);
+        connection->next = daemon.connections;
+        daemon.connections = connection;
+        pthread_mutex_unlock(&daemon.lock);
+
+        if (pthread_create(&thread, NULL, ServeConnection, connection) != 0) {
+            pthread_mutex_lock(&daemon.lock);
+            daemon.connections = connection->next;
+            pthread_mutex_unlock(&daemon.lock);
+            close(client);
+            free(connection);
+        } else {
+            pthread_detach(thread);
+        }
+    }
+
+    close(listener);
+    unlink(address);
+
+    pthread_mutex_lock(&daemon.lock);
+    for (connection = daemon.connections; connection != NULL; connection = connection->next) {
+        shutdown(connection->socket, SHUT_RDWR);
+    }
+    while (daemon.connections != NULL) {
+        pthread_cond_wait(&daemon.idle, &daemon.lock);
+    }
+    pthread_mutex_unlock(&daemon.lock);
+
+    sigaction(SIGINT, &oldInterrupt, NULL);
+    sigaction(SIGTERM, &oldTerminate, NULL);
+    sigaction(SIGHUP, &oldHangUp, NULL);
+    sigaction(SIGPIPE, &oldPipe, NULL);
+    close(stopPipe[0]);
+    close(stopPipe[1]);
+
+    StopVersions(&daemon, format, report);
+
+    return error;
+}
+
+/*
+ * Send lines of codes to the daemon at a socket and write its records to output
+ * With no input, codes is sent instead.  The request is sent while the
+ * records are read back, so neither side waits on the other however
+ * long the input is.  *invalid is set to the number of lines that were
+ * not alert codes.
+ */
+ULONG RunDaemonClient(CONST_STRPTR address, ULONG format, FILE *input, CONST_STRPTR codes, FILE *output,
+                      ULONG *invalid)
+{
+    struct ReplyScan scan;
+    struct sigaction action;
+    struct sigaction oldPipe;
+    struct pollfd waits[2];
+    char *request;
+    char *reply;
+    ULONG sent;
+    ULONG queued;
+    ULONG length;
+    ULONG error;
+    ssize_t got;
+    int server;
+    BOOL inputDone;
+    BOOL requestDone;
+
+    *invalid = 0;
+    request = (char *)malloc(BATCH_BUFFER_SIZE);
+    reply = (char *)malloc(BATCH_BUFFER_SIZE);
+    if (request == NULL || reply == NULL) {
+        free(request);
+        free(reply);
+        return DAEMON_ERROR_MEMORY;
+    }
+
+    server = ConnectTo(address);
+    if (server < 0) {
+        free(request);
+        free(reply);
+        return DAEMON_ERROR_CONNECT;
+    }
+    fcntl(server, F_SETFL, fcntl(server, F_GETFL) | O_NONBLOCK);
+
+    memset(&action, 0, sizeof(action));
+    sigemptyset(&action.sa_mask);
+    action.sa_handler = SIG_IGN;
+    sigaction(SIGPIPE, &action, &oldPipe);
+
+    /* Records come back in the client's format, whatever the daemon's default */
+    strcpy(request, (format == BATCH_FORMAT_JSON) ? "FORMAT=JSON\n" : "FORMAT=TSV\n");
+    queued = (ULONG)strlen(request);
+    inputDone = (BOOL)(input == NULL);
+    if (input == NULL) {
+        length = (ULONG)strlen(codes);
+        if (length > BATCH_BUFFER_SIZE - queued - 1) {
+            length = BATCH_BUFFER_SIZE - queued - 1;
+        }
+        memcpy(request + queued, codes, length);
+        queued += length;
+        request[queued++] = '\n';
+    }
+
+    sent = 0;
+    requestDone = FALSE;
+    scan.tailLength = 0;
+    scan.invalid = 0;
+    error = DAEMON_OK;
+    for (;;) {
+        if (inputDone && sent == queued && !requestDone) {
+            shutdown(server, SHUT_WR);
+            requestDone = TRUE;
+        }
+
+        waits[0].fd = server;
+        waits[0].events = (short)(POLLIN | ((sent < queued) ? POLLOUT : 0));
+        waits[1].fd = (input != NULL && !inputDone && sent == queued) ? fileno(input) : -1;
+        waits[1].events = POLLIN;
+        waits[1].revents = 0;
+        if (poll(waits, 2, -1) < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            error = DAEMON_ERROR_IO;
+            break;
+        }
+
+        if (waits[1].revents != 0) {
+            got = read(waits[1].fd, request, BATCH_BUFFER_SIZE);
+            if (got < 0 && errno != EINTR) {
+                error = DAEMON_ERROR_IO;
+                break;
+            }
+            sent = 0;
+            queued = (got > 0) ? (ULONG)got : 0;
+            inputDone = (BOOL)(got == 0);
+        }
+
+        if ((waits[0].revents & POLLOUT) != 0) {
+            got = send(server, request + sent, queued - sent, 0);
+            if (got < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+                error = DAEMON_ERROR_IO;
+                break;
+            }
+            if (got > 0) {
+                sent += (ULONG)got;
+            }
+        }
+
+        if ((waits[0].revents & (POLLIN | POLLHUP | POLLERR)) != 0) {
+            got = recv(server, reply, BATCH_BUFFER_SIZE, 0);
+            if (got < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)) {
+                continue;
+            }
+            if (got <= 0) {
+                /* The daemon only hangs up first if it failed or stopped */
+                if (got < 0 || !requestDone) {
+                    error = DAEMON_ERROR_IO;
+                }
+                break;
+            }
+            if (fwrite(reply, 1, (size_t)got, output) != (size_t)got) {
+                error = DAEMON_ERROR_IO;
+                break;
+            }
+            ScanReplies(&scan, reply, (ULONG)got);
+        }
+    }
+
+    if (fflush(output) != 0 && error == DAEMON_OK) {
+        error = DAEMON_ERROR_IO;
+    }
+
+    sigaction(SIGPIPE, &oldPipe, NULL);
+    close(server);
+    free(request);
+    free(reply);
+
+    *invalid = scan.invalid;
+    return error;
+}
+
+/*
+ * Make a listening socket at a path
+ * A socket file left by a daemon that is no longer running is replaced;
+ * one that still answers, or any other kind of file, is not.  Returns -1
+ * with error set on failure.
+ */
+static int ListenAt(CONST_STRPTR address, ULONG *error)
+{
+    struct sockaddr_un name;
+    struct stat status;
+    int listener;
+    int probe;
+    BOOL bound;
+
+    *error = DAEMON_ERROR_ADDRESS;
+    if (!FillAddress(&name, address)) {
+        return -1;
+    }
+
+    listener = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listener < 0) {
+        *error = DAEMON_ERROR_IO;
+        return -1;
+    }
+
+    bound = (BOOL)(bind(listener, (struct sockaddr *)&name, sizeof(name)) == 0);
+    if (!bound && errno == EADDRINUSE && lstat(address, &status) == 0 && S_ISSOCK(status.st_mode)) {
+        probe = ConnectTo(address);
+        if (probe >= 0) {
+            close(probe);
+        } else if (unlink(address) == 0) {
+            bound = (BOOL)(bind(listener, (struct sockaddr *)&name, sizeof(name)) == 0);
+        }
+    }
+    if (!bound) {
+        close(listener);
+        return -1;
+    }
+
+    if (listen(listener, DAEMON_BACKLOG) != 0) {
+        close(listener);
+        unlink(address);
+        return -1;
+    }
+
+    return listener;
+}
+
+/*
+ * Connect to the socket at a path
+ * Returns -1 if no daemon answers there.
+ */
+static int ConnectTo(CONST_STRPTR address)
+{
+    struct sockaddr_un name;
+    int server;
+
+    if (!FillAddress(&name, address)) {
+        return -1;
+    }
+
+    server = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (server < 0) {
+        return -1;
+    }
+    if (connect(server, (struct sockaddr *)&name, sizeof(name)) != 0) {
+        close(server);
+        return -1;
+    }
+
+    return server;
+}
+
+/*
+ * Fill in a socket address for a path
+ * Returns FALSE if the path is too long for one.
+ */
+static BOOL FillAddress(struct sockaddr_un *name, CONST_STRPTR address)
+{
+    memset(name, 0, sizeof(struct sockaddr_un));
+    name->sun_family = AF_UNIX;
+    if (strlen(address) >= sizeof(name->sun_path)) {
+        return FALSE;
+    }
+    strcpy(name->sun_path, address);
+
+    return TRUE;
+}
+
+/*
+ * Connection thread - answer a client's lines until it hangs up
+ * Each read is answered in full before the next, so replies keep pace
+ * with a client that waits for each one as well as with one that sends
+ * everything first.
+ */
+static VOID *ServeConnection(VOID *arg)
+{
+    struct Connection *connection = (struct Connection *)arg;
+    struct Daemon *daemon = connection->daemon;
+    struct Connection **link;
+    struct BatchWriter writer;
+    char *buffer;
+    char *newline;
+    ULONG start;
+    ULONG end;
+    ssize_t got;
+    BOOL final;
+    BOOL skipping;
+
+    buffer = (char *)malloc(BATCH_BUFFER_SIZE);
+    if (buffer != NULL && OpenBatchWriter(&writer, NULL, daemon->format)) {
+        end = 0;
+        final = FALSE;
+        skipping = FALSE;
+        while (!final) {
+            got = recv(connection->socket, buffer + end, BATCH_BUFFER_SIZE - end, 0);
+            if (got < 0 && errno == EINTR) {
+                continue;
+            }
+            if (got <= 0) {
+                final = TRUE;
+            } else {
+                end += (ULONG)got;
+            }
+
+            start = 0;
+            if (skipping) {
+                /* Tail of an overlong line that was already answered */
+                newline = (char *)memchr(buffer, '\n', end);
+                start = (newline != NULL) ? (ULONG)(newline - buffer) + 1 : end;
+                skipping = (BOOL)(newline == NULL);
+            }
+            BeginRequests(connection);
+            start += ServeLines(daemon, &writer, buffer + start, end - start, final);
+            EndRequests(connection);
+            memmove(buffer, buffer + start, end - start);
+            end -= start;
+            if (end == BATCH_BUFFER_SIZE) {
+                /* A line longer than the whole block cannot be an alert code */
+                WriteInvalidRecord(&writer, buffer, end);
+                end = 0;
+                skipping = TRUE;
+            }
+
+            if (writer.failed || !SendAll(connection->socket, writer.buffer, writer.used)) {
+                break;
+            }
+            writer.used = 0;
+        }
+        CloseBatchWriter(&writer);
+    }
+    free(buffer);
+
+    pthread_mutex_lock(&daemon->lock);
+    link = &daemon->connections;
+    while (*link != connection) {
+        link = &(*link)->next;
+    }
+    *link = connection->next;
+    close(connection->socket);
+    if (daemon->connections == NULL) {
+        pthread_cond_signal(&daemon->idle);
+    }
+    pthread_mutex_unlock(&daemon->lock);
+
+    free(connection);
+
+    return NULL;
+}
+
+/*
+ * Enter the current epoch and pin the current version for a block of requests
+ * The epoch is published before current is read, so a reload that
+ * replaces the version after that read sees the epoch and keeps the
+ * version until the block ends.
+ */
+static VOID BeginRequests(struct Connection *connection)
+{
+    struct Daemon *daemon = connection->daemon;
+
+    __atomic_store_n(&connection->epoch, __atomic_load_n(&daemon->epoch, __ATOMIC_SEQ_CST), __ATOMIC_SEQ_CST);
+    PinInsightDatabase(CurrentVersion(daemon)->database);
+}
+
+/*
+ * Leave the epoch once a block of requests has been answered
+ * The records are copies, so nothing is read from the version while they
+ * are sent.  Versions replaced meanwhile are closed if no one needs them.
+ */
+static VOID EndRequests(struct Connection *connection)
+{
+    struct Daemon *daemon = connection->daemon;
+
+    __atomic_store_n(&connection->epoch, 0, __ATOMIC_SEQ_CST);
+    if (__atomic_load_n(&daemon->retired, __ATOMIC_SEQ_CST) != NULL) {
+        ReclaimVersions(daemon);
+    }
+}
+
+/*
+ * Find the version new requests are served from
+ */
+static struct DatabaseVersion *CurrentVersion(struct Daemon *daemon)
+{
+    return __atomic_load_n(&daemon->current, __ATOMIC_SEQ_CST);
+}
+
+/*
+ * Make a newly loaded version current and retire the one it replaces
+ * Requests that began before the swap may still be reading the old
+ * version, so it is only closed once every connection has left the
+ * epochs before the one the swap starts.
+ */
+static VOID ReplaceVersion(struct Daemon *daemon, struct DatabaseVersion *version)
+{
+    struct DatabaseVersion *old;
+
+    pthread_mutex_lock(&daemon->lock);
+    old = __atomic_exchange_n(&daemon->current, version, __ATOMIC_SEQ_CST);
+    old->retired = __atomic_add_fetch(&daemon->epoch, 1, __ATOMIC_SEQ_CST);
+    old->next = daemon->retired;
+    __atomic_store_n(&daemon->retired, old, __ATOMIC_SEQ_CST);
+    daemon->reloads++;
+    pthread_mutex_unlock(&daemon->lock);
+
+    ReclaimVersions(daemon);
+}
+
+/*
+ * Close the retired versions no connection can still be reading
+ * A version retired in epoch n is free once every connection is between
+ * blocks or began its block in epoch n or later, as those blocks pinned
+ * a later version.
+ */
+static VOID ReclaimVersions(struct Daemon *daemon)
+{
+    struct DatabaseVersion *version;
+    struct DatabaseVersion *next;
+    struct DatabaseVersion *kept;
+    struct Connection *connection;
+    ULONG oldest;
+    ULONG epoch;
+
+    pthread_mutex_lock(&daemon->lock);
+    oldest = __atomic_load_n(&daemon->epoch, __ATOMIC_SEQ_CST);
+    for (connection = daemon->connections; connection != NULL; connection = connection->next) {
+        epoch = __atomic_load_n(&connection->epoch, __ATOMIC_SEQ_CST);
+        if (epoch != 0 && epoch < oldest) {
+            oldest = epoch;
+        }
+    }
+
+    kept = NULL;
+    for (version = daemon->retired; version != NULL; version = next) {
+        next = version->next;
+        if (version->retired <= oldest) {
+            FreeVersion(version);
+        } else {
+            version->next = kept;
+            kept = version;
+        }
+    }
+    __atomic_store_n(&daemon->retired, kept, __ATOMIC_SEQ_CST);
+    pthread_mutex_unlock(&daemon->lock);
+}
+
+/*
+ * Send a whole block to a socket
+ * Returns FALSE if the client has gone.
+ */
+static BOOL SendAll(int to, const char *data, ULONG length)
+{
+    ssize_t sent;
+
+    while (length > 0) {
+        sent = send(to, data, length, 0);
+        if (sent < 0 && errno == EINTR) {
+            continue;
+        }
+        if (sent <= 0) {
+            return FALSE;
+        }
+        data += sent;
+        length -= (ULONG)sent;
+    }
+
+    return TRUE;
+}
+
+/*
+ * SIGINT, SIGTERM and SIGHUP handler - wake the accept loop to stop or reload
+ */
+static VOID StopDaemon(int number)
+{
+    char stop;
+
+    stop = (char)number;
+    if (write(stopPipe[1], &stop, 1) < 0) {
+        /* The pipe is full, so the loop is already woken */
+    }
+}
+
+#endif /* INSIGHT_AMIGA */
@@ -0,0 +1,101 @@
+/*
+ * Insight Daemon
+ *
+ * Keeps the database resident and answers lookups for other processes, so
+ * a script that decodes codes one at a time pays for starting Insight and
+ * loading the database once.  The host daemon listens on a Unix domain
+ * socket and the Amiga one on a public message port.  Requests are the
+ * lines FROM reads and replies the records it writes.  A new database
+ * file can be loaded while it runs, without a restart and without
+ * holding up lookups.
+ *
+ * After meditiation comes... Insight
+ *
+ * Copyright (c) 2025-26 amigazen project
+ * Licensed under BSD 2-Clause License
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef DAEMON_H
+#define DAEMON_H
+
+#include <stdio.h>
+#include "platform.h"
+#ifdef INSIGHT_AMIGA
+#include <exec/ports.h>
+#endif
+#include "batch.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Protocol - the client sends lines and reads one record back for each:
+ *   an alert code, as FROM reads it    its record, as FROM writes it
+ *   FORMAT=TSV or FORMAT=JSON          nothing - later records use that format
+ *   STATS                              the database record: file, version,
+ *                                      entries, checksum and reload counts
+ *   RELOAD or RELOAD=file              the database record once the file, or
+ *                                      the one being served, is in use - or a
+ *                                      reload record with the reason it is not
+ * Blank lines are skipped.  Requests may be pipelined: the daemon answers
+ * the complete lines that have arrived, in order, without waiting for more.
+ * SIGHUP on the host and Ctrl-F on the Amiga reload the file too.
+ */
+
+/* Connections the host daemon lets wait to be accepted */
+#define DAEMON_BACKLOG 64
+
+/* RunDaemon and RunDaemonClient results */
+#define DAEMON_OK            0
+#define DAEMON_ERROR_ADDRESS 1   /* The socket or port name is taken or cannot be used */
+#define DAEMON_ERROR_CONNECT 2   /* No daemon answers at that name */
+#define DAEMON_ERROR_IO      3   /* Reading the input, writing the output or the connection failed */
+#define DAEMON_ERROR_MEMORY  4
+
+#ifdef INSIGHT_AMIGA
+/* A request put to the daemon's port - the whole text is answered at once */
+struct DaemonMessage {
+    struct Message message;
+    ULONG format;            /* BATCH_FORMAT_xxx of the records */
+    const char *request;     /* Lines, the last of which may lack its newline */
+    ULONG requestLength;
+    char *reply;             /* Records in MEMF_PUBLIC memory, NULL if none - the client FreeVecs it */
+    ULONG replyLength;
+    ULONG error;             /* DAEMON_OK or DAEMON_ERROR_xxx */
+};
+#endif
+
+/* Function declarations */
+ULONG RunDaemon(CONST_STRPTR address, ULONG format, CONST_STRPTR file, FILE *report);
+ULONG RunDaemonClient(CONST_STRPTR address, ULONG format, FILE *input, CONST_STRPTR codes, FILE *output,
+                      ULONG *invalid);
+CONST_STRPTR DaemonErrorText(ULONG error);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* DAEMON_H */
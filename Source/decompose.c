@@ -0,0 +1,426 @@
+/*
+ * Alert Code Decomposition
+ *
+ * Decodes alert codes that are not in the database.  Every alert code carries
+ * its deadend bit, subsystem, general error class and specific code, so a
+ * missing code falls back to the closest entry in the range index generated
+ * by gentables and gets an explanation synthesized from its fields.
+ *
+ * After meditiation comes... Insight
+ *
+ * Copyright (c) 2025-26 amigazen project
+ * Licensed under BSD 2-Clause License
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <string.h>
+#include "error_codes.h"
+#include "lookup.h"
+#include "idb.h"
+#include "decompose.h"
+#include "phase.h"
+
+/* Text written into a caller-supplied buffer, counting what does not fit */
+struct TextOut {
+    STRPTR buffer;
+    ULONG size;
+    ULONG total;
+};
+
+/* Subsystem names, from the AN_ numbers in exec/alerts.h */
+static const struct {
+    UBYTE subsystem;
+    CONST_STRPTR name;
+} subsystemNames[] = {
+    { 0x00, "CPU" },
+    { 0x01, "exec.library" },
+    { 0x02, "graphics.library" },
+    { 0x03, "layers.library" },
+    { 0x04, "intuition.library" },
+    { 0x05, "mathffp.library" },
+    { 0x06, "clist.library" },
+    { 0x07, "dos.library" },
+    { 0x08, "ramlib" },
+    { 0x09, "icon.library" },
+    { 0x0A, "expansion.library" },
+    { 0x0B, "diskfont.library" },
+    { 0x0C, "utility.library" },
+    { 0x0D, "keymap.library" },
+    { 0x10, "audio.device" },
+    { 0x11, "console.device" },
+    { 0x12, "gameport.device" },
+    { 0x13, "keyboard.device" },
+    { 0x14, "trackdisk.device" },
+    { 0x15, "timer.device" },
+    { 0x20, "cia.resource" },
+    { 0x21, "disk.resource" },
+    { 0x22, "misc.resource" },
+    { 0x30, "Bootstrap" },
+    { 0x31, "Workbench" },
+    { 0x32, "DiskCopy" },
+    { 0x33, "gadtools.library" },
+    { 0x34, "utility.library" },
+    { 0x35, "Unknown subsystem" },
+    { 0x3E, "mmu.library" }
+};
+
+#define SUBSYSTEM_NAMES (sizeof(subsystemNames) / sizeof(subsystemNames[0]))
+
+/* General error classes, indexed by the AG_ number */
+static const struct {
+    CONST_STRPTR name;
+    CONST_STRPTR explanation;
+} classNames[] = {
+    { NULL, NULL },
+    { "Out of memory", "The subsystem could not allocate memory it needed; check for a memory shortage or a leak." },
+    { "Could not make library", "A library could not be built from its function table during initialization." },
+    { "Could not open library", "A required library could not be opened; it may be missing from LIBS: or too old." },
+    { "Could not open device", "A required device could not be opened; it may be missing from DEVS: or too old." },
+    { "Could not open resource", "A required resource could not be opened." },
+    { "I/O error", "An input/output operation failed." },
+    { "No signal", "No free signal bit was available to the task." },
+    { "Bad parameter", "A function was called with an invalid parameter." },
+    { "Library closed too often", "A library was closed more times than it was opened." },
+    { "Device closed too often", "A device was closed more times than it was opened." },
+    { "Could not create process", "A new process could not be created." },
+    { "Obsolete function", "A function that is no longer supported was called." }
+};
+
+#define CLASS_NAMES (sizeof(classNames) / sizeof(classNames[0]))
+
+/* Match levels, indexed by ALERT_MATCH_xxx */
+static const CONST_STRPTR matchNames[] = {
+    "exact", "class", "subsystem", "none"
+};
+
+/* Forward declarations */
+static VOID AppendText(struct TextOut *out, CONST_STRPTR text);
+static VOID AppendHex(struct TextOut *out, ULONG value, ULONG digits);
+static VOID AppendInsight(struct TextOut *out, CONST_STRPTR insight);
+static UWORD AlertIndexAt(ULONG table, ULONG slot);
+static VOID Terminate(struct TextOut *out);
+
+/*
+ * Split an alert code into its fields
+ */
+VOID SplitAlertCode(ULONG alertCode, struct AlertParts *parts)
+{
+    parts->deadend = (BOOL)((alertCode & ALERT_DEADEND) != 0);
+    parts->subsystem = (UBYTE)((alertCode >> 24) & (ALERT_SUBSYSTEMS - 1));
+    parts->generalClass = (UBYTE)((alertCode >> 16) & 0xFF);
+    parts->specific = (UWORD)(alertCode & 0xFFFF);
+}
+
+/*
+ * Find the database entry closest to an alert code
+ * Falls back from the exact code to the same subsystem and general class,
+ * then to the same subsystem, through the generated range index - constant
+ * time after the exact lookup.  Returns the database index, or
+ * LOOKUP_NOT_FOUND with *match set to ALERT_MATCH_NONE.
+ */
+LONG FindRelatedAlert(ULONG alertCode, ULONG *match)
+{
+    struct AlertParts parts;
+    LONG index;
+    ULONG entry;
+
+    index = FindInsightIndex(alertCode);
+    if (index != LOOKUP_NOT_FOUND) {
+        *match = ALERT_MATCH_EXACT;
+        return index;
+    }
+
+    SplitAlertCode(alertCode, &parts);
+
+    /* Class 0 holds the subsystem's own specific alerts, not a general error */
+    if (parts.generalClass != 0 && parts.generalClass < AlertIndexAt(IDB_ALERT_CLASS_COUNT, parts.subsystem)) {
+        entry = AlertIndexAt(IDB_ALERT_CLASS_ENTRY,
+                             AlertIndexAt(IDB_ALERT_CLASS_BASE, parts.subsystem) + parts.generalClass);
+        if (entry != ALERT_NO_ENTRY) {
+            *match = ALERT_MATCH_CLASS;
+            return (LONG)entry;
+        }
+    }
+
+    /* Subsystem 0 general errors come from applications, not the CPU traps */
+    entry = AlertIndexAt(IDB_ALERT_SUBSYSTEM_ENTRY, parts.subsystem);
+    if (entry != ALERT_NO_ENTRY && (parts.subsystem != 0 || parts.generalClass == 0)) {
+        *match = ALERT_MATCH_SUBSYSTEM;
+        return (LONG)entry;
+    }
+
+    *match = ALERT_MATCH_NONE;
+    return LOOKUP_NOT_FOUND;
+}
+
+/*
+ * Explain any alert code into a caller-supplied buffer
+ * Codes in the database get their own insight; anything else gets an
+ * explanation synthesized from the code's fields and the closest related
+ * entry.  Never fails.  Returns the full length like ExpandExplanationInto,
+ * so a NULL buffer with zero size measures the explanation.
+ */
+ULONG DecodeAlertInto(ULONG alertCode, struct AlertDecoding *decoding, STRPTR buffer, ULONG bufferSize)
+{
+    struct TextOut out;
+    struct TextOut description;
+    CONST_STRPTR subsystemName;
+    CONST_STRPTR className;
+    struct ErrorView entry;
+    struct AlertParts example;
+    LONG index;
+
+    BEGIN_PHASE(PHASE_LOOKUP);
+    decoding->code = alertCode;
+    SplitAlertCode(alertCode, &decoding->parts);
+    index = FindRelatedAlert(alertCode, &decoding->match);
+    decoding->relatedIndex = index;
+    END_PHASE(PHASE_LOOKUP, 0);
+
+    BEGIN_PHASE(PHASE_EXPANSION);
+    if (index != LOOKUP_NOT_FOUND) {
+        InsightEntryView((ULONG)index, &entry);
+    }
+
+    out.buffer = buffer;
+    out.size = bufferSize;
+    out.total = 0;
+
+    if (decoding->match == ALERT_MATCH_EXACT) {
+        decoding->description = entry.description;
+        AppendInsight(&out, entry.insight);
+        Terminate(&out);
+        END_PHASE(PHASE_EXPANSION, out.total);
+        return out.total;
+    }
+
+    subsystemName = AlertSubsystemName(decoding->parts.subsystem);
+    className = AlertClassName(decoding->parts.generalClass);
+    if (decoding->parts.subsystem == 0 && decoding->parts.generalClass != 0) {
+        /* A general error with no subsystem is raised by application code */
+        subsystemName = "Application";
+    }
+
+    /* Description, for example "dos.library: Out of memory" */
+    description.buffer = decoding->descriptionBuffer;
+    description.size = sizeof(decoding->descriptionBuffer);
+    description.total = 0;
+    if (subsystemName != NULL) {
+        AppendText(&description, subsystemName);
+    } else {
+        AppendText(&description, "Subsystem 0x");
+        AppendHex(&description, decoding->parts.subsystem, 2);
+    }
+    if (className != NULL) {
+        AppendText(&description, ": ");
+        AppendText(&description, className);
+    } else {
+        AppendText(&description, " alert");
+    }
+    Terminate(&description);
+    decoding->description = decoding->descriptionBuffer;
+
+    AppendText(&out, "This alert is not in the database; Insight decoded it from the alert code. Raised by: ");
+    if (subsystemName != NULL) {
+        AppendText(&out, subsystemName);
+        AppendText(&out, ".");
+    } else {
+        AppendText(&out, "subsystem 0x");
+        AppendHex(&out, decoding->parts.subsystem, 2);
+        AppendText(&out, ", which is not a known subsystem.");
+    }
+
+    if (className != NULL) {
+        AppendText(&out, " ");
+        AppendText(&out, classNames[decoding->parts.generalClass].explanation);
+    } else if (decoding->parts.generalClass != 0) {
+        AppendText(&out, " General error class 0x");
+        AppendHex(&out, decoding->parts.generalClass, 2);
+        AppendText(&out, " is not defined.");
+    }
+
+    /* General errors name the object involved with an AO_ code */
+    if (decoding->parts.generalClass != 0 && (decoding->parts.specific & ALERT_OBJECT) != 0 &&
+        AlertSubsystemName(decoding->parts.specific & ~ALERT_OBJECT) != NULL) {
+        AppendText(&out, " The object involved is ");
+        AppendText(&out, AlertSubsystemName(decoding->parts.specific & ~ALERT_OBJECT));
+        AppendText(&out, ".");
+    } else if (decoding->parts.specific != 0) {
+        AppendText(&out, " The specific code is 0x");
+        AppendHex(&out, decoding->parts.specific, 4);
+        AppendText(&out, ".");
+    }
+
+    if (decoding->parts.deadend) {
+        AppendText(&out, " This was a deadend alert, so the system could not recover.");
+    } else {
+        AppendText(&out, " This was a recoverable alert.");
+    }
+
+    if (decoding->match == ALERT_MATCH_CLASS) {
+        AppendText(&out, " The closest known alert is 0x");
+        AppendHex(&out, entry.code, 8);
+        AppendText(&out, " (");
+        AppendText(&out, entry.description);
+        AppendText(&out, "): ");
+        AppendInsight(&out, entry.insight);
+    } else if (decoding->match == ALERT_MATCH_SUBSYSTEM) {
+        /* The subsystem's entry is not related to this alert - only cite it as an example of a similar one */
+        SplitAlertCode(entry.code, &example);
+        if (example.generalClass == decoding->parts.generalClass || example.deadend == decoding->parts.deadend) {
+            AppendText(&out, " For example, 0x");
+            AppendHex(&out, entry.code, 8);
+            AppendText(&out, " (");
+            AppendText(&out, entry.description);
+            AppendText(&out, ") is a known alert from the same subsystem.");
+        }
+    }
+
+    Terminate(&out);
+    END_PHASE(PHASE_EXPANSION, out.total);
+    return out.total;
+}
+
+/*
+ * Name of a subsystem, or NULL if the number is not assigned
+ */
+CONST_STRPTR AlertSubsystemName(ULONG subsystem)
+{
+    ULONG i;
+
+    for (i = 0; i < SUBSYSTEM_NAMES; i++) {
+        if (subsystemNames[i].subsystem == subsystem) {
+            return subsystemNames[i].name;
+        }
+    }
+
+    return NULL;
+}
+
+/*
+ * Name of a general error class, or NULL for class 0 and undefined classes
+ */
+CONST_STRPTR AlertClassName(ULONG generalClass)
+{
+    if (generalClass == 0 || generalClass >= CLASS_NAMES) {
+        return NULL;
+    }
+
+    return classNames[generalClass].name;
+}
+
+/*
+ * Short name of a match level, as used in batch output
+ */
+CONST_STRPTR AlertMatchName(ULONG match)
+{
+    if (match > ALERT_MATCH_NONE) {
+        return "unknown";
+    }
+
+    return matchNames[match];
+}
+
+/*
+ * Append a string, copying whatever still fits
+ */
+static VOID AppendText(struct TextOut *out, CONST_STRPTR text)
+{
+    ULONG length;
+    ULONG copy;
+
+    length = strlen(text);
+    if (out->total + 1 < out->size) {
+        copy = out->size - 1 - out->total;
+        if (copy > length) {
+            copy = length;
+        }
+        memcpy(out->buffer + out->total, text, copy);
+    }
+    out->total += length;
+}
+
+/*
+ * Append a value as upper case hex digits
+ */
+static VOID AppendHex(struct TextOut *out, ULONG value, ULONG digits)
+{
+    char hex[9];
+    ULONG i;
+
+    for (i = 0; i < digits; i++) {
+        hex[digits - 1 - i] = "0123456789ABCDEF"[(value >> (i * 4)) & 0xF];
+    }
+    hex[digits] = '\0';
+
+    AppendText(out, hex);
+}
+
+/*
+ * Append the expanded insight of a database entry
+ */
+static VOID AppendInsight(struct TextOut *out, CONST_STRPTR insight)
+{
+    if (out->total + 1 < out->size) {
+        out->total += ExpandExplanationInto(insight, out->buffer + out->total, out->size - out->total);
+    } else {
+        out->total += ExpandExplanationInto(insight, NULL, 0);
+    }
+}
+
+/*
+ * Read the alert range index of the active database
+ * (alertSubsystemEntry and friends, or the same tables in an .idb file)
+ */
+static UWORD AlertIndexAt(ULONG table, ULONG slot)
+{
+    struct InsightDatabase *database;
+
+    database = ActiveInsightDatabase();
+    if (database != NULL) {
+        return IdbAlertIndex(database, table, slot);
+    }
+
+    if (table == IDB_ALERT_SUBSYSTEM_ENTRY) {
+        return alertSubsystemEntry[slot];
+    }
+    if (table == IDB_ALERT_CLASS_BASE) {
+        return alertClassBase[slot];
+    }
+    if (table == IDB_ALERT_CLASS_COUNT) {
+        return alertClassCount[slot];
+    }
+
+    return alertClassEntry[slot];
+}
+
+/*
+ * Terminate the text, truncating if it did not fit
+ */
+static VOID Terminate(struct TextOut *out)
+{
+    if (out->size > 0) {
+        out->buffer[out->total < out->size ? out->total : out->size - 1] = '\0';
+    }
+}
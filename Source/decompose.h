@@ -0,0 +1,98 @@
+/*
+ * Alert Code Decomposition
+ *
+ * Splits an Amiga alert code into its deadend bit, subsystem, general error
+ * class and specific code, and explains codes that are missing from the
+ * database by falling back to the closest related entry.
+ *
+ * After meditiation comes... Insight
+ *
+ * Copyright (c) 2025-26 amigazen project
+ * Licensed under BSD 2-Clause License
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef DECOMPOSE_H
+#define DECOMPOSE_H
+
+#include "platform.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Alert code layout - see exec/alerts.h */
+#define ALERT_DEADEND         0x80000000UL
+#define ALERT_SUBSYSTEMS      128
+#define ALERT_OBJECT          0x8000
+
+/* How closely an alert code matched the database */
+#define ALERT_MATCH_EXACT     0  /* The code itself is in errorTable */
+#define ALERT_MATCH_CLASS     1  /* Same subsystem and general error class */
+#define ALERT_MATCH_SUBSYSTEM 2  /* Same subsystem only */
+#define ALERT_MATCH_NONE      3  /* Decoded from the code structure alone */
+
+/* Range index slot with no related entry */
+#define ALERT_NO_ENTRY        0xFFFF
+
+/* Room for a synthesized description */
+#define ALERT_DESCRIPTION_LENGTH 80
+
+/* Fields of an alert code */
+struct AlertParts {
+    BOOL deadend;
+    UBYTE subsystem;    /* AN_ number without the deadend bit */
+    UBYTE generalClass; /* AG_ number, 0 for subsystem-specific alerts */
+    UWORD specific;     /* Specific code or AO_ object */
+};
+
+/* Result of decoding an alert code - owned by the caller */
+struct AlertDecoding {
+    ULONG code;
+    ULONG match;                /* ALERT_MATCH_xxx */
+    struct AlertParts parts;
+    LONG relatedIndex;          /* Database index used, or LOOKUP_NOT_FOUND */
+    CONST_STRPTR description;   /* Database text or descriptionBuffer */
+    char descriptionBuffer[ALERT_DESCRIPTION_LENGTH];
+};
+
+/* Range index generated by gentables, keyed by subsystem then class */
+extern const UWORD alertSubsystemEntry[];
+extern const UWORD alertClassBase[];
+extern const UWORD alertClassCount[];
+extern const UWORD alertClassEntry[];
+
+/* Function declarations */
+VOID SplitAlertCode(ULONG alertCode, struct AlertParts *parts);
+LONG FindRelatedAlert(ULONG alertCode, ULONG *match);
+ULONG DecodeAlertInto(ULONG alertCode, struct AlertDecoding *decoding, STRPTR buffer, ULONG bufferSize);
+CONST_STRPTR AlertSubsystemName(ULONG subsystem);
+CONST_STRPTR AlertClassName(ULONG generalClass);
+CONST_STRPTR AlertMatchName(ULONG match);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* DECOMPOSE_H */
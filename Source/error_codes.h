@@ -35,7 +35,11 @@
 #ifndef ERROR_CODES_H
 #define ERROR_CODES_H
 
-#include <exec/types.h>
+#include "platform.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
 
 /* Structure to hold error code information */
 struct ErrorInfo {
@@ -44,16 +48,60 @@ struct ErrorInfo {
     STRPTR insight;
 };
 
-/* Comprehensive error lookup table */
+/* Token dictionary entry - a token byte code in the insight text expands to value */
+struct TokenInfo {
+    const char *value;
+    UWORD length;
+};
+
+/*
+ * Token byte codes in compressed insight text.  Insight text is 7-bit
+ * ASCII, so bytes from TOKEN_FIRST_CODE up index tokenTable directly:
+ * 0x80-0xFE are tokens 0-126, and TOKEN_ESCAPE_CODE followed by a byte
+ * n (1-255) is token 126 + n.
+ */
+#define TOKEN_FIRST_CODE   0x80
+#define TOKEN_ESCAPE_CODE  0xFF
+#define TOKEN_SHORT_COUNT  (TOKEN_ESCAPE_CODE - TOKEN_FIRST_CODE)
+#define TOKEN_MAX_COUNT    (TOKEN_SHORT_COUNT + 255)
+
+/* Borrowed, read-only view of a database entry - never freed by the caller */
+struct ErrorView {
+    ULONG code;
+    CONST_STRPTR description;
+    CONST_STRPTR insight;       /* Compressed - expand with ExpandExplanationInto */
+    ULONG insightLength;        /* Expanded length, excluding the terminator */
+};
+
+/* Suggested buffer size for expanded insights - longer text is truncated */
+#define INSIGHT_MAX_LENGTH 2048
+
+/* Comprehensive error lookup table - generated by gendb from error_codes.txt */
 extern struct ErrorInfo errorTable[];
 
 /* Number of entries in the error table */
 extern const ULONG ERROR_TABLE_SIZE;
 
+/* Token dictionary generated by gendb, indexed by token number */
+extern const struct TokenInfo tokenTable[];
+extern const ULONG TOKEN_TABLE_SIZE;
+
+/* Expanded insight length of each errorTable entry, generated by gendb */
+extern const UWORD insightLengthTable[];
+
 /* Function declarations */
 struct ErrorInfo* GainInsight(ULONG errorCode);
 STRPTR ExpandExplanation(STRPTR compressedExplanation);
 VOID FreeErrorInfo(struct ErrorInfo *errorInfo);
-STRPTR LookupToken(const char *tokenName);
+STRPTR LookupToken(ULONG tokenIndex);
+BOOL PeekInsight(ULONG errorCode, struct ErrorView *view);
+LONG GainInsightInto(ULONG errorCode, struct ErrorView *view, STRPTR buffer, ULONG bufferSize);
+ULONG ExpandExplanationInto(CONST_STRPTR explanation, STRPTR buffer, ULONG bufferSize);
+LONG FindInsightIndex(ULONG errorCode);
+VOID InsightEntryView(ULONG index, struct ErrorView *view);
+
+#ifdef __cplusplus
+}
+#endif
 
 #endif /* ERROR_CODES_H */ 
\ No newline at end of file
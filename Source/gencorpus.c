@@ -0,0 +1,601 @@
+/*
+ * Corpus Generator
+ *
+ * Host tool that writes synthetic inputs for throughput testing.  A batch
+ * corpus has one alert code per line, for FROM.  A log corpus is serial
+ * console noise with alerts in every form the log scanner knows, for SCAN.
+ * The mix of database and unknown codes, deadend alerts and noise is
+ * chosen on the command line (NOISE is the share of invalid lines in a
+ * batch corpus), and the same seed always gives the same file, so runs on
+ * different builds see identical input.  Writing stops at the first line
+ * end at or past SIZE.  The counts of what was written go to stderr so
+ * scan results can be checked against them.  A history corpus is a crash
+ * history file for HISTORY, its records an hour apart on average from the
+ * start of 2026, with NOISE the share of damaged record slots.
+ *
+ * Usage: gencorpus <output file>|- [MODE=batch|log|history] [SIZE=<n>[K|M|G]]
+ *                  [SEED=<n>] [KNOWN=<percent>] [DEADEND=<percent>]
+ *                  [NOISE=<percent>]
+ *
+ * After meditiation comes... Insight
+ *
+ * Copyright (c) 2025-26 amigazen project
+ * Licensed under BSD 2-Clause License
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "libinsight.h"
+#include "decompose.h"
+#include "logscan.h"
+#include "history.h"
+#include "hosttools.h"
+
+/* Corpus kinds */
+#define CORPUS_BATCH   0  /* One code per line, for FROM */
+#define CORPUS_LOG     1  /* Console log, for SCAN */
+#define CORPUS_HISTORY 2  /* Crash history file, for HISTORY */
+
+/* First history record time - 1 January 2026 in seconds since 1978 */
+#define CORPUS_HISTORY_START 1514764800UL
+#define CORPUS_HISTORY_GAP   7200    /* Most seconds between records */
+
+/* Output block - the corpus is written in blocks this size */
+#define CORPUS_BUFFER_SIZE 1048576
+
+/* Room kept free in the block for one more line */
+#define CORPUS_LINE_ROOM 256
+
+/* Defaults */
+#define CORPUS_DEFAULT_SIZE    (64ULL * 1024 * 1024)
+#define CORPUS_DEFAULT_KNOWN   80  /* Percent of codes taken from the database */
+#define CORPUS_DEFAULT_DEADEND 40  /* Percent of codes with the deadend bit */
+#define CORPUS_DEFAULT_NOISE   90  /* Percent of log lines without an alert */
+#define CORPUS_DEFAULT_INVALID 1   /* Percent of invalid batch lines */
+
+/* What was written, reported on stderr */
+struct CorpusCounts {
+    uint64_t bytes;
+    uint64_t lines;
+    uint64_t codes;
+    uint64_t known;
+    uint64_t deadend;
+    uint64_t noise;                  /* Noise log lines, invalid batch lines or damaged records */
+    uint64_t kinds[SCAN_KINDS];      /* Log alerts by SCAN_KIND_xxx */
+};
+
+/* Output state */
+struct Corpus {
+    FILE *file;
+    char *buffer;
+    ULONG used;
+    BOOL failed;
+    ULONG mode;
+    ULONG known;
+    ULONG deadend;
+    ULONG noise;
+    ULONG *deadendEntries;           /* Database codes by deadend bit */
+    ULONG deadendCount;
+    ULONG *recoverableEntries;
+    ULONG recoverableCount;
+    ULONG tick;                      /* Log timestamp in milliseconds */
+    ULONG time;                      /* History record time */
+    struct CorpusCounts counts;
+};
+
+/* Devices and tasks named in noise lines and alerts */
+static const CONST_STRPTR sources[] = {
+    "trackdisk.device", "scsi.device", "serial.device", "input.device", "ramlib",
+    "Workbench", "Shell Process", "dos.library", "intuition.library", "CON"
+};
+
+#define SOURCE_COUNT (sizeof(sources) / sizeof(sources[0]))
+
+/* Forward declarations */
+static BOOL ParseSize(const char *text, uint64_t *size);
+static BOOL ParsePercent(const char *text, ULONG *percent);
+static BOOL Chance(ULONG percent);
+static BOOL PrepareEntries(struct Corpus *corpus);
+static ULONG PickCode(struct Corpus *corpus);
+static VOID WriteBatchLine(struct Corpus *corpus);
+static VOID WriteLogLines(struct Corpus *corpus);
+static VOID WriteNoiseLine(struct Corpus *corpus);
+static VOID WriteTimestamp(struct Corpus *corpus);
+static VOID WriteHistoryRecord(struct Corpus *corpus);
+static VOID PutText(struct Corpus *corpus, CONST_STRPTR text);
+static VOID PutHex(struct Corpus *corpus, ULONG value, ULONG digits);
+static VOID PutDecimal(struct Corpus *corpus, ULONG value, ULONG width, char fill);
+static VOID EndLine(struct Corpus *corpus);
+static BOOL FlushCorpus(struct Corpus *corpus);
+
+int main(int argc, char *argv[])
+{
+    struct Corpus corpus;
+    const char *value;
+    uint64_t size;
+    ULONG seed;
+    int i;
+
+    if (argc < 2) {
+        fprintf(stderr, "Usage: gencorpus <output file>|- [MODE=batch|log|history] [SIZE=<n>[K|M|G]] [SEED=<n>]\n"
+                        "                 [KNOWN=<percent>] [DEADEND=<percent>] [NOISE=<percent>]\n");
+        return EXIT_FAILURE;
+    }
+
+    memset(&corpus, 0, sizeof(corpus));
+    corpus.mode = CORPUS_BATCH;
+    corpus.known = CORPUS_DEFAULT_KNOWN;
+    corpus.deadend = CORPUS_DEFAULT_DEADEND;
+    corpus.noise = 101;
+    size = CORPUS_DEFAULT_SIZE;
+    seed = 1;
+
+    for (i = 2; i < argc; i++) {
+        if (MatchKeyword(argv[i], "MODE", &value) && value != NULL &&
+            (strcmp(value, "batch") == 0 || strcmp(value, "log") == 0 || strcmp(value, "history") == 0)) {
+            corpus.mode = (strcmp(value, "log") == 0) ? CORPUS_LOG :
+                          (strcmp(value, "history") == 0) ? CORPUS_HISTORY : CORPUS_BATCH;
+        } else if (MatchKeyword(argv[i], "SIZE", &value) && value != NULL && ParseSize(value, &size)) {
+            continue;
+        } else if (MatchKeyword(argv[i], "SEED", &value) && value != NULL) {
+            seed = (ULONG)strtoul(value, NULL, 10);
+        } else if (MatchKeyword(argv[i], "KNOWN", &value) && value != NULL && ParsePercent(value, &corpus.known)) {
+            continue;
+        } else if (MatchKeyword(argv[i], "DEADEND", &value) && value != NULL &&
+                   ParsePercent(value, &corpus.deadend)) {
+            continue;
+        } else if (MatchKeyword(argv[i], "NOISE", &value) && value != NULL && ParsePercent(value, &corpus.noise)) {
+            continue;
+        } else {
+            fprintf(stderr, "gencorpus: bad argument %s\n", argv[i]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    /* NOISE defaults by mode */
+    if (corpus.noise > 100) {
+        corpus.noise = (corpus.mode == CORPUS_LOG) ? CORPUS_DEFAULT_NOISE :
+                       (corpus.mode == CORPUS_HISTORY) ? 0 : CORPUS_DEFAULT_INVALID;
+    }
+
+    SeedRandom(seed);
+    corpus.buffer = (char *)malloc(CORPUS_BUFFER_SIZE);
+    if (corpus.buffer == NULL || !PrepareEntries(&corpus)) {
+        fprintf(stderr, "gencorpus: out of memory\n");
+        return EXIT_FAILURE;
+    }
+
+    if (strcmp(argv[1], "-") == 0) {
+        corpus.file = stdout;
+    } else {
+        corpus.file = fopen(argv[1], "wb");
+        if (corpus.file == NULL) {
+            fprintf(stderr, "gencorpus: cannot create %s\n", argv[1]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (corpus.mode == CORPUS_HISTORY) {
+        EncodeCrashHeader((UBYTE *)corpus.buffer);
+        corpus.used = HISTORY_HEADER_SIZE;
+        corpus.time = CORPUS_HISTORY_START;
+    }
+
+    while (!corpus.failed && corpus.counts.bytes + corpus.used < size) {
+        if (corpus.mode == CORPUS_LOG) {
+            WriteLogLines(&corpus);
+        } else if (corpus.mode == CORPUS_HISTORY) {
+            WriteHistoryRecord(&corpus);
+        } else {
+            WriteBatchLine(&corpus);
+        }
+        if (corpus.used > CORPUS_BUFFER_SIZE - CORPUS_LINE_ROOM) {
+            FlushCorpus(&corpus);
+        }
+    }
+    FlushCorpus(&corpus);
+
+    if ((corpus.file != stdout && fclose(corpus.file) != 0) || (corpus.file == stdout && fflush(stdout) != 0)) {
+        corpus.failed = TRUE;
+    }
+    if (corpus.failed) {
+        fprintf(stderr, "gencorpus: cannot write %s\n", argv[1]);
+        return EXIT_FAILURE;
+    }
+
+    fprintf(stderr, "gencorpus: %llu bytes, %llu lines, %llu codes (%llu known, %llu deadend), %llu %s",
+            (unsigned long long)corpus.counts.bytes, (unsigned long long)corpus.counts.lines,
+            (unsigned long long)corpus.counts.codes, (unsigned long long)corpus.counts.known,
+            (unsigned long long)corpus.counts.deadend, (unsigned long long)corpus.counts.noise,
+            corpus.mode == CORPUS_LOG ? "noise lines" :
+            corpus.mode == CORPUS_HISTORY ? "damaged records" : "invalid lines");
+    if (corpus.mode == CORPUS_LOG) {
+        fprintf(stderr, ", %llu guru, %llu software-failure, %llu recoverable, %llu bare",
+                (unsigned long long)corpus.counts.kinds[SCAN_KIND_GURU],
+                (unsigned long long)corpus.counts.kinds[SCAN_KIND_SOFTWARE_FAILURE],
+                (unsigned long long)corpus.counts.kinds[SCAN_KIND_RECOVERABLE],
+                (unsigned long long)corpus.counts.kinds[SCAN_KIND_BARE]);
+    }
+    fprintf(stderr, "\n");
+
+    free(corpus.deadendEntries);
+    free(corpus.recoverableEntries);
+    free(corpus.buffer);
+
+    return EXIT_SUCCESS;
+}
+
+/*
+ * Read a size in bytes with an optional K, M or G suffix
+ */
+static BOOL ParseSize(const char *text, uint64_t *size)
+{
+    char *end;
+    unsigned long long value;
+
+    value = strtoull(text, &end, 10);
+    if (end == text) {
+        return FALSE;
+    }
+
+    if ((*end | 0x20) == 'k') {
+        value <<= 10;
+        end++;
+    } else if ((*end | 0x20) == 'm') {
+        value <<= 20;
+        end++;
+    } else if ((*end | 0x20) == 'g') {
+        value <<= 30;
+        end++;
+    }
+    if (*end != '\0' || value == 0) {
+        return FALSE;
+    }
+
+    *size = (uint64_t)value;
+    return TRUE;
+}
+
+/*
+ * Read a percentage from 0 to 100
+ */
+static BOOL ParsePercent(const char *text, ULONG *percent)
+{
+    char *end;
+    unsigned long value;
+
+    value = strtoul(text, &end, 10);
+    if (end == text || *end != '\0' || value > 100) {
+        return FALSE;
+    }
+
+    *percent = (ULONG)value;
+    return TRUE;
+}
+
+/*
+ * TRUE with the given percent chance
+ */
+static BOOL Chance(ULONG percent)
+{
+    return (BOOL)(NextRandom() % 100 < percent);
+}
+
+/*
+ * Split the database codes by their deadend bit, so known codes can
+ * follow the deadend ratio too
+ */
+static BOOL PrepareEntries(struct Corpus *corpus)
+{
+    ULONG entries;
+    ULONG code;
+    ULONG i;
+
+    entries = InsightEntryCount();
+    corpus->deadendEntries = (ULONG *)malloc((entries + 1) * sizeof(ULONG));
+    corpus->recoverableEntries = (ULONG *)malloc((entries + 1) * sizeof(ULONG));
+    if (corpus->deadendEntries == NULL || corpus->recoverableEntries == NULL) {
+        return FALSE;
+    }
+
+    for (i = 0; i < entries; i++) {
+        code = InsightEntryAt(i)->code;
+        if ((code & ALERT_DEADEND) != 0) {
+            corpus->deadendEntries[corpus->deadendCount++] = code;
+        } else {
+            corpus->recoverableEntries[corpus->recoverableCount++] = code;
+        }
+    }
+
+    return TRUE;
+}
+
+/*
+ * Pick the next code and count it
+ * Known codes come from the database; unknown ones are random codes that
+ * are not in it.  Either way the deadend bit follows the deadend ratio,
+ * unless the database has no code of that kind.
+ */
+static ULONG PickCode(struct Corpus *corpus)
+{
+    ULONG code;
+    BOOL deadend;
+
+    deadend = Chance(corpus->deadend);
+
+    if (Chance(corpus->known) && (deadend ? corpus->deadendCount : corpus->recoverableCount) > 0) {
+        if (deadend) {
+            code = corpus->deadendEntries[NextRandom() % corpus->deadendCount];
+        } else {
+            code = corpus->recoverableEntries[NextRandom() % corpus->recoverableCount];
+        }
+        corpus->counts.known++;
+    } else {
+        do {
+            code = (NextRandom() & ~ALERT_DEADEND) | (deadend ? ALERT_DEADEND : 0);
+        } while (InsightIsKnownCode(code));
+    }
+
+    corpus->counts.codes++;
+    if ((code & ALERT_DEADEND) != 0) {
+        corpus->counts.deadend++;
+    }
+
+    return code;
+}
+
+/*
+ * One batch line - a code, a quarter of them with 0x, or an invalid line
+ */
+static VOID WriteBatchLine(struct Corpus *corpus)
+{
+    if (Chance(corpus->noise)) {
+        PutText(corpus, (NextRandom() & 1) ? "no alert" : "0x1234");
+        corpus->counts.noise++;
+    } else {
+        if ((NextRandom() & 3) == 0) {
+            PutText(corpus, "0x");
+        }
+        PutHex(corpus, PickCode(corpus), 8);
+    }
+    EndLine(corpus);
+}
+
+/*
+ * One noise line, or the lines of one alert
+ * Deadend codes are shown as a Guru Meditation or a Software Failure,
+ * others as a Guru Meditation or a Recoverable Alert; a fifth of either
+ * appear as bare hex, which only a scan without STRICT finds.
+ */
+static VOID WriteLogLines(struct Corpus *corpus)
+{
+    ULONG code;
+    ULONG task;
+    ULONG form;
+
+    if (Chance(corpus->noise)) {
+        WriteNoiseLine(corpus);
+        corpus->counts.noise++;
+        return;
+    }
+
+    code = PickCode(corpus);
+    task = 0x00C00000UL + (NextRandom() & 0x000FFFFCUL);
+    form = NextRandom() % 10;
+
+    WriteTimestamp(corpus);
+    if (form < 2) {
+        PutText(corpus, "exec: alert ");
+        PutHex(corpus, code, 8);
+        PutText(corpus, " raised by ");
+        PutText(corpus, sources[NextRandom() % SOURCE_COUNT]);
+        corpus->counts.kinds[SCAN_KIND_BARE]++;
+    } else if (form < 6) {
+        PutText(corpus, "Guru Meditation #");
+        PutHex(corpus, code, 8);
+        PutText(corpus, ".");
+        PutHex(corpus, task, 8);
+        corpus->counts.kinds[SCAN_KIND_GURU]++;
+    } else {
+        if ((code & ALERT_DEADEND) != 0) {
+            PutText(corpus, "Software Failure. Press left mouse button to continue.");
+            corpus->counts.kinds[SCAN_KIND_SOFTWARE_FAILURE]++;
+        } else {
+            PutText(corpus, "Recoverable Alert. Press left mouse button to continue.");
+            corpus->counts.kinds[SCAN_KIND_RECOVERABLE]++;
+        }
+        EndLine(corpus);
+        WriteTimestamp(corpus);
+        PutText(corpus, "Error: ");
+        PutHex(corpus, code, 8);
+        PutText(corpus, "   Task: $");
+        PutHex(corpus, task, 8);
+    }
+    EndLine(corpus);
+}
+
+/*
+ * A console line with no alert in it
+ * Numbers are kept below 8 digits so none of them looks like a code.
+ */
+static VOID WriteNoiseLine(struct Corpus *corpus)
+{
+    ULONG form;
+
+    WriteTimestamp(corpus);
+    PutText(corpus, sources[NextRandom() % SOURCE_COUNT]);
+    PutText(corpus, ": ");
+
+    form = NextRandom() % 6;
+    if (form == 0) {
+        PutText(corpus, "opened unit ");
+        PutDecimal(corpus, NextRandom() % 8, 1, ' ');
+    } else if (form == 1) {
+        PutText(corpus, "read retry on track ");
+        PutDecimal(corpus, NextRandom() % 160, 1, ' ');
+        PutText(corpus, ", sector ");
+        PutDecimal(corpus, NextRandom() % 11, 1, ' ');
+    } else if (form == 2) {
+        PutText(corpus, "buffer overrun at $");
+        PutHex(corpus, NextRandom() & 0xFFFFFF, 6);
+    } else if (form == 3) {
+        PutText(corpus, "low memory, ");
+        PutDecimal(corpus, NextRandom() % 2000000, 1, ' ');
+        PutText(corpus, " bytes free");
+    } else if (form == 4) {
+        PutText(corpus, "mounted DH");
+        PutDecimal(corpus, NextRandom() % 4, 1, ' ');
+        PutText(corpus, ": (FFS, 512 byte blocks)");
+    } else {
+        PutText(corpus, "task woke up after ");
+        PutDecimal(corpus, NextRandom() % 5000, 1, ' ');
+        PutText(corpus, " ticks");
+    }
+    EndLine(corpus);
+}
+
+/*
+ * Lead a log line with "[seconds.millis] ", moving the clock on a little
+ */
+static VOID WriteTimestamp(struct Corpus *corpus)
+{
+    corpus->tick += NextRandom() % 50;
+    if (corpus->tick >= 1000000000UL) {
+        corpus->tick = 0;
+    }
+
+    PutText(corpus, "[");
+    PutDecimal(corpus, corpus->tick / 1000, 6, ' ');
+    PutText(corpus, ".");
+    PutDecimal(corpus, corpus->tick % 1000, 3, '0');
+    PutText(corpus, "] ");
+}
+
+/*
+ * One crash history record, or a damaged slot where a reset tore one
+ * The time moves on whichever it is, so queries see gaps where records
+ * were lost.  Lines and the line count mean records here.
+ */
+static VOID WriteHistoryRecord(struct Corpus *corpus)
+{
+    struct CrashRecord record;
+    UBYTE *data;
+    BOOL damaged;
+
+    data = (UBYTE *)corpus->buffer + corpus->used;
+    corpus->time += 1 + NextRandom() % CORPUS_HISTORY_GAP;
+    damaged = Chance(corpus->noise);
+
+    /* Damaged slots are not counted as codes, as HISTORY never sees them */
+    memset(&record, 0, sizeof(record));
+    record.timestamp = corpus->time;
+    record.code = damaged ? NextRandom() : PickCode(corpus);
+    record.taskID = 0x00C00000UL + (NextRandom() % 0x10000) * 4;
+    record.lastAlert[0] = record.code;
+    record.lastAlert[1] = record.taskID;
+    SetCrashTaskName(&record, sources[NextRandom() % SOURCE_COUNT]);
+    EncodeCrashRecord(&record, data);
+
+    if (damaged) {
+        data[HISTORY_CHECKSUM_OFFSET - 1 - NextRandom() % 8] ^= 0xFF;
+        corpus->counts.noise++;
+    }
+    corpus->used += HISTORY_RECORD_SIZE;
+    corpus->counts.lines++;
+}
+
+/*
+ * Append text to the output block
+ */
+static VOID PutText(struct Corpus *corpus, CONST_STRPTR text)
+{
+    ULONG length;
+
+    length = (ULONG)strlen(text);
+    memcpy(corpus->buffer + corpus->used, text, length);
+    corpus->used += length;
+}
+
+/*
+ * Append the low digits of a value in upper case hex
+ */
+static VOID PutHex(struct Corpus *corpus, ULONG value, ULONG digits)
+{
+    ULONG i;
+
+    for (i = 0; i < digits; i++) {
+        corpus->buffer[corpus->used + digits - 1 - i] = "0123456789ABCDEF"[(value >> (i * 4)) & 0xF];
+    }
+    corpus->used += digits;
+}
+
+/*
+ * Append a decimal number, padded with fill to width
+ */
+static VOID PutDecimal(struct Corpus *corpus, ULONG value, ULONG width, char fill)
+{
+    char digits[10];
+    ULONG count;
+
+    count = 0;
+    do {
+        digits[sizeof(digits) - 1 - count] = (char)('0' + value % 10);
+        value /= 10;
+        count++;
+    } while (value != 0);
+
+    while (width > count) {
+        corpus->buffer[corpus->used++] = fill;
+        width--;
+    }
+    memcpy(corpus->buffer + corpus->used, digits + sizeof(digits) - count, count);
+    corpus->used += count;
+}
+
+/*
+ * End the current line
+ */
+static VOID EndLine(struct Corpus *corpus)
+{
+    corpus->buffer[corpus->used++] = '\n';
+    corpus->counts.lines++;
+}
+
+/*
+ * Write out the output block
+ */
+static BOOL FlushCorpus(struct Corpus *corpus)
+{
+    if (corpus->used > 0 && !corpus->failed) {
+        if (fwrite(corpus->buffer, 1, corpus->used, corpus->file) != corpus->used) {
+            corpus->failed = TRUE;
+        }
+        corpus->counts.bytes += corpus->used;
+    }
+    corpus->used = 0;
+
+    return (BOOL)!corpus->failed;
+}
@@ -0,0 +1,892 @@
+/*
+ * Error Database Generator
+ *
+ * Build-time database generator.  Reads the error database source file(s),
+ * sorts and dedupes the entries, learns a token dictionary of frequent
+ * phrases to compress the insight text and writes the errorTable[] and
+ * tokenTable[] arrays to a C source file, followed by a size report.
+ *
+ * Usage: gendb <output file> <database file> [<database file> ...]
+ *
+ * After meditiation comes... Insight
+ *
+ * Copyright (c) 2025-26 amigazen project
+ * Licensed under BSD 2-Clause License
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "platform.h"
+#include "error_codes.h"
+
+/* Longest line accepted in a database file */
+#define MAX_LINE_LENGTH 4096
+
+/* Longest phrase, in words, considered for a token */
+#define MAX_PHRASE_WORDS 8
+
+/* Dictionary size limit - every token needs a byte code (see error_codes.h) */
+#define MAX_TOKENS TOKEN_MAX_COUNT
+
+/* Stored size of a token reference in the compressed text - one byte
+ * for the first TOKEN_SHORT_COUNT tokens, an escape pair after that */
+#define TOKEN_REFERENCE_SIZE(token) ((token) < TOKEN_SHORT_COUNT ? 1 : 2)
+
+/* Fixed cost of a dictionary entry: a pointer and a length, padded */
+#define TOKEN_ENTRY_OVERHEAD 8
+
+/* A database entry as read from the source file */
+struct DbEntry {
+    ULONG code;
+    char *description;
+    char *insight;
+    const char *file;
+    ULONG fileIndex;    /* Position of the file on the command line */
+    ULONG line;
+    LONG *words;        /* Insight as word ids; tokens are >= wordCount */
+    ULONG wordTotal;
+};
+
+/* One distinct phrase seen while counting candidates */
+struct Candidate {
+    ULONG hash;
+    ULONG entry;        /* First occurrence, used to compare keys */
+    ULONG position;
+    ULONG length;       /* In words */
+    ULONG count;        /* Non-overlapping occurrences */
+    ULONG lastEntry;
+    ULONG lastEnd;
+};
+
+/* Database being generated */
+static struct DbEntry *entries = NULL;
+static ULONG entryCount = 0;
+static ULONG entryCapacity = 0;
+
+/* Interned words - the vocabulary of the insight text */
+static char **words = NULL;
+static ULONG *wordLengths = NULL;
+static ULONG wordCount = 0;
+static ULONG wordCapacity = 0;
+
+/* Learned dictionary, in token order */
+static char *tokens[MAX_TOKENS];
+static ULONG tokenCount = 0;
+
+/* Forward declarations */
+static BOOL ReadDatabase(const char *fileName, ULONG fileIndex);
+static BOOL ParseLine(char *line, const char *fileName, ULONG fileIndex, ULONG lineNumber);
+static char *TrimField(char *text);
+static char *CopyString(const char *text, ULONG length);
+static int CompareEntries(const void *a, const void *b);
+static BOOL SortAndDedupe(ULONG *duplicates);
+static LONG InternWord(const char *text, ULONG length);
+static BOOL SplitInsights(VOID);
+static ULONG PhraseLength(const LONG *phrase, ULONG length);
+static ULONG HashPhrase(const LONG *phrase, ULONG length);
+static BOOL LearnToken(VOID);
+static ULONG CompressedLength(const struct DbEntry *entry);
+static ULONG TokenUses(const struct DbEntry *entry);
+static VOID WriteString(FILE *out, const char *text);
+static VOID WriteCompressed(FILE *out, const struct DbEntry *entry);
+static BOOL WriteTable(const char *fileName);
+static VOID WriteReport(ULONG duplicates);
+
+/* Main entry point */
+int main(int argc, char *argv[])
+{
+    ULONG duplicates;
+    int i;
+
+    if (argc < 3) {
+        fprintf(stderr, "Usage: gendb <output file> <database file> [<database file> ...]\n");
+        return EXIT_FAILURE;
+    }
+
+    for (i = 2; i < argc; i++) {
+        if (!ReadDatabase(argv[i], (ULONG)i)) {
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (!SortAndDedupe(&duplicates) || !SplitInsights()) {
+        return EXIT_FAILURE;
+    }
+
+    while (tokenCount < MAX_TOKENS && LearnToken()) {
+        /* Each pass adds the phrase with the best net saving */
+    }
+
+    if (!WriteTable(argv[1])) {
+        return EXIT_FAILURE;
+    }
+
+    WriteReport(duplicates);
+
+    return EXIT_SUCCESS;
+}
+
+/*
+ * Read every entry from one database file
+ */
+static BOOL ReadDatabase(const char *fileName, ULONG fileIndex)
+{
+    FILE *in;
+    char line[MAX_LINE_LENGTH];
+    ULONG lineNumber;
+    ULONG length;
+    BOOL valid;
+
+    in = fopen(fileName, "r");
+    if (in == NULL) {
+        fprintf(stderr, "gendb: cannot open %s\n", fileName);
+        return FALSE;
+    }
+
+    valid = TRUE;
+    lineNumber = 0;
+    while (fgets(line, sizeof(line), in) != NULL) {
+        lineNumber++;
+
+        length = strlen(line);
+        if (length == sizeof(line) - 1 && line[length - 1] != '\n') {
+            fprintf(stderr, "%s:%lu: line too long\n", fileName, (unsigned long)lineNumber);
+            valid = FALSE;
+            break;
+        }
+
+        if (!ParseLine(line, fileName, fileIndex, lineNumber)) {
+            valid = FALSE;
+        }
+    }
+
+    fclose(in);
+    return valid;
+}
+
+/*
+ * Parse one "0xCODE | Description | Insight" line
+ * Comments and blank lines are skipped
+ */
+static BOOL ParseLine(char *line, const char *fileName, ULONG fileIndex, ULONG lineNumber)
+{
+    struct DbEntry *entry;
+    char *text;
+    char *description;
+    char *insight;
+    ULONG code;
+    ULONG digits;
+    char c;
+
+    text = TrimField(line);
+    if (*text == '\0' || *text == '#') {
+        return TRUE;
+    }
+
+    /* Split into the three fields at the first two separators */
+    description = strchr(text, '|');
+    insight = (description != NULL) ? strchr(description + 1, '|') : NULL;
+    if (insight == NULL) {
+        fprintf(stderr, "%s:%lu: expected 0xCODE | Description | Insight\n", fileName, (unsigned long)lineNumber);
+        return FALSE;
+    }
+    *description++ = '\0';
+    *insight++ = '\0';
+    text = TrimField(text);
+    description = TrimField(description);
+    insight = TrimField(insight);
+
+    /* Code - exactly 8 hex digits after the 0x prefix */
+    code = 0;
+    digits = 0;
+    if (text[0] == '0' && (text[1] == 'x' || text[1] == 'X')) {
+        for (text += 2; *text != '\0' && digits <= 8; text++, digits++) {
+            c = *text;
+            if (c >= '0' && c <= '9') {
+                code = (code << 4) | (ULONG)(c - '0');
+            } else if (c >= 'A' && c <= 'F') {
+                code = (code << 4) | (ULONG)(c - 'A' + 10);
+            } else if (c >= 'a' && c <= 'f') {
+                code = (code << 4) | (ULONG)(c - 'a' + 10);
+            } else {
+                break;
+            }
+        }
+    }
+    if (digits != 8 || *text != '\0') {
+        fprintf(stderr, "%s:%lu: expected 0x followed by an 8 digit code\n", fileName, (unsigned long)lineNumber);
+        return FALSE;
+    }
+
+    if (code == 0xFFFFFFFFUL) {
+        fprintf(stderr, "%s:%lu: 0xFFFFFFFF is reserved for the end marker\n", fileName, (unsigned long)lineNumber);
+        return FALSE;
+    }
+
+    if (*description == '\0' || *insight == '\0') {
+        fprintf(stderr, "%s:%lu: description and insight must not be empty\n", fileName, (unsigned long)lineNumber);
+        return FALSE;
+    }
+
+    /* Bytes from TOKEN_FIRST_CODE up are token codes in the compressed text */
+    for (text = insight; *text != '\0'; text++) {
+        if ((UBYTE)*text < 0x20 || (UBYTE)*text >= TOKEN_FIRST_CODE) {
+            fprintf(stderr, "%s:%lu: insight text must be printable 7-bit ASCII\n", fileName, (unsigned long)lineNumber);
+            return FALSE;
+        }
+    }
+
+    if (entryCount == entryCapacity) {
+        entryCapacity = (entryCapacity == 0) ? 1024 : entryCapacity * 2;
+        entries = (struct DbEntry *)realloc(entries, entryCapacity * sizeof(struct DbEntry));
+        if (entries == NULL) {
+            fprintf(stderr, "gendb: out of memory\n");
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    entry = &entries[entryCount++];
+    entry->code = code;
+    entry->description = CopyString(description, strlen(description));
+    entry->insight = CopyString(insight, strlen(insight));
+    entry->file = fileName;
+    entry->fileIndex = fileIndex;
+    entry->line = lineNumber;
+    entry->words = NULL;
+    entry->wordTotal = 0;
+
+    return TRUE;
+}
+
+/*
+ * Strip leading and trailing white space in place
+ */
+static char *TrimField(char *text)
+{
+    char *end;
+
+    while (*text == ' ' || *text == '\t') {
+        text++;
+    }
+
+    end = text + strlen(text);
+    while (end > text && (end[-1] == ' ' || end[-1] == '\t' || end[-1] == '\n' || end[-1] == '\r')) {
+        end--;
+    }
+    *end = '\0';
+
+    return text;
+}
+
+/*
+ * Allocate a terminated copy of a string
+ */
+static char *CopyString(const char *text, ULONG length)
+{
+    char *copy;
+
+    copy = (char *)malloc(length + 1);
+    if (copy == NULL) {
+        fprintf(stderr, "gendb: out of memory\n");
+        exit(EXIT_FAILURE);
+    }
+
+    memcpy(copy, text, length);
+    copy[length] = '\0';
+
+    return copy;
+}
+
+/*
+ * qsort comparison - by code, then by source position so that the first
+ * definition of a duplicated code is the one kept
+ */
+static int CompareEntries(const void *a, const void *b)
+{
+    const struct DbEntry *ea = (const struct DbEntry *)a;
+    const struct DbEntry *eb = (const struct DbEntry *)b;
+
+    if (ea->code != eb->code) {
+        return (ea->code < eb->code) ? -1 : 1;
+    }
+
+    if (ea->fileIndex != eb->fileIndex) {
+        return (ea->fileIndex < eb->fileIndex) ? -1 : 1;
+    }
+
+    return (ea->line < eb->line) ? -1 : (ea->line > eb->line);
+}
+
+/*
+ * Sort the entries by code and drop exact duplicates
+ * A code defined twice with different text is an error
+ */
+static BOOL SortAndDedupe(ULONG *duplicates)
+{
+    ULONG i;
+    ULONG kept;
+    BOOL valid;
+
+    qsort(entries, entryCount, sizeof(struct DbEntry), CompareEntries);
+
+    valid = TRUE;
+    kept = 0;
+    *duplicates = 0;
+
+    for (i = 0; i < entryCount; i++) {
+        if (kept > 0 && entries[kept - 1].code == entries[i].code) {
+            if (strcmp(entries[kept - 1].description, entries[i].description) != 0 ||
+                strcmp(entries[kept - 1].insight, entries[i].insight) != 0) {
+                fprintf(stderr, "%s:%lu: code 0x%08lX conflicts with %s:%lu\n",
+                        entries[i].file, (unsigned long)entries[i].line, (unsigned long)entries[i].code,
+                        entries[kept - 1].file, (unsigned long)entries[kept - 1].line);
+                valid = FALSE;
+            }
+            (*duplicates)++;
+            continue;
+        }
+        entries[kept++] = entries[i];
+    }
+
+    entryCount = kept;
+
+    if (entryCount > 65535UL) {
+        fprintf(stderr, "gendb: %lu entries, at most 65535 are supported\n", (unsigned long)entryCount);
+        valid = FALSE;
+    }
+
+    return valid;
+}
+
+/*
+ * Return the id of a word, adding it to the vocabulary if new
+ * Words are found through a small chained hash table
+ */
+static LONG InternWord(const char *text, ULONG length)
+{
+    static LONG *buckets = NULL;
+    static LONG *chain = NULL;
+    static ULONG chainCapacity = 0;
+    ULONG hash;
+    ULONG i;
+    LONG id;
+
+    if (buckets == NULL) {
+        buckets = (LONG *)malloc(4096 * sizeof(LONG));
+        if (buckets == NULL) {
+            fprintf(stderr, "gendb: out of memory\n");
+            exit(EXIT_FAILURE);
+        }
+        for (i = 0; i < 4096; i++) {
+            buckets[i] = -1;
+        }
+    }
+
+    hash = 5381;
+    for (i = 0; i < length; i++) {
+        hash = (hash * 33) ^ (UBYTE)text[i];
+    }
+    hash &= 4095;
+
+    for (id = buckets[hash]; id >= 0; id = chain[id]) {
+        if (wordLengths[id] == length && memcmp(words[id], text, length) == 0) {
+            return id;
+        }
+    }
+
+    if (wordCount == wordCapacity) {
+        wordCapacity = (wordCapacity == 0) ? 4096 : wordCapacity * 2;
+        words = (char **)realloc(words, wordCapacity * sizeof(char *));
+        wordLengths = (ULONG *)realloc(wordLengths, wordCapacity * sizeof(ULONG));
+        if (words == NULL || wordLengths == NULL) {
+            fprintf(stderr, "gendb: out of memory\n");
+            exit(EXIT_FAILURE);
+        }
+    }
+    if (wordCount >= chainCapacity) {
+        chainCapacity = wordCapacity;
+        chain = (LONG *)realloc(chain, chainCapacity * sizeof(LONG));
+        if (chain == NULL) {
+            fprintf(stderr, "gendb: out of memory\n");
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    id = (LONG)wordCount++;
+    words[id] = CopyString(text, length);
+    wordLengths[id] = length;
+    chain[id] = buckets[hash];
+    buckets[hash] = id;
+
+    return id;
+}
+
+/*
+ * Split every insight into word ids at single spaces
+ * Splitting at every space (empty words included) keeps the round trip exact
+ */
+static BOOL SplitInsights(VOID)
+{
+    struct DbEntry *entry;
+    const char *start;
+    const char *end;
+    ULONG i;
+    ULONG n;
+
+    for (i = 0; i < entryCount; i++) {
+        entry = &entries[i];
+
+        n = 1;
+        for (end = entry->insight; *end != '\0'; end++) {
+            if (*end == ' ') {
+                n++;
+            }
+        }
+
+        entry->words = (LONG *)malloc(n * sizeof(LONG));
+        if (entry->words == NULL) {
+            fprintf(stderr, "gendb: out of memory\n");
+            return FALSE;
+        }
+
+        entry->wordTotal = 0;
+        start = entry->insight;
+        for (;;) {
+            end = start;
+            while (*end != '\0' && *end != ' ') {
+                end++;
+            }
+            entry->words[entry->wordTotal++] = InternWord(start, (ULONG)(end - start));
+            if (*end == '\0') {
+                break;
+            }
+            start = end + 1;
+        }
+    }
+
+    return TRUE;
+}
+
+/*
+ * Length in characters of a phrase of plain words joined by spaces
+ */
+static ULONG PhraseLength(const LONG *phrase, ULONG length)
+{
+    ULONG total;
+    ULONG i;
+
+    total = length - 1;
+    for (i = 0; i < length; i++) {
+        total += wordLengths[phrase[i]];
+    }
+
+    return total;
+}
+
+/*
+ * Hash a phrase of word ids
+ */
+static ULONG HashPhrase(const LONG *phrase, ULONG length)
+{
+    ULONG hash;
+    ULONG i;
+
+    hash = 2166136261UL;
+    for (i = 0; i < length; i++) {
+        hash = (hash ^ (ULONG)phrase[i]) * 16777619UL;
+    }
+
+    return hash ^ length;
+}
+
+/*
+ * Count every candidate phrase, pick the one with the best net saving and
+ * replace its occurrences with a new token
+ * Returns FALSE when no phrase would make the database smaller
+ */
+static BOOL LearnToken(VOID)
+{
+    struct Candidate *table;
+    struct Candidate *slot;
+    struct Candidate *best;
+    struct DbEntry *entry;
+    const LONG *phrase;
+    ULONG tableSize;
+    ULONG grams;
+    ULONG i;
+    ULONG j;
+    ULONG n;
+    ULONG k;
+    ULONG out;
+    ULONG hash;
+    LONG gain;
+    LONG bestGain;
+    LONG tokenId;
+    LONG *bestPhrase;
+    ULONG bestLength;
+    ULONG reference;
+    BOOL plain;
+
+    /* Size the open addressing table for the worst case */
+    grams = 0;
+    for (i = 0; i < entryCount; i++) {
+        grams += entries[i].wordTotal * MAX_PHRASE_WORDS;
+    }
+    tableSize = 1024;
+    while (tableSize < grams * 2) {
+        tableSize <<= 1;
+    }
+
+    table = (struct Candidate *)calloc(tableSize, sizeof(struct Candidate));
+    if (table == NULL) {
+        fprintf(stderr, "gendb: out of memory\n");
+        exit(EXIT_FAILURE);
+    }
+
+    for (i = 0; i < entryCount; i++) {
+        entry = &entries[i];
+        for (j = 0; j < entry->wordTotal; j++) {
+            for (n = 1; n <= MAX_PHRASE_WORDS && j + n <= entry->wordTotal; n++) {
+                phrase = &entry->words[j];
+
+                /* Tokens are never nested inside other tokens */
+                if (phrase[n - 1] >= (LONG)wordCount || phrase[0] >= (LONG)wordCount) {
+                    break;
+                }
+
+                hash = HashPhrase(phrase, n);
+                k = hash & (tableSize - 1);
+                for (;;) {
+                    slot = &table[k];
+                    if (slot->count == 0) {
+                        slot->hash = hash;
+                        slot->entry = i;
+                        slot->position = j;
+                        slot->length = n;
+                        slot->count = 1;
+                        slot->lastEntry = i;
+                        slot->lastEnd = j + n;
+                        break;
+                    }
+                    if (slot->hash == hash && slot->length == n &&
+                        memcmp(&entries[slot->entry].words[slot->position], phrase, n * sizeof(LONG)) == 0) {
+                        /* Only count occurrences that do not overlap the previous one */
+                        if (slot->lastEntry != i || j >= slot->lastEnd) {
+                            slot->count++;
+                            slot->lastEntry = i;
+                            slot->lastEnd = j + n;
+                        }
+                        break;
+                    }
+                    k = (k + 1) & (tableSize - 1);
+                }
+            }
+        }
+    }
+
+    /* References to the next token cost one or two bytes */
+    reference = TOKEN_REFERENCE_SIZE(tokenCount);
+    best = NULL;
+    bestGain = 0;
+    for (k = 0; k < tableSize; k++) {
+        slot = &table[k];
+        if (slot->count < 2) {
+            continue;
+        }
+        n = PhraseLength(&entries[slot->entry].words[slot->position], slot->length);
+        if (n <= reference) {
+            continue;
+        }
+        gain = (LONG)(slot->count * (n - reference)) - (LONG)(n + 1) - TOKEN_ENTRY_OVERHEAD;
+        if (gain > bestGain) {
+            bestGain = gain;
+            best = slot;
+        }
+    }
+
+    if (best == NULL) {
+        free(table);
+        return FALSE;
+    }
+
+    /* Record the phrase text as the token value */
+    bestLength = best->length;
+    bestPhrase = (LONG *)malloc(bestLength * sizeof(LONG));
+    if (bestPhrase == NULL) {
+        fprintf(stderr, "gendb: out of memory\n");
+        exit(EXIT_FAILURE);
+    }
+    memcpy(bestPhrase, &entries[best->entry].words[best->position], bestLength * sizeof(LONG));
+    free(table);
+
+    n = PhraseLength(bestPhrase, bestLength);
+    tokens[tokenCount] = (char *)malloc(n + 1);
+    if (tokens[tokenCount] == NULL) {
+        fprintf(stderr, "gendb: out of memory\n");
+        exit(EXIT_FAILURE);
+    }
+    out = 0;
+    for (i = 0; i < bestLength; i++) {
+        if (i > 0) {
+            tokens[tokenCount][out++] = ' ';
+        }
+        memcpy(tokens[tokenCount] + out, words[bestPhrase[i]], wordLengths[bestPhrase[i]]);
+        out += wordLengths[bestPhrase[i]];
+    }
+    tokens[tokenCount][out] = '\0';
+
+    /* Replace every non-overlapping occurrence, left to right */
+    tokenId = (LONG)(wordCount + tokenCount);
+    for (i = 0; i < entryCount; i++) {
+        entry = &entries[i];
+        out = 0;
+        j = 0;
+        while (j < entry->wordTotal) {
+            plain = (j + bestLength <= entry->wordTotal &&
+                     memcmp(&entry->words[j], bestPhrase, bestLength * sizeof(LONG)) == 0);
+            if (plain) {
+                entry->words[out++] = tokenId;
+                j += bestLength;
+            } else {
+                entry->words[out++] = entry->words[j++];
+            }
+        }
+        entry->wordTotal = out;
+    }
+
+    free(bestPhrase);
+    tokenCount++;
+
+    return TRUE;
+}
+
+/*
+ * Size of an entry's compressed insight text, excluding the terminator
+ */
+static ULONG CompressedLength(const struct DbEntry *entry)
+{
+    ULONG total;
+    ULONG i;
+
+    total = entry->wordTotal - 1;
+    for (i = 0; i < entry->wordTotal; i++) {
+        if (entry->words[i] >= (LONG)wordCount) {
+            total += TOKEN_REFERENCE_SIZE(entry->words[i] - (LONG)wordCount);
+        } else {
+            total += wordLengths[entry->words[i]];
+        }
+    }
+
+    return total;
+}
+
+/*
+ * Number of token references in an entry's compressed insight
+ */
+static ULONG TokenUses(const struct DbEntry *entry)
+{
+    ULONG uses;
+    ULONG i;
+
+    uses = 0;
+    for (i = 0; i < entry->wordTotal; i++) {
+        if (entry->words[i] >= (LONG)wordCount) {
+            uses++;
+        }
+    }
+
+    return uses;
+}
+
+/*
+ * Write a C string literal, escaping anything the compiler would interpret
+ */
+static VOID WriteString(FILE *out, const char *text)
+{
+    fputc('"', out);
+    while (*text != '\0') {
+        if (*text == '"' || *text == '\\') {
+            fputc('\\', out);
+            fputc(*text, out);
+        } else if (*text == '?' && text[1] == '?') {
+            /* Break up trigraphs */
+            fputs("?\\", out);
+        } else if ((UBYTE)*text < 0x20 || (UBYTE)*text >= 0x7F) {
+            fprintf(out, "\\%03o", (unsigned int)(UBYTE)*text);
+        } else {
+            fputc(*text, out);
+        }
+        text++;
+    }
+    fputc('"', out);
+}
+
+/*
+ * Write an entry's compressed insight as a C string literal
+ */
+static VOID WriteCompressed(FILE *out, const struct DbEntry *entry)
+{
+    char *text;
+    char *dst;
+    ULONG token;
+    ULONG i;
+
+    text = (char *)malloc(CompressedLength(entry) + 1);
+    if (text == NULL) {
+        fprintf(stderr, "gendb: out of memory\n");
+        exit(EXIT_FAILURE);
+    }
+
+    dst = text;
+    for (i = 0; i < entry->wordTotal; i++) {
+        if (i > 0) {
+            *dst++ = ' ';
+        }
+        if (entry->words[i] >= (LONG)wordCount) {
+            token = (ULONG)(entry->words[i] - (LONG)wordCount);
+            if (token < TOKEN_SHORT_COUNT) {
+                *dst++ = (char)(TOKEN_FIRST_CODE + token);
+            } else {
+                *dst++ = (char)TOKEN_ESCAPE_CODE;
+                *dst++ = (char)(token - TOKEN_SHORT_COUNT + 1);
+            }
+        } else {
+            memcpy(dst, words[entry->words[i]], wordLengths[entry->words[i]]);
+            dst += wordLengths[entry->words[i]];
+        }
+    }
+    *dst = '\0';
+
+    WriteString(out, text);
+    free(text);
+}
+
+/*
+ * Write the generated errorTable[], tokenTable[] and insightLengthTable[]
+ */
+static BOOL WriteTable(const char *fileName)
+{
+    FILE *out;
+    ULONG i;
+
+    out = fopen(fileName, "w");
+    if (out == NULL) {
+        fprintf(stderr, "gendb: cannot write %s\n", fileName);
+        return FALSE;
+    }
+
+    fprintf(out, "/*\n * Error Codes Database - generated by gendb, do not edit\n");
+    fprintf(out, " * Edit error_codes.txt instead.\n */\n\n");
+    fprintf(out, "#include <stdio.h>\n#include \"error_codes.h\"\n\n");
+
+    fprintf(out, "/* Consolidated error lookup table, sorted by code */\n");
+    fprintf(out, "struct ErrorInfo errorTable[] = {\n");
+    for (i = 0; i < entryCount; i++) {
+        fprintf(out, "    { 0x%08lX, ", (unsigned long)entries[i].code);
+        WriteString(out, entries[i].description);
+        fprintf(out, ", ");
+        WriteCompressed(out, &entries[i]);
+        fprintf(out, " },\n");
+    }
+    fprintf(out, "\n    /* End marker */\n");
+    fprintf(out, "    { 0xFFFFFFFF, \"End of table\", \"End marker for error table.\" }\n};\n\n");
+    fprintf(out, "/* Number of entries in the error table */\n");
+    fprintf(out, "const ULONG ERROR_TABLE_SIZE = sizeof(errorTable) / sizeof(struct ErrorInfo);\n\n");
+
+    fprintf(out, "/* Token dictionary learned from the insight text */\n");
+    fprintf(out, "const struct TokenInfo tokenTable[] = {\n");
+    for (i = 0; i < tokenCount; i++) {
+        fprintf(out, "    { ");
+        WriteString(out, tokens[i]);
+        fprintf(out, ", %lu },\n", (unsigned long)strlen(tokens[i]));
+    }
+    fprintf(out, "    { NULL, 0 }\n};\n\n");
+    fprintf(out, "/* Number of tokens, excluding the terminator */\n");
+    fprintf(out, "const ULONG TOKEN_TABLE_SIZE = %lu;\n\n", (unsigned long)tokenCount);
+
+    /* The round trip is exact, so the expanded length is the source length */
+    fprintf(out, "/* Expanded insight length of each errorTable entry */\n");
+    fprintf(out, "const UWORD insightLengthTable[] = {\n");
+    for (i = 0; i < entryCount; i++) {
+        fprintf(out, "    %lu,\n", (unsigned long)strlen(entries[i].insight));
+    }
+    fprintf(out, "    %lu\n};\n", (unsigned long)strlen("End marker for error table."));
+
+    if (fclose(out) != 0) {
+        fprintf(stderr, "gendb: error writing %s\n", fileName);
+        return FALSE;
+    }
+
+    return TRUE;
+}
+
+/*
+ * Print the compression report
+ */
+static VOID WriteReport(ULONG duplicates)
+{
+    ULONG rawBytes;
+    ULONG packedBytes;
+    ULONG dictionaryBytes;
+    ULONG uses;
+    ULONG maxUses;
+    ULONG i;
+
+    rawBytes = 0;
+    packedBytes = 0;
+    uses = 0;
+    maxUses = 0;
+    for (i = 0; i < entryCount; i++) {
+        rawBytes += strlen(entries[i].insight) + 1;
+        packedBytes += CompressedLength(&entries[i]) + 1;
+        uses += TokenUses(&entries[i]);
+        if (TokenUses(&entries[i]) > maxUses) {
+            maxUses = TokenUses(&entries[i]);
+        }
+    }
+
+    dictionaryBytes = 0;
+    for (i = 0; i < tokenCount; i++) {
+        dictionaryBytes += strlen(tokens[i]) + 1 + TOKEN_ENTRY_OVERHEAD;
+    }
+
+    printf("gendb: %lu entries, %lu duplicates removed\n",
+           (unsigned long)entryCount, (unsigned long)duplicates);
+    printf("gendb: insight text %lu bytes raw, %lu bytes compressed + %lu bytes dictionary (%lu tokens)\n",
+           (unsigned long)rawBytes, (unsigned long)packedBytes,
+           (unsigned long)dictionaryBytes, (unsigned long)tokenCount);
+    if (packedBytes + dictionaryBytes > 0) {
+        printf("gendb: expansion ratio %lu.%02lu:1\n",
+               (unsigned long)(rawBytes / (packedBytes + dictionaryBytes)),
+               (unsigned long)((rawBytes * 100 / (packedBytes + dictionaryBytes)) % 100));
+    }
+    if (entryCount > 0) {
+        printf("gendb: decode cost %lu.%02lu token expansions per insight (max %lu)\n",
+               (unsigned long)(uses / entryCount),
+               (unsigned long)((uses * 100 / entryCount) % 100),
+               (unsigned long)maxUses);
+    }
+}
@@ -0,0 +1,370 @@
+/*
+ * Database File Generator
+ *
+ * Build-time generator for insight.idb, the database file Insight can load
+ * in place of its compiled-in tables.  Links the generated error_table.c
+ * and lookup_tables.c, so the file holds exactly the entries, token
+ * dictionary, alert range index and search index that are compiled in.  The file is read
+ * back through OpenInsightDatabaseMemory and compared entry by entry before
+ * it is written; the build fails on any difference.
+ *
+ * Usage: genidb <output file>
+ *
+ * After meditiation comes... Insight
+ *
+ * Copyright (c) 2025-26 amigazen project
+ * Licensed under BSD 2-Clause License
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "error_codes.h"
+#include "lookup.h"
+#include "decompose.h"
+#include "idb.h"
+#include "search.h"
+#include "names.h"
+
+/* Growing byte image of the file being built */
+struct Image {
+    UBYTE *data;
+    ULONG size;
+    ULONG capacity;
+};
+
+/* Forward declarations */
+static BOOL Reserve(struct Image *image, ULONG size);
+static VOID PutLongAt(struct Image *image, ULONG offset, ULONG value);
+static VOID PutWordAt(struct Image *image, ULONG offset, UWORD value);
+static ULONG AddString(struct Image *image, ULONG poolStart, const char *text, ULONG length);
+static BOOL VerifyImage(const struct Image *image, ULONG tableSize, ULONG classEntries);
+
+/* Main entry point */
+int main(int argc, char *argv[])
+{
+    struct Image image;
+    FILE *out;
+    ULONG tableSize;
+    ULONG classEntries;
+    ULONG codesOffset;
+    ULONG bucketsOffset;
+    ULONG entriesOffset;
+    ULONG tokensOffset;
+    ULONG alertOffset;
+    ULONG poolOffset;
+    ULONG poolSize;
+    ULONG searchOffset;
+    ULONG nameOffset;
+    ULONG bucket;
+    ULONG first;
+    ULONG entry;
+    ULONG i;
+
+    if (argc != 2) {
+        fprintf(stderr, "Usage: genidb <output file>\n");
+        return EXIT_FAILURE;
+    }
+
+    /* Exclude the end marker (0xFFFFFFFF) */
+    tableSize = ERROR_TABLE_SIZE - 1;
+
+    classEntries = 0;
+    for (i = 0; i < ALERT_SUBSYSTEMS; i++) {
+        if ((ULONG)alertClassBase[i] + alertClassCount[i] > classEntries) {
+            classEntries = (ULONG)alertClassBase[i] + alertClassCount[i];
+        }
+    }
+
+    /* Fixed-size sections first, then the string pool */
+    codesOffset = IDB_HEADER_SIZE;
+    bucketsOffset = codesOffset + tableSize * 4;
+    entriesOffset = bucketsOffset + (IDB_BUCKETS + 1) * 4;
+    tokensOffset = entriesOffset + tableSize * IDB_ENTRY_SIZE;
+    alertOffset = tokensOffset + TOKEN_TABLE_SIZE * IDB_TOKEN_SIZE;
+    poolOffset = (alertOffset + (3 * ALERT_SUBSYSTEMS + classEntries) * 2 + 3) & ~3UL;
+
+    image.data = NULL;
+    image.size = 0;
+    image.capacity = 0;
+    if (!Reserve(&image, poolOffset)) {
+        fprintf(stderr, "genidb: out of memory\n");
+        return EXIT_FAILURE;
+    }
+    memset(image.data, 0, poolOffset);
+    image.size = poolOffset;
+
+    /* Codes, with the first entry of each top byte */
+    first = 0;
+    for (bucket = 0; bucket <= IDB_BUCKETS; bucket++) {
+        while (first < tableSize && (errorTable[first].code >> 24) < bucket) {
+            first++;
+        }
+        PutLongAt(&image, bucketsOffset + bucket * 4, first);
+    }
+
+    for (i = 0; i < tableSize; i++) {
+        entry = entriesOffset + i * IDB_ENTRY_SIZE;
+        PutLongAt(&image, codesOffset + i * 4, errorTable[i].code);
+        PutLongAt(&image, entry, AddString(&image, poolOffset, errorTable[i].description,
+                                            (ULONG)strlen(errorTable[i].description)));
+        PutLongAt(&image, entry + 4, AddString(&image, poolOffset, errorTable[i].insight,
+                                                (ULONG)strlen(errorTable[i].insight)));
+        PutLongAt(&image, entry + 8, insightLengthTable[i]);
+    }
+
+    for (i = 0; i < TOKEN_TABLE_SIZE; i++) {
+        PutLongAt(&image, tokensOffset + i * IDB_TOKEN_SIZE,
+                  AddString(&image, poolOffset, tokenTable[i].value, tokenTable[i].length));
+        PutLongAt(&image, tokensOffset + i * IDB_TOKEN_SIZE + 4, tokenTable[i].length);
+    }
+
+    for (i = 0; i < ALERT_SUBSYSTEMS; i++) {
+        PutWordAt(&image, alertOffset + (IDB_ALERT_SUBSYSTEM_ENTRY * ALERT_SUBSYSTEMS + i) * 2, alertSubsystemEntry[i]);
+        PutWordAt(&image, alertOffset + (IDB_ALERT_CLASS_BASE * ALERT_SUBSYSTEMS + i) * 2, alertClassBase[i]);
+        PutWordAt(&image, alertOffset + (IDB_ALERT_CLASS_COUNT * ALERT_SUBSYSTEMS + i) * 2, alertClassCount[i]);
+    }
+    for (i = 0; i < classEntries; i++) {
+        PutWordAt(&image, alertOffset + (3 * ALERT_SUBSYSTEMS + i) * 2, alertClassEntry[i]);
+    }
+
+    /* The search and name indexes follow the pool, copied as they are */
+    poolSize = image.size - poolOffset;
+    searchOffset = (image.size + 3) & ~3UL;
+    if (Reserve(&image, searchOffset + searchIndexSize)) {
+        memset(image.data + image.size, 0, searchOffset - image.size);
+        memcpy(image.data + searchOffset, searchIndex, searchIndexSize);
+        image.size = searchOffset + searchIndexSize;
+    }
+    nameOffset = (image.size + 3) & ~3UL;
+    if (Reserve(&image, nameOffset + nameIndexSize)) {
+        memset(image.data + image.size, 0, nameOffset - image.size);
+        memcpy(image.data + nameOffset, nameIndex, nameIndexSize);
+        image.size = nameOffset + nameIndexSize;
+    }
+
+    if (image.data == NULL) {
+        fprintf(stderr, "genidb: out of memory\n");
+        return EXIT_FAILURE;
+    }
+
+    /* Header last, with the checksum over everything else */
+    PutLongAt(&image, IDB_FIELD_MAGIC * 4, IDB_MAGIC);
+    PutLongAt(&image, IDB_FIELD_VERSION * 4, ((ULONG)IDB_VERSION_MAJOR << 16) | IDB_VERSION_MINOR);
+    PutLongAt(&image, IDB_FIELD_HEADER_SIZE * 4, IDB_HEADER_SIZE);
+    PutLongAt(&image, IDB_FIELD_FILE_SIZE * 4, image.size);
+    PutLongAt(&image, IDB_FIELD_ENTRY_COUNT * 4, tableSize);
+    PutLongAt(&image, IDB_FIELD_TOKEN_COUNT * 4, TOKEN_TABLE_SIZE);
+    PutLongAt(&image, IDB_FIELD_CODES * 4, codesOffset);
+    PutLongAt(&image, IDB_FIELD_BUCKETS * 4, bucketsOffset);
+    PutLongAt(&image, IDB_FIELD_ENTRIES * 4, entriesOffset);
+    PutLongAt(&image, IDB_FIELD_TOKENS * 4, tokensOffset);
+    PutLongAt(&image, IDB_FIELD_ALERT_INDEX * 4, alertOffset);
+    PutLongAt(&image, IDB_FIELD_CLASS_ENTRIES * 4, classEntries);
+    PutLongAt(&image, IDB_FIELD_POOL * 4, poolOffset);
+    PutLongAt(&image, IDB_FIELD_POOL_SIZE * 4, poolSize);
+    PutLongAt(&image, IDB_FIELD_SEARCH_INDEX * 4, searchOffset);
+    PutLongAt(&image, IDB_FIELD_NAME_INDEX * 4, nameOffset);
+    PutLongAt(&image, IDB_FIELD_CHECKSUM * 4, IdbChecksum(0, image.data, image.size));
+
+    if (!VerifyImage(&image, tableSize, classEntries)) {
+        return EXIT_FAILURE;
+    }
+
+    out = fopen(argv[1], "wb");
+    if (out == NULL) {
+        fprintf(stderr, "genidb: cannot create %s\n", argv[1]);
+        return EXIT_FAILURE;
+    }
+    if (fwrite(image.data, 1, image.size, out) != image.size || fclose(out) != 0) {
+        fprintf(stderr, "genidb: cannot write %s\n", argv[1]);
+        return EXIT_FAILURE;
+    }
+
+    printf("genidb: %lu entries, %lu tokens, %lu bytes (%lu of strings, %lu of search index, %lu of name index)\n",
+           (unsigned long)tableSize, (unsigned long)TOKEN_TABLE_SIZE, (unsigned long)image.size,
+           (unsigned long)poolSize, (unsigned long)searchIndexSize, (unsigned long)nameIndexSize);
+
+    free(image.data);
+    return EXIT_SUCCESS;
+}
+
+/*
+ * Make room for size bytes in the image
+ * On failure the image data is freed and set to NULL.
+ */
+static BOOL Reserve(struct Image *image, ULONG size)
+{
+    UBYTE *data;
+    ULONG capacity;
+
+    if (image->data == NULL && image->capacity != 0) {
+        return FALSE;
+    }
+    if (size <= image->capacity) {
+        return TRUE;
+    }
+
+    capacity = (image->capacity > 0) ? image->capacity : 65536;
+    while (capacity < size) {
+        capacity *= 2;
+    }
+
+    data = (UBYTE *)realloc(image->data, capacity);
+    if (data == NULL) {
+        free(image->data);
+        image->data = NULL;
+        return FALSE;
+    }
+
+    image->data = data;
+    image->capacity = capacity;
+    return TRUE;
+}
+
+/*
+ * Store a big-endian ULONG
+ */
+static VOID PutLongAt(struct Image *image, ULONG offset, ULONG value)
+{
+    if (image->data == NULL) {
+        return;
+    }
+
+    image->data[offset] = (UBYTE)(value >> 24);
+    image->data[offset + 1] = (UBYTE)(value >> 16);
+    image->data[offset + 2] = (UBYTE)(value >> 8);
+    image->data[offset + 3] = (UBYTE)value;
+}
+
+/*
+ * Store a big-endian UWORD
+ */
+static VOID PutWordAt(struct Image *image, ULONG offset, UWORD value)
+{
+    if (image->data == NULL) {
+        return;
+    }
+
+    image->data[offset] = (UBYTE)(value >> 8);
+    image->data[offset + 1] = (UBYTE)value;
+}
+
+/*
+ * Add a string to the pool, reusing an identical earlier one
+ * Returns its offset from the start of the pool.
+ */
+static ULONG AddString(struct Image *image, ULONG poolStart, const char *text, ULONG length)
+{
+    ULONG offset;
+
+    if (image->data == NULL) {
+        return 0;
+    }
+
+    /* Strings are NUL-terminated, so a match must end at a terminator too */
+    offset = poolStart;
+    while (offset < image->size) {
+        if (strlen((const char *)image->data + offset) == length &&
+            memcmp(image->data + offset, text, length) == 0) {
+            return offset - poolStart;
+        }
+        offset += (ULONG)strlen((const char *)image->data + offset) + 1;
+    }
+
+    if (!Reserve(image, image->size + length + 1)) {
+        return 0;
+    }
+    offset = image->size;
+    memcpy(image->data + offset, text, length);
+    image->data[offset + length] = '\0';
+    image->size += length + 1;
+
+    return offset - poolStart;
+}
+
+/*
+ * Open the finished image the way Insight will and compare it with the
+ * compiled-in tables
+ */
+static BOOL VerifyImage(const struct Image *image, ULONG tableSize, ULONG classEntries)
+{
+    struct InsightDatabase *database;
+    struct ErrorView view;
+    ULONG error;
+    ULONG i;
+    BOOL success;
+
+    database = OpenInsightDatabaseMemory(image->data, image->size, 0, &error);
+    if (database == NULL) {
+        fprintf(stderr, "genidb: generated file does not open: %s\n", IdbErrorText(error));
+        return FALSE;
+    }
+
+    success = TRUE;
+    for (i = 0; i < tableSize && success; i++) {
+        IdbEntryView(database, i, &view);
+        if (IdbLookup(database, errorTable[i].code) != (LONG)i || view.code != errorTable[i].code ||
+            strcmp(view.description, errorTable[i].description) != 0 ||
+            strcmp(view.insight, errorTable[i].insight) != 0 || view.insightLength != insightLengthTable[i]) {
+            fprintf(stderr, "genidb: entry 0x%08lX differs in the generated file\n", (unsigned long)errorTable[i].code);
+            success = FALSE;
+        }
+    }
+    for (i = 0; i < TOKEN_TABLE_SIZE && success; i++) {
+        if (database->tokens[i].length != tokenTable[i].length ||
+            strcmp(database->tokens[i].value, tokenTable[i].value) != 0) {
+            fprintf(stderr, "genidb: token %lu differs in the generated file\n", (unsigned long)i);
+            success = FALSE;
+        }
+    }
+    for (i = 0; i < ALERT_SUBSYSTEMS && success; i++) {
+        if (IdbAlertIndex(database, IDB_ALERT_SUBSYSTEM_ENTRY, i) != alertSubsystemEntry[i] ||
+            IdbAlertIndex(database, IDB_ALERT_CLASS_BASE, i) != alertClassBase[i] ||
+            IdbAlertIndex(database, IDB_ALERT_CLASS_COUNT, i) != alertClassCount[i]) {
+            fprintf(stderr, "genidb: alert index differs for subsystem 0x%02lX\n", (unsigned long)i);
+            success = FALSE;
+        }
+    }
+    for (i = 0; i < classEntries && success; i++) {
+        if (IdbAlertIndex(database, IDB_ALERT_CLASS_ENTRY, i) != alertClassEntry[i]) {
+            fprintf(stderr, "genidb: alert class entry %lu differs\n", (unsigned long)i);
+            success = FALSE;
+        }
+    }
+    if (success && (database->searchIndexSize != searchIndexSize ||
+                    memcmp(database->searchIndex, searchIndex, searchIndexSize) != 0)) {
+        fprintf(stderr, "genidb: search index differs in the generated file\n");
+        success = FALSE;
+    }
+    if (success && (database->nameIndexSize != nameIndexSize ||
+                    memcmp(database->nameIndex, nameIndex, nameIndexSize) != 0)) {
+        fprintf(stderr, "genidb: name index differs in the generated file\n");
+        success = FALSE;
+    }
+
+    CloseInsightDatabase(database);
+    return success;
+}
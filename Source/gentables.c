@@ -0,0 +1,866 @@
+/*
+ * Lookup Table Generator
+ *
+ * Build-time generator for the lookup engine tables.  Checks that
+ * errorTable[] is sorted with no duplicate codes, then writes the packed,
+ * Eytzinger, subsystem and minimal perfect hash tables to lookup_tables.c,
+ * along with the range index used to decode alerts missing from the table,
+ * the SEARCH index over the expanded text and the NAME index over the
+ * descriptions.  The build fails if the database breaks the ordering
+ * rules.
+ *
+ * Usage: gentables <output file>
+ *
+ * After meditiation comes... Insight
+ *
+ * Copyright (c) 2025-26 amigazen project
+ * Licensed under BSD 2-Clause License
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "error_codes.h"
+#include "lookup.h"
+#include "lookup_hash.h"
+#include "decompose.h"
+#include "search.h"
+#include "search_terms.h"
+#include "names.h"
+#include "name_text.h"
+
+/* Largest table the UWORD index arrays can address */
+#define MAX_TABLE_ENTRIES 65535UL
+
+/* Seeds tried per perfect hash bucket before growing the bucket count */
+#define MAX_PERFECT_SEED 0x100000UL
+
+/* One use of a term in an entry, before the uses are sorted and counted */
+struct TermUse {
+    char term[SEARCH_TERM_SIZE];
+    UWORD entry;
+    UWORD frequency;
+};
+
+/* A word start in a description, before the places are sorted */
+struct NamePlace {
+    UWORD entry;
+    UBYTE offset;
+};
+
+/* Growing byte image of the search or name index */
+struct ByteImage {
+    UBYTE *data;
+    ULONG size;
+    ULONG capacity;
+};
+
+/* Forward declarations */
+static BOOL ValidateTable(ULONG tableSize);
+static ULONG FillEytzinger(ULONG *codes, UWORD *indices, ULONG tableSize, ULONG next, ULONG k);
+static BOOL BuildPerfectHash(ULONG tableSize, ULONG bucketCount, ULONG *seeds, ULONG *slotCodes, UWORD *slotIndices);
+static ULONG BuildAlertIndex(ULONG tableSize, UWORD *subsystemEntry, UWORD *classBase, UWORD *classCount, UWORD *classEntry);
+static VOID WriteULongArray(FILE *out, const char *decl, const ULONG *values, ULONG count);
+static VOID WriteUWordArray(FILE *out, const char *decl, const UWORD *values, ULONG count);
+static VOID WriteUByteArray(FILE *out, const char *decl, const UBYTE *values, ULONG count);
+static ULONG BuildSearchIndex(ULONG tableSize, struct ByteImage *image);
+static ULONG AddTermUses(struct TermUse **uses, ULONG count, ULONG *capacity, CONST_STRPTR text, ULONG entry,
+                         ULONG frequency);
+static int CompareTermUses(const VOID *a, const VOID *b);
+static STRPTR ExpandInsight(ULONG entry);
+static ULONG SearchTermWeight(ULONG entries, ULONG documents);
+static ULONG BuildNameIndex(ULONG tableSize, struct ByteImage *image);
+static int CompareNamePlaces(const VOID *a, const VOID *b);
+static VOID PutByte(struct ByteImage *image, UBYTE value);
+static VOID PutLongAt(struct ByteImage *image, ULONG offset, ULONG value);
+
+/* Main entry point */
+int main(int argc, char *argv[])
+{
+    FILE *out;
+    ULONG tableSize;
+    ULONG bucketCount;
+    ULONG i;
+    ULONG *codes;
+    ULONG *eytzinger;
+    UWORD *eytzingerIdx;
+    UWORD subsystems[257];
+    ULONG *seeds;
+    ULONG *slotCodes;
+    UWORD *slotIndices;
+    UWORD alertSubsystems[ALERT_SUBSYSTEMS];
+    UWORD alertBases[ALERT_SUBSYSTEMS];
+    UWORD alertCounts[ALERT_SUBSYSTEMS];
+    UWORD *alertClasses;
+    ULONG alertSlots;
+    struct ByteImage search;
+    ULONG searchTerms;
+    struct ByteImage names;
+    ULONG namePlaces;
+
+    if (argc != 2) {
+        fprintf(stderr, "Usage: gentables <output file>\n");
+        return EXIT_FAILURE;
+    }
+
+    /* Exclude the end marker (0xFFFFFFFF) */
+    tableSize = ERROR_TABLE_SIZE - 1;
+
+    if (!ValidateTable(tableSize)) {
+        return EXIT_FAILURE;
+    }
+
+    codes = (ULONG *)malloc((tableSize + 1) * sizeof(ULONG));
+    eytzinger = (ULONG *)malloc((tableSize + 1) * sizeof(ULONG));
+    eytzingerIdx = (UWORD *)malloc((tableSize + 1) * sizeof(UWORD));
+    slotCodes = (ULONG *)malloc((tableSize + 1) * sizeof(ULONG));
+    slotIndices = (UWORD *)malloc((tableSize + 1) * sizeof(UWORD));
+    alertClasses = (UWORD *)malloc(ALERT_SUBSYSTEMS * 256 * sizeof(UWORD));
+    seeds = NULL;
+    if (codes == NULL || eytzinger == NULL || eytzingerIdx == NULL ||
+        slotCodes == NULL || slotIndices == NULL || alertClasses == NULL) {
+        fprintf(stderr, "gentables: out of memory\n");
+        return EXIT_FAILURE;
+    }
+
+    /* Packed code column, in table order */
+    for (i = 0; i < tableSize; i++) {
+        codes[i] = errorTable[i].code;
+    }
+
+    /* Eytzinger layout is 1-based; slot 0 is never probed */
+    eytzinger[0] = 0;
+    eytzingerIdx[0] = 0;
+    FillEytzinger(eytzinger, eytzingerIdx, tableSize, 0, 1);
+
+    /* First index of each subsystem byte, with a sentinel at 256 */
+    for (i = 0; i <= 256; i++) {
+        ULONG first = 0;
+        while (first < tableSize && (codes[first] >> 24) < i) {
+            first++;
+        }
+        subsystems[i] = (UWORD)first;
+    }
+
+    alertSlots = BuildAlertIndex(tableSize, alertSubsystems, alertBases, alertCounts, alertClasses);
+
+    searchTerms = BuildSearchIndex(tableSize, &search);
+    namePlaces = BuildNameIndex(tableSize, &names);
+
+    /* Minimal perfect hash - grow the bucket count until every bucket places */
+    bucketCount = (tableSize + 3) / 4;
+    if (bucketCount == 0) {
+        bucketCount = 1;
+    }
+    for (;;) {
+        seeds = (ULONG *)malloc(bucketCount * sizeof(ULONG));
+        if (seeds == NULL) {
+            fprintf(stderr, "gentables: out of memory\n");
+            return EXIT_FAILURE;
+        }
+        if (BuildPerfectHash(tableSize, bucketCount, seeds, slotCodes, slotIndices)) {
+            break;
+        }
+        free(seeds);
+        bucketCount += (tableSize / 8) + 1;
+    }
+
+    out = fopen(argv[1], "w");
+    if (out == NULL) {
+        fprintf(stderr, "gentables: cannot write %s\n", argv[1]);
+        return EXIT_FAILURE;
+    }
+
+    fprintf(out, "/*\n * Lookup engine tables - generated by gentables, do not edit\n */\n\n");
+    fprintf(out, "#include \"lookup.h\"\n#include \"decompose.h\"\n#include \"search.h\"\n#include \"names.h\"\n\n");
+    fprintf(out, "const ULONG lookupTableSize = %luUL;\n\n", (unsigned long)tableSize);
+    WriteULongArray(out, "const ULONG packedCodes[]", codes, tableSize);
+    WriteULongArray(out, "const ULONG eytzingerCodes[]", eytzinger, tableSize + 1);
+    WriteUWordArray(out, "const UWORD eytzingerIndex[]", eytzingerIdx, tableSize + 1);
+    WriteUWordArray(out, "const UWORD subsystemFirst[]", subsystems, 257);
+    fprintf(out, "const ULONG perfectBucketCount = %luUL;\n\n", (unsigned long)bucketCount);
+    WriteULongArray(out, "const ULONG perfectSeeds[]", seeds, bucketCount);
+    WriteULongArray(out, "const ULONG perfectCodes[]", slotCodes, tableSize);
+    WriteUWordArray(out, "const UWORD perfectIndex[]", slotIndices, tableSize);
+    WriteUWordArray(out, "const UWORD alertSubsystemEntry[]", alertSubsystems, ALERT_SUBSYSTEMS);
+    WriteUWordArray(out, "const UWORD alertClassBase[]", alertBases, ALERT_SUBSYSTEMS);
+    WriteUWordArray(out, "const UWORD alertClassCount[]", alertCounts, ALERT_SUBSYSTEMS);
+    WriteUWordArray(out, "const UWORD alertClassEntry[]", alertClasses, alertSlots);
+    fprintf(out, "const ULONG searchIndexSize = %luUL;\n\n", (unsigned long)search.size);
+    WriteUByteArray(out, "const UBYTE searchIndex[]", search.data, search.size);
+    fprintf(out, "const ULONG nameIndexSize = %luUL;\n\n", (unsigned long)names.size);
+    WriteUByteArray(out, "const UBYTE nameIndex[]", names.data, names.size);
+
+    if (fclose(out) != 0) {
+        fprintf(stderr, "gentables: error writing %s\n", argv[1]);
+        return EXIT_FAILURE;
+    }
+
+    free(codes);
+    free(eytzinger);
+    free(eytzingerIdx);
+    free(seeds);
+    free(slotCodes);
+    free(slotIndices);
+    free(alertClasses);
+    free(search.data);
+    free(names.data);
+
+    printf("gentables: search index of %lu terms in %lu bytes\n", (unsigned long)searchTerms,
+           (unsigned long)search.size);
+    printf("gentables: name index of %lu word starts in %lu bytes\n", (unsigned long)namePlaces,
+           (unsigned long)names.size);
+
+    return EXIT_SUCCESS;
+}
+
+/*
+ * Check that the table is strictly ascending and properly terminated
+ * Reports every offending entry so they can all be fixed in one pass
+ */
+static BOOL ValidateTable(ULONG tableSize)
+{
+    BOOL valid;
+    ULONG i;
+
+    valid = TRUE;
+
+    if (ERROR_TABLE_SIZE == 0 || errorTable[tableSize].code != 0xFFFFFFFFUL) {
+        fprintf(stderr, "gentables: errorTable must end with the 0xFFFFFFFF end marker\n");
+        return FALSE;
+    }
+
+    if (tableSize > MAX_TABLE_ENTRIES) {
+        fprintf(stderr, "gentables: errorTable has %lu entries, at most %lu are supported\n",
+                (unsigned long)tableSize, (unsigned long)MAX_TABLE_ENTRIES);
+        return FALSE;
+    }
+
+    for (i = 1; i < tableSize; i++) {
+        if (errorTable[i].code == errorTable[i - 1].code) {
+            fprintf(stderr, "gentables: duplicate code 0x%08lX (\"%s\")\n",
+                    (unsigned long)errorTable[i].code, errorTable[i].description);
+            valid = FALSE;
+        } else if (errorTable[i].code < errorTable[i - 1].code) {
+            fprintf(stderr, "gentables: code 0x%08lX (\"%s\") is out of order after 0x%08lX\n",
+                    (unsigned long)errorTable[i].code, errorTable[i].description,
+                    (unsigned long)errorTable[i - 1].code);
+            valid = FALSE;
+        }
+    }
+
+    return valid;
+}
+
+/*
+ * Build the range index used to decode alerts missing from the table
+ * Each subsystem gets the first entry seen for it and a dense run of
+ * slots, one per general error class up to the highest class it uses,
+ * holding the first entry seen for that class.  Scanning in table order
+ * prefers recoverable codes and the class's own generic entry (specific
+ * code 0).  The deadend bit is ignored and code 0 ("No Error") is not an
+ * alert, so it is left out.  Returns the number of class slots.
+ */
+static ULONG BuildAlertIndex(ULONG tableSize, UWORD *subsystemEntry, UWORD *classBase, UWORD *classCount, UWORD *classEntry)
+{
+    UWORD *grid;
+    ULONG subsystem;
+    ULONG generalClass;
+    ULONG slots;
+    ULONG i;
+
+    grid = (UWORD *)malloc(ALERT_SUBSYSTEMS * 256 * sizeof(UWORD));
+    if (grid == NULL) {
+        fprintf(stderr, "gentables: out of memory\n");
+        exit(EXIT_FAILURE);
+    }
+
+    for (i = 0; i < ALERT_SUBSYSTEMS * 256; i++) {
+        grid[i] = ALERT_NO_ENTRY;
+    }
+    for (i = 0; i < ALERT_SUBSYSTEMS; i++) {
+        subsystemEntry[i] = ALERT_NO_ENTRY;
+        classCount[i] = 0;
+    }
+
+    for (i = 0; i < tableSize; i++) {
+        if (errorTable[i].code == 0) {
+            continue;
+        }
+        subsystem = (errorTable[i].code >> 24) & (ALERT_SUBSYSTEMS - 1);
+        generalClass = (errorTable[i].code >> 16) & 0xFF;
+        if (subsystemEntry[subsystem] == ALERT_NO_ENTRY) {
+            subsystemEntry[subsystem] = (UWORD)i;
+        }
+        if (grid[subsystem * 256 + generalClass] == ALERT_NO_ENTRY) {
+            grid[subsystem * 256 + generalClass] = (UWORD)i;
+        }
+        if (generalClass + 1 > classCount[subsystem]) {
+            classCount[subsystem] = (UWORD)(generalClass + 1);
+        }
+    }
+
+    /* Pack each subsystem's run of classes one after another */
+    slots = 0;
+    for (subsystem = 0; subsystem < ALERT_SUBSYSTEMS; subsystem++) {
+        classBase[subsystem] = (UWORD)slots;
+        for (generalClass = 0; generalClass < classCount[subsystem]; generalClass++) {
+            classEntry[slots++] = grid[subsystem * 256 + generalClass];
+        }
+    }
+
+    free(grid);
+
+    return slots;
+}
+
+/*
+ * Fill the 1-based Eytzinger array by an in-order walk of the implicit tree
+ * Returns the next sorted index to place
+ */
+static ULONG FillEytzinger(ULONG *codes, UWORD *indices, ULONG tableSize, ULONG next, ULONG k)
+{
+    if (k <= tableSize) {
+        next = FillEytzinger(codes, indices, tableSize, next, 2 * k);
+        codes[k] = errorTable[next].code;
+        indices[k] = (UWORD)next;
+        next++;
+        next = FillEytzinger(codes, indices, tableSize, next, 2 * k + 1);
+    }
+
+    return next;
+}
+
+/*
+ * Hash and displace construction of a minimal perfect hash
+ * Buckets are placed largest first; each gets the first seed that sends
+ * all of its codes to distinct free slots.
+ */
+static BOOL BuildPerfectHash(ULONG tableSize, ULONG bucketCount, ULONG *seeds, ULONG *slotCodes, UWORD *slotIndices)
+{
+    ULONG *bucketOf;
+    ULONG *bucketSize;
+    ULONG *order;
+    ULONG *members;
+    ULONG *slots;
+    UBYTE *used;
+    ULONG i;
+    ULONG j;
+    ULONG b;
+    ULONG seed;
+    ULONG count;
+    BOOL placed;
+    BOOL success;
+
+    bucketOf = (ULONG *)malloc((tableSize + 1) * sizeof(ULONG));
+    bucketSize = (ULONG *)calloc(bucketCount, sizeof(ULONG));
+    order = (ULONG *)malloc(bucketCount * sizeof(ULONG));
+    members = (ULONG *)malloc((tableSize + 1) * sizeof(ULONG));
+    slots = (ULONG *)malloc((tableSize + 1) * sizeof(ULONG));
+    used = (UBYTE *)calloc(tableSize + 1, 1);
+    if (bucketOf == NULL || bucketSize == NULL || order == NULL ||
+        members == NULL || slots == NULL || used == NULL) {
+        fprintf(stderr, "gentables: out of memory\n");
+        exit(EXIT_FAILURE);
+    }
+
+    for (i = 0; i < tableSize; i++) {
+        bucketOf[i] = LookupHash(errorTable[i].code, 0) % bucketCount;
+        bucketSize[bucketOf[i]]++;
+    }
+
+    /* Order buckets by descending size (insertion sort - tables are small) */
+    for (i = 0; i < bucketCount; i++) {
+        j = i;
+        while (j > 0 && bucketSize[order[j - 1]] < bucketSize[i]) {
+            order[j] = order[j - 1];
+            j--;
+        }
+        order[j] = i;
+        seeds[i] = 0;
+    }
+
+    success = TRUE;
+    for (i = 0; i < bucketCount && success; i++) {
+        b = order[i];
+        if (bucketSize[b] == 0) {
+            break;
+        }
+
+        count = 0;
+        for (j = 0; j < tableSize; j++) {
+            if (bucketOf[j] == b) {
+                members[count++] = j;
+            }
+        }
+
+        placed = FALSE;
+        for (seed = 1; seed < MAX_PERFECT_SEED && !placed; seed++) {
+            placed = TRUE;
+            for (j = 0; j < count; j++) {
+                slots[j] = LookupHash(errorTable[members[j]].code, seed) % tableSize;
+                if (used[slots[j]]) {
+                    placed = FALSE;
+                    break;
+                }
+                used[slots[j]] = 1;
+            }
+            if (!placed) {
+                /* Release the slots claimed by this attempt */
+                while (j > 0) {
+                    j--;
+                    used[slots[j]] = 0;
+                }
+            } else {
+                seeds[b] = seed;
+                for (j = 0; j < count; j++) {
+                    slotCodes[slots[j]] = errorTable[members[j]].code;
+                    slotIndices[slots[j]] = (UWORD)members[j];
+                }
+            }
+        }
+
+        success = placed;
+    }
+
+    free(bucketOf);
+    free(bucketSize);
+    free(order);
+    free(members);
+    free(slots);
+    free(used);
+
+    return success;
+}
+
+/*
+ * Write a ULONG array initialiser, eight values per line
+ */
+static VOID WriteULongArray(FILE *out, const char *decl, const ULONG *values, ULONG count)
+{
+    ULONG i;
+
+    fprintf(out, "%s = {", decl);
+    for (i = 0; i < count; i++) {
+        fprintf(out, "%s0x%08lXUL%s", (i % 8) == 0 ? "\n    " : " ",
+                (unsigned long)values[i], (i + 1 < count) ? "," : "");
+    }
+    /* Keep the initialiser valid for empty tables */
+    if (count == 0) {
+        fprintf(out, "\n    0");
+    }
+    fprintf(out, "\n};\n\n");
+}
+
+/*
+ * Write a UWORD array initialiser, twelve values per line
+ */
+static VOID WriteUWordArray(FILE *out, const char *decl, const UWORD *values, ULONG count)
+{
+    ULONG i;
+
+    fprintf(out, "%s = {", decl);
+    for (i = 0; i < count; i++) {
+        fprintf(out, "%s%5u%s", (i % 12) == 0 ? "\n    " : " ",
+                (unsigned int)values[i], (i + 1 < count) ? "," : "");
+    }
+    if (count == 0) {
+        fprintf(out, "\n    0");
+    }
+    fprintf(out, "\n};\n\n");
+}
+
+/*
+ * Write a UBYTE array initialiser, sixteen values per line
+ */
+static VOID WriteUByteArray(FILE *out, const char *decl, const UBYTE *values, ULONG count)
+{
+    ULONG i;
+
+    fprintf(out, "%s = {", decl);
+    for (i = 0; i < count; i++) {
+        fprintf(out, "%s0x%02X%s", (i % 16) == 0 ? "\n    " : " ",
+                (unsigned int)values[i], (i + 1 < count) ? "," : "");
+    }
+    if (count == 0) {
+        fprintf(out, "\n    0");
+    }
+    fprintf(out, "\n};\n\n");
+}
+
+/*
+ * Build the SEARCH index - see search.h for the layout
+ * Every use of a term in a description or expanded insight is collected,
+ * then sorted by term and entry so each term's posting list comes out in
+ * entry order.  A description use counts SEARCH_DESCRIPTION_WEIGHT times.
+ * Returns the number of terms.
+ */
+static ULONG BuildSearchIndex(ULONG tableSize, struct ByteImage *image)
+{
+    struct TermUse *uses;
+    STRPTR insight;
+    ULONG capacity;
+    ULONG count;
+    ULONG postings;
+    ULONG termCount;
+    ULONG poolSize;
+    ULONG previous;
+    ULONG documents;
+    ULONG frequency;
+    ULONG first;
+    ULONG next;
+    ULONG gap;
+    ULONG i;
+    ULONG j;
+
+    capacity = 4096;
+    count = 0;
+    uses = (struct TermUse *)malloc(capacity * sizeof(struct TermUse));
+    if (uses == NULL) {
+        fprintf(stderr, "gentables: out of memory\n");
+        exit(EXIT_FAILURE);
+    }
+
+    for (i = 0; i < tableSize; i++) {
+        insight = ExpandInsight(i);
+        count = AddTermUses(&uses, count, &capacity, errorTable[i].description, i, SEARCH_DESCRIPTION_WEIGHT);
+        count = AddTermUses(&uses, count, &capacity, insight, i, 1);
+        free(insight);
+    }
+
+    qsort(uses, count, sizeof(struct TermUse), CompareTermUses);
+
+    /* Fold repeated uses of a term in one entry into its frequency */
+    j = 0;
+    for (i = 0; i < count; i++) {
+        if (j > 0 && uses[j - 1].entry == uses[i].entry && strcmp(uses[j - 1].term, uses[i].term) == 0) {
+            frequency = (ULONG)uses[j - 1].frequency + uses[i].frequency;
+            uses[j - 1].frequency = (UWORD)((frequency < 255) ? frequency : 255);
+        } else {
+            uses[j++] = uses[i];
+        }
+    }
+    postings = j;
+
+    termCount = 0;
+    poolSize = 0;
+    for (i = 0; i < postings; i++) {
+        if (i == 0 || strcmp(uses[i - 1].term, uses[i].term) != 0) {
+            termCount++;
+            poolSize += (ULONG)strlen(uses[i].term) + 1;
+        }
+    }
+
+    /* Header and term records are filled in once the posting offsets are known */
+    image->data = NULL;
+    image->size = 0;
+    image->capacity = 0;
+    for (i = 0; i < SEARCH_HEADER_SIZE + termCount * SEARCH_TERM_RECORD; i++) {
+        PutByte(image, 0);
+    }
+
+    j = 0;
+    for (first = 0; first < postings; first = next) {
+        next = first + 1;
+        while (next < postings && strcmp(uses[next].term, uses[first].term) == 0) {
+            next++;
+        }
+        documents = next - first;
+        if (documents > 0xFFFF) {
+            fprintf(stderr, "gentables: term \"%s\" is in too many entries\n", uses[first].term);
+            exit(EXIT_FAILURE);
+        }
+
+        PutLongAt(image, SEARCH_HEADER_SIZE + j * SEARCH_TERM_RECORD + 4, image->size - SEARCH_HEADER_SIZE -
+                  termCount * SEARCH_TERM_RECORD);
+        PutLongAt(image, SEARCH_HEADER_SIZE + j * SEARCH_TERM_RECORD + 8,
+                  (documents << 16) | SearchTermWeight(tableSize, documents));
+
+        previous = 0;
+        for (i = first; i < next; i++) {
+            gap = uses[i].entry - previous;
+            previous = uses[i].entry;
+            while (gap >= 0x80) {
+                PutByte(image, (UBYTE)(gap | 0x80));
+                gap >>= 7;
+            }
+            PutByte(image, (UBYTE)gap);
+            PutByte(image, (UBYTE)uses[i].frequency);
+        }
+        j++;
+    }
+    PutLongAt(image, 12, image->size - SEARCH_HEADER_SIZE - termCount * SEARCH_TERM_RECORD);
+
+    /* Term strings, in the same order as their records */
+    j = 0;
+    poolSize = 0;
+    for (i = 0; i < postings; i++) {
+        if (i == 0 || strcmp(uses[i - 1].term, uses[i].term) != 0) {
+            PutLongAt(image, SEARCH_HEADER_SIZE + j * SEARCH_TERM_RECORD, poolSize);
+            for (first = 0; uses[i].term[first] != '\0'; first++) {
+                PutByte(image, (UBYTE)uses[i].term[first]);
+            }
+            PutByte(image, 0);
+            poolSize += first + 1;
+            j++;
+        }
+    }
+
+    PutLongAt(image, 0, image->size);
+    PutLongAt(image, 4, tableSize);
+    PutLongAt(image, 8, termCount);
+    PutLongAt(image, 16, poolSize);
+
+    free(uses);
+
+    return termCount;
+}
+
+/*
+ * Add a use of each term in text to the list, growing it as needed
+ * Returns the new number of uses.
+ */
+static ULONG AddTermUses(struct TermUse **uses, ULONG count, ULONG *capacity, CONST_STRPTR text, ULONG entry,
+                         ULONG frequency)
+{
+    struct TermUse *grown;
+    char term[SEARCH_TERM_SIZE];
+
+    while (NextSearchTerm(&text, term) > 0) {
+        if (count == *capacity) {
+            grown = (struct TermUse *)realloc(*uses, *capacity * 2 * sizeof(struct TermUse));
+            if (grown == NULL) {
+                fprintf(stderr, "gentables: out of memory\n");
+                exit(EXIT_FAILURE);
+            }
+            *uses = grown;
+            *capacity *= 2;
+        }
+        strcpy((*uses)[count].term, term);
+        (*uses)[count].entry = (UWORD)entry;
+        (*uses)[count].frequency = (UWORD)frequency;
+        count++;
+    }
+
+    return count;
+}
+
+/*
+ * Sort order for term uses - by term, then by entry
+ */
+static int CompareTermUses(const VOID *a, const VOID *b)
+{
+    const struct TermUse *left = (const struct TermUse *)a;
+    const struct TermUse *right = (const struct TermUse *)b;
+    int order;
+
+    order = strcmp(left->term, right->term);
+    if (order != 0) {
+        return order;
+    }
+
+    return (int)left->entry - (int)right->entry;
+}
+
+/*
+ * Expand an entry's insight text with the token dictionary
+ * The caller frees the result.
+ */
+static STRPTR ExpandInsight(ULONG entry)
+{
+    const UBYTE *src;
+    STRPTR text;
+    ULONG length;
+    ULONG token;
+
+    text = (STRPTR)malloc((ULONG)insightLengthTable[entry] + 1);
+    if (text == NULL) {
+        fprintf(stderr, "gentables: out of memory\n");
+        exit(EXIT_FAILURE);
+    }
+
+    length = 0;
+    src = (const UBYTE *)errorTable[entry].insight;
+    while (*src != '\0') {
+        if (*src < TOKEN_FIRST_CODE) {
+            if (length < insightLengthTable[entry]) {
+                text[length++] = (char)*src;
+            }
+            src++;
+            continue;
+        }
+
+        token = (ULONG)(*src++ - TOKEN_FIRST_CODE);
+        if (token == TOKEN_SHORT_COUNT) {
+            if (*src == '\0') {
+                break;
+            }
+            token = TOKEN_SHORT_COUNT + (ULONG)*src++ - 1;
+        }
+        if (token < TOKEN_TABLE_SIZE && length + tokenTable[token].length <= insightLengthTable[entry]) {
+            memcpy(text + length, tokenTable[token].value, tokenTable[token].length);
+            length += tokenTable[token].length;
+        }
+    }
+    text[length] = '\0';
+
+    return text;
+}
+
+/*
+ * Weight of a term found in documents of the entries - 256 * log2(1 + entries / documents)
+ * Rare terms weigh most.  The logarithm is taken a bit at a time, with
+ * the fraction interpolated linearly, so no floating point is needed.
+ */
+static ULONG SearchTermWeight(ULONG entries, ULONG documents)
+{
+    ULONG ratio;
+    ULONG bit;
+
+    /* ratio is 1 + entries / documents in 1/256ths */
+    ratio = ((entries + documents) << 8) / documents;
+
+    bit = 8;
+    while ((ratio >> (bit + 1)) != 0) {
+        bit++;
+    }
+
+    return ((bit - 8) << 8) + (((ratio - (1UL << bit)) << 8) >> bit);
+}
+
+/*
+ * Build the NAME index - see names.h for the layout
+ * Every word start in every description is collected and sorted by the
+ * text from there on.  Returns the number of places.
+ */
+static ULONG BuildNameIndex(ULONG tableSize, struct ByteImage *image)
+{
+    struct NamePlace *places;
+    CONST_STRPTR description;
+    ULONG capacity;
+    ULONG count;
+    ULONG offset;
+    ULONG i;
+
+    capacity = 0;
+    for (i = 0; i < tableSize; i++) {
+        capacity += (ULONG)strlen(errorTable[i].description);
+    }
+    places = (struct NamePlace *)malloc((capacity + 1) * sizeof(struct NamePlace));
+    if (places == NULL) {
+        fprintf(stderr, "gentables: out of memory\n");
+        exit(EXIT_FAILURE);
+    }
+
+    count = 0;
+    for (i = 0; i < tableSize; i++) {
+        description = errorTable[i].description;
+        for (offset = 0; description[offset] != '\0'; offset++) {
+            if (!IsNameStart(description, offset)) {
+                continue;
+            }
+            if (offset > 0xFF) {
+                fprintf(stderr, "gentables: description of 0x%08lX is too long for the name index\n",
+                        (unsigned long)errorTable[i].code);
+                exit(EXIT_FAILURE);
+            }
+            places[count].entry = (UWORD)i;
+            places[count].offset = (UBYTE)offset;
+            count++;
+        }
+    }
+
+    qsort(places, count, sizeof(struct NamePlace), CompareNamePlaces);
+
+    image->data = NULL;
+    image->size = 0;
+    image->capacity = 0;
+    for (i = 0; i < NAME_HEADER_SIZE; i++) {
+        PutByte(image, 0);
+    }
+    for (i = 0; i < count; i++) {
+        PutByte(image, (UBYTE)(places[i].entry >> 8));
+        PutByte(image, (UBYTE)places[i].entry);
+        PutByte(image, places[i].offset);
+    }
+
+    PutLongAt(image, 0, image->size);
+    PutLongAt(image, 4, tableSize);
+    PutLongAt(image, 8, count);
+
+    free(places);
+
+    return count;
+}
+
+/*
+ * Sort order for name places - by text from the place on, ignoring case,
+ * then by entry
+ */
+static int CompareNamePlaces(const VOID *a, const VOID *b)
+{
+    const struct NamePlace *left = (const struct NamePlace *)a;
+    const struct NamePlace *right = (const struct NamePlace *)b;
+    int order;
+
+    order = CompareNameText(errorTable[left->entry].description + left->offset,
+                            errorTable[right->entry].description + right->offset, FALSE);
+    if (order != 0) {
+        return order;
+    }
+
+    return (int)left->entry - (int)right->entry;
+}
+
+/*
+ * Append one byte to the search or name index image
+ */
+static VOID PutByte(struct ByteImage *image, UBYTE value)
+{
+    UBYTE *data;
+
+    if (image->size == image->capacity) {
+        image->capacity = (image->capacity > 0) ? image->capacity * 2 : 65536;
+        data = (UBYTE *)realloc(image->data, image->capacity);
+        if (data == NULL) {
+            fprintf(stderr, "gentables: out of memory\n");
+            exit(EXIT_FAILURE);
+        }
+        image->data = data;
+    }
+
+    image->data[image->size++] = value;
+}
+
+/*
+ * Store a big-endian ULONG at an offset already in the image
+ */
+static VOID PutLongAt(struct ByteImage *image, ULONG offset, ULONG value)
+{
+    image->data[offset] = (UBYTE)(value >> 24);
+    image->data[offset + 1] = (UBYTE)(value >> 16);
+    image->data[offset + 2] = (UBYTE)(value >> 8);
+    image->data[offset + 3] = (UBYTE)value;
+}
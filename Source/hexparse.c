@@ -0,0 +1,332 @@
+/*
+ * Hexadecimal Error Code Parsing
+ *
+ * Command line and log front ends share these helpers to recognise and
+ * convert the 8 digit alert codes shown in Guru Meditation messages.
+ * ParseHexCode validates and converts in one pass; ParseHexFields
+ * converts many fields at once for bulk decoding.
+ *
+ * After meditiation comes... Insight
+ *
+ * Copyright (c) 2025-26 amigazen project
+ * Licensed under BSD 2-Clause License
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "hexparse.h"
+
+#if defined(INSIGHT_NO_SIMD)
+/* Scalar build - the vector paths are checked against it */
+#elif defined(__AVX2__)
+#include <immintrin.h>
+#define HEX_FIELDS_PER_STEP 4
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#define HEX_FIELDS_PER_STEP 2
+#endif
+
+/* Value of each byte as a hex digit, 0xFF for anything else */
+static const UBYTE hexDigitValue[256] = {
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+       0,    1,    2,    3,    4,    5,    6,    7,    8,    9, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF,   10,   11,   12,   13,   14,   15, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF,   10,   11,   12,   13,   14,   15, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF
+};
+
+/**
+ * @brief Validates and converts an alert code in a single pass.
+ * @param text The null-terminated string to parse.
+ * @param value Receives the code when the result is HEX_OK; may be NULL.
+ * @return HEX_OK, or the reason the text is not an alert code.
+ *
+ * See ParseHexSpan for the rules.
+ */
+enum HexStatus ParseHexCode(CONST_STRPTR text, ULONG *value) {
+    return ParseHexSpan(text, HEX_TERMINATED, value);
+}
+
+/**
+ * @brief Validates and converts an alert code held in a counted span.
+ * @param text The characters to parse; need not be null-terminated.
+ * @param length Number of characters, or HEX_TERMINATED to stop at the NUL.
+ * @param value Receives the code when the result is HEX_OK; may be NULL.
+ * @return HEX_OK, or the reason the text is not an alert code.
+ *
+ * An alert code is exactly 8 hex digits in either case, optionally after a
+ * "0x" or "0X" prefix.  Each character is read once and classified and
+ * converted with a single table lookup.  A non-digit anywhere takes
+ * precedence over a wrong digit count, so HEX_TOO_SHORT and HEX_TOO_LONG
+ * mean the text was all hex digits - what the command line treats as an
+ * implicit ERROR argument.
+ */
+enum HexStatus ParseHexSpan(CONST_STRPTR text, ULONG length, ULONG *value) {
+    const UBYTE *current;
+    BOOL terminated;
+    ULONG result;
+    ULONG digitCount;
+    UBYTE digit;
+
+    if (text == NULL) {
+        return HEX_EMPTY;
+    }
+
+    current = (const UBYTE *)text;
+    terminated = (length == HEX_TERMINATED);
+
+    /* Skip "0x" or "0X" prefix if present */
+    if (length >= 2 && current[0] == '0' && (current[1] == 'x' || current[1] == 'X')) {
+        current += 2;
+        length -= 2;
+    }
+
+    result = 0;
+    digitCount = 0;
+
+    while (length > 0) {
+        if (*current == '\0' && terminated) {
+            break;
+        }
+
+        digit = hexDigitValue[*current];
+        if (digit > 15) {
+            return HEX_BAD_DIGIT;
+        }
+
+        /* Digits past the eighth only matter for the status */
+        result = (result << 4) | digit;
+        digitCount++;
+        current++;
+        length--;
+    }
+
+    if (digitCount == 0) {
+        return HEX_EMPTY;
+    }
+    if (digitCount < 8) {
+        return HEX_TOO_SHORT;
+    }
+    if (digitCount > 8) {
+        return HEX_TOO_LONG;
+    }
+
+    if (value != NULL) {
+        *value = result;
+    }
+
+    return HEX_OK;
+}
+
+/**
+ * @brief Converts many 8 digit hex fields in one call.
+ * @param fields Pointers to the fields - 8 readable bytes each, no prefix.
+ * @param count Number of fields.
+ * @param values Receives the code of each field that converts.
+ * @param status Receives HEX_OK or HEX_BAD_DIGIT for each field.
+ * @return The number of fields that converted.
+ *
+ * Meant for bulk decoding once the caller has found the field boundaries.
+ * On x86 several fields are converted at once - two per SSE2 register, or
+ * four per AVX2 register when built with AVX2 enabled - and the rest fall
+ * back to a scalar loop that gives the same results.
+ */
+ULONG ParseHexFields(const char *const *fields, ULONG count, ULONG *values, UBYTE *status) {
+    const UBYTE *field;
+    ULONG converted;
+    ULONG result;
+    ULONG i;
+    ULONG k;
+    UBYTE digit;
+    UBYTE invalid;
+#if defined(HEX_FIELDS_PER_STEP)
+    ULONG validMask;
+    ULONG packedCode[HEX_FIELDS_PER_STEP];
+#endif
+
+    converted = 0;
+    i = 0;
+
+#if defined(HEX_FIELDS_PER_STEP) && HEX_FIELDS_PER_STEP == 4
+    for (; i + 4 <= count; i += 4) {
+        long long lanes[4];
+        __m256i text;
+        __m256i lower;
+        __m256i isDigit;
+        __m256i isLetter;
+        __m256i nibbles;
+        __m256i packed;
+
+        for (k = 0; k < 4; k++) {
+            memcpy(&lanes[k], fields[i + k], 8);
+        }
+        text = _mm256_set_epi64x(lanes[3], lanes[2], lanes[1], lanes[0]);
+
+        /* Signed compares - bytes from 0x80 up fail both ranges */
+        lower = _mm256_or_si256(text, _mm256_set1_epi8(0x20));
+        isDigit = _mm256_and_si256(_mm256_cmpgt_epi8(text, _mm256_set1_epi8('0' - 1)),
+                                   _mm256_cmpgt_epi8(_mm256_set1_epi8('9' + 1), text));
+        isLetter = _mm256_and_si256(_mm256_cmpgt_epi8(lower, _mm256_set1_epi8('a' - 1)),
+                                    _mm256_cmpgt_epi8(_mm256_set1_epi8('f' + 1), lower));
+        validMask = (ULONG)_mm256_movemask_epi8(_mm256_or_si256(isDigit, isLetter));
+
+        /* Digit values, then each pair of digits into one byte */
+        nibbles = _mm256_sub_epi8(lower, _mm256_set1_epi8('0'));
+        nibbles = _mm256_sub_epi8(nibbles, _mm256_and_si256(isLetter, _mm256_set1_epi8('a' - '0' - 10)));
+        nibbles = _mm256_or_si256(_mm256_slli_epi16(nibbles, 4), _mm256_srli_epi16(nibbles, 8));
+        packed = _mm256_packus_epi16(_mm256_and_si256(nibbles, _mm256_set1_epi16(0x00FF)), _mm256_setzero_si256());
+
+        /* packus works per 128-bit lane - two fields in each */
+        packedCode[0] = (ULONG)_mm256_extract_epi32(packed, 0);
+        packedCode[1] = (ULONG)_mm256_extract_epi32(packed, 1);
+        packedCode[2] = (ULONG)_mm256_extract_epi32(packed, 4);
+        packedCode[3] = (ULONG)_mm256_extract_epi32(packed, 5);
+
+        for (k = 0; k < 4; k++) {
+            if (((validMask >> (k * 8)) & 0xFF) == 0xFF) {
+                values[i + k] = __builtin_bswap32(packedCode[k]);
+                status[i + k] = HEX_OK;
+                converted++;
+            } else {
+                status[i + k] = HEX_BAD_DIGIT;
+            }
+        }
+    }
+#elif defined(HEX_FIELDS_PER_STEP) && HEX_FIELDS_PER_STEP == 2
+    for (; i + 2 <= count; i += 2) {
+        __m128i text;
+        __m128i lower;
+        __m128i isDigit;
+        __m128i isLetter;
+        __m128i nibbles;
+        __m128i packed;
+
+        text = _mm_unpacklo_epi64(_mm_loadl_epi64((const __m128i *)fields[i]),
+                                  _mm_loadl_epi64((const __m128i *)fields[i + 1]));
+
+        /* Signed compares - bytes from 0x80 up fail both ranges */
+        lower = _mm_or_si128(text, _mm_set1_epi8(0x20));
+        isDigit = _mm_and_si128(_mm_cmpgt_epi8(text, _mm_set1_epi8('0' - 1)),
+                                _mm_cmplt_epi8(text, _mm_set1_epi8('9' + 1)));
+        isLetter = _mm_and_si128(_mm_cmpgt_epi8(lower, _mm_set1_epi8('a' - 1)),
+                                 _mm_cmplt_epi8(lower, _mm_set1_epi8('f' + 1)));
+        validMask = (ULONG)_mm_movemask_epi8(_mm_or_si128(isDigit, isLetter));
+
+        /* Digit values, then each pair of digits into one byte */
+        nibbles = _mm_sub_epi8(lower, _mm_set1_epi8('0'));
+        nibbles = _mm_sub_epi8(nibbles, _mm_and_si128(isLetter, _mm_set1_epi8('a' - '0' - 10)));
+        nibbles = _mm_or_si128(_mm_slli_epi16(nibbles, 4), _mm_srli_epi16(nibbles, 8));
+        packed = _mm_packus_epi16(_mm_and_si128(nibbles, _mm_set1_epi16(0x00FF)), _mm_setzero_si128());
+
+        packedCode[0] = (ULONG)_mm_cvtsi128_si32(packed);
+        packedCode[1] = (ULONG)_mm_cvtsi128_si32(_mm_srli_si128(packed, 4));
+
+        for (k = 0; k < 2; k++) {
+            if (((validMask >> (k * 8)) & 0xFF) == 0xFF) {
+                values[i + k] = __builtin_bswap32(packedCode[k]);
+                status[i + k] = HEX_OK;
+                converted++;
+            } else {
+                status[i + k] = HEX_BAD_DIGIT;
+            }
+        }
+    }
+#endif
+
+    /* Scalar loop for the remaining fields, or all of them */
+    for (; i < count; i++) {
+        field = (const UBYTE *)fields[i];
+        result = 0;
+        invalid = 0;
+        for (k = 0; k < 8; k++) {
+            digit = hexDigitValue[field[k]];
+            invalid |= digit;
+            result = (result << 4) | (digit & 0x0F);
+        }
+
+        if ((invalid & 0xF0) == 0) {
+            values[i] = result;
+            status[i] = HEX_OK;
+            converted++;
+        } else {
+            status[i] = HEX_BAD_DIGIT;
+        }
+    }
+
+    return converted;
+}
+
+/**
+ * @brief Converts a hexadecimal string to a ULONG.
+ * @param hexString The null-terminated string containing the hex value.
+ * @return The converted ULONG value, or (ULONG)-1 if it is not an alert code.
+ *
+ * Superseded by ParseHexCode, which also says why the text was rejected.
+ */
+ULONG HexStringToULong(STRPTR hexString) {
+    ULONG result;
+
+    if (ParseHexCode(hexString, &result) != HEX_OK) {
+        return (ULONG)-1;
+    }
+
+    return result;
+}
+
+/**
+ * @brief Checks if a string looks like a hexadecimal number.
+ * @param str The null-terminated string to check.
+ * @return TRUE if the string looks like a hex number, FALSE otherwise.
+ *
+ * A string looks like a hex number if:
+ * - It starts with "0x" or "0X" followed by one or more hex digits, OR
+ * - It consists entirely of hex digits (0-9, A-F, a-f)
+ */
+BOOL LooksLikeHexNumber(STRPTR str) {
+    enum HexStatus status;
+
+    status = ParseHexCode(str, NULL);
+    return (status == HEX_OK || status == HEX_TOO_SHORT || status == HEX_TOO_LONG);
+}
+
+/**
+ * @brief Validates that a string is exactly 8 hexadecimal digits.
+ * @param hexString The null-terminated string to validate.
+ * @return TRUE if the string is exactly 8 hex digits (with or without 0x prefix), FALSE otherwise.
+ */
+BOOL ValidateHexErrorCode(STRPTR hexString) {
+    return (ParseHexCode(hexString, NULL) == HEX_OK);
+}
@@ -0,0 +1,67 @@
+/*
+ * Hexadecimal Error Code Parsing
+ *
+ * After meditiation comes... Insight
+ *
+ * Copyright (c) 2025-26 amigazen project
+ * Licensed under BSD 2-Clause License
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef HEXPARSE_H
+#define HEXPARSE_H
+
+#include "platform.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Result of ParseHexCode and ParseHexSpan */
+enum HexStatus {
+    HEX_OK = 0,         /* Exactly 8 hex digits, optionally after 0x */
+    HEX_EMPTY,          /* NULL, empty or a bare 0x prefix */
+    HEX_BAD_DIGIT,      /* Holds a character that is not a hex digit */
+    HEX_TOO_SHORT,      /* All hex digits, but fewer than 8 */
+    HEX_TOO_LONG        /* All hex digits, but more than 8 */
+};
+
+/* Span length meaning "up to the terminating NUL" */
+#define HEX_TERMINATED 0xFFFFFFFFUL
+
+/* Function declarations */
+enum HexStatus ParseHexCode(CONST_STRPTR text, ULONG *value);  /* Validate and convert a NUL-terminated code */
+enum HexStatus ParseHexSpan(CONST_STRPTR text, ULONG length, ULONG *value);  /* Same for a counted span */
+ULONG ParseHexFields(const char *const *fields, ULONG count, ULONG *values, UBYTE *status);  /* Convert many 8 digit fields */
+
+/* Older helpers, kept for existing callers - each is one ParseHexCode call */
+ULONG HexStringToULong(STRPTR hexString);  /* Convert hex string to ULONG */
+BOOL LooksLikeHexNumber(STRPTR str);  /* Check if string looks like a hex number */
+BOOL ValidateHexErrorCode(STRPTR hexString);  /* Validate that string is exactly 8 hex digits */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HEXPARSE_H */
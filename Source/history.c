@@ -0,0 +1,684 @@
+/*
+ * Crash History
+ *
+ * Appends alerts to the crash history and reads them back.  An append takes
+ * an exclusive lock on the file (LockRecord on the Amiga, fcntl on the
+ * host), so several processes can add records at once.  It writes at the
+ * last whole record boundary, which drops any record a reset tore in half,
+ * and it skips an alert when LastAlert has not changed since the previous
+ * record, so the same guru is kept once however many reboots follow it.
+ * Appends use no heap, so the WBStartup path can call them after a crash.
+ *
+ * After meditiation comes... Insight
+ *
+ * Copyright (c) 2025-26 amigazen project
+ * Licensed under BSD 2-Clause License
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "platform.h"
+#ifdef INSIGHT_AMIGA
+#include <dos/dos.h>
+#include <dos/record.h>
+#include <proto/dos.h>
+#else
+#include <errno.h>
+#include <fcntl.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#endif
+#include "idb.h"
+#include "history.h"
+
+/* Open history file handle */
+#ifdef INSIGHT_AMIGA
+typedef BPTR HistoryFile;
+#define NO_HISTORY_FILE 0
+#define HISTORY_LOCK_TICKS (5 * TICKS_PER_SECOND)
+#else
+typedef int HistoryFile;
+#define NO_HISTORY_FILE (-1)
+#endif
+
+/* Records read from the file per block */
+#define HISTORY_READ_RECORDS 64
+
+struct CrashHistory {
+    HistoryFile file;
+    ULONG size;                 /* File size when opened */
+    ULONG offset;               /* File offset of the next block */
+    ULONG damaged;              /* Record slots that failed their checksum */
+    ULONG blockLength;
+    ULONG blockNext;
+    UBYTE block[HISTORY_READ_RECORDS * HISTORY_RECORD_SIZE];
+};
+
+/* Error messages, indexed by HISTORY_xxx result */
+static const CONST_STRPTR errorTexts[] = {
+    "no error",
+    "alert already recorded",
+    "cannot open the history file",
+    "cannot lock the history file",
+    "not an Insight history file",
+    "cannot write the history file",
+    "out of memory",
+    "cannot write the output"
+};
+
+/* Forward declarations */
+static BOOL HeaderValid(const UBYTE *data, ULONG *error);
+static BOOL SameAlert(const struct CrashRecord *a, const struct CrashRecord *b);
+static ULONG AppendLocked(HistoryFile file, const struct CrashRecord *record);
+static HistoryFile OpenHistoryFile(CONST_STRPTR path, BOOL write);
+static VOID CloseHistoryFile(HistoryFile file);
+static BOOL LockHistoryFile(HistoryFile file);
+static VOID UnlockHistoryFile(HistoryFile file);
+static BOOL HistoryFileSize(HistoryFile file, ULONG *size);
+static BOOL ReadHistoryAt(HistoryFile file, ULONG offset, UBYTE *data, ULONG length);
+static BOOL WriteHistoryAt(HistoryFile file, ULONG offset, const UBYTE *data, ULONG length);
+
+/*
+ * Append one alert to a history file, creating the file if needed
+ * Returns HISTORY_OK, HISTORY_DUPLICATE if the previous record holds
+ * the same LastAlert, or an error.  Uses no heap.
+ */
+ULONG AppendCrashRecord(CONST_STRPTR path, const struct CrashRecord *record)
+{
+    HistoryFile file;
+    ULONG result;
+
+    file = OpenHistoryFile(path, TRUE);
+    if (file == NO_HISTORY_FILE) {
+        return HISTORY_ERROR_OPEN;
+    }
+
+    if (!LockHistoryFile(file)) {
+        CloseHistoryFile(file);
+        return HISTORY_ERROR_LOCK;
+    }
+
+    result = AppendLocked(file, record);
+
+    UnlockHistoryFile(file);
+    CloseHistoryFile(file);
+    return result;
+}
+
+/*
+ * Open a history file for reading with NextCrashRecord
+ * Returns NULL with *error set if it cannot be read or is not a history file.
+ */
+struct CrashHistory *OpenCrashHistory(CONST_STRPTR path, ULONG *error)
+{
+    struct CrashHistory *history;
+    UBYTE header[HISTORY_HEADER_SIZE];
+    HistoryFile file;
+    ULONG size;
+
+    file = OpenHistoryFile(path, FALSE);
+    if (file == NO_HISTORY_FILE) {
+        *error = HISTORY_ERROR_OPEN;
+        return NULL;
+    }
+
+    if (!HistoryFileSize(file, &size) || size < HISTORY_HEADER_SIZE ||
+        !ReadHistoryAt(file, 0, header, HISTORY_HEADER_SIZE)) {
+        CloseHistoryFile(file);
+        *error = HISTORY_ERROR_FORMAT;
+        return NULL;
+    }
+    if (!HeaderValid(header, error)) {
+        CloseHistoryFile(file);
+        return NULL;
+    }
+
+    history = (struct CrashHistory *)malloc(sizeof(struct CrashHistory));
+    if (history == NULL) {
+        CloseHistoryFile(file);
+        *error = HISTORY_ERROR_MEMORY;
+        return NULL;
+    }
+
+    /* A record still being written (or torn) past the last whole slot is ignored */
+    history->file = file;
+    history->size = size - (size - HISTORY_HEADER_SIZE) % HISTORY_RECORD_SIZE;
+    history->offset = HISTORY_HEADER_SIZE;
+    history->damaged = 0;
+    history->blockLength = 0;
+    history->blockNext = 0;
+
+    *error = HISTORY_OK;
+    return history;
+}
+
+/*
+ * Read the next intact record, oldest first
+ * Damaged slots are skipped and counted.  Returns FALSE at the end.
+ */
+BOOL NextCrashRecord(struct CrashHistory *history, struct CrashRecord *record)
+{
+    ULONG length;
+
+    for (;;) {
+        while (history->blockNext < history->blockLength) {
+            history->blockNext += HISTORY_RECORD_SIZE;
+            if (DecodeCrashRecord(history->block + history->blockNext - HISTORY_RECORD_SIZE, record)) {
+                return TRUE;
+            }
+            history->damaged++;
+        }
+
+        if (history->offset >= history->size) {
+            return FALSE;
+        }
+
+        length = history->size - history->offset;
+        if (length > sizeof(history->block)) {
+            length = sizeof(history->block);
+        }
+        if (!ReadHistoryAt(history->file, history->offset, history->block, length)) {
+            return FALSE;
+        }
+        history->offset += length;
+        history->blockLength = length;
+        history->blockNext = 0;
+    }
+}
+
+/*
+ * Number of whole record slots in the file when it was opened,
+ * intact or not
+ */
+ULONG CrashHistorySlots(const struct CrashHistory *history)
+{
+    return (history->size - HISTORY_HEADER_SIZE) / HISTORY_RECORD_SIZE;
+}
+
+/*
+ * Make NextCrashRecord continue from a record slot
+ */
+BOOL SeekCrashHistory(struct CrashHistory *history, ULONG slot)
+{
+    if (slot > CrashHistorySlots(history)) {
+        return FALSE;
+    }
+
+    history->offset = HISTORY_HEADER_SIZE + slot * HISTORY_RECORD_SIZE;
+    history->blockLength = 0;
+    history->blockNext = 0;
+    return TRUE;
+}
+
+/*
+ * Slot NextCrashRecord will look at next
+ */
+ULONG CrashHistoryPosition(const struct CrashHistory *history)
+{
+    return (history->offset - history->blockLength + history->blockNext - HISTORY_HEADER_SIZE) / HISTORY_RECORD_SIZE;
+}
+
+/*
+ * Read the raw HISTORY_RECORD_SIZE bytes of one slot
+ * Does not move NextCrashRecord.
+ */
+BOOL ReadCrashSlot(struct CrashHistory *history, ULONG slot, UBYTE *data)
+{
+    if (slot >= CrashHistorySlots(history)) {
+        return FALSE;
+    }
+
+    return ReadHistoryAt(history->file, HISTORY_HEADER_SIZE + slot * HISTORY_RECORD_SIZE, data, HISTORY_RECORD_SIZE);
+}
+
+/*
+ * Number of damaged record slots NextCrashRecord has skipped so far
+ */
+ULONG CrashHistoryDamaged(const struct CrashHistory *history)
+{
+    return history->damaged;
+}
+
+/*
+ * Close a history opened with OpenCrashHistory
+ */
+VOID CloseCrashHistory(struct CrashHistory *history)
+{
+    if (history == NULL) {
+        return;
+    }
+
+    CloseHistoryFile(history->file);
+    free(history);
+}
+
+/*
+ * Write the file header into HISTORY_HEADER_SIZE bytes
+ */
+VOID EncodeCrashHeader(UBYTE *data)
+{
+    memset(data, 0, HISTORY_HEADER_SIZE);
+    IdbPutLong(data, HISTORY_MAGIC);
+    IdbPutLong(data + 4, HISTORY_VERSION);
+    IdbPutLong(data + 8, HISTORY_HEADER_SIZE);
+    IdbPutLong(data + 12, HISTORY_RECORD_SIZE);
+    IdbPutLong(data + HISTORY_CHECKSUM_OFFSET, IdbChecksum(0, data, HISTORY_CHECKSUM_OFFSET));
+}
+
+/*
+ * Write a record into HISTORY_RECORD_SIZE bytes, checksum included
+ */
+VOID EncodeCrashRecord(const struct CrashRecord *record, UBYTE *data)
+{
+    ULONG i;
+
+    memset(data, 0, HISTORY_RECORD_SIZE);
+    IdbPutLong(data + HISTORY_FIELD_MAGIC * 4, HISTORY_RECORD_MAGIC);
+    IdbPutLong(data + HISTORY_FIELD_TIMESTAMP * 4, record->timestamp);
+    IdbPutLong(data + HISTORY_FIELD_CODE * 4, record->code);
+    IdbPutLong(data + HISTORY_FIELD_TASK * 4, record->taskID);
+    for (i = 0; i < 4; i++) {
+        IdbPutLong(data + (HISTORY_FIELD_LAST_ALERT + i) * 4, record->lastAlert[i]);
+    }
+
+    /* The last name byte always stays NUL */
+    for (i = 0; i < HISTORY_NAME_SIZE - 1 && record->taskName[i] != '\0'; i++) {
+        data[HISTORY_NAME_OFFSET + i] = (UBYTE)record->taskName[i];
+    }
+
+    IdbPutLong(data + HISTORY_CHECKSUM_OFFSET, IdbChecksum(0, data, HISTORY_CHECKSUM_OFFSET));
+}
+
+/*
+ * Read a record from HISTORY_RECORD_SIZE bytes
+ * Returns FALSE if the slot is not an intact record.
+ */
+BOOL DecodeCrashRecord(const UBYTE *data, struct CrashRecord *record)
+{
+    ULONG i;
+
+    if (IdbGetLong(data + HISTORY_FIELD_MAGIC * 4) != HISTORY_RECORD_MAGIC ||
+        IdbGetLong(data + HISTORY_CHECKSUM_OFFSET) != IdbChecksum(0, data, HISTORY_CHECKSUM_OFFSET)) {
+        return FALSE;
+    }
+
+    record->timestamp = IdbGetLong(data + HISTORY_FIELD_TIMESTAMP * 4);
+    record->code = IdbGetLong(data + HISTORY_FIELD_CODE * 4);
+    record->taskID = IdbGetLong(data + HISTORY_FIELD_TASK * 4);
+    for (i = 0; i < 4; i++) {
+        record->lastAlert[i] = IdbGetLong(data + (HISTORY_FIELD_LAST_ALERT + i) * 4);
+    }
+    memcpy(record->taskName, data + HISTORY_NAME_OFFSET, HISTORY_NAME_SIZE);
+    record->taskName[HISTORY_NAME_SIZE - 1] = '\0';
+
+    return TRUE;
+}
+
+/*
+ * Copy a task name into a record, cut to fit
+ * NULL leaves the name empty.
+ */
+VOID SetCrashTaskName(struct CrashRecord *record, CONST_STRPTR name)
+{
+    ULONG i;
+
+    memset(record->taskName, 0, HISTORY_NAME_SIZE);
+    if (name == NULL) {
+        return;
+    }
+
+    for (i = 0; i < HISTORY_NAME_SIZE - 1 && name[i] != '\0'; i++) {
+        record->taskName[i] = name[i];
+    }
+}
+
+/*
+ * Get a readable message for an AppendCrashRecord or OpenCrashHistory error
+ */
+CONST_STRPTR HistoryErrorText(ULONG error)
+{
+    if (error >= sizeof(errorTexts) / sizeof(errorTexts[0])) {
+        return "unknown error";
+    }
+
+    return errorTexts[error];
+}
+
+/*
+ * Check a file header, setting *error if it is not one this code can use
+ */
+static BOOL HeaderValid(const UBYTE *data, ULONG *error)
+{
+    if (IdbGetLong(data) != HISTORY_MAGIC ||
+        IdbGetLong(data + HISTORY_CHECKSUM_OFFSET) != IdbChecksum(0, data, HISTORY_CHECKSUM_OFFSET) ||
+        IdbGetLong(data + 4) != HISTORY_VERSION ||
+        IdbGetLong(data + 8) != HISTORY_HEADER_SIZE ||
+        IdbGetLong(data + 12) != HISTORY_RECORD_SIZE) {
+        *error = HISTORY_ERROR_FORMAT;
+        return FALSE;
+    }
+
+    return TRUE;
+}
+
+/*
+ * Two records describe the same alert if LastAlert and the decoded code
+ * and task match - the time and the resolved name may differ across boots
+ */
+static BOOL SameAlert(const struct CrashRecord *a, const struct CrashRecord *b)
+{
+    ULONG i;
+
+    if (a->code != b->code || a->taskID != b->taskID) {
+        return FALSE;
+    }
+    for (i = 0; i < 4; i++) {
+        if (a->lastAlert[i] != b->lastAlert[i]) {
+            return FALSE;
+        }
+    }
+
+    return TRUE;
+}
+
+/*
+ * Append with the file already locked
+ * Writes the header into a new file, then the record at the last whole
+ * record boundary - a torn record from an earlier append is overwritten.
+ */
+static ULONG AppendLocked(HistoryFile file, const struct CrashRecord *record)
+{
+    UBYTE data[HISTORY_RECORD_SIZE];
+    UBYTE previousData[HISTORY_HEADER_SIZE];
+    struct CrashRecord previous;
+    ULONG size;
+    ULONG end;
+    ULONG slot;
+    ULONG error;
+
+    if (!HistoryFileSize(file, &size)) {
+        return HISTORY_ERROR_OPEN;
+    }
+
+    if (size < HISTORY_HEADER_SIZE) {
+        /* New file, or one whose header was torn while being created - never another file */
+        EncodeCrashHeader(data);
+        if (size > 0 && (!ReadHistoryAt(file, 0, previousData, size) || memcmp(previousData, data, size) != 0)) {
+            return HISTORY_ERROR_FORMAT;
+        }
+        if (!WriteHistoryAt(file, 0, data, HISTORY_HEADER_SIZE)) {
+            return HISTORY_ERROR_WRITE;
+        }
+        size = HISTORY_HEADER_SIZE;
+    } else {
+        if (!ReadHistoryAt(file, 0, data, HISTORY_HEADER_SIZE)) {
+            return HISTORY_ERROR_OPEN;
+        }
+        if (!HeaderValid(data, &error)) {
+            return error;
+        }
+    }
+
+    end = size - (size - HISTORY_HEADER_SIZE) % HISTORY_RECORD_SIZE;
+
+    /* Only the previous intact record matters, so this is constant time */
+    slot = end;
+    while (slot > HISTORY_HEADER_SIZE && end - slot < HISTORY_DEDUP_SCAN * HISTORY_RECORD_SIZE) {
+        slot -= HISTORY_RECORD_SIZE;
+        if (ReadHistoryAt(file, slot, data, HISTORY_RECORD_SIZE) && DecodeCrashRecord(data, &previous)) {
+            if (SameAlert(&previous, record)) {
+                return HISTORY_DUPLICATE;
+            }
+            break;
+        }
+    }
+
+    EncodeCrashRecord(record, data);
+    if (!WriteHistoryAt(file, end, data, HISTORY_RECORD_SIZE)) {
+        return HISTORY_ERROR_WRITE;
+    }
+
+    return HISTORY_OK;
+}
+
+#ifdef INSIGHT_AMIGA
+
+/*
+ * Current time as seconds since 1978
+ */
+ULONG CrashTimestampNow(VOID)
+{
+    struct DateStamp now;
+
+    DateStamp(&now);
+    return (ULONG)now.ds_Days * 86400UL + (ULONG)now.ds_Minute * 60UL + (ULONG)now.ds_Tick / TICKS_PER_SECOND;
+}
+
+/*
+ * Open a history file - MODE_READWRITE creates it and shares it with
+ * other writers, who are kept apart by LockHistoryFile
+ */
+static HistoryFile OpenHistoryFile(CONST_STRPTR path, BOOL write)
+{
+    return Open((STRPTR)path, write ? MODE_READWRITE : MODE_OLDFILE);
+}
+
+/*
+ * Close a history file
+ */
+static VOID CloseHistoryFile(HistoryFile file)
+{
+    Close(file);
+}
+
+/*
+ * Take the append lock - an exclusive record lock over the header
+ */
+static BOOL LockHistoryFile(HistoryFile file)
+{
+    return (BOOL)(LockRecord(file, 0, HISTORY_HEADER_SIZE, REC_EXCLUSIVE, HISTORY_LOCK_TICKS) != 0);
+}
+
+/*
+ * Release the append lock
+ */
+static VOID UnlockHistoryFile(HistoryFile file)
+{
+    UnLockRecord(file, 0, HISTORY_HEADER_SIZE);
+}
+
+/*
+ * Get the current size of a history file
+ */
+static BOOL HistoryFileSize(HistoryFile file, ULONG *size)
+{
+    LONG end;
+
+    if (Seek(file, 0, OFFSET_END) < 0) {
+        return FALSE;
+    }
+    end = Seek(file, 0, OFFSET_CURRENT);
+    if (end < 0) {
+        return FALSE;
+    }
+
+    *size = (ULONG)end;
+    return TRUE;
+}
+
+/*
+ * Read length bytes at an offset
+ */
+static BOOL ReadHistoryAt(HistoryFile file, ULONG offset, UBYTE *data, ULONG length)
+{
+    if (Seek(file, (LONG)offset, OFFSET_BEGINNING) < 0) {
+        return FALSE;
+    }
+
+    return (BOOL)(Read(file, data, (LONG)length) == (LONG)length);
+}
+
+/*
+ * Write length bytes at an offset
+ */
+static BOOL WriteHistoryAt(HistoryFile file, ULONG offset, const UBYTE *data, ULONG length)
+{
+    if (Seek(file, (LONG)offset, OFFSET_BEGINNING) < 0) {
+        return FALSE;
+    }
+
+    return (BOOL)(Write(file, (APTR)data, (LONG)length) == (LONG)length);
+}
+
+#else
+
+/*
+ * Current time as seconds since 1978
+ */
+ULONG CrashTimestampNow(VOID)
+{
+    return (ULONG)((unsigned long long)time(NULL) - HISTORY_UNIX_OFFSET);
+}
+
+/*
+ * Open a history file, creating it for appends
+ */
+static HistoryFile OpenHistoryFile(CONST_STRPTR path, BOOL write)
+{
+    if (write) {
+        return open(path, O_RDWR | O_CREAT, 0644);
+    }
+
+    return open(path, O_RDONLY);
+}
+
+/*
+ * Close a history file
+ */
+static VOID CloseHistoryFile(HistoryFile file)
+{
+    close(file);
+}
+
+/*
+ * Take the append lock - an fcntl write lock over the whole file, which
+ * serialises appending processes (threads of one process share it)
+ */
+static BOOL LockHistoryFile(HistoryFile file)
+{
+    struct flock lock;
+
+    memset(&lock, 0, sizeof(lock));
+    lock.l_type = F_WRLCK;
+    lock.l_whence = SEEK_SET;
+
+    while (fcntl(file, F_SETLKW, &lock) != 0) {
+        if (errno != EINTR) {
+            return FALSE;
+        }
+    }
+
+    return TRUE;
+}
+
+/*
+ * Release the append lock, once the record has reached the disk
+ */
+static VOID UnlockHistoryFile(HistoryFile file)
+{
+    struct flock lock;
+
+    fsync(file);
+
+    memset(&lock, 0, sizeof(lock));
+    lock.l_type = F_UNLCK;
+    lock.l_whence = SEEK_SET;
+    fcntl(file, F_SETLK, &lock);
+}
+
+/*
+ * Get the current size of a history file
+ */
+static BOOL HistoryFileSize(HistoryFile file, ULONG *size)
+{
+    struct stat status;
+
+    if (fstat(file, &status) != 0 || (unsigned long long)status.st_size > 0xFFFFFFFFULL) {
+        return FALSE;
+    }
+
+    *size = (ULONG)status.st_size;
+    return TRUE;
+}
+
+/*
+ * Read length bytes at an offset
+ */
+static BOOL ReadHistoryAt(HistoryFile file, ULONG offset, UBYTE *data, ULONG length)
+{
+    ssize_t done;
+
+    while (length > 0) {
+        done = pread(file, data, length, (off_t)offset);
+        if (done <= 0) {
+            if (done < 0 && errno == EINTR) {
+                continue;
+            }
+            return FALSE;
+        }
+        data += done;
+        offset += (ULONG)done;
+        length -= (ULONG)done;
+    }
+
+    return TRUE;
+}
+
+/*
+ * Write length bytes at an offset
+ */
+static BOOL WriteHistoryAt(HistoryFile file, ULONG offset, const UBYTE *data, ULONG length)
+{
+    ssize_t done;
+
+    while (length > 0) {
+        done = pwrite(file, data, length, (off_t)offset);
+        if (done <= 0) {
+            if (done < 0 && errno == EINTR) {
+                continue;
+            }
+            return FALSE;
+        }
+        data += done;
+        offset += (ULONG)done;
+        length -= (ULONG)done;
+    }
+
+    return TRUE;
+}
+
+#endif
@@ -0,0 +1,120 @@
+/*
+ * Crash History
+ *
+ * Append-only crash history.  Every alert Insight finds at WBStartup is
+ * kept in a small binary file so gurus survive the requester being closed.
+ * The file is a 64-byte header followed by fixed 64-byte records, each
+ * framed by a magic word and closed by a CRC-32, so a record torn by a
+ * reset is detected and overwritten by the next append.
+ *
+ * After meditiation comes... Insight
+ *
+ * Copyright (c) 2025-26 amigazen project
+ * Licensed under BSD 2-Clause License
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef HISTORY_H
+#define HISTORY_H
+
+#include "platform.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* File layout - all fields are big-endian ULONGs */
+#define HISTORY_MAGIC        0x49485354UL   /* "IHST" - header */
+#define HISTORY_RECORD_MAGIC 0x47555255UL   /* "GURU" - record */
+#define HISTORY_VERSION      1
+#define HISTORY_HEADER_SIZE  64
+#define HISTORY_RECORD_SIZE  64
+#define HISTORY_NAME_SIZE    28              /* Task name, NUL-padded */
+
+/* Record fields, as ULONG offsets - the name follows at byte 32 */
+#define HISTORY_FIELD_MAGIC      0
+#define HISTORY_FIELD_TIMESTAMP  1
+#define HISTORY_FIELD_CODE       2
+#define HISTORY_FIELD_TASK       3
+#define HISTORY_FIELD_LAST_ALERT 4           /* Four words */
+#define HISTORY_NAME_OFFSET      32
+#define HISTORY_CHECKSUM_OFFSET  60          /* CRC-32 of the bytes before it */
+
+/* Where the WBStartup path keeps its history */
+#ifdef INSIGHT_AMIGA
+#define HISTORY_DEFAULT_PATH "S:Insight.history"
+#else
+#define HISTORY_DEFAULT_PATH "Insight.history"
+#endif
+
+/* Timestamps count seconds from 1 January 1978, the AmigaDOS epoch */
+#define HISTORY_UNIX_OFFSET 252460800UL
+
+/* How many damaged slots an append looks past for the previous record */
+#define HISTORY_DEDUP_SCAN 16
+
+/* AppendCrashRecord results */
+#define HISTORY_OK           0
+#define HISTORY_DUPLICATE    1   /* LastAlert unchanged since the last record */
+#define HISTORY_ERROR_OPEN   2
+#define HISTORY_ERROR_LOCK   3
+#define HISTORY_ERROR_FORMAT 4   /* Not a history file, or a newer version */
+#define HISTORY_ERROR_WRITE  5
+#define HISTORY_ERROR_MEMORY 6
+#define HISTORY_ERROR_OUTPUT 7   /* Query results could not be written */
+
+/* One alert as kept in the history */
+struct CrashRecord {
+    ULONG timestamp;                       /* Seconds since 1978 */
+    ULONG code;                            /* Alert code as decoded */
+    ULONG taskID;
+    ULONG lastAlert[4];                    /* Raw ExecBase->LastAlert */
+    char taskName[HISTORY_NAME_SIZE];      /* Empty when it could not be resolved */
+};
+
+/* A history file open for reading, one record at a time */
+struct CrashHistory;
+
+/* Function declarations */
+ULONG AppendCrashRecord(CONST_STRPTR path, const struct CrashRecord *record);
+struct CrashHistory *OpenCrashHistory(CONST_STRPTR path, ULONG *error);
+BOOL NextCrashRecord(struct CrashHistory *history, struct CrashRecord *record);
+ULONG CrashHistorySlots(const struct CrashHistory *history);
+BOOL SeekCrashHistory(struct CrashHistory *history, ULONG slot);
+ULONG CrashHistoryPosition(const struct CrashHistory *history);
+BOOL ReadCrashSlot(struct CrashHistory *history, ULONG slot, UBYTE *data);
+ULONG CrashHistoryDamaged(const struct CrashHistory *history);
+VOID CloseCrashHistory(struct CrashHistory *history);
+VOID EncodeCrashHeader(UBYTE *data);
+VOID EncodeCrashRecord(const struct CrashRecord *record, UBYTE *data);
+BOOL DecodeCrashRecord(const UBYTE *data, struct CrashRecord *record);
+VOID SetCrashTaskName(struct CrashRecord *record, CONST_STRPTR name);
+ULONG CrashTimestampNow(VOID);
+CONST_STRPTR HistoryErrorText(ULONG error);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HISTORY_H */
@@ -0,0 +1,701 @@
+/*
+ * Crash History Queries
+ *
+ * Answers time and code queries over the crash history without reading
+ * all of it.  The sparse index next to the history file summarises each
+ * block of HISTORY_INDEX_BLOCK records by its earliest and latest time and
+ * a bitmap of the top code bytes in it; blocks whose summary cannot match
+ * are never read.  Each query first summarises any whole blocks appended
+ * since the index was written and saves them, so the index grows with the
+ * history and is rebuilt from scratch if the history is replaced.
+ *
+ * After meditiation comes... Insight
+ *
+ * Copyright (c) 2025-26 amigazen project
+ * Licensed under BSD 2-Clause License
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "idb.h"
+#include "batch.h"
+#include "history.h"
+#include "histquery.h"
+
+/* Days from 1970 to the 1978 history epoch */
+#define EPOCH_DAYS 2922L
+
+/* Years a ULONG of seconds since 1978 can hold */
+#define FIRST_YEAR 1978
+#define LAST_YEAR  2114
+
+/* Summary of one block of records */
+struct IndexEntry {
+    ULONG first;                        /* Earliest time - 0xFFFFFFFF when empty */
+    ULONG last;                         /* Latest time */
+    ULONG mask[HISTORY_MASK_WORDS];     /* Top code bytes present */
+};
+
+/* Index held while a query runs */
+struct HistoryIndex {
+    struct IndexEntry *entries;
+    ULONG count;                        /* Entries loaded from or checked against the file */
+    ULONG built;                        /* Entries after this query's additions */
+    BOOL valid;                         /* The file on disk matches the history */
+};
+
+/* State for QueryHistoryToRecords */
+struct RecordQuery {
+    struct BatchWriter writer;
+    char time[HISTORY_TIME_LENGTH];
+};
+
+/* Forward declarations */
+static LONG DaysFromCivil(LONG year, LONG month, LONG day);
+static BOOL ReadNumber(CONST_STRPTR *text, ULONG digits, ULONG *value);
+static BOOL LoadIndex(CONST_STRPTR indexPath, struct CrashHistory *history, struct HistoryIndex *index);
+static VOID SaveIndex(CONST_STRPTR indexPath, struct CrashHistory *history, const struct HistoryIndex *index);
+static VOID EncodeEntry(const struct IndexEntry *entry, UBYTE *data);
+static BOOL DecodeEntry(const UBYTE *data, struct IndexEntry *entry);
+static BOOL EntryMatches(const struct IndexEntry *entry, const struct HistoryQuery *query, const ULONG *topMask);
+static BOOL ScanSlots(struct CrashHistory *history, ULONG first, ULONG end, const struct HistoryQuery *query,
+                      struct IndexEntry *entry,
+                      BOOL (*report)(const struct CrashRecord *record, APTR userData), APTR userData,
+                      struct HistoryQueryStats *stats);
+static BOOL WriteHistoryRecord(const struct CrashRecord *record, APTR userData);
+
+/*
+ * Set a query that matches every record
+ */
+VOID InitHistoryQuery(struct HistoryQuery *query)
+{
+    query->since = 0;
+    query->until = 0xFFFFFFFFUL;
+    query->codeValue = 0;
+    query->codeMask = 0;
+}
+
+/*
+ * Read a SINCE or UNTIL time as seconds since 1978
+ * Accepts NOW, -<n>S/M/H/D/W back from now, and YYYY-MM-DD with an optional
+ * HH:MM[:SS] after a space or T.  A bare date ends the day when end is set.
+ */
+BOOL ParseHistoryTime(CONST_STRPTR text, ULONG now, BOOL end, ULONG *time)
+{
+    ULONG year;
+    ULONG month;
+    ULONG day;
+    ULONG hour;
+    ULONG minute;
+    ULONG second;
+    ULONG amount;
+    ULONG unit;
+    LONG days;
+
+    if ((text[0] == 'N' || text[0] == 'n') && (text[1] == 'O' || text[1] == 'o') &&
+        (text[2] == 'W' || text[2] == 'w') && text[3] == '\0') {
+        *time = now;
+        return TRUE;
+    }
+
+    if (text[0] == '-') {
+        text++;
+        amount = 0;
+        while (*text >= '0' && *text <= '9' && amount < 100000000UL) {
+            amount = amount * 10 + (ULONG)(*text - '0');
+            text++;
+        }
+
+        unit = 0;
+        if (*text == 's' || *text == 'S') {
+            unit = 1;
+        } else if (*text == 'm' || *text == 'M') {
+            unit = 60;
+        } else if (*text == 'h' || *text == 'H') {
+            unit = 3600;
+        } else if (*text == 'd' || *text == 'D') {
+            unit = 86400;
+        } else if (*text == 'w' || *text == 'W') {
+            unit = 604800;
+        }
+        if (unit == 0 || text[1] != '\0') {
+            return FALSE;
+        }
+
+        /* Further back than 1978 is simply the start of the history */
+        *time = (amount > now / unit) ? 0 : now - amount * unit;
+        return TRUE;
+    }
+
+    if (!ReadNumber(&text, 4, &year) || *text++ != '-' || !ReadNumber(&text, 2, &month) ||
+        *text++ != '-' || !ReadNumber(&text, 2, &day)) {
+        return FALSE;
+    }
+    if (year < FIRST_YEAR || year > LAST_YEAR || month < 1 || month > 12 || day < 1 || day > 31) {
+        return FALSE;
+    }
+
+    hour = 0;
+    minute = 0;
+    second = 0;
+    if (*text == ' ' || *text == 'T' || *text == 't') {
+        text++;
+        if (!ReadNumber(&text, 2, &hour) || *text++ != ':' || !ReadNumber(&text, 2, &minute)) {
+            return FALSE;
+        }
+        if (*text == ':') {
+            text++;
+            if (!ReadNumber(&text, 2, &second)) {
+                return FALSE;
+            }
+        }
+        if (hour > 23 || minute > 59 || second > 59) {
+            return FALSE;
+        }
+    } else if (end) {
+        hour = 23;
+        minute = 59;
+        second = 59;
+    }
+    if (*text != '\0') {
+        return FALSE;
+    }
+
+    second += hour * 3600UL + minute * 60UL;
+    days = DaysFromCivil((LONG)year, (LONG)month, (LONG)day) - EPOCH_DAYS;
+    if (days < 0 || (ULONG)days > (0xFFFFFFFFUL - second) / 86400UL) {
+        return FALSE;
+    }
+
+    *time = (ULONG)days * 86400UL + second;
+    return TRUE;
+}
+
+/*
+ * Read a CODE pattern - up to 8 hex digits, x or ? for any digit
+ * Fewer than 8 digits match as a prefix, so 81 is 81xxxxxx.  An optional
+ * 0x or $ prefix is allowed.
+ */
+BOOL ParseHistoryCodePattern(CONST_STRPTR text, ULONG *value, ULONG *mask)
+{
+    ULONG digits;
+    ULONG nibble;
+    char c;
+
+    if (text[0] == '0' && (text[1] == 'x' || text[1] == 'X')) {
+        text += 2;
+    } else if (text[0] == '$') {
+        text++;
+    }
+
+    *value = 0;
+    *mask = 0;
+    for (digits = 0; text[digits] != '\0'; digits++) {
+        if (digits == 8) {
+            return FALSE;
+        }
+
+        c = text[digits];
+        if (c == 'x' || c == 'X' || c == '?') {
+            continue;
+        }
+        if (c >= '0' && c <= '9') {
+            nibble = (ULONG)(c - '0');
+        } else if (c >= 'a' && c <= 'f') {
+            nibble = (ULONG)(c - 'a' + 10);
+        } else if (c >= 'A' && c <= 'F') {
+            nibble = (ULONG)(c - 'A' + 10);
+        } else {
+            return FALSE;
+        }
+
+        *value |= nibble << (28 - digits * 4);
+        *mask |= 0xFUL << (28 - digits * 4);
+    }
+
+    return (BOOL)(digits > 0);
+}
+
+/*
+ * Narrow a query to codes with (code & mask) == value as well
+ * Returns FALSE, leaving the query as it was, if no code can satisfy
+ * both - e.g. CODE=01 with DEADEND.
+ */
+BOOL RestrictHistoryCodes(struct HistoryQuery *query, ULONG value, ULONG mask)
+{
+    if (((query->codeValue ^ value) & query->codeMask & mask) != 0) {
+        return FALSE;
+    }
+
+    query->codeValue = (query->codeValue & query->codeMask) | (value & mask);
+    query->codeMask |= mask;
+    return TRUE;
+}
+
+/*
+ * Write a history time as "YYYY-MM-DD HH:MM:SS"
+ * buffer must hold HISTORY_TIME_LENGTH characters.
+ */
+VOID FormatHistoryTime(ULONG time, char *buffer)
+{
+    LONG days;
+    LONG era;
+    LONG dayOfEra;
+    LONG yearOfEra;
+    LONG dayOfYear;
+    LONG shiftedMonth;
+    LONG year;
+    LONG month;
+    LONG day;
+    ULONG seconds;
+
+    /* Civil date from a day count (proleptic Gregorian), 1 March based */
+    days = (LONG)(time / 86400UL) + EPOCH_DAYS + 719468L;
+    era = days / 146097L;
+    dayOfEra = days - era * 146097L;
+    yearOfEra = (dayOfEra - dayOfEra / 1460 + dayOfEra / 36524 - dayOfEra / 146096) / 365;
+    dayOfYear = dayOfEra - (365 * yearOfEra + yearOfEra / 4 - yearOfEra / 100);
+    shiftedMonth = (5 * dayOfYear + 2) / 153;
+    day = dayOfYear - (153 * shiftedMonth + 2) / 5 + 1;
+    month = (shiftedMonth < 10) ? shiftedMonth + 3 : shiftedMonth - 9;
+    year = yearOfEra + era * 400 + ((month <= 2) ? 1 : 0);
+
+    seconds = time % 86400UL;
+    sprintf(buffer, "%04ld-%02ld-%02ld %02lu:%02lu:%02lu", (long)year, (long)month, (long)day,
+            (unsigned long)(seconds / 3600), (unsigned long)(seconds / 60 % 60), (unsigned long)(seconds % 60));
+}
+
+/*
+ * Report every record of a history file that matches a query, oldest first
+ * Only blocks whose index summary can match are read.  Whole blocks not
+ * yet in the index are summarised while they are read, and the index file
+ * is extended if it can be written.  report may return FALSE to stop.
+ * Returns HISTORY_OK or a HISTORY_ERROR_xxx code.
+ */
+ULONG QueryCrashHistory(CONST_STRPTR path, const struct HistoryQuery *query,
+                        BOOL (*report)(const struct CrashRecord *record, APTR userData), APTR userData,
+                        struct HistoryQueryStats *stats)
+{
+    struct CrashHistory *history;
+    struct HistoryIndex index;
+    ULONG topMask[HISTORY_MASK_WORDS];
+    char *indexPath;
+    ULONG error;
+    ULONG slots;
+    ULONG block;
+    ULONG top;
+    ULONG codeTop;
+    ULONG maskTop;
+    BOOL running;
+
+    memset(stats, 0, sizeof(*stats));
+
+    history = OpenCrashHistory(path, &error);
+    if (history == NULL) {
+        return error;
+    }
+
+    slots = CrashHistorySlots(history);
+    stats->blocks = slots / HISTORY_INDEX_BLOCK;
+
+    indexPath = (char *)malloc(strlen(path) + sizeof(HISTORY_INDEX_SUFFIX));
+    index.entries = (struct IndexEntry *)malloc((stats->blocks + 1) * sizeof(struct IndexEntry));
+    if (indexPath == NULL || index.entries == NULL) {
+        free(indexPath);
+        free(index.entries);
+        CloseCrashHistory(history);
+        return HISTORY_ERROR_MEMORY;
+    }
+    strcpy(indexPath, path);
+    strcat(indexPath, HISTORY_INDEX_SUFFIX);
+
+    index.valid = LoadIndex(indexPath, history, &index);
+    index.built = index.count;
+
+    /* Top code bytes the query accepts, in the index bitmap layout */
+    codeTop = query->codeValue >> 24;
+    maskTop = query->codeMask >> 24;
+    memset(topMask, 0, sizeof(topMask));
+    for (top = 0; top < 256; top++) {
+        if ((top & maskTop) == (codeTop & maskTop)) {
+            topMask[top >> 5] |= 1UL << (top & 31);
+        }
+    }
+
+    running = TRUE;
+    for (block = 0; block < stats->blocks && running; block++) {
+        if (block < index.count) {
+            if (EntryMatches(&index.entries[block], query, topMask)) {
+                stats->blocksRead++;
+                running = ScanSlots(history, block * HISTORY_INDEX_BLOCK, (block + 1) * HISTORY_INDEX_BLOCK,
+                                    query, NULL, report, userData, stats);
+            }
+        } else {
+            /* Not summarised yet - read it once to build its entry */
+            stats->blocksRead++;
+            running = ScanSlots(history, block * HISTORY_INDEX_BLOCK, (block + 1) * HISTORY_INDEX_BLOCK,
+                                query, &index.entries[block], report, userData, stats);
+            if (running) {
+                index.built = block + 1;
+                stats->indexed++;
+            }
+        }
+    }
+
+    /* Records after the last whole block are always read */
+    if (running) {
+        ScanSlots(history, stats->blocks * HISTORY_INDEX_BLOCK, slots, query, NULL, report, userData, stats);
+    }
+
+    if (index.built > index.count || !index.valid) {
+        SaveIndex(indexPath, history, &index);
+    }
+
+    stats->damaged = CrashHistoryDamaged(history);
+    free(indexPath);
+    free(index.entries);
+    CloseCrashHistory(history);
+    return HISTORY_OK;
+}
+
+/*
+ * Query a history file and write each match as a TSV or JSON record
+ * Records lead with the time, task and task name, then the code decoded
+ * as in batch mode.
+ */
+ULONG QueryHistoryToRecords(CONST_STRPTR path, const struct HistoryQuery *query, FILE *output, ULONG format,
+                            struct HistoryQueryStats *stats)
+{
+    struct RecordQuery *state;
+    ULONG error;
+
+    state = (struct RecordQuery *)malloc(sizeof(struct RecordQuery));
+    if (state == NULL) {
+        memset(stats, 0, sizeof(*stats));
+        return HISTORY_ERROR_MEMORY;
+    }
+    if (!OpenBatchWriter(&state->writer, output, format)) {
+        free(state);
+        memset(stats, 0, sizeof(*stats));
+        return HISTORY_ERROR_MEMORY;
+    }
+
+    error = QueryCrashHistory(path, query, WriteHistoryRecord, state, stats);
+
+    if (!CloseBatchWriter(&state->writer) && error == HISTORY_OK) {
+        error = HISTORY_ERROR_OUTPUT;
+    }
+
+    free(state);
+    return error;
+}
+
+/*
+ * Days from 1 January 1970 to a civil date (proleptic Gregorian)
+ */
+static LONG DaysFromCivil(LONG year, LONG month, LONG day)
+{
+    LONG era;
+    LONG yearOfEra;
+    LONG dayOfYear;
+    LONG dayOfEra;
+
+    year -= (month <= 2) ? 1 : 0;
+    era = year / 400;
+    yearOfEra = year - era * 400;
+    dayOfYear = (153 * (month + ((month > 2) ? -3 : 9)) + 2) / 5 + day - 1;
+    dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+
+    return era * 146097L + dayOfEra - 719468L;
+}
+
+/*
+ * Read exactly digits decimal digits and step past them
+ */
+static BOOL ReadNumber(CONST_STRPTR *text, ULONG digits, ULONG *value)
+{
+    ULONG i;
+
+    *value = 0;
+    for (i = 0; i < digits; i++) {
+        if ((*text)[i] < '0' || (*text)[i] > '9') {
+            return FALSE;
+        }
+        *value = *value * 10 + (ULONG)((*text)[i] - '0');
+    }
+
+    *text += digits;
+    return TRUE;
+}
+
+/*
+ * Load the entries of an index file that still describe the history
+ * The first and last indexed record slots must carry the checksums the
+ * index remembers; otherwise the history was replaced and nothing is kept.
+ * Entries past a damaged one are dropped and rebuilt.  Returns TRUE if
+ * the file on disk can be extended as it is.
+ */
+static BOOL LoadIndex(CONST_STRPTR indexPath, struct CrashHistory *history, struct HistoryIndex *index)
+{
+    UBYTE header[HISTORY_INDEX_HEADER_SIZE];
+    UBYTE data[HISTORY_INDEX_ENTRY_SIZE];
+    UBYTE slot[HISTORY_RECORD_SIZE];
+    FILE *file;
+    ULONG entries;
+    ULONG i;
+
+    index->count = 0;
+
+    file = fopen(indexPath, "rb");
+    if (file == NULL) {
+        return FALSE;
+    }
+
+    if (fread(header, 1, sizeof(header), file) != sizeof(header) ||
+        IdbGetLong(header + HISTORY_INDEX_FIELD_MAGIC * 4) != HISTORY_INDEX_MAGIC ||
+        IdbGetLong(header + HISTORY_INDEX_FIELD_VERSION * 4) != HISTORY_INDEX_VERSION ||
+        IdbGetLong(header + HISTORY_INDEX_FIELD_BLOCK * 4) != HISTORY_INDEX_BLOCK ||
+        IdbGetLong(header + HISTORY_INDEX_FIELD_CHECKSUM * 4) !=
+            IdbChecksum(0, header, HISTORY_INDEX_FIELD_CHECKSUM * 4)) {
+        fclose(file);
+        return FALSE;
+    }
+
+    entries = IdbGetLong(header + HISTORY_INDEX_FIELD_ENTRIES * 4);
+    if (entries > CrashHistorySlots(history) / HISTORY_INDEX_BLOCK) {
+        fclose(file);
+        return FALSE;
+    }
+
+    if (entries > 0) {
+        if (!ReadCrashSlot(history, 0, slot) ||
+            IdbGetLong(slot + HISTORY_CHECKSUM_OFFSET) != IdbGetLong(header + HISTORY_INDEX_FIELD_FIRST * 4) ||
+            !ReadCrashSlot(history, entries * HISTORY_INDEX_BLOCK - 1, slot) ||
+            IdbGetLong(slot + HISTORY_CHECKSUM_OFFSET) != IdbGetLong(header + HISTORY_INDEX_FIELD_LAST * 4)) {
+            fclose(file);
+            return FALSE;
+        }
+    }
+
+    for (i = 0; i < entries; i++) {
+        if (fread(data, 1, sizeof(data), file) != sizeof(data) || !DecodeEntry(data, &index->entries[i])) {
+            break;
+        }
+    }
+    index->count = i;
+
+    fclose(file);
+    return (BOOL)(i == entries);
+}
+
+/*
+ * Write the index - new entries are appended to a valid file, otherwise
+ * the file is written afresh.  The header goes last, so an interrupted
+ * write leaves an index that still describes the entries it counts.
+ * Failures are ignored; the next query tries again.
+ */
+static VOID SaveIndex(CONST_STRPTR indexPath, struct CrashHistory *history, const struct HistoryIndex *index)
+{
+    UBYTE header[HISTORY_INDEX_HEADER_SIZE];
+    UBYTE data[HISTORY_INDEX_ENTRY_SIZE];
+    UBYTE slot[HISTORY_RECORD_SIZE];
+    FILE *file;
+    ULONG first;
+    ULONG i;
+    BOOL written;
+
+    memset(header, 0, sizeof(header));
+    IdbPutLong(header + HISTORY_INDEX_FIELD_MAGIC * 4, HISTORY_INDEX_MAGIC);
+    IdbPutLong(header + HISTORY_INDEX_FIELD_VERSION * 4, HISTORY_INDEX_VERSION);
+    IdbPutLong(header + HISTORY_INDEX_FIELD_BLOCK * 4, HISTORY_INDEX_BLOCK);
+    IdbPutLong(header + HISTORY_INDEX_FIELD_ENTRIES * 4, index->built);
+    if (index->built > 0) {
+        if (!ReadCrashSlot(history, 0, slot)) {
+            return;
+        }
+        IdbPutLong(header + HISTORY_INDEX_FIELD_FIRST * 4, IdbGetLong(slot + HISTORY_CHECKSUM_OFFSET));
+        if (!ReadCrashSlot(history, index->built * HISTORY_INDEX_BLOCK - 1, slot)) {
+            return;
+        }
+        IdbPutLong(header + HISTORY_INDEX_FIELD_LAST * 4, IdbGetLong(slot + HISTORY_CHECKSUM_OFFSET));
+    }
+    IdbPutLong(header + HISTORY_INDEX_FIELD_CHECKSUM * 4, IdbChecksum(0, header, HISTORY_INDEX_FIELD_CHECKSUM * 4));
+
+    first = 0;
+    file = NULL;
+    if (index->valid) {
+        file = fopen(indexPath, "r+b");
+        first = index->count;
+    }
+    if (file == NULL) {
+        file = fopen(indexPath, "wb");
+        first = 0;
+    }
+    if (file == NULL) {
+        return;
+    }
+
+    written = (BOOL)(fseek(file, (long)(HISTORY_INDEX_HEADER_SIZE + first * HISTORY_INDEX_ENTRY_SIZE), SEEK_SET) == 0);
+    for (i = first; i < index->built && written; i++) {
+        EncodeEntry(&index->entries[i], data);
+        written = (BOOL)(fwrite(data, 1, sizeof(data), file) == sizeof(data));
+    }
+
+    if (written && fflush(file) == 0 && fseek(file, 0, SEEK_SET) == 0) {
+        fwrite(header, 1, sizeof(header), file);
+    }
+
+    fclose(file);
+}
+
+/*
+ * Write an index entry into HISTORY_INDEX_ENTRY_SIZE bytes
+ */
+static VOID EncodeEntry(const struct IndexEntry *entry, UBYTE *data)
+{
+    ULONG i;
+
+    IdbPutLong(data, entry->first);
+    IdbPutLong(data + 4, entry->last);
+    for (i = 0; i < HISTORY_MASK_WORDS; i++) {
+        IdbPutLong(data + 8 + i * 4, entry->mask[i]);
+    }
+    IdbPutLong(data + HISTORY_INDEX_ENTRY_SIZE - 4, IdbChecksum(0, data, HISTORY_INDEX_ENTRY_SIZE - 4));
+}
+
+/*
+ * Read an index entry, checking its CRC
+ */
+static BOOL DecodeEntry(const UBYTE *data, struct IndexEntry *entry)
+{
+    ULONG i;
+
+    if (IdbGetLong(data + HISTORY_INDEX_ENTRY_SIZE - 4) != IdbChecksum(0, data, HISTORY_INDEX_ENTRY_SIZE - 4)) {
+        return FALSE;
+    }
+
+    entry->first = IdbGetLong(data);
+    entry->last = IdbGetLong(data + 4);
+    for (i = 0; i < HISTORY_MASK_WORDS; i++) {
+        entry->mask[i] = IdbGetLong(data + 8 + i * 4);
+    }
+
+    return TRUE;
+}
+
+/*
+ * Could a block with this summary hold a matching record?
+ */
+static BOOL EntryMatches(const struct IndexEntry *entry, const struct HistoryQuery *query, const ULONG *topMask)
+{
+    ULONG i;
+
+    if (entry->first > query->until || entry->last < query->since) {
+        return FALSE;
+    }
+
+    for (i = 0; i < HISTORY_MASK_WORDS; i++) {
+        if ((entry->mask[i] & topMask[i]) != 0) {
+            return TRUE;
+        }
+    }
+
+    return FALSE;
+}
+
+/*
+ * Read the records in slots first..end-1, reporting the matches
+ * Fills entry with the slots' summary when it is not NULL.  Returns FALSE
+ * once report asks to stop.
+ */
+static BOOL ScanSlots(struct CrashHistory *history, ULONG first, ULONG end, const struct HistoryQuery *query,
+                      struct IndexEntry *entry,
+                      BOOL (*report)(const struct CrashRecord *record, APTR userData), APTR userData,
+                      struct HistoryQueryStats *stats)
+{
+    struct CrashRecord record;
+    ULONG top;
+
+    if (entry != NULL) {
+        entry->first = 0xFFFFFFFFUL;
+        entry->last = 0;
+        memset(entry->mask, 0, sizeof(entry->mask));
+    }
+
+    if (first >= end || !SeekCrashHistory(history, first)) {
+        return TRUE;
+    }
+
+    while (NextCrashRecord(history, &record) && CrashHistoryPosition(history) <= end) {
+        stats->records++;
+
+        if (entry != NULL) {
+            if (record.timestamp < entry->first) {
+                entry->first = record.timestamp;
+            }
+            if (record.timestamp > entry->last) {
+                entry->last = record.timestamp;
+            }
+            top = record.code >> 24;
+            entry->mask[top >> 5] |= 1UL << (top & 31);
+        }
+
+        if (record.timestamp >= query->since && record.timestamp <= query->until &&
+            (record.code & query->codeMask) == query->codeValue) {
+            stats->matches++;
+            if (!report(&record, userData)) {
+                return FALSE;
+            }
+        }
+    }
+
+    return TRUE;
+}
+
+/*
+ * Report callback for QueryHistoryToRecords - decode the record into the writer
+ */
+static BOOL WriteHistoryRecord(const struct CrashRecord *record, APTR userData)
+{
+    struct RecordQuery *state;
+    struct RecordSource source;
+
+    state = (struct RecordQuery *)userData;
+
+    FormatHistoryTime(record->timestamp, state->time);
+    source.line = 0;
+    source.time = state->time;
+    source.kind = NULL;
+    source.hasProducer = FALSE;
+    source.producer = 0;
+    source.hasTask = TRUE;
+    source.task = record->taskID;
+    source.taskName = record->taskName;
+    WriteSourcedAlertRecord(&state->writer, record->code, &source);
+
+    /* Stop reading once the output is gone */
+    return (BOOL)!state->writer.failed;
+}
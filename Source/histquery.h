@@ -0,0 +1,106 @@
+/*
+ * Crash History Queries
+ *
+ * Time and code queries over the crash history.  A sparse index kept next
+ * to the history file (<history>.idx) records, for every block of
+ * HISTORY_INDEX_BLOCK records, the time range it covers and which top code
+ * bytes appear in it.  A query reads only the blocks whose summary can
+ * match, then the few records appended since the last whole block.
+ *
+ * After meditiation comes... Insight
+ *
+ * Copyright (c) 2025-26 amigazen project
+ * Licensed under BSD 2-Clause License
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef HISTQUERY_H
+#define HISTQUERY_H
+
+#include <stdio.h>
+#include "platform.h"
+#include "history.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Index file layout - all fields are big-endian ULONGs */
+#define HISTORY_INDEX_MAGIC      0x49484958UL   /* "IHIX" */
+#define HISTORY_INDEX_VERSION    1
+#define HISTORY_INDEX_SUFFIX     ".idx"
+#define HISTORY_INDEX_BLOCK      256            /* Records summarised per entry */
+#define HISTORY_INDEX_HEADER_SIZE 32
+#define HISTORY_INDEX_ENTRY_SIZE  44
+
+/* Index header fields, as ULONG offsets */
+#define HISTORY_INDEX_FIELD_MAGIC    0
+#define HISTORY_INDEX_FIELD_VERSION  1
+#define HISTORY_INDEX_FIELD_BLOCK    2
+#define HISTORY_INDEX_FIELD_ENTRIES  3          /* Whole blocks indexed */
+#define HISTORY_INDEX_FIELD_FIRST    4          /* Checksum word of the first record slot */
+#define HISTORY_INDEX_FIELD_LAST     5          /* Checksum word of the last indexed slot */
+#define HISTORY_INDEX_FIELD_CHECKSUM 7          /* CRC-32 of the fields before it */
+
+/* Index entry: first and last time, 256-bit top byte mask, CRC-32 */
+#define HISTORY_MASK_WORDS 8
+
+/* Formatted record time, "YYYY-MM-DD HH:MM:SS" */
+#define HISTORY_TIME_LENGTH 20
+
+/* Query bounds - the defaults match every record */
+struct HistoryQuery {
+    ULONG since;          /* First time, inclusive */
+    ULONG until;          /* Last time, inclusive */
+    ULONG codeValue;      /* Matching codes have (code & codeMask) == codeValue */
+    ULONG codeMask;
+};
+
+/* What a query did */
+struct HistoryQueryStats {
+    ULONG matches;
+    ULONG records;        /* Intact records examined */
+    ULONG blocks;         /* Whole blocks in the history */
+    ULONG blocksRead;     /* Blocks whose summary could match */
+    ULONG indexed;        /* Blocks added to the index by this query */
+    ULONG damaged;        /* Damaged slots met while reading */
+};
+
+/* Function declarations */
+VOID InitHistoryQuery(struct HistoryQuery *query);
+BOOL ParseHistoryTime(CONST_STRPTR text, ULONG now, BOOL end, ULONG *time);
+BOOL ParseHistoryCodePattern(CONST_STRPTR text, ULONG *value, ULONG *mask);
+BOOL RestrictHistoryCodes(struct HistoryQuery *query, ULONG value, ULONG mask);
+VOID FormatHistoryTime(ULONG time, char *buffer);
+ULONG QueryCrashHistory(CONST_STRPTR path, const struct HistoryQuery *query,
+                        BOOL (*report)(const struct CrashRecord *record, APTR userData), APTR userData,
+                        struct HistoryQueryStats *stats);
+ULONG QueryHistoryToRecords(CONST_STRPTR path, const struct HistoryQuery *query, FILE *output, ULONG format,
+                            struct HistoryQueryStats *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HISTQUERY_H */
@@ -0,0 +1,92 @@
+/*
+ * Insight Host Tools
+ *
+ * Argument matching and seeded random numbers for the host tools.  The
+ * command line tool, the benchmarks, the corpus generator and the checks
+ * all read ReadArgs-style KEYWORD=value arguments and draw their input
+ * from one xorshift32 generator, so a SEED means the same thing to each.
+ * Host-only - the Amiga build uses ReadArgs.
+ *
+ * After meditiation comes... Insight
+ *
+ * Copyright (c) 2025-26 amigazen project
+ * Licensed under BSD 2-Clause License
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <stddef.h>
+#include <ctype.h>
+#include "platform.h"
+#include "hosttools.h"
+
+/* xorshift32 state - never 0, which the generator cannot leave */
+static ULONG randomState = 1;
+
+/*
+ * Case-insensitive keyword match in the style of ReadArgs()
+ * Accepts "KEYWORD" or "KEYWORD=value"; value is set to the text after '='
+ */
+BOOL MatchKeyword(const char *arg, const char *keyword, const char **value)
+{
+    while (*keyword != '\0') {
+        if (toupper((unsigned char)*arg) != *keyword) {
+            return FALSE;
+        }
+        arg++;
+        keyword++;
+    }
+
+    if (*arg == '=') {
+        *value = arg + 1;
+        return TRUE;
+    }
+
+    if (*arg == '\0') {
+        *value = NULL;
+        return TRUE;
+    }
+
+    return FALSE;
+}
+
+/*
+ * Start the generator again from a seed - 0 is taken as 1
+ */
+VOID SeedRandom(ULONG seed)
+{
+    randomState = (seed != 0) ? seed : 1;
+}
+
+/*
+ * Next number from the xorshift32 generator
+ * Not thread-safe - tools draw their input before starting threads.
+ */
+ULONG NextRandom(VOID)
+{
+    randomState ^= randomState << 13;
+    randomState ^= randomState >> 17;
+    randomState ^= randomState << 5;
+
+    return randomState;
+}
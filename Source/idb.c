@@ -0,0 +1,740 @@
+/*
+ * Insight Database Files
+ *
+ * Opens .idb files and serves lookups straight from their bytes.  On build
+ * hosts the file is mapped with mmap, or read into memory for programs
+ * that keep it open while it may be replaced; on the Amiga it is read into
+ * one AllocVec block.  Opening checks the header, the checksum and that every
+ * section lies inside the file, then only builds the small token
+ * dictionary - entries and strings are read in place on each lookup.
+ *
+ * After meditiation comes... Insight
+ *
+ * Copyright (c) 2025-26 amigazen project
+ * Licensed under BSD 2-Clause License
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "platform.h"
+#ifdef INSIGHT_AMIGA
+#include <exec/memory.h>
+#include <proto/exec.h>
+#include <proto/dos.h>
+#else
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+#include "lookup.h"
+#include "decompose.h"
+#include "search.h"
+#include "names.h"
+#include "idb.h"
+
+/* Database used by the lookup functions - NULL means the compiled-in tables */
+static struct InsightDatabase *activeDatabase = NULL;
+
+/* Pinned in place of NULL, for the compiled-in tables */
+static struct InsightDatabase compiledTables;
+
+/*
+ * Database pinned for the calling thread, NULL if none.  The Amiga daemon
+ * serves one request at a time on one task, so one pin is enough there.
+ */
+#ifdef INSIGHT_AMIGA
+static struct InsightDatabase *pinnedDatabase = NULL;
+#else
+static pthread_key_t pinnedKey;
+static pthread_once_t pinnedOnce = PTHREAD_ONCE_INIT;
+static BOOL pinnedKeyMade = FALSE;
+static BOOL pinnedEver = FALSE;           /* Until a thread pins, lookups skip the key */
+#endif
+
+/* CRC-32 (IEEE 802.3, reflected) of each nibble value */
+static const ULONG crcNibble[16] = {
+    0x00000000UL, 0x1DB71064UL, 0x3B6E20C8UL, 0x26D930ACUL,
+    0x76DC4190UL, 0x6B6B51F4UL, 0x4DB26158UL, 0x5005713CUL,
+    0xEDB88320UL, 0xF00F9344UL, 0xD6D6A3E8UL, 0xCB61B38CUL,
+    0x9B64C2B0UL, 0x86D3D2D4UL, 0xA00AE278UL, 0xBDBDF21CUL
+};
+
+/* Messages for IDB_xxx open errors */
+static const CONST_STRPTR errorTexts[] = {
+    "no error",
+    "cannot read the file",
+    "out of memory",
+    "not an Insight database",
+    "unsupported database version",
+    "checksum mismatch",
+    "database is corrupt"
+};
+
+/* Forward declarations */
+static BOOL SectionFits(const struct InsightDatabase *database, ULONG offset, ULONG count, ULONG itemSize);
+static ULONG ValidateDatabase(struct InsightDatabase *database, ULONG flags);
+static ULONG BuildTokens(struct InsightDatabase *database);
+static ULONG LoadFile(CONST_STRPTR path, ULONG flags, UBYTE **data, ULONG *size, ULONG *storage);
+static VOID ReleaseFile(UBYTE *data, ULONG size, ULONG storage);
+#ifndef INSIGHT_AMIGA
+static VOID MakePinnedKey(VOID);
+#endif
+
+/*
+ * Open an .idb file
+ * Returns NULL on failure with the reason in *error (which may be NULL).
+ */
+struct InsightDatabase *OpenInsightDatabase(CONST_STRPTR path, ULONG flags, ULONG *error)
+{
+    struct InsightDatabase *database;
+    UBYTE *data;
+    ULONG size;
+    ULONG storage;
+    ULONG failure;
+
+    database = NULL;
+
+    failure = LoadFile(path, flags, &data, &size, &storage);
+    if (failure == IDB_OK) {
+        database = OpenInsightDatabaseMemory(data, size, flags, &failure);
+        if (database == NULL) {
+            ReleaseFile(data, size, storage);
+        } else {
+            database->storage = storage;
+        }
+    }
+
+    if (error != NULL) {
+        *error = failure;
+    }
+    return database;
+}
+
+/*
+ * Use an .idb image that is already in memory
+ * The memory is borrowed and must stay valid until the database is closed.
+ * Returns NULL on failure with the reason in *error (which may be NULL).
+ */
+struct InsightDatabase *OpenInsightDatabaseMemory(const VOID *data, ULONG size, ULONG flags, ULONG *error)
+{
+    struct InsightDatabase *database;
+    ULONG failure;
+
+    database = (struct InsightDatabase *)calloc(1, sizeof(struct InsightDatabase));
+    if (database == NULL) {
+        failure = IDB_ERROR_MEMORY;
+    } else {
+        database->data = (const UBYTE *)data;
+        database->size = size;
+        database->storage = IDB_STORAGE_BORROWED;
+
+        failure = ValidateDatabase(database, flags);
+        if (failure == IDB_OK) {
+            failure = BuildTokens(database);
+        }
+        if (failure != IDB_OK) {
+            free(database->tokens);
+            free(database);
+            database = NULL;
+        }
+    }
+
+    if (error != NULL) {
+        *error = failure;
+    }
+    return database;
+}
+
+/*
+ * Close a database and release its memory
+ * If it is the active database, lookups go back to the compiled-in tables.
+ */
+VOID CloseInsightDatabase(struct InsightDatabase *database)
+{
+    if (database == NULL) {
+        return;
+    }
+
+    if (activeDatabase == database) {
+        activeDatabase = NULL;
+    }
+
+    if (database->storage != IDB_STORAGE_BORROWED) {
+        ReleaseFile((UBYTE *)database->data, database->size, database->storage);
+    }
+
+    free(database->tokens);
+    free(database);
+}
+
+/*
+ * Find an error code in a database
+ * A binary search over the codes sharing the code's top byte.
+ * Returns the entry index or LOOKUP_NOT_FOUND.
+ */
+LONG IdbLookup(const struct InsightDatabase *database, ULONG errorCode)
+{
+    const UBYTE *bucket;
+    ULONG low;
+    ULONG high;
+    ULONG middle;
+    ULONG code;
+
+    bucket = database->buckets + (errorCode >> 24) * 4;
+    low = IdbGetLong(bucket);
+    high = IdbGetLong(bucket + 4);
+
+    while (low < high) {
+        middle = low + (high - low) / 2;
+        code = IdbGetLong(database->codes + middle * 4);
+        if (code == errorCode) {
+            return (LONG)middle;
+        }
+        if (code < errorCode) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+
+    return LOOKUP_NOT_FOUND;
+}
+
+/*
+ * Describe a database entry without copying anything
+ * The strings point into the database.  Offsets outside the string pool
+ * read as empty strings rather than past the file.
+ */
+VOID IdbEntryView(const struct InsightDatabase *database, ULONG index, struct ErrorView *view)
+{
+    const UBYTE *entry;
+    ULONG description;
+    ULONG insight;
+
+    if (index >= database->entryCount) {
+        view->code = 0;
+        view->description = database->pool + database->poolSize - 1;
+        view->insight = view->description;
+        view->insightLength = 0;
+        return;
+    }
+
+    entry = database->entries + index * IDB_ENTRY_SIZE;
+    description = IdbGetLong(entry);
+    insight = IdbGetLong(entry + 4);
+
+    view->code = IdbGetLong(database->codes + index * 4);
+    view->description = database->pool + ((description < database->poolSize) ? description : database->poolSize - 1);
+    view->insight = database->pool + ((insight < database->poolSize) ? insight : database->poolSize - 1);
+    view->insightLength = IdbGetLong(entry + 8);
+}
+
+/*
+ * Read one value of the alert range index (IDB_ALERT_xxx table)
+ * Out of range slots read as ALERT_NO_ENTRY.
+ */
+UWORD IdbAlertIndex(const struct InsightDatabase *database, ULONG table, ULONG slot)
+{
+    if (table < IDB_ALERT_CLASS_ENTRY) {
+        if (slot >= ALERT_SUBSYSTEMS) {
+            return ALERT_NO_ENTRY;
+        }
+        return IdbGetWord(database->alertIndex + (table * ALERT_SUBSYSTEMS + slot) * 2);
+    }
+
+    if (table != IDB_ALERT_CLASS_ENTRY || slot >= database->classEntryCount) {
+        return ALERT_NO_ENTRY;
+    }
+    return IdbGetWord(database->alertIndex + (3 * ALERT_SUBSYSTEMS + slot) * 2);
+}
+
+/*
+ * Update a CRC-32 with more data - start with 0, like zlib's crc32()
+ * Four bits at a time so the table stays small on the Amiga.
+ */
+ULONG IdbChecksum(ULONG crc, const UBYTE *data, ULONG length)
+{
+    crc = ~crc;
+    while (length > 0) {
+        crc ^= *data++;
+        crc = (crc >> 4) ^ crcNibble[crc & 0x0F];
+        crc = (crc >> 4) ^ crcNibble[crc & 0x0F];
+        length--;
+    }
+
+    return ~crc;
+}
+
+/*
+ * Read a big-endian ULONG - every file format here stores them this way
+ */
+ULONG IdbGetLong(const UBYTE *data)
+{
+    return ((ULONG)data[0] << 24) | ((ULONG)data[1] << 16) | ((ULONG)data[2] << 8) | (ULONG)data[3];
+}
+
+/*
+ * Store a big-endian ULONG
+ */
+VOID IdbPutLong(UBYTE *data, ULONG value)
+{
+    data[0] = (UBYTE)(value >> 24);
+    data[1] = (UBYTE)(value >> 16);
+    data[2] = (UBYTE)(value >> 8);
+    data[3] = (UBYTE)value;
+}
+
+/*
+ * Read a big-endian UWORD
+ */
+UWORD IdbGetWord(const UBYTE *data)
+{
+    return (UWORD)(((UWORD)data[0] << 8) | (UWORD)data[1]);
+}
+
+/*
+ * Describe an IDB_xxx open error
+ */
+CONST_STRPTR IdbErrorText(ULONG error)
+{
+    if (error >= sizeof(errorTexts) / sizeof(errorTexts[0])) {
+        return "unknown error";
+    }
+
+    return errorTexts[error];
+}
+
+/*
+ * Serve lookups from a database, or from the compiled-in tables with NULL
+ * Set before decoding starts - the lookup functions read it without locking.
+ */
+VOID UseInsightDatabase(struct InsightDatabase *database)
+{
+    activeDatabase = database;
+}
+
+/*
+ * Return the database lookups are served from, NULL for the compiled-in tables
+ * A database pinned by the calling thread takes the place of the one
+ * UseInsightDatabase selected.
+ */
+struct InsightDatabase *ActiveInsightDatabase(VOID)
+{
+    struct InsightDatabase *pinned;
+
+#ifdef INSIGHT_AMIGA
+    pinned = pinnedDatabase;
+#else
+    /* A thread that pinned has seen its own store, and the others have no pin to find */
+    pinned = NULL;
+    if (__atomic_load_n(&pinnedEver, __ATOMIC_RELAXED)) {
+        pthread_once(&pinnedOnce, MakePinnedKey);
+        pinned = pinnedKeyMade ? (struct InsightDatabase *)pthread_getspecific(pinnedKey) : NULL;
+    }
+#endif
+    if (pinned != NULL) {
+        return (pinned == &compiledTables) ? NULL : pinned;
+    }
+
+    return activeDatabase;
+}
+
+/*
+ * Serve the calling thread's lookups from a database, or from the compiled-in tables with NULL
+ * Other threads keep the database they had, so a daemon can hand new
+ * requests a reloaded database while requests in flight finish on the
+ * old one.  Returns FALSE if the thread cannot have a pin.
+ */
+BOOL PinInsightDatabase(struct InsightDatabase *database)
+{
+    if (database == NULL) {
+        database = &compiledTables;
+    }
+
+#ifdef INSIGHT_AMIGA
+    pinnedDatabase = database;
+    return TRUE;
+#else
+    pthread_once(&pinnedOnce, MakePinnedKey);
+    __atomic_store_n(&pinnedEver, TRUE, __ATOMIC_RELAXED);
+    return (BOOL)(pinnedKeyMade && pthread_setspecific(pinnedKey, database) == 0);
+#endif
+}
+
+/*
+ * Go back to the database UseInsightDatabase selected for the calling thread
+ */
+VOID UnpinInsightDatabase(VOID)
+{
+#ifdef INSIGHT_AMIGA
+    pinnedDatabase = NULL;
+#else
+    if (pinnedKeyMade) {
+        pthread_setspecific(pinnedKey, NULL);
+    }
+#endif
+}
+
+#ifndef INSIGHT_AMIGA
+/*
+ * Create the key that holds each thread's pinned database - run once
+ */
+static VOID MakePinnedKey(VOID)
+{
+    pinnedKeyMade = (BOOL)(pthread_key_create(&pinnedKey, NULL) == 0);
+}
+#endif
+
+/*
+ * Check that count items of itemSize bytes at offset lie inside the file
+ */
+static BOOL SectionFits(const struct InsightDatabase *database, ULONG offset, ULONG count, ULONG itemSize)
+{
+    if (offset < IDB_HEADER_MINIMUM || offset > database->size) {
+        return FALSE;
+    }
+
+    return (BOOL)(count <= (database->size - offset) / itemSize);
+}
+
+/*
+ * Check the header, checksum and sections and set up the section pointers
+ * Everything a lookup relies on is checked here so lookups need no
+ * checks beyond the entry's own string offsets.  Returns IDB_OK or the
+ * IDB_ERROR_xxx reason.
+ */
+static ULONG ValidateDatabase(struct InsightDatabase *database, ULONG flags)
+{
+    static const UBYTE zeroChecksum[4] = { 0, 0, 0, 0 };
+    struct SearchIndex search;
+    struct NameIndex names;
+    const UBYTE *data;
+    ULONG field[IDB_FIELD_COUNT];
+    ULONG alertWords;
+    ULONG previous;
+    ULONG bucket;
+    ULONG value;
+    ULONG crc;
+    ULONG i;
+
+    data = database->data;
+    if (database->size < IDB_HEADER_MINIMUM) {
+        return IDB_ERROR_FORMAT;
+    }
+    /* Fields beyond an older, shorter header read as 0 */
+    for (i = 0; i < IDB_FIELD_COUNT; i++) {
+        field[i] = 0;
+        if (i < IDB_HEADER_MINIMUM / 4 ||
+            (i * 4 < field[IDB_FIELD_HEADER_SIZE] && i * 4 + 4 <= database->size)) {
+            field[i] = IdbGetLong(data + i * 4);
+        }
+    }
+
+    if (field[IDB_FIELD_MAGIC] != IDB_MAGIC) {
+        return IDB_ERROR_FORMAT;
+    }
+    if ((field[IDB_FIELD_VERSION] >> 16) != IDB_VERSION_MAJOR) {
+        return IDB_ERROR_VERSION;
+    }
+    if (field[IDB_FIELD_HEADER_SIZE] < IDB_HEADER_MINIMUM || field[IDB_FIELD_HEADER_SIZE] > database->size ||
+        field[IDB_FIELD_FILE_SIZE] != database->size) {
+        return IDB_ERROR_CORRUPT;
+    }
+
+    if ((flags & IDB_SKIP_CHECKSUM) == 0) {
+        crc = IdbChecksum(0, data, IDB_FIELD_CHECKSUM * 4);
+        crc = IdbChecksum(crc, zeroChecksum, 4);
+        crc = IdbChecksum(crc, data + (IDB_FIELD_CHECKSUM + 1) * 4, database->size - (IDB_FIELD_CHECKSUM + 1) * 4);
+        if (crc != field[IDB_FIELD_CHECKSUM]) {
+            return IDB_ERROR_CHECKSUM;
+        }
+    }
+
+    database->version = field[IDB_FIELD_VERSION];
+    database->checksum = field[IDB_FIELD_CHECKSUM];
+    database->entryCount = field[IDB_FIELD_ENTRY_COUNT];
+    database->tokenCount = field[IDB_FIELD_TOKEN_COUNT];
+    database->classEntryCount = field[IDB_FIELD_CLASS_ENTRIES];
+    database->poolSize = field[IDB_FIELD_POOL_SIZE];
+    alertWords = 3 * ALERT_SUBSYSTEMS + database->classEntryCount;
+
+    /* Entry indexes must fit the UWORD alert index next to ALERT_NO_ENTRY */
+    if (database->entryCount >= ALERT_NO_ENTRY || database->tokenCount > TOKEN_MAX_COUNT ||
+        database->classEntryCount > ALERT_SUBSYSTEMS * 256 || database->poolSize == 0 ||
+        !SectionFits(database, field[IDB_FIELD_CODES], database->entryCount, 4) ||
+        !SectionFits(database, field[IDB_FIELD_BUCKETS], IDB_BUCKETS + 1, 4) ||
+        !SectionFits(database, field[IDB_FIELD_ENTRIES], database->entryCount, IDB_ENTRY_SIZE) ||
+        !SectionFits(database, field[IDB_FIELD_TOKENS], database->tokenCount, IDB_TOKEN_SIZE) ||
+        !SectionFits(database, field[IDB_FIELD_ALERT_INDEX], alertWords, 2) ||
+        !SectionFits(database, field[IDB_FIELD_POOL], database->poolSize, 1)) {
+        return IDB_ERROR_CORRUPT;
+    }
+
+    database->codes = data + field[IDB_FIELD_CODES];
+    database->buckets = data + field[IDB_FIELD_BUCKETS];
+    database->entries = data + field[IDB_FIELD_ENTRIES];
+    database->alertIndex = data + field[IDB_FIELD_ALERT_INDEX];
+    database->pool = (const char *)data + field[IDB_FIELD_POOL];
+
+    /* Every string ends inside the pool */
+    if (database->pool[database->poolSize - 1] != '\0') {
+        return IDB_ERROR_CORRUPT;
+    }
+
+    /* Buckets must partition the entries in order */
+    previous = 0;
+    for (i = 0; i <= IDB_BUCKETS; i++) {
+        value = IdbGetLong(database->buckets + i * 4);
+        if (value < previous || value > database->entryCount) {
+            return IDB_ERROR_CORRUPT;
+        }
+        previous = value;
+    }
+    if (IdbGetLong(database->buckets) != 0 || previous != database->entryCount) {
+        return IDB_ERROR_CORRUPT;
+    }
+
+    /* Codes must ascend and sit in their top byte's bucket, or lookups miss them */
+    bucket = 0;
+    for (i = 0; i < database->entryCount; i++) {
+        value = IdbGetLong(database->codes + i * 4);
+        if (i > 0 && value <= IdbGetLong(database->codes + (i - 1) * 4)) {
+            return IDB_ERROR_CORRUPT;
+        }
+        while (i >= IdbGetLong(database->buckets + (bucket + 1) * 4)) {
+            bucket++;
+        }
+        if ((value >> 24) != bucket) {
+            return IDB_ERROR_CORRUPT;
+        }
+    }
+
+    /* Class runs stay inside the class entries; all indexes name entries */
+    for (i = 0; i < ALERT_SUBSYSTEMS; i++) {
+        if ((ULONG)IdbAlertIndex(database, IDB_ALERT_CLASS_BASE, i) +
+            IdbAlertIndex(database, IDB_ALERT_CLASS_COUNT, i) > database->classEntryCount) {
+            return IDB_ERROR_CORRUPT;
+        }
+        value = IdbAlertIndex(database, IDB_ALERT_SUBSYSTEM_ENTRY, i);
+        if (value != ALERT_NO_ENTRY && value >= database->entryCount) {
+            return IDB_ERROR_CORRUPT;
+        }
+    }
+    for (i = 0; i < database->classEntryCount; i++) {
+        value = IdbAlertIndex(database, IDB_ALERT_CLASS_ENTRY, i);
+        if (value != ALERT_NO_ENTRY && value >= database->entryCount) {
+            return IDB_ERROR_CORRUPT;
+        }
+    }
+
+    /* The search index is optional, but checked in full when present */
+    if (field[IDB_FIELD_SEARCH_INDEX] != 0) {
+        if (!SectionFits(database, field[IDB_FIELD_SEARCH_INDEX], SEARCH_HEADER_SIZE, 1)) {
+            return IDB_ERROR_CORRUPT;
+        }
+        value = IdbGetLong(data + field[IDB_FIELD_SEARCH_INDEX]);
+        if (!SectionFits(database, field[IDB_FIELD_SEARCH_INDEX], value, 1) ||
+            !OpenSearchIndex(&search, data + field[IDB_FIELD_SEARCH_INDEX], value) ||
+            !CheckSearchIndex(&search, database->entryCount)) {
+            return IDB_ERROR_CORRUPT;
+        }
+        database->searchIndex = data + field[IDB_FIELD_SEARCH_INDEX];
+        database->searchIndexSize = value;
+    }
+
+    /* So is the name index, which is checked against the descriptions */
+    if (field[IDB_FIELD_NAME_INDEX] != 0) {
+        if (!SectionFits(database, field[IDB_FIELD_NAME_INDEX], NAME_HEADER_SIZE, 1)) {
+            return IDB_ERROR_CORRUPT;
+        }
+        value = IdbGetLong(data + field[IDB_FIELD_NAME_INDEX]);
+        if (!SectionFits(database, field[IDB_FIELD_NAME_INDEX], value, 1) ||
+            !OpenNameIndex(&names, data + field[IDB_FIELD_NAME_INDEX], value, database) ||
+            !CheckNameIndex(&names)) {
+            return IDB_ERROR_CORRUPT;
+        }
+        database->nameIndex = data + field[IDB_FIELD_NAME_INDEX];
+        database->nameIndexSize = value;
+    }
+
+    return IDB_OK;
+}
+
+/*
+ * Build the token dictionary used by ExpandExplanationInto
+ * The values stay in the pool; each must be terminated right after its length.
+ */
+static ULONG BuildTokens(struct InsightDatabase *database)
+{
+    const UBYTE *token;
+    ULONG offset;
+    ULONG length;
+    ULONG i;
+
+    database->tokens = (struct TokenInfo *)malloc((database->tokenCount + 1) * sizeof(struct TokenInfo));
+    if (database->tokens == NULL) {
+        return IDB_ERROR_MEMORY;
+    }
+
+    for (i = 0; i < database->tokenCount; i++) {
+        token = database->data + IdbGetLong(database->data + IDB_FIELD_TOKENS * 4) + i * IDB_TOKEN_SIZE;
+        offset = IdbGetLong(token);
+        length = IdbGetLong(token + 4);
+        if (offset >= database->poolSize || length >= database->poolSize - offset || length > 0xFFFF ||
+            database->pool[offset + length] != '\0') {
+            return IDB_ERROR_CORRUPT;
+        }
+        database->tokens[i].value = database->pool + offset;
+        database->tokens[i].length = (UWORD)length;
+    }
+    database->tokens[database->tokenCount].value = NULL;
+    database->tokens[database->tokenCount].length = 0;
+
+    return IDB_OK;
+}
+
+#ifdef INSIGHT_AMIGA
+
+/*
+ * Read a whole file into one AllocVec block
+ * Files are always read, so IDB_PRIVATE_COPY changes nothing here.
+ */
+static ULONG LoadFile(CONST_STRPTR path, ULONG flags, UBYTE **data, ULONG *size, ULONG *storage)
+{
+    BPTR file;
+    LONG end;
+    ULONG failure;
+
+    file = Open((STRPTR)path, MODE_OLDFILE);
+    if (file == 0) {
+        return IDB_ERROR_OPEN;
+    }
+
+    failure = IDB_OK;
+    Seek(file, 0, OFFSET_END);
+    end = Seek(file, 0, OFFSET_BEGINNING);
+    if (end < 0) {
+        failure = IDB_ERROR_OPEN;
+    } else if (end < IDB_HEADER_MINIMUM) {
+        failure = IDB_ERROR_FORMAT;
+    } else {
+        *size = (ULONG)end;
+        *data = (UBYTE *)AllocVec(*size, MEMF_ANY);
+        if (*data == NULL) {
+            failure = IDB_ERROR_MEMORY;
+        } else if (Read(file, *data, end) != end) {
+            FreeVec(*data);
+            failure = IDB_ERROR_OPEN;
+        }
+    }
+
+    Close(file);
+    *storage = IDB_STORAGE_ALLOCATED;
+    return failure;
+}
+
+/*
+ * Free a file read by LoadFile
+ */
+static VOID ReleaseFile(UBYTE *data, ULONG size, ULONG storage)
+{
+    FreeVec(data);
+}
+
+#else
+
+/*
+ * Map a whole file read-only, or with IDB_PRIVATE_COPY read it into memory
+ * A mapping shares the file's pages, so a copy is needed by anything that
+ * keeps a database open while the file may be overwritten: touching a
+ * page a truncated file no longer has raises SIGBUS.
+ */
+static ULONG LoadFile(CONST_STRPTR path, ULONG flags, UBYTE **data, ULONG *size, ULONG *storage)
+{
+    struct stat status;
+    ULONG failure;
+    ULONG done;
+    ssize_t length;
+    int file;
+
+    file = open(path, O_RDONLY);
+    if (file < 0) {
+        return IDB_ERROR_OPEN;
+    }
+
+    failure = IDB_OK;
+    if (fstat(file, &status) != 0) {
+        failure = IDB_ERROR_OPEN;
+    } else if (status.st_size < IDB_HEADER_MINIMUM || (unsigned long long)status.st_size > 0xFFFFFFFFULL) {
+        failure = IDB_ERROR_FORMAT;
+    } else {
+        *size = (ULONG)status.st_size;
+        if ((flags & IDB_PRIVATE_COPY) == 0) {
+            *storage = IDB_STORAGE_MAPPED;
+            *data = (UBYTE *)mmap(NULL, *size, PROT_READ, MAP_PRIVATE, file, 0);
+            if (*data == (UBYTE *)MAP_FAILED) {
+                failure = IDB_ERROR_OPEN;
+            }
+        } else {
+            *storage = IDB_STORAGE_ALLOCATED;
+            *data = (UBYTE *)malloc(*size);
+            if (*data == NULL) {
+                failure = IDB_ERROR_MEMORY;
+            }
+            done = 0;
+            while (failure == IDB_OK && done < *size) {
+                length = read(file, *data + done, *size - done);
+                if (length > 0) {
+                    done += (ULONG)length;
+                } else if (length == 0 || errno != EINTR) {
+                    /* The file was cut short since fstat */
+                    free(*data);
+                    failure = IDB_ERROR_OPEN;
+                }
+            }
+        }
+    }
+
+    close(file);
+    return failure;
+}
+
+/*
+ * Unmap or free a file loaded by LoadFile
+ */
+static VOID ReleaseFile(UBYTE *data, ULONG size, ULONG storage)
+{
+    if (storage == IDB_STORAGE_MAPPED) {
+        munmap(data, size);
+    } else {
+        free(data);
+    }
+}
+
+#endif
@@ -0,0 +1,150 @@
+/*
+ * Insight Database Files
+ *
+ * An .idb file is the error database in a form Insight can use straight
+ * from the file's bytes: the sorted codes, a bucket index over them, the
+ * entries, the alert range index used by DecodeAlertInto, the token
+ * dictionary and one string pool.  genidb writes it at build time from the
+ * same generated tables that are compiled in, so a database update can be
+ * shipped without a new binary.  All fields are big-endian ULONGs or
+ * UWORDs at offsets given in the header; the CRC-32 covers the whole file
+ * with the checksum field read as zero.
+ *
+ * After meditiation comes... Insight
+ *
+ * Copyright (c) 2025-26 amigazen project
+ * Licensed under BSD 2-Clause License
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef IDB_H
+#define IDB_H
+
+#include "platform.h"
+#include "error_codes.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* File identification - "INDB" */
+#define IDB_MAGIC          0x494E4442UL
+#define IDB_VERSION_MAJOR  1      /* Readers reject other major versions */
+#define IDB_VERSION_MINOR  2      /* Newer minor versions only append fields */
+#define IDB_HEADER_SIZE    68     /* As written - fields past the file's header size read as 0 */
+#define IDB_HEADER_MINIMUM 64     /* Header of 1.0 and 1.1 files */
+
+/* Header fields, as ULONG positions from the start of the file */
+#define IDB_FIELD_MAGIC          0
+#define IDB_FIELD_VERSION        1   /* major << 16 | minor */
+#define IDB_FIELD_HEADER_SIZE    2
+#define IDB_FIELD_FILE_SIZE      3
+#define IDB_FIELD_CHECKSUM       4
+#define IDB_FIELD_ENTRY_COUNT    5
+#define IDB_FIELD_TOKEN_COUNT    6
+#define IDB_FIELD_CODES          7   /* ULONG code per entry, ascending */
+#define IDB_FIELD_BUCKETS        8   /* ULONG first entry per top code byte, then entry count */
+#define IDB_FIELD_ENTRIES        9   /* Description offset, insight offset, insight length */
+#define IDB_FIELD_TOKENS        10   /* Value offset and length per token */
+#define IDB_FIELD_ALERT_INDEX   11   /* UWORD subsystem entry, class base, class count, class entries */
+#define IDB_FIELD_CLASS_ENTRIES 12   /* Number of class entries */
+#define IDB_FIELD_POOL          13   /* NUL-terminated strings */
+#define IDB_FIELD_POOL_SIZE     14
+#define IDB_FIELD_SEARCH_INDEX  15   /* SEARCH index image, 0 if none (added in 1.1) */
+#define IDB_FIELD_NAME_INDEX    16   /* NAME index image, 0 if none (added in 1.2) */
+#define IDB_FIELD_COUNT         17
+
+#define IDB_BUCKETS     256   /* Codes are bucketed by their top byte */
+#define IDB_ENTRY_SIZE  12
+#define IDB_TOKEN_SIZE  8
+
+/* Tables in the alert range index, laid out in this order */
+#define IDB_ALERT_SUBSYSTEM_ENTRY 0   /* alertSubsystemEntry */
+#define IDB_ALERT_CLASS_BASE      1   /* alertClassBase */
+#define IDB_ALERT_CLASS_COUNT     2   /* alertClassCount */
+#define IDB_ALERT_CLASS_ENTRY     3   /* alertClassEntry */
+
+/* OpenInsightDatabase flags */
+#define IDB_SKIP_CHECKSUM 0x0001      /* Trust the file - header and bounds are still checked */
+#define IDB_PRIVATE_COPY  0x0002      /* Read the file instead of mapping it, so it can be overwritten while open */
+
+/* Why a database could not be opened */
+#define IDB_OK             0
+#define IDB_ERROR_OPEN     1   /* File could not be opened or read */
+#define IDB_ERROR_MEMORY   2
+#define IDB_ERROR_FORMAT   3   /* Not an .idb file */
+#define IDB_ERROR_VERSION  4   /* Incompatible major version */
+#define IDB_ERROR_CHECKSUM 5
+#define IDB_ERROR_CORRUPT  6   /* A section is out of bounds or inconsistent */
+
+/* How an open database holds the file's bytes */
+#define IDB_STORAGE_BORROWED  0   /* Caller's memory */
+#define IDB_STORAGE_MAPPED    1   /* mmap */
+#define IDB_STORAGE_ALLOCATED 2   /* Read into an allocation */
+
+/* An open database - all section pointers point into data */
+struct InsightDatabase {
+    const UBYTE *data;
+    ULONG size;
+    ULONG storage;
+    ULONG version;
+    ULONG checksum;               /* As stored in the header, checked or not */
+    ULONG entryCount;
+    ULONG tokenCount;
+    ULONG classEntryCount;
+    const UBYTE *codes;
+    const UBYTE *buckets;
+    const UBYTE *entries;
+    const UBYTE *alertIndex;
+    const char *pool;
+    ULONG poolSize;
+    struct TokenInfo *tokens;     /* Dictionary, pointing into the pool */
+    const UBYTE *searchIndex;     /* NULL if the file has none */
+    ULONG searchIndexSize;
+    const UBYTE *nameIndex;       /* NULL if the file has none */
+    ULONG nameIndexSize;
+};
+
+/* Function declarations */
+struct InsightDatabase *OpenInsightDatabase(CONST_STRPTR path, ULONG flags, ULONG *error);
+struct InsightDatabase *OpenInsightDatabaseMemory(const VOID *data, ULONG size, ULONG flags, ULONG *error);
+VOID CloseInsightDatabase(struct InsightDatabase *database);
+LONG IdbLookup(const struct InsightDatabase *database, ULONG errorCode);
+VOID IdbEntryView(const struct InsightDatabase *database, ULONG index, struct ErrorView *view);
+UWORD IdbAlertIndex(const struct InsightDatabase *database, ULONG table, ULONG slot);
+ULONG IdbChecksum(ULONG crc, const UBYTE *data, ULONG length);
+ULONG IdbGetLong(const UBYTE *data);
+VOID IdbPutLong(UBYTE *data, ULONG value);
+UWORD IdbGetWord(const UBYTE *data);
+CONST_STRPTR IdbErrorText(ULONG error);
+VOID UseInsightDatabase(struct InsightDatabase *database);
+struct InsightDatabase *ActiveInsightDatabase(VOID);
+BOOL PinInsightDatabase(struct InsightDatabase *database);
+VOID UnpinInsightDatabase(VOID);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* IDB_H */
@@ -29,6 +29,7 @@
 
 #include <exec/types.h>
 #include <exec/execbase.h>
+#include <exec/memory.h>
 #include <exec/alerts.h>
 #include <exec/tasks.h>
 #include <dos/dos.h>
@@ -47,30 +48,75 @@
 #include <proto/utility.h>
 #include <proto/graphics.h>
 #include <dos/rdargs.h>
+#include <dos/var.h>
 #include <workbench/startup.h>
 #include <string.h>
 #include <stdlib.h>
 #include <stdio.h>
 #include <time.h>
 #include "error_codes.h"
+#include "hexparse.h"
+#include "lookup.h"
+#include "decompose.h"
+#include "idb.h"
+#include "history.h"
+#include "histquery.h"
+#include "summary.h"
+#include "nearest.h"
+#include "names.h"
+#include "daemon.h"
+#include "phase.h"
+#include "batch.h"
+#include "logscan.h"
+#include "wordwrap.h"
 
 /* External error table reference */
 extern struct ErrorInfo errorTable[];
 extern const ULONG ERROR_TABLE_SIZE;
 
+/* Room in the dialog text for everything but the description, insight and task name */
+#define DIALOG_TEXT_SIZE 96
+
+/* Dialog text used when it cannot be allocated - longer text is cut short */
+#define DIALOG_FALLBACK_SIZE 1024
+
+/* Kept free for the end of the dialog text when the insight is cut short */
+#define DIALOG_TAIL_SIZE 8
+
+/* Glyph widths of a screen's font, kept by whoever wraps text for that screen */
+struct ScreenMetrics {
+    struct GlyphMetrics glyphs;
+    struct TextFont *font;      /* Font the widths belong to, NULL before any are measured */
+};
+
 /* Forward declarations */
 VOID ShowErrorDialog(ULONG errorCode, STRPTR description, STRPTR explanation, ULONG taskID);
 BOOL InitializeLibraries(VOID);
 VOID Cleanup(VOID);
 BOOL InitializeApplication(VOID);
-STRPTR WordWrapText(STRPTR text, ULONG maxWidth, struct Screen *screen);
+ULONG WordWrapTextInto(STRPTR text, ULONG maxWidth, struct Screen *screen, struct ScreenMetrics *metrics,
+                       STRPTR buffer, ULONG bufferSize);
 VOID SafeExit(int status);  /* Safe exit with cleanup */
-ULONG HexStringToULong(STRPTR hexString);  /* Convert hex string to ULONG */
 ULONG ParseLastAlert(ULONG *taskID);  /* Parse LastAlert array and return error code */
-BOOL LooksLikeHexNumber(STRPTR str);  /* Check if string looks like a hex number */
-BOOL ValidateHexErrorCode(STRPTR hexString);  /* Validate that string is exactly 8 hex digits */
 static STRPTR ResolveTaskNameFromAddress(ULONG taskID);
 static VOID FormatTaskIdLabel(char *out, ULONG outSize, ULONG taskID);
+static VOID RecordCrash(ULONG guruCode, ULONG taskID);  /* Append to the crash history */
+static int DecodeBatchFile(STRPTR fromArg, ULONG format);  /* FROM batch mode */
+static int ScanLogFile(STRPTR scanArg, ULONG format, ULONG flags);  /* SCAN log mode */
+static int SummarizeInput(STRPTR fromArg, STRPTR scanArg, ULONG format, ULONG flags, ULONG top);  /* SUMMARY mode */
+static int QueryHistoryFile(STRPTR historyArg, const struct HistoryQuery *query, ULONG format);  /* HISTORY mode */
+static int SearchDatabase(STRPTR searchArg, ULONG format, ULONG top);  /* SEARCH mode */
+static int ListNearestCodes(STRPTR nearArg, ULONG format, ULONG top);  /* NEAR mode */
+static int LookUpName(STRPTR nameArg, ULONG format, ULONG top);  /* NAME mode */
+static int ServeLookups(STRPTR daemonArg, ULONG format);  /* DAEMON mode */
+static int AskDaemon(STRPTR connectArg, STRPTR fromArg, STRPTR codes, ULONG format);  /* CONNECT mode */
+static VOID PrintNearHints(ULONG guruCode);  /* Known codes an unknown one may be a copy of */
+static FILE *OpenInput(STRPTR name);
+static BOOL IsStatsSwitch(STRPTR arg);
+static VOID StartStats(VOID);
+static VOID FinishStats(VOID);
+static ULONG ScreenGlyphWidth(UBYTE glyph, APTR font);
+static ULONG AppendDialogText(STRPTR buffer, ULONG bufferSize, ULONG length, CONST_STRPTR text, ULONG keep);
 
 
 /* Library base pointers */
@@ -85,6 +131,20 @@ struct ClassLibrary *RequesterBase = NULL;
 /* Reaction class handles */
 Class *RequesterClass = NULL;
 
+/* Database file loaded with DATABASE/K - NULL uses the compiled-in tables */
+static struct InsightDatabase *insightDatabase = NULL;
+static char databaseFile[256];             /* Its name, which DAEMON/K reloads */
+
+/* STATS/S phase times - runStats is NULL unless they are being taken */
+static struct PhaseStats phaseStats;
+static struct PhaseStats *runStats = NULL;
+static ULONG statsFormat = BATCH_FORMAT_TSV;
+static BOOL showStats = FALSE;
+
+/* Workbench runs append their times to the file named by this variable */
+#define STATS_VARIABLE "Insight/Stats"
+static char statsFile[256];
+
 static const char *verstag = "$VER: Insight 47.7 (6/4/2026)\n";
 static const char *stack_cookie = "$STACK: 8192\n";
 long oslibversion  = 47L; 
@@ -94,7 +154,9 @@ long oslibversion  = 47L;
 /* Main entry point */
 int main(int argc, char *argv[])
 {
-    struct ErrorInfo *errorInfo;
+    static char insightText[INSIGHT_MAX_LENGTH];  /* Expanded insight - no heap use after a crash */
+    struct ErrorView errorView;
+    struct AlertDecoding alertDecoding;  /* Codes missing from the database are decoded from their fields */
     ULONG guruCode;
     ULONG taskID;
     struct RDArgs *rdargs;
@@ -124,8 +186,16 @@ int main(int argc, char *argv[])
             SafeExit(RETURN_FAIL);
         }
         
+        /* There are no arguments from Workbench - ENV:Insight/Stats asks for phase times */
+        if (GetVar(STATS_VARIABLE, statsFile, sizeof(statsFile), GVF_GLOBAL_ONLY) > 0) {
+            showStats = TRUE;
+            StartStats();
+        }
+        
         /* Parse the LastAlert array to get the complete error code and task ID */
+        BEGIN_PHASE(PHASE_LAST_ALERT);
         guruCode = ParseLastAlert(&taskID);
+        END_PHASE(PHASE_LAST_ALERT, 0);
         
         /* Check if there's actually an error code (not -1) */
         /* According to Amiga documentation, LastAlert[0] = -1 (0xFFFFFFFF) means no error */
@@ -137,25 +207,27 @@ int main(int argc, char *argv[])
             /* No error - LastAlert[0] = 0 means no error exists */
             SafeExit(RETURN_OK);
         } else {
+            /* Keep the alert before anything else can fail - the requester is not a record */
+            RecordCrash(guruCode, taskID);
+            
             /* Error exists - parse the error code and show requester */
+            BEGIN_PHASE(PHASE_LIBRARIES);
             if (!InitializeLibraries()) {
                 SafeExit(RETURN_FAIL);
             }
+            END_PHASE(PHASE_LIBRARIES, 0);
+            BEGIN_PHASE(PHASE_APPLICATION);
             if (!InitializeApplication()) {
                 Cleanup();
                 SafeExit(RETURN_FAIL);
             }
+            END_PHASE(PHASE_APPLICATION, 0);
             
             /* Parse the error code to get description and explanation */
-            errorInfo = GainInsight(guruCode);
-            if (errorInfo != NULL) {
-                /* Found error in database - show with proper description */
-                ShowErrorDialog(guruCode, errorInfo->description, errorInfo->insight, taskID);
-                FreeErrorInfo(errorInfo);  /* Free allocated memory */
-            } else {
-                /* Error code not in database - show generic error dialog */
-                ShowErrorDialog(guruCode, "Unknown Error", "This error is not recognized.", taskID);
-            }
+            /* The memory list may be corrupt after a reboot, so nothing is allocated here */
+            /* Codes not in the database get an explanation built from the alert fields */
+            DecodeAlertInto(guruCode, &alertDecoding, insightText, sizeof(insightText));
+            ShowErrorDialog(guruCode, (STRPTR)alertDecoding.description, insightText, taskID);
             
             Cleanup();
             
@@ -163,11 +235,41 @@ int main(int argc, char *argv[])
         }
     } else {
         /* Command line mode: parse arguments and handle accordingly */
-        STRPTR args[2] = {NULL, NULL};  /* ERROR/K, GURU/S */
+        /* ERROR/K, GURU/S, FROM/K, FORMAT/K, SCAN/K, STRICT/S, DATABASE/K, HISTORY/K, SINCE/K, UNTIL/K, CODE/K, DEADEND/S,
+           SUMMARY/S, TOP/N, STATS/S, SEARCH/K, NEAR/K, NAME/K, DAEMON/K, CONNECT/K */
+        STRPTR args[20] = {NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL,
+                           NULL, NULL, NULL, NULL};
         STRPTR errorArg = NULL;
+        STRPTR fromArg = NULL;
+        STRPTR scanArg = NULL;
+        STRPTR historyArg = NULL;
+        STRPTR searchArg = NULL;
+        STRPTR nearArg = NULL;
+        STRPTR nameArg = NULL;
+        STRPTR daemonArg = NULL;
+        STRPTR connectArg = NULL;
+        struct HistoryQuery historyQuery;
+        ULONG codeValue;
+        ULONG codeMask;
+        BOOL summarize = FALSE;
+        ULONG summaryTop = SUMMARY_TOP_DEFAULT;
+        ULONG searchTop = SEARCH_TOP_DEFAULT;
+        ULONG nearTop = NEAR_TOP_DEFAULT;
+        ULONG nameTop = NAME_TOP_DEFAULT;
+        ULONG scanFlags = 0;
+        LONG batchFormat = BATCH_FORMAT_TSV;
         int i;  /* C89 compliance - declare at start of block */
         int j;  /* C89 compliance - for implicit hex check */
         
+        /* Argument parsing is itself a phase, so STATS is looked for before ReadArgs */
+        for (j = 1; j < argc; j++) {
+            if (IsStatsSwitch(argv[j])) {
+                StartStats();
+                break;
+            }
+        }
+        BEGIN_PHASE(PHASE_ARGUMENTS);
+        
         /* First, check for implicit hex numbers before ReadArgs processing */
         /* This handles cases like "insight 8000000B" where no ERROR keyword is used */
         for (j = 1; j < argc; j++) {
@@ -189,12 +291,147 @@ int main(int argc, char *argv[])
         }
         
         /* Parse command line arguments */
+        InitHistoryQuery(&historyQuery);
         
-        rdargs = ReadArgs("ERROR/K,GURU/S", (LONG *)args, NULL);
+        rdargs = ReadArgs("ERROR/K,GURU/S,FROM/K,FORMAT/K,SCAN/K,STRICT/S,DATABASE/K,HISTORY/K,SINCE/K,UNTIL/K,CODE/K,DEADEND/S,"
+                          "SUMMARY/S,TOP/N,STATS/S,SEARCH/K,NEAR/K,NAME/K,DAEMON/K,CONNECT/K",
+                          (LONG *)args, NULL);
         if (rdargs != NULL) {
             /* Set flags */
             testMode = (args[1] != NULL);      /* GURU/S is a switch */
             
+            /* FROM/K switches to batch mode - copy the file name before FreeArgs */
+            if (args[2] != NULL) {
+                static char fromBuffer[256];
+                
+                strncpy(fromBuffer, args[2], sizeof(fromBuffer) - 1);
+                fromBuffer[sizeof(fromBuffer) - 1] = '\0';
+                fromArg = fromBuffer;
+            }
+            
+            /* SCAN/K switches to log scanning - copy the file name before FreeArgs */
+            if (args[4] != NULL) {
+                static char scanBuffer[256];
+                
+                strncpy(scanBuffer, args[4], sizeof(scanBuffer) - 1);
+                scanBuffer[sizeof(scanBuffer) - 1] = '\0';
+                scanArg = scanBuffer;
+            }
+            if (args[5] != NULL) {
+                scanFlags |= SCAN_STRICT;
+            }
+            if (args[3] != NULL) {
+                batchFormat = FindBatchFormat(args[3]);
+                if (batchFormat < 0) {
+                    Printf("Error: Unknown output format. Use TSV or JSON.\n");
+                    FreeArgs(rdargs);
+                    SafeExit(RETURN_FAIL);
+                }
+            }
+            
+            /* DATABASE/K replaces the compiled-in tables for this run only */
+            /* The Workbench crash path never loads a file, so it stays allocation-free */
+            if (args[6] != NULL) {
+                ULONG databaseError;
+                
+                insightDatabase = OpenInsightDatabase(args[6], 0, &databaseError);
+                if (insightDatabase == NULL) {
+                    Printf("Error: Cannot load database %s: %s\n", args[6], IdbErrorText(databaseError));
+                    FreeArgs(rdargs);
+                    SafeExit(RETURN_FAIL);
+                }
+                UseInsightDatabase(insightDatabase);
+                strncpy(databaseFile, args[6], sizeof(databaseFile) - 1);
+                databaseFile[sizeof(databaseFile) - 1] = '\0';
+            }
+            
+            /* HISTORY/K queries the crash history - the filters are parsed before FreeArgs */
+            if (args[7] != NULL) {
+                static char historyBuffer[256];
+                
+                strncpy(historyBuffer, args[7], sizeof(historyBuffer) - 1);
+                historyBuffer[sizeof(historyBuffer) - 1] = '\0';
+                historyArg = historyBuffer;
+            }
+            if ((args[8] != NULL && !ParseHistoryTime(args[8], CrashTimestampNow(), FALSE, &historyQuery.since)) ||
+                (args[9] != NULL && !ParseHistoryTime(args[9], CrashTimestampNow(), TRUE, &historyQuery.until))) {
+                Printf("Error: Use NOW, -<n>S/M/H/D/W or YYYY-MM-DD [HH:MM[:SS]] for SINCE and UNTIL.\n");
+                FreeArgs(rdargs);
+                SafeExit(RETURN_FAIL);
+            }
+            if (args[10] != NULL && !ParseHistoryCodePattern(args[10], &codeValue, &codeMask)) {
+                Printf("Error: CODE must be up to 8 hex digits, x for any digit - e.g. 81xxxxxx.\n");
+                FreeArgs(rdargs);
+                SafeExit(RETURN_FAIL);
+            }
+            if ((args[10] != NULL && !RestrictHistoryCodes(&historyQuery, codeValue, codeMask)) ||
+                (args[11] != NULL && !RestrictHistoryCodes(&historyQuery, ALERT_DEADEND, ALERT_DEADEND))) {
+                Printf("Error: CODE and DEADEND can never both match.\n");
+                FreeArgs(rdargs);
+                SafeExit(RETURN_FAIL);
+            }
+            
+            /* SUMMARY/S reports counts instead of records; TOP/N is how many codes it lists */
+            summarize = (args[12] != NULL);
+            if (args[13] != NULL) {
+                if (*(LONG *)args[13] < 0 || *(LONG *)args[13] > SUMMARY_SLOTS) {
+                    Printf("Error: TOP must be a number of codes from 0 to %ld.\n", (LONG)SUMMARY_SLOTS);
+                    FreeArgs(rdargs);
+                    SafeExit(RETURN_FAIL);
+                }
+                summaryTop = (ULONG)*(LONG *)args[13];
+                searchTop = summaryTop;
+                nearTop = summaryTop;
+                nameTop = summaryTop;
+            }
+            
+            /* SEARCH/K lists the entries whose text best matches its words */
+            if (args[15] != NULL) {
+                static char searchBuffer[256];
+                
+                strncpy(searchBuffer, args[15], sizeof(searchBuffer) - 1);
+                searchBuffer[sizeof(searchBuffer) - 1] = '\0';
+                searchArg = searchBuffer;
+            }
+            
+            /* NEAR/K lists the known codes closest to a mistyped or corrupt one */
+            if (args[16] != NULL) {
+                static char nearBuffer[32];
+                
+                strncpy(nearBuffer, args[16], sizeof(nearBuffer) - 1);
+                nearBuffer[sizeof(nearBuffer) - 1] = '\0';
+                nearArg = nearBuffer;
+            }
+            
+            /* NAME/K looks codes up by a word of their name, as it is typed */
+            if (args[17] != NULL) {
+                static char nameBuffer[128];
+                
+                strncpy(nameBuffer, args[17], sizeof(nameBuffer) - 1);
+                nameBuffer[sizeof(nameBuffer) - 1] = '\0';
+                nameArg = nameBuffer;
+            }
+            
+            /* DAEMON/K serves lookups at a public port, CONNECT/K has the daemon there decode */
+            if (args[18] != NULL) {
+                static char daemonBuffer[64];
+                
+                strncpy(daemonBuffer, args[18], sizeof(daemonBuffer) - 1);
+                daemonBuffer[sizeof(daemonBuffer) - 1] = '\0';
+                daemonArg = daemonBuffer;
+            }
+            if (args[19] != NULL) {
+                static char connectBuffer[64];
+                
+                strncpy(connectBuffer, args[19], sizeof(connectBuffer) - 1);
+                connectBuffer[sizeof(connectBuffer) - 1] = '\0';
+                connectArg = connectBuffer;
+            }
+            
+            /* STATS/S prints the phase times at exit, in the FORMAT of the records */
+            showStats = (args[14] != NULL);
+            statsFormat = (ULONG)batchFormat;
+            
             /* Copy the string content before freeing the args */
             /* Only use ReadArgs result if we didn't already find an implicit hex number */
             if (args[0] != NULL && errorArg == NULL) {
@@ -234,6 +471,8 @@ int main(int argc, char *argv[])
                 } else if (argv[i][0] == 'G' && argv[i][1] == 'U' && argv[i][2] == 'R' && 
                            argv[i][3] == 'U' && argv[i][4] == '\0') {
                     testMode = TRUE;
+                } else if (IsStatsSwitch(argv[i])) {
+                    showStats = TRUE;
                 } else if (errorArg == NULL && LooksLikeHexNumber(argv[i])) {
                     /* Implicit ERROR: if argument looks like a hex number, treat it as error code */
                     /* Copy to buffer to avoid issues with string pointers */
@@ -278,8 +517,48 @@ int main(int argc, char *argv[])
             }
         }
         
+        END_PHASE(PHASE_ARGUMENTS, (ULONG)(argc - 1));
+        
+        /* Batch input is timed as one phase, not code by code - see the batch functions */
+        UsePhaseStats(NULL);
+        
+        /* Batch mode needs no GUI libraries - decode the stream and exit */
+        if (daemonArg != NULL) {
+            SafeExit(ServeLookups(daemonArg, (ULONG)batchFormat));
+        }
+        if (connectArg != NULL) {
+            SafeExit(AskDaemon(connectArg, fromArg, errorArg, (ULONG)batchFormat));
+        }
+        if (summarize) {
+            if (fromArg == NULL && scanArg == NULL) {
+                Printf("Error: SUMMARY needs FROM or SCAN.\n");
+                SafeExit(RETURN_FAIL);
+            }
+            SafeExit(SummarizeInput(fromArg, scanArg, (ULONG)batchFormat, scanFlags, summaryTop));
+        }
+        if (fromArg != NULL) {
+            SafeExit(DecodeBatchFile(fromArg, (ULONG)batchFormat));
+        }
+        if (scanArg != NULL) {
+            SafeExit(ScanLogFile(scanArg, (ULONG)batchFormat, scanFlags));
+        }
+        if (historyArg != NULL) {
+            SafeExit(QueryHistoryFile(historyArg, &historyQuery, (ULONG)batchFormat));
+        }
+        if (searchArg != NULL) {
+            SafeExit(SearchDatabase(searchArg, (ULONG)batchFormat, searchTop));
+        }
+        if (nearArg != NULL) {
+            SafeExit(ListNearestCodes(nearArg, (ULONG)batchFormat, nearTop));
+        }
+        if (nameArg != NULL) {
+            SafeExit(LookUpName(nameArg, (ULONG)batchFormat, nameTop));
+        }
+        
+        UsePhaseStats(runStats);
+        
         /* If we have arguments but ReadArgs failed and we didn't find any valid parameters, exit */
-        if (argc > 1 && errorArg == NULL && !testMode) {
+        if (argc > 1 && errorArg == NULL && !testMode && !showStats) {
             SafeExit(RETURN_OK);
         }
         
@@ -289,60 +568,51 @@ int main(int argc, char *argv[])
         }
         
         /* Initialize libraries */
+        BEGIN_PHASE(PHASE_LIBRARIES);
         if (!InitializeLibraries()) {
             SafeExit(RETURN_FAIL);
         }
+        END_PHASE(PHASE_LIBRARIES, 0);
         
         /* Initialize application */
+        BEGIN_PHASE(PHASE_APPLICATION);
         if (!InitializeApplication()) {
             Cleanup();
             SafeExit(RETURN_FAIL);
         }
+        END_PHASE(PHASE_APPLICATION, 0);
         
         /* Determine what to do based on parameters */
         if (errorArg != NULL) {
             /* ERROR parameter specified - parse and show specific error */
-            /* First validate that it's exactly 8 hex digits */
-            if (!ValidateHexErrorCode(errorArg)) {
+            /* Validate and convert in one pass - exactly 8 hex digits */
+            if (ParseHexCode(errorArg, &guruCode) != HEX_OK) {
                 Printf("Error: Invalid error code format. Error code must be exactly 8 hexadecimal digits.\n");
                 Printf("Example: 8000000B or 0x8000000B\n");
                 success = FALSE;
             } else {
-                guruCode = HexStringToULong(errorArg);
-                
-                /* Check if parsing was successful - HexStringToULong returns (ULONG)-1 for invalid input */
-                if (guruCode != (ULONG)-1) {
-                    errorInfo = GainInsight(guruCode);
-                    if (errorInfo != NULL) {
-                        if (testMode) {
-                            ShowErrorDialog(guruCode, errorInfo->description, errorInfo->insight, 0);
-                        }
-                        /* Always show error information when ERROR parameter is specified */
-                        Printf("Error Code: 0x%08lX\nError: %s\n%s\n", 
-                               guruCode, errorInfo->description, errorInfo->insight);
-                        success = TRUE;  /* Successfully parsed and displayed error */
-                        FreeErrorInfo(errorInfo);  /* Free allocated memory */
-                    } else {
-                        Printf("Unknown error code: 0x%08lX\n", guruCode);
-                        success = FALSE;  /* Error code not found */
-                    }
-                } else {
-                    Printf("Error: Failed to parse error code. Use format: 8000000B or 0x8000000B\n");
-                    success = FALSE;  /* Invalid format */
+                /* Codes not in the database are decoded from the alert fields */
+                DecodeAlertInto(guruCode, &alertDecoding, insightText, sizeof(insightText));
+                if (testMode) {
+                    ShowErrorDialog(guruCode, (STRPTR)alertDecoding.description, insightText, 0);
                 }
+                /* Always show error information when ERROR parameter is specified */
+                Printf("Error Code: 0x%08lX\nError: %s\n%s\n", 
+                       guruCode, alertDecoding.description, insightText);
+                if (alertDecoding.match != ALERT_MATCH_EXACT) {
+                    PrintNearHints(guruCode);
+                }
+                success = TRUE;  /* Successfully parsed and displayed error */
             }
         } else if (testMode) {
             /* GURU parameter - show random error */
             ULONG randomIndex = (ULONG)rand() % ERROR_TABLE_SIZE;
             guruCode = errorTable[randomIndex].code;
             
-            /* Use GainInsight to get expanded explanation with token expansion */
-            errorInfo = GainInsight(guruCode);
-            if (errorInfo != NULL) {
-                ShowErrorDialog(guruCode, errorInfo->description, errorInfo->insight, 0);
+            /* Use GainInsightInto to get expanded explanation with token expansion */
+            if (GainInsightInto(guruCode, &errorView, insightText, sizeof(insightText)) != LOOKUP_NOT_FOUND) {
+                ShowErrorDialog(guruCode, (STRPTR)errorView.description, insightText, 0);
                 success = TRUE;  /* Successfully showed random error */
-                
-                FreeErrorInfo(errorInfo);  /* Free allocated memory */
             } else {
                 Printf("Failed to lookup error code 0x%08lX\n", guruCode);
                 success = FALSE;
@@ -351,7 +621,9 @@ int main(int argc, char *argv[])
             /* No special parameters - check SysBase LastAlert */
             /* LastAlert[4] is an array containing the last 4 system alert codes */
             /* The 4 LONG values together form the complete error code */
+            BEGIN_PHASE(PHASE_LAST_ALERT);
             guruCode = ParseLastAlert(&taskID);
+            END_PHASE(PHASE_LAST_ALERT, 0);
             
             /* Check if there's actually an error code (not -1) */
             /* According to Amiga documentation, LastAlert[0] = -1 (0xFFFFFFFF) means no error */
@@ -360,26 +632,15 @@ int main(int argc, char *argv[])
                 success = TRUE;  /* Successfully determined no error exists */
             } else {
                 /* Error exists - parse the error code and print to console */
-                errorInfo = GainInsight(guruCode);
-                if (errorInfo != NULL) {
-                    resolvedTaskName = ResolveTaskNameFromAddress(taskID);
-                    if (resolvedTaskName != NULL && resolvedTaskName[0] != '\0') {
-                        Printf("Error Code: 0x%08lX\n\nTask ID: 0x%08lX (%s)\n\nError: %s\n\n%s\n",
-                               guruCode, taskID, resolvedTaskName, errorInfo->description, errorInfo->insight);
-                    } else {
-                        Printf("Error Code: 0x%08lX\n\nTask ID: 0x%08lX\n\nError: %s\n\n%s\n",
-                               guruCode, taskID, errorInfo->description, errorInfo->insight);
-                    }
-                    FreeErrorInfo(errorInfo);  /* Free allocated memory */
+                /* Codes not in the database are decoded from the alert fields */
+                DecodeAlertInto(guruCode, &alertDecoding, insightText, sizeof(insightText));
+                resolvedTaskName = ResolveTaskNameFromAddress(taskID);
+                if (resolvedTaskName != NULL && resolvedTaskName[0] != '\0') {
+                    Printf("Error Code: 0x%08lX\n\nTask ID: 0x%08lX (%s)\n\nError: %s\n\n%s\n",
+                           guruCode, taskID, resolvedTaskName, alertDecoding.description, insightText);
                 } else {
-                    resolvedTaskName = ResolveTaskNameFromAddress(taskID);
-                    if (resolvedTaskName != NULL && resolvedTaskName[0] != '\0') {
-                        Printf("Error Code: 0x%08lX\n\nTask ID: 0x%08lX (%s)\n\nError: Unknown Error\n\nNo Insight for this error code.\n",
-                               guruCode, taskID, resolvedTaskName);
-                    } else {
-                        Printf("Error Code: 0x%08lX\n\nTask ID: 0x%08lX\n\nError: Unknown Error\n\nNo Insight for this error code.\n",
-                               guruCode, taskID);
-                    }
+                    Printf("Error Code: 0x%08lX\n\nTask ID: 0x%08lX\n\nError: %s\n\n%s\n",
+                           guruCode, taskID, alertDecoding.description, insightText);
                 }
                 success = FALSE;  /* Exit with failure status since there was an error */
             }
@@ -394,78 +655,451 @@ int main(int argc, char *argv[])
 }
 
 /*
- * Word wrap text to fit within specified width
+ * Batch mode - decode a file of codes, one per line, to the console
+ * FROM=* reads the console.  Returns RETURN_WARN if any line was not an
+ * alert code.
  */
-STRPTR WordWrapText(STRPTR text, ULONG maxWidth, struct Screen *screen)
+static int DecodeBatchFile(STRPTR fromArg, ULONG format)
 {
-    static char wrappedText[1024];
-    char *src = (char *)text;
-    char *dst = wrappedText;
-    char *wordStart = src;
-    ULONG currentWidth = 0;
-    ULONG wordWidth;
+    struct BatchStats stats;
+    FILE *input;
+    BOOL ok;
     
-    /* Clear the output buffer */
-    memset(wrappedText, 0, sizeof(wrappedText));
+    input = OpenInput(fromArg);
+    if (input == NULL) {
+        return RETURN_FAIL;
+    }
     
-    /* Safety check - if screen is invalid, just return original text */
-    if (screen == NULL || screen->Width <= 0 || screen->Height <= 0) {
-        strcpy(wrappedText, text);
-        return wrappedText;
+    if (runStats != NULL) {
+        BeginPhase(runStats, PHASE_BATCH);
+    }
+    ok = DecodeBatch(input, stdout, format, &stats);
+    if (runStats != NULL) {
+        EndPhase(runStats, PHASE_BATCH, stats.lines);
     }
     
-    while (*src && (dst - wrappedText) < sizeof(wrappedText) - 1) {
-        if (*src == ' ' || *src == '\n' || *src == '\0') {
-            /* End of word, calculate its width - use temporary buffer */
-            char tempChar = *src;
-            char tempWord[256];
-            ULONG wordLen = src - wordStart;
-            
-            /* Copy word to temporary buffer safely */
-            if (wordLen < sizeof(tempWord) - 1) {
-                strncpy(tempWord, wordStart, wordLen);
-                tempWord[wordLen] = '\0';
-                wordWidth = TextLength(&screen->RastPort, tempWord, wordLen);
-            } else {
-                /* Word too long, truncate safely */
-                strncpy(tempWord, wordStart, sizeof(tempWord) - 1);
-                tempWord[sizeof(tempWord) - 1] = '\0';
-                wordWidth = TextLength(&screen->RastPort, tempWord, strlen(tempWord));
-            }
-            
-            /* Check if adding this word would exceed line width */
-            if (currentWidth + wordWidth > maxWidth && currentWidth > 0) {
-                /* Start new line */
-                *dst++ = '\n';
-                currentWidth = 0;
-            }
-            
-            /* Copy the word */
-            strcpy(dst, tempWord);
-            dst += strlen(tempWord);
-            currentWidth += wordWidth;
-            
-            /* Add space or newline */
-            if (tempChar == ' ') {
-                *dst++ = ' ';
-                currentWidth += TextLength(&screen->RastPort, " ", 1);
-            } else if (tempChar == '\n') {
-                *dst++ = '\n';
-                currentWidth = 0;
-            }
-            
-            /* Move to next word */
-            wordStart = src + 1;
+    if (input != stdin) {
+        fclose(input);
+    }
+    
+    if (!ok) {
+        Printf("Error: Batch decoding failed after %lu lines\n", stats.lines);
+        return RETURN_FAIL;
+    }
+    
+    return (stats.invalid > 0) ? RETURN_WARN : RETURN_OK;
+}
+
+/*
+ * Daemon mode - keep the database loaded and answer requests at a public port
+ * Runs until Ctrl-C; Ctrl-F reloads the DATABASE/K file.  With STATS/S
+ * the database record is written to the console when it stops.
+ */
+static int ServeLookups(STRPTR daemonArg, ULONG format)
+{
+    ULONG error;
+    
+    error = RunDaemon(daemonArg, format, (insightDatabase != NULL) ? databaseFile : NULL,
+                      showStats ? stderr : NULL);
+    if (error != DAEMON_OK) {
+        Printf("Error: Cannot serve at %s: %s\n", daemonArg, DaemonErrorText(error));
+        return RETURN_FAIL;
+    }
+    
+    return RETURN_OK;
+}
+
+/*
+ * Client mode - have the daemon at a port decode a code or the FROM input to the console
+ * With neither, codes are read from the console.  Returns RETURN_WARN if
+ * any line was not an alert code, as FROM does.
+ */
+static int AskDaemon(STRPTR connectArg, STRPTR fromArg, STRPTR codes, ULONG format)
+{
+    FILE *input;
+    ULONG invalid;
+    ULONG error;
+    
+    input = NULL;
+    if (fromArg != NULL || codes == NULL) {
+        input = OpenInput((fromArg != NULL) ? fromArg : (STRPTR)"*");
+        if (input == NULL) {
+            return RETURN_FAIL;
+        }
+    }
+    
+    error = RunDaemonClient(connectArg, format, input, codes, stdout, &invalid);
+    
+    if (input != NULL && input != stdin) {
+        fclose(input);
+    }
+    
+    if (error != DAEMON_OK) {
+        Printf("Error: Cannot decode through %s: %s\n", connectArg, DaemonErrorText(error));
+        return RETURN_FAIL;
+    }
+    
+    return (invalid > 0) ? RETURN_WARN : RETURN_OK;
+}
+
+/*
+ * Scan mode - find the alerts in a log and decode each to the console
+ * Returns RETURN_WARN if the log holds no alerts
+ */
+static int ScanLogFile(STRPTR scanArg, ULONG format, ULONG flags)
+{
+    FILE *input;
+    ULONG hits;
+    BOOL ok;
+    
+    input = OpenInput(scanArg);
+    if (input == NULL) {
+        return RETURN_FAIL;
+    }
+    
+    if (runStats != NULL) {
+        BeginPhase(runStats, PHASE_BATCH);
+    }
+    ok = ScanLogToRecords(input, stdout, format, flags, &hits);
+    if (runStats != NULL) {
+        EndPhase(runStats, PHASE_BATCH, hits);
+    }
+    
+    if (input != stdin) {
+        fclose(input);
+    }
+    
+    if (!ok) {
+        Printf("Error: Log scan failed after %lu alerts\n", hits);
+        return RETURN_FAIL;
+    }
+    
+    return (hits == 0) ? RETURN_WARN : RETURN_OK;
+}
+
+/*
+ * Summary mode - count the codes of a FROM file or the alerts of a SCAN
+ * log and write the report to the console
+ * Returns RETURN_WARN if a FROM line was not an alert code or a log
+ * holds no alerts.
+ */
+static int SummarizeInput(STRPTR fromArg, STRPTR scanArg, ULONG format, ULONG flags, ULONG top)
+{
+    struct AlertSummary *summary;
+    struct BatchStats stats;
+    FILE *input;
+    ULONG hits;
+    BOOL ok;
+    int result;
+    
+    summary = AllocAlertSummary();
+    if (summary == NULL) {
+        Printf("Error: Out of memory\n");
+        return RETURN_FAIL;
+    }
+    
+    input = OpenInput((fromArg != NULL) ? fromArg : scanArg);
+    if (input == NULL) {
+        FreeAlertSummary(summary);
+        return RETURN_FAIL;
+    }
+    
+    result = RETURN_OK;
+    if (runStats != NULL) {
+        BeginPhase(runStats, PHASE_BATCH);
+    }
+    if (fromArg != NULL) {
+        ok = SummarizeBatch(input, summary, &stats);
+        if (runStats != NULL) {
+            EndPhase(runStats, PHASE_BATCH, stats.lines);
+        }
+        if (!ok) {
+            Printf("Error: Batch summary failed after %lu lines\n", stats.lines);
+        } else if (stats.invalid > 0) {
+            result = RETURN_WARN;
         }
-        src++;
+    } else {
+        ok = ScanLogToSummary(input, flags, summary, &hits);
+        if (runStats != NULL) {
+            EndPhase(runStats, PHASE_BATCH, hits);
+        }
+        if (!ok) {
+            Printf("Error: Log scan failed after %lu alerts\n", hits);
+        } else if (hits == 0) {
+            result = RETURN_WARN;
+        }
+    }
+    
+    if (input != stdin) {
+        fclose(input);
+    }
+    
+    if (ok && !WriteSummaryReport(stdout, format, summary, top)) {
+        Printf("Error: Cannot write the summary\n");
+        ok = FALSE;
+    }
+    FreeAlertSummary(summary);
+    
+    return ok ? result : RETURN_FAIL;
+}
+
+/*
+ * History mode - decode the crash history records matching a query to the console
+ * Returns RETURN_WARN if no record matches
+ */
+static int QueryHistoryFile(STRPTR historyArg, const struct HistoryQuery *query, ULONG format)
+{
+    struct HistoryQueryStats stats;
+    ULONG error;
+    
+    if (runStats != NULL) {
+        BeginPhase(runStats, PHASE_BATCH);
+    }
+    error = QueryHistoryToRecords(historyArg, query, stdout, format, &stats);
+    if (runStats != NULL) {
+        EndPhase(runStats, PHASE_BATCH, stats.matches);
+    }
+    if (error != HISTORY_OK) {
+        Printf("Error: Cannot query %s: %s\n", historyArg, HistoryErrorText(error));
+        return RETURN_FAIL;
     }
     
-    /* Handle the last word if any */
-    if (*wordStart && (dst - wrappedText) < sizeof(wrappedText) - 1) {
-        strcpy(dst, wordStart);
+    return (stats.matches == 0) ? RETURN_WARN : RETURN_OK;
+}
+
+/*
+ * Search mode - write the entries best matching the words of a query to the console
+ * Returns RETURN_WARN if nothing matches
+ */
+static int SearchDatabase(STRPTR searchArg, ULONG format, ULONG top)
+{
+    struct SearchIndex index;
+    struct SearchTotals totals;
+    BOOL ok;
+    
+    if (!ActiveSearchIndex(&index)) {
+        Printf("Error: The database has no search index. Write it again with genidb.\n");
+        return RETURN_FAIL;
+    }
+    
+    if (runStats != NULL) {
+        BeginPhase(runStats, PHASE_LOOKUP);
+    }
+    ok = WriteSearchResults(stdout, format, searchArg, top, &totals);
+    if (runStats != NULL) {
+        EndPhase(runStats, PHASE_LOOKUP, totals.matches);
+    }
+    if (!ok) {
+        Printf("Error: Cannot write the search results\n");
+        return RETURN_FAIL;
+    }
+    if (totals.terms == 0) {
+        Printf("Error: SEARCH needs a word of two or more letters or digits that is not too common.\n");
+        return RETURN_FAIL;
+    }
+    
+    return (totals.matches == 0) ? RETURN_WARN : RETURN_OK;
+}
+
+/*
+ * Near mode - write the known codes closest to a mistyped or corrupt code to the console
+ * Returns RETURN_WARN if no code is close enough
+ */
+static int ListNearestCodes(STRPTR nearArg, ULONG format, ULONG top)
+{
+    ULONG code;
+    ULONG found;
+    BOOL ok;
+    
+    if (ParseHexCode(nearArg, &code) != HEX_OK) {
+        Printf("Error: Invalid error code format. Error code must be exactly 8 hexadecimal digits.\n");
+        Printf("Example: 8000000B or 0x8000000B\n");
+        return RETURN_FAIL;
+    }
+    
+    if (runStats != NULL) {
+        BeginPhase(runStats, PHASE_LOOKUP);
+    }
+    ok = WriteNearestCodes(stdout, format, code, top, &found);
+    if (runStats != NULL) {
+        EndPhase(runStats, PHASE_LOOKUP, found);
+    }
+    if (!ok) {
+        Printf("Error: Cannot write the near codes\n");
+        return RETURN_FAIL;
     }
     
-    return wrappedText;
+    return (found == 0) ? RETURN_WARN : RETURN_OK;
+}
+
+/*
+ * Name mode - write the entries whose names contain a word starting with a query to the console
+ * Returns RETURN_WARN if nothing matches
+ */
+static int LookUpName(STRPTR nameArg, ULONG format, ULONG top)
+{
+    struct NameIndex index;
+    ULONG found;
+    BOOL ok;
+    
+    if (!ActiveNameIndex(&index)) {
+        Printf("Error: The database has no name index. Write it again with genidb.\n");
+        return RETURN_FAIL;
+    }
+    if (nameArg[strspn(nameArg, " \t")] == '\0') {
+        Printf("Error: NAME needs the start of a word in an alert's name.\n");
+        return RETURN_FAIL;
+    }
+    
+    if (runStats != NULL) {
+        BeginPhase(runStats, PHASE_LOOKUP);
+    }
+    ok = WriteNameResults(stdout, format, nameArg, top, &found);
+    if (runStats != NULL) {
+        EndPhase(runStats, PHASE_LOOKUP, found);
+    }
+    if (!ok) {
+        Printf("Error: Cannot write the names found\n");
+        return RETURN_FAIL;
+    }
+    
+    return (found == 0) ? RETURN_WARN : RETURN_OK;
+}
+
+/*
+ * List the known codes that an ERROR code missing from the database may
+ * be a mistyped copy of
+ */
+static VOID PrintNearHints(ULONG guruCode)
+{
+    struct NearMatch hints[NEAR_HINTS];
+    struct ErrorView view;
+    ULONG count;
+    ULONG i;
+    
+    count = FindNearestCodes(guruCode, NEAR_MAX_DIGITS, hints, NEAR_HINTS);
+    if (count > 0) {
+        Printf("Did you mean:\n");
+    }
+    for (i = 0; i < count; i++) {
+        InsightEntryView(hints[i].entry, &view);
+        Printf("  0x%08lX  %s\n", view.code, view.description);
+    }
+}
+
+/*
+ * Open a FROM or SCAN input - "*" (or "-") means the console
+ */
+static FILE *OpenInput(STRPTR name)
+{
+    FILE *input;
+    
+    if (strcmp(name, "*") == 0 || strcmp(name, "-") == 0) {
+        return stdin;
+    }
+    
+    input = fopen(name, "rb");
+    if (input == NULL) {
+        Printf("Error: Cannot open %s\n", name);
+    }
+    
+    return input;
+}
+
+/*
+ * Whether a command line argument is the STATS switch, in any case
+ */
+static BOOL IsStatsSwitch(STRPTR arg)
+{
+    return (BOOL)((arg[0] & 0xDF) == 'S' && (arg[1] & 0xDF) == 'T' && (arg[2] & 0xDF) == 'A' &&
+                  (arg[3] & 0xDF) == 'T' && (arg[4] & 0xDF) == 'S' && arg[5] == '\0');
+}
+
+/*
+ * Start taking phase times on timer.device
+ * Without the timer the run simply goes untimed.
+ */
+static VOID StartStats(VOID)
+{
+    if (runStats == NULL && StartPhaseStats(&phaseStats, NULL, NULL)) {
+        runStats = &phaseStats;
+        UsePhaseStats(runStats);
+    }
+}
+
+/*
+ * Write the phase times and stop the timer
+ * A Workbench run appends them to the file named in ENV:Insight/Stats;
+ * STATS/S writes them to the console.
+ */
+static VOID FinishStats(VOID)
+{
+    FILE *output;
+    
+    if (runStats == NULL) {
+        return;
+    }
+    
+    if (showStats) {
+        if (statsFile[0] != '\0') {
+            output = fopen(statsFile, "a");
+            if (output != NULL) {
+                WritePhaseReport(output, statsFormat, runStats);
+                fclose(output);
+            }
+        } else {
+            WritePhaseReport(stderr, statsFormat, runStats);
+        }
+    }
+    
+    StopPhaseStats(runStats);
+    runStats = NULL;
+}
+
+/*
+ * Width of one glyph in the font of a screen's RastPort
+ */
+static ULONG ScreenGlyphWidth(UBYTE glyph, APTR font)
+{
+    char c = (char)glyph;
+
+    return TextLength((struct RastPort *)font, &c, 1);
+}
+
+/*
+ * Word wrap text to fit within specified width into a caller-supplied buffer
+ * The buffer may be the text itself.  Glyph widths are kept in the
+ * caller's metrics, whose font must start NULL, and measured again only
+ * when the screen font changes.  Output is truncated to fit and always
+ * terminated when bufferSize > 0; returns the full wrapped length
+ * (excluding the terminator), which is strlen(text).
+ */
+ULONG WordWrapTextInto(STRPTR text, ULONG maxWidth, struct Screen *screen, struct ScreenMetrics *metrics,
+                       STRPTR buffer, ULONG bufferSize)
+{
+    ULONG length;
+
+    /* Safety check - if screen is invalid, just copy the original text */
+    if (screen == NULL || screen->Width <= 0 || screen->Height <= 0) {
+        length = strlen(text);
+        if (bufferSize > 0 && buffer != text) {
+            if (length < bufferSize) {
+                memcpy(buffer, text, length + 1);
+            } else {
+                memcpy(buffer, text, bufferSize - 1);
+                buffer[bufferSize - 1] = '\0';
+            }
+        }
+        return length;
+    }
+
+    if (metrics->font == NULL || metrics->glyphs.font != (APTR)&screen->RastPort ||
+        metrics->font != screen->RastPort.Font) {
+        InitGlyphMetrics(&metrics->glyphs, ScreenGlyphWidth, &screen->RastPort);
+        metrics->font = screen->RastPort.Font;
+    }
+
+    return WrapTextInto(&metrics->glyphs, text, maxWidth, buffer, bufferSize);
 }
 
 /*
@@ -474,15 +1108,18 @@ STRPTR WordWrapText(STRPTR text, ULONG maxWidth, struct Screen *screen)
  */
 VOID ShowErrorDialog(ULONG errorCode, STRPTR description, STRPTR explanation, ULONG taskID)
 {
+    static char fallbackMessage[DIALOG_FALLBACK_SIZE];  /* Low on memory after a crash - the requester still appears */
+    struct ScreenMetrics metrics;
     Object *reqobj;
     char title[256];
-    char message[1024];
-    char wrappedMessage[2048];
+    char taskLine[32];
+    STRPTR message;
+    ULONG messageSize;
+    ULONG length;
     struct Screen *screen;
     ULONG screenWidth;
     ULONG maxTextWidth;
     BOOL testMode;
-    char taskLine[128];
     STRPTR resolvedName;
     
     /* Determine if this is test mode based on taskID */
@@ -522,43 +1159,54 @@ VOID ShowErrorDialog(ULONG errorCode, STRPTR description, STRPTR explanation, UL
     /* Format the title and message */
     sprintf(title, "Guru Meditation Insight");
     
+    resolvedName = testMode ? NULL : ResolveTaskNameFromAddress(taskID);
+    
+    /* Size the message exactly - wrapping never changes its length */
+    messageSize = strlen(description) + strlen(explanation) + DIALOG_TEXT_SIZE;
+    if (resolvedName != NULL) {
+        messageSize += strlen(resolvedName);
+    }
+    
+    message = (STRPTR)AllocVec(messageSize, MEMF_ANY);
+    if (message == NULL) {
+        message = fallbackMessage;
+        messageSize = sizeof(fallbackMessage);
+    }
+    
+    /* Every part is appended within messageSize, so only the fallback is ever cut short */
+    length = sprintf(message, "\n\nError Code: 0x%08X \n\n", (unsigned int)errorCode);
     if (testMode) {
         /* Test mode - show that this is a random selected Insight */
-        sprintf(message, 
-                "\n\n"
-                "Error Code: 0x%08X \n\n"
-                "Task ID: (Test Mode) \n\n"
-                "Error: %s \n\n"
-                "\33i%s\33n \n\n",
-                errorCode, description, explanation);
-    } else {
-        resolvedName = ResolveTaskNameFromAddress(taskID);
-        if (resolvedName != NULL && resolvedName[0] != '\0') {
-            sprintf(taskLine, "Task ID: 0x%08X (%s) \n\n", (unsigned int)taskID, resolvedName);
-        } else {
-            sprintf(taskLine, "Task ID: 0x%08X \n\n", (unsigned int)taskID);
-        }
+        length = AppendDialogText(message, messageSize, length, "Task ID: (Test Mode) \n\n", 0);
+    } else if (resolvedName != NULL && resolvedName[0] != '\0') {
         /* Normal mode - show actual task ID from LastAlert */
-        sprintf(message, 
-                "\n\n"
-                "Error Code: 0x%08X \n\n"
-                "%s"
-                "Error: %s \n\n"
-                "\33i%s\33n \n\n",
-                errorCode, taskLine, description, explanation);
+        sprintf(taskLine, "Task ID: 0x%08X (", (unsigned int)taskID);
+        length = AppendDialogText(message, messageSize, length, taskLine, 0);
+        length = AppendDialogText(message, messageSize, length, resolvedName, DIALOG_TAIL_SIZE);
+        length = AppendDialogText(message, messageSize, length, ") \n\n", 0);
+    } else {
+        sprintf(taskLine, "Task ID: 0x%08X \n\n", (unsigned int)taskID);
+        length = AppendDialogText(message, messageSize, length, taskLine, 0);
     }
+    length = AppendDialogText(message, messageSize, length, "Error: ", 0);
+    length = AppendDialogText(message, messageSize, length, description, DIALOG_TAIL_SIZE);
+    length = AppendDialogText(message, messageSize, length, " \n\n\33i", DIALOG_TAIL_SIZE);
+    length = AppendDialogText(message, messageSize, length, explanation, DIALOG_TAIL_SIZE);
+    length = AppendDialogText(message, messageSize, length, "\33n \n\n", 0);
     
-    /* Word wrap the message if we have a valid screen */
+    /* Word wrap the message in place if we have a valid screen */
+    BEGIN_PHASE(PHASE_WORD_WRAP);
     if (screen != NULL && screen->Width > 0) {
-        strcpy(wrappedMessage, WordWrapText(message, maxTextWidth, screen));
-    } else {
-        strcpy(wrappedMessage, message);
+        metrics.font = NULL;
+        length = WordWrapTextInto(message, maxTextWidth, screen, &metrics, message, length + 1);
     }
+    END_PHASE(PHASE_WORD_WRAP, length);
     
-    /* Create the requester object with all attributes */
+    /* Create the requester object with all attributes - the time includes waiting for OK */
+    BEGIN_PHASE(PHASE_REQUESTER);
     reqobj = NewObject(RequesterClass, NULL,
                        REQ_TitleText, title,
-                       REQ_BodyText, wrappedMessage,
+                       REQ_BodyText, message,
                        REQ_Type, REQTYPE_INFO,
                        REQ_GadgetText, "OK",
                        REQ_Image, REQIMAGE_ERROR,
@@ -571,6 +1219,32 @@ VOID ShowErrorDialog(ULONG errorCode, STRPTR description, STRPTR explanation, UL
         /* Clean up the requester object */
         DisposeObject(reqobj);
     }
+    END_PHASE(PHASE_REQUESTER, 0);
+    
+    if (message != fallbackMessage) {
+        FreeVec(message);
+    }
+}
+
+/*
+ * Append text to the dialog text, cutting it short so keep bytes stay free
+ * Returns the new length.  A cut never splits a requester escape from the
+ * character after it.
+ */
+static ULONG AppendDialogText(STRPTR buffer, ULONG bufferSize, ULONG length, CONST_STRPTR text, ULONG keep)
+{
+    ULONG limit;
+
+    limit = (bufferSize > keep + 1) ? bufferSize - keep - 1 : 0;
+    while (*text != '\0' && length < limit) {
+        if (*text == WRAP_ESCAPE && (text[1] == '\0' || length + 1 >= limit)) {
+            break;
+        }
+        buffer[length++] = *text++;
+    }
+    buffer[length] = '\0';
+
+    return length;
 }
 
 /*
@@ -674,6 +1348,33 @@ static VOID FormatTaskIdLabel(char *out, ULONG outSize, ULONG taskID)
     }
 }
 
+/*
+ * Append the alert found at WBStartup to the crash history
+ * An unchanged LastAlert after another reboot is skipped by AppendCrashRecord.
+ * Failures are ignored - a read-only S: must not stop the requester.
+ */
+static VOID RecordCrash(ULONG guruCode, ULONG taskID)
+{
+    struct CrashRecord record;
+    struct ExecBase *sysBase;
+    ULONG i;
+
+    sysBase = *(struct ExecBase **)4;
+    if (sysBase == NULL && SysBase != NULL) {
+        sysBase = SysBase;
+    }
+
+    record.timestamp = CrashTimestampNow();
+    record.code = guruCode;
+    record.taskID = taskID;
+    for (i = 0; i < 4; i++) {
+        record.lastAlert[i] = (sysBase != NULL) ? sysBase->LastAlert[i] : (ULONG)-1;
+    }
+    SetCrashTaskName(&record, ResolveTaskNameFromAddress(taskID));
+
+    AppendCrashRecord(HISTORY_DEFAULT_PATH, &record);
+}
+
 /*
  * Initialize required libraries
  */
@@ -733,6 +1434,12 @@ BOOL InitializeApplication(VOID)
  */
 VOID Cleanup(VOID)
 {
+    /* Closing the active database also switches back to the compiled-in tables */
+    if (insightDatabase != NULL) {
+        CloseInsightDatabase(insightDatabase);
+        insightDatabase = NULL;
+    }
+    
     /* Close Reaction classes first - be extra careful with order */
     if (RequesterClass != NULL) {
         /* For Reaction classes, we don't call FreeClass - just clear the pointer */
@@ -770,6 +1477,9 @@ VOID SafeExit(int status)
     /* Final cleanup pass */
     Cleanup();
     
+    /* Phase times cover the whole run, so they are written last */
+    FinishStats();
+    
     /* Exit with proper status */
     exit(status);
 }
@@ -787,200 +1497,6 @@ BOOL CheckWorkbenchStartup(VOID)
     return FALSE;
 }
 
-/**
- * @brief Converts a hexadecimal string to a ULONG.
- * @param hexString The null-terminated string containing the hex value.
- * @return The converted ULONG value.
- * 
- * This function parses hex strings the same way ParseLastAlert reads ULONG values
- * from memory - as a big-endian 32-bit value. The string is processed left-to-right,
- * with each character representing 4 bits, building the value from most significant
- * to least significant digit.
- */
-ULONG HexStringToULong(STRPTR hexString) {
-    ULONG result;
-    char localBuffer[32];
-    int startIdx;
-    int idx;
-    int digitCount;
-    unsigned char charVal;
-    ULONG digitVal;
-    int i;
-    
-    /* Initialize all variables - C89 compliance */
-    result = 0;
-    startIdx = 0;
-    idx = 0;
-    digitCount = 0;
-    charVal = 0;
-    digitVal = 0;
-    
-    /* Check for NULL pointer or empty string */
-    if (hexString == NULL || hexString[0] == '\0') {
-        return (ULONG)-1;
-    }
-
-    /* Copy string to local buffer */
-    i = 0;
-    while (i < 31 && hexString[i] != '\0') {
-        localBuffer[i] = hexString[i];
-        i++;
-    }
-    localBuffer[i] = '\0';
-
-    /* Skip "0x" prefix if present */
-    if (localBuffer[0] == '0' && (localBuffer[1] == 'x' || localBuffer[1] == 'X')) {
-        startIdx = 2;
-    }
-
-    /* Check if we have at least one character after prefix */
-    if (localBuffer[startIdx] == '\0') {
-        return (ULONG)-1;
-    }
-
-    /* Process each character from left to right using while loop */
-    i = startIdx;
-    
-    while (i < 32 && localBuffer[i] != '\0' && digitCount < 8) {
-        charVal = (unsigned char)localBuffer[i];
-        
-        /* Convert to uppercase */
-        if (charVal >= 'a' && charVal <= 'z') {
-            charVal = charVal - 'a' + 'A';
-        }
-        
-        /* Convert hex char to digit value */
-        if (charVal >= '0' && charVal <= '9') {
-            digitVal = charVal - '0';
-        } else if (charVal >= 'A' && charVal <= 'F') {
-            digitVal = charVal - 'A' + 10;
-        } else {
-            return (ULONG)-1;
-        }
-        
-        /* Shift result left by 4 bits and add new digit */
-        result = (result << 4) | digitVal;
-        
-        digitCount = digitCount + 1;
-        i = i + 1;
-    }
-    
-    idx = i;  /* Set idx for later checks */
-    
-    /* Check for too many digits */
-    if (localBuffer[idx] != '\0') {
-        return (ULONG)-1;
-    }
-    
-    /* Must have exactly 8 digits */
-    if (digitCount != 8) {
-        return (ULONG)-1;
-    }
-    
-    return result;
-}
-
-/**
- * @brief Checks if a string looks like a hexadecimal number.
- * @param str The null-terminated string to check.
- * @return TRUE if the string looks like a hex number, FALSE otherwise.
- * 
- * A string looks like a hex number if:
- * - It starts with "0x" or "0X" followed by one or more hex digits, OR
- * - It consists entirely of hex digits (0-9, A-F, a-f)
- */
-BOOL LooksLikeHexNumber(STRPTR str) {
-    STRPTR current;
-    unsigned char tempChar;
-    
-    /* Check for NULL pointer or empty string */
-    if (str == NULL || *str == '\0') {
-        return FALSE;
-    }
-    
-    current = str;
-    
-    /* Skip "0x" or "0X" prefix if present */
-    if (current[0] == '0' && (current[1] == 'x' || current[1] == 'X')) {
-        current += 2;
-        /* After 0x prefix, we must have at least one hex digit */
-        if (*current == '\0') {
-            return FALSE;
-        }
-    }
-    
-    /* Check if remaining characters are all hex digits */
-    while (*current != '\0') {
-        tempChar = (unsigned char)*current;
-        
-        /* Convert to uppercase for case-insensitive processing */
-        if (tempChar >= 'a' && tempChar <= 'z') {
-            tempChar = tempChar - 'a' + 'A';
-        }
-        
-        /* Check if it's a valid hex digit */
-        if (!((tempChar >= '0' && tempChar <= '9') || 
-              (tempChar >= 'A' && tempChar <= 'F'))) {
-            return FALSE;  /* Invalid character found */
-        }
-        
-        current++;
-    }
-    
-    /* All characters are valid hex digits */
-    return TRUE;
-}
-
-/**
- * @brief Validates that a string is exactly 8 hexadecimal digits.
- * @param hexString The null-terminated string to validate.
- * @return TRUE if the string is exactly 8 hex digits (with or without 0x prefix), FALSE otherwise.
- * 
- * This function ensures the error code is exactly 8 hex digits, which represents a 32-bit value.
- * The string may optionally start with "0x" or "0X" prefix.
- */
-BOOL ValidateHexErrorCode(STRPTR hexString) {
-    STRPTR current;
-    int digitCount = 0;
-    unsigned char tempChar;
-    
-    /* Check for NULL pointer or empty string */
-    if (hexString == NULL || *hexString == '\0') {
-        return FALSE;
-    }
-    
-    current = hexString;
-    
-    /* Skip "0x" or "0X" prefix if present */
-    if (current[0] == '0' && (current[1] == 'x' || current[1] == 'X')) {
-        current += 2;
-    }
-    
-    /* Count hex digits - must be exactly 8 */
-    while (*current != '\0') {
-        tempChar = (unsigned char)*current;
-        
-        /* Convert to uppercase for case-insensitive processing */
-        if (tempChar >= 'a' && tempChar <= 'z') {
-            tempChar = tempChar - 'a' + 'A';
-        }
-        
-        /* Check if it's a valid hex digit */
-        if ((tempChar >= '0' && tempChar <= '9') || 
-            (tempChar >= 'A' && tempChar <= 'F')) {
-            digitCount++;
-        } else {
-            /* Invalid character found */
-            return FALSE;
-        }
-        
-        current++;
-    }
-    
-    /* Must be exactly 8 hex digits */
-    return (digitCount == 8);
-}
-
 /*
  * Parse the LastAlert array from SysBase to get the complete error code and task ID.
  * Returns (ULONG)-1 if no error, otherwise the error code.
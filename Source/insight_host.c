@@ -0,0 +1,910 @@
+/*
+ * Insight Host Command Line Tool
+ *
+ * Host command line front end for libinsight.  Accepts the same arguments
+ * as the Amiga Insight command (ERROR/K, GURU/S and implicit hex codes) so
+ * crash logs can be triaged on build hosts without an emulator.  ENGINE/K
+ * selects the lookup engine.  FROM/K decodes a file (or - for stdin) of
+ * codes, one per line, to TSV or JSON records chosen with FORMAT/K.  SCAN/K
+ * finds and decodes the alerts in a free-form log; STRICT/S skips bare hex.
+ * THREADS/N sets how many threads decode FROM input (default one per CPU).
+ * DATABASE/K loads an insight.idb file in place of the compiled-in tables.
+ * HISTORY queries a crash history file, narrowed by SINCE/K, UNTIL/K,
+ * CODE/K (a pattern such as 81xxxxxx) and DEADEND/S.  STATS/S writes the
+ * time spent in each phase of the run to stderr.
+ *
+ * After meditiation comes... Insight
+ *
+ * Copyright (c) 2025-26 amigazen project
+ * Licensed under BSD 2-Clause License
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "libinsight.h"
+#include "batch.h"
+#include "parallel.h"
+#include "logscan.h"
+#include "histquery.h"
+#include "daemon.h"
+#include "ring.h"
+#include "ringdecode.h"
+#include "hosttools.h"
+
+#define RETURN_OK    0
+#define RETURN_WARN  5
+#define RETURN_FAIL 20
+
+/* Forward declarations */
+static BOOL ParseCount(const char *text, ULONG maximum, ULONG *count);
+static int RunCommand(const char *fromArg, const char *scanArg, const char *historyArg, const char *searchArg,
+                      const char *nearArg, const char *nameArg, const char *daemonArg, const char *connectArg,
+                      const char *ringArg, const char *databaseArg, const struct HistoryQuery *query, STRPTR errorArg,
+                      enum HexStatus errorStatus, ULONG errorCode, BOOL testMode, ULONG format, ULONG scanFlags,
+                      ULONG threads, BOOL summarize, ULONG top, struct PhaseStats *phases);
+static int QueryHistoryFile(const char *historyArg, const struct HistoryQuery *query, ULONG format,
+                            struct PhaseStats *phases);
+static int DecodeErrorArgument(enum HexStatus status, ULONG guruCode);
+static int SearchDatabase(const char *searchArg, ULONG format, ULONG top, struct PhaseStats *phases);
+static int ListNearestCodes(const char *nearArg, ULONG format, ULONG top, struct PhaseStats *phases);
+static int LookUpName(const char *nameArg, ULONG format, ULONG top, struct PhaseStats *phases);
+static int ServeLookups(const char *daemonArg, const char *databaseArg, ULONG format, struct PhaseStats *phases);
+static int AskDaemon(const char *connectArg, const char *fromArg, const char *codes, ULONG format);
+static int DecodeRing(const char *ringArg, ULONG format, BOOL summarize, ULONG top, struct PhaseStats *phases);
+static int DecodeBatchFile(const char *fromArg, ULONG format, ULONG threads, struct PhaseStats *phases);
+static int ScanLogFile(const char *scanArg, ULONG format, ULONG flags, struct PhaseStats *phases);
+static int SummarizeInput(const char *fromArg, const char *scanArg, ULONG format, ULONG flags, ULONG threads,
+                          ULONG top, struct PhaseStats *phases);
+static FILE *OpenInput(const char *name);
+static int PrintErrorCode(ULONG guruCode);
+static int ShowRandomError(VOID);
+static VOID PrintUsage(VOID);
+
+/*
+ * Read a /N value such as THREADS or TOP - a decimal count up to maximum
+ */
+static BOOL ParseCount(const char *text, ULONG maximum, ULONG *count)
+{
+    ULONG value;
+
+    if (*text == '\0') {
+        return FALSE;
+    }
+
+    value = 0;
+    while (*text >= '0' && *text <= '9') {
+        value = value * 10 + (ULONG)(*text - '0');
+        if (value > maximum) {
+            return FALSE;
+        }
+        text++;
+    }
+    if (*text != '\0') {
+        return FALSE;
+    }
+
+    *count = value;
+    return TRUE;
+}
+
+/* Main entry point */
+int main(int argc, char *argv[])
+{
+    STRPTR errorArg = NULL;
+    enum HexStatus errorStatus = HEX_EMPTY;
+    enum HexStatus status;
+    ULONG errorCode = 0;
+    BOOL testMode = FALSE;
+    const char *fromArg = NULL;
+    const char *scanArg = NULL;
+    ULONG scanFlags = 0;
+    ULONG threads = 0;
+    BOOL summarize = FALSE;
+    ULONG top = SUMMARY_TOP_DEFAULT;
+    BOOL topGiven = FALSE;
+    const char *databaseArg = NULL;
+    const char *searchArg = NULL;
+    const char *nearArg = NULL;
+    const char *nameArg = NULL;
+    const char *daemonArg = NULL;
+    const char *connectArg = NULL;
+    const char *ringArg = NULL;
+    const char *historyArg = NULL;
+    struct HistoryQuery query;
+    ULONG codeValue;
+    ULONG codeMask;
+    struct InsightDatabase *database = NULL;
+    ULONG databaseError;
+    struct PhaseStats phases;
+    BOOL showStats = FALSE;
+    int result;
+    const char *value;
+    LONG engine;
+    LONG format = BATCH_FORMAT_TSV;
+    int i;
+
+    /* The clock is cheap to read here, so the arguments are always timed in case STATS is among them */
+    StartPhaseStats(&phases, NULL, NULL);
+    BeginPhase(&phases, PHASE_ARGUMENTS);
+
+    InitHistoryQuery(&query);
+
+    for (i = 1; i < argc; i++) {
+        if (MatchKeyword(argv[i], "ERROR", &value)) {
+            if (value == NULL && i + 1 < argc) {
+                value = argv[++i];
+            }
+            if (value == NULL) {
+                PrintUsage();
+                return RETURN_FAIL;
+            }
+            errorArg = (STRPTR)value;
+            errorStatus = ParseHexCode(errorArg, &errorCode);
+        } else if (MatchKeyword(argv[i], "ENGINE", &value)) {
+            if (value == NULL && i + 1 < argc) {
+                value = argv[++i];
+            }
+            engine = FindLookupEngine(value);
+            if (engine < 0) {
+                printf("Error: Unknown lookup engine. Use binary, eytzinger, perfect or subsystem.\n");
+                return RETURN_FAIL;
+            }
+            SetLookupEngine((ULONG)engine);
+        } else if (MatchKeyword(argv[i], "FROM", &value)) {
+            if (value == NULL && i + 1 < argc) {
+                value = argv[++i];
+            }
+            if (value == NULL) {
+                PrintUsage();
+                return RETURN_FAIL;
+            }
+            fromArg = value;
+        } else if (MatchKeyword(argv[i], "SCAN", &value)) {
+            if (value == NULL && i + 1 < argc) {
+                value = argv[++i];
+            }
+            if (value == NULL) {
+                PrintUsage();
+                return RETURN_FAIL;
+            }
+            scanArg = value;
+        } else if (MatchKeyword(argv[i], "STRICT", &value) && value == NULL) {
+            scanFlags |= SCAN_STRICT;
+        } else if (MatchKeyword(argv[i], "THREADS", &value)) {
+            if (value == NULL && i + 1 < argc) {
+                value = argv[++i];
+            }
+            if (value == NULL || !ParseCount(value, PARALLEL_MAX_THREADS, &threads)) {
+                printf("Error: THREADS must be a number from 0 (one per CPU) to %d.\n", PARALLEL_MAX_THREADS);
+                return RETURN_FAIL;
+            }
+        } else if (MatchKeyword(argv[i], "SUMMARY", &value) && value == NULL) {
+            summarize = TRUE;
+        } else if (MatchKeyword(argv[i], "TOP", &value)) {
+            if (value == NULL && i + 1 < argc) {
+                value = argv[++i];
+            }
+            if (value == NULL || !ParseCount(value, SUMMARY_SLOTS, &top)) {
+                printf("Error: TOP must be a number of codes from 0 to %d.\n", SUMMARY_SLOTS);
+                return RETURN_FAIL;
+            }
+            topGiven = TRUE;
+        } else if (MatchKeyword(argv[i], "SEARCH", &value)) {
+            if (value == NULL && i + 1 < argc) {
+                value = argv[++i];
+            }
+            if (value == NULL) {
+                PrintUsage();
+                return RETURN_FAIL;
+            }
+            searchArg = value;
+        } else if (MatchKeyword(argv[i], "NEAR", &value)) {
+            if (value == NULL && i + 1 < argc) {
+                value = argv[++i];
+            }
+            if (value == NULL) {
+                PrintUsage();
+                return RETURN_FAIL;
+            }
+            nearArg = value;
+        } else if (MatchKeyword(argv[i], "NAME", &value)) {
+            if (value == NULL && i + 1 < argc) {
+                value = argv[++i];
+            }
+            if (value == NULL) {
+                PrintUsage();
+                return RETURN_FAIL;
+            }
+            nameArg = value;
+        } else if (MatchKeyword(argv[i], "DAEMON", &value)) {
+            if (value == NULL && i + 1 < argc) {
+                value = argv[++i];
+            }
+            if (value == NULL) {
+                PrintUsage();
+                return RETURN_FAIL;
+            }
+            daemonArg = value;
+        } else if (MatchKeyword(argv[i], "CONNECT", &value)) {
+            if (value == NULL && i + 1 < argc) {
+                value = argv[++i];
+            }
+            if (value == NULL) {
+                PrintUsage();
+                return RETURN_FAIL;
+            }
+            connectArg = value;
+        } else if (MatchKeyword(argv[i], "RING", &value)) {
+            if (value == NULL && i + 1 < argc) {
+                value = argv[++i];
+            }
+            if (value == NULL) {
+                PrintUsage();
+                return RETURN_FAIL;
+            }
+            ringArg = value;
+        } else if (MatchKeyword(argv[i], "DATABASE", &value)) {
+            if (value == NULL && i + 1 < argc) {
+                value = argv[++i];
+            }
+            if (value == NULL) {
+                PrintUsage();
+                return RETURN_FAIL;
+            }
+            databaseArg = value;
+        } else if (MatchKeyword(argv[i], "HISTORY", &value)) {
+            /* HISTORY alone queries the default history file */
+            historyArg = (value != NULL) ? value : HISTORY_DEFAULT_PATH;
+        } else if (MatchKeyword(argv[i], "SINCE", &value)) {
+            if (value == NULL && i + 1 < argc) {
+                value = argv[++i];
+            }
+            if (value == NULL || !ParseHistoryTime(value, CrashTimestampNow(), FALSE, &query.since)) {
+                printf("Error: Use NOW, -<n>s/m/h/d/w or YYYY-MM-DD [HH:MM[:SS]] for SINCE and UNTIL.\n");
+                return RETURN_FAIL;
+            }
+        } else if (MatchKeyword(argv[i], "UNTIL", &value)) {
+            if (value == NULL && i + 1 < argc) {
+                value = argv[++i];
+            }
+            if (value == NULL || !ParseHistoryTime(value, CrashTimestampNow(), TRUE, &query.until)) {
+                printf("Error: Use NOW, -<n>s/m/h/d/w or YYYY-MM-DD [HH:MM[:SS]] for SINCE and UNTIL.\n");
+                return RETURN_FAIL;
+            }
+        } else if (MatchKeyword(argv[i], "CODE", &value)) {
+            if (value == NULL && i + 1 < argc) {
+                value = argv[++i];
+            }
+            if (value == NULL || !ParseHistoryCodePattern(value, &codeValue, &codeMask)) {
+                printf("Error: CODE must be up to 8 hex digits, x for any digit - e.g. 81xxxxxx.\n");
+                return RETURN_FAIL;
+            }
+            if (!RestrictHistoryCodes(&query, codeValue, codeMask)) {
+                printf("Error: CODE and DEADEND can never both match.\n");
+                return RETURN_FAIL;
+            }
+        } else if (MatchKeyword(argv[i], "DEADEND", &value) && value == NULL) {
+            if (!RestrictHistoryCodes(&query, ALERT_DEADEND, ALERT_DEADEND)) {
+                printf("Error: CODE and DEADEND can never both match.\n");
+                return RETURN_FAIL;
+            }
+        } else if (MatchKeyword(argv[i], "FORMAT", &value)) {
+            if (value == NULL && i + 1 < argc) {
+                value = argv[++i];
+            }
+            format = FindBatchFormat(value);
+            if (format < 0) {
+                printf("Error: Unknown output format. Use tsv or json.\n");
+                return RETURN_FAIL;
+            }
+        } else if (MatchKeyword(argv[i], "GURU", &value) && value == NULL) {
+            testMode = TRUE;
+        } else if (MatchKeyword(argv[i], "STATS", &value) && value == NULL) {
+            showStats = TRUE;
+        } else if (errorArg == NULL &&
+                   (status = ParseHexCode(argv[i], &errorCode)) != HEX_BAD_DIGIT && status != HEX_EMPTY) {
+            /* Implicit ERROR: bare hex numbers are treated as error codes */
+            errorArg = argv[i];
+            errorStatus = status;
+        } else {
+            PrintUsage();
+            return RETURN_FAIL;
+        }
+    }
+
+    if (summarize && fromArg == NULL && scanArg == NULL && ringArg == NULL) {
+        printf("Error: SUMMARY needs FROM, SCAN or RING.\n");
+        return RETURN_FAIL;
+    }
+
+    /* TOP defaults to fewer search results, near codes and names than summary codes */
+    if (searchArg != NULL && !topGiven) {
+        top = SEARCH_TOP_DEFAULT;
+    }
+    if (nearArg != NULL && !topGiven) {
+        top = NEAR_TOP_DEFAULT;
+    }
+    if (nameArg != NULL && !topGiven) {
+        top = NAME_TOP_DEFAULT;
+    }
+
+    if (databaseArg != NULL) {
+        /* The daemon reads a copy, since the file may be replaced while it runs */
+        database = OpenInsightDatabase(databaseArg, (daemonArg != NULL) ? IDB_PRIVATE_COPY : 0, &databaseError);
+        if (database == NULL) {
+            fprintf(stderr, "Error: Cannot load database %s: %s\n", databaseArg, IdbErrorText(databaseError));
+            return RETURN_FAIL;
+        }
+        UseInsightDatabase(database);
+    }
+    EndPhase(&phases, PHASE_ARGUMENTS, (ULONG)(argc - 1));
+
+    result = RunCommand(fromArg, scanArg, historyArg, searchArg, nearArg, nameArg, daemonArg, connectArg, ringArg,
+                        databaseArg, &query, errorArg, errorStatus, errorCode, testMode, (ULONG)format, scanFlags,
+                        threads, summarize, top, showStats ? &phases : NULL);
+
+    if (database != NULL) {
+        CloseInsightDatabase(database);
+    }
+
+    /* Statistics go to stderr so they never mix with records on stdout */
+    if (showStats) {
+        WritePhaseReport(stderr, (ULONG)format, &phases);
+    }
+    StopPhaseStats(&phases);
+
+    return result;
+}
+
+/*
+ * Run the command selected by the arguments
+ * phases is NULL unless STATS was given.  Batch input is timed as one
+ * phase; a single code has its lookup and expansion timed by the core.
+ */
+static int RunCommand(const char *fromArg, const char *scanArg, const char *historyArg, const char *searchArg,
+                      const char *nearArg, const char *nameArg, const char *daemonArg, const char *connectArg,
+                      const char *ringArg, const char *databaseArg, const struct HistoryQuery *query, STRPTR errorArg,
+                      enum HexStatus errorStatus, ULONG errorCode, BOOL testMode, ULONG format, ULONG scanFlags,
+                      ULONG threads, BOOL summarize, ULONG top, struct PhaseStats *phases)
+{
+    if (daemonArg != NULL) {
+        return ServeLookups(daemonArg, databaseArg, format, phases);
+    }
+
+    if (connectArg != NULL) {
+        return AskDaemon(connectArg, fromArg, errorArg, format);
+    }
+
+    if (ringArg != NULL) {
+        return DecodeRing(ringArg, format, summarize, top, phases);
+    }
+
+    if (summarize) {
+        return SummarizeInput(fromArg, scanArg, format, scanFlags, threads, top, phases);
+    }
+
+    if (fromArg != NULL) {
+        return DecodeBatchFile(fromArg, format, threads, phases);
+    }
+
+    if (scanArg != NULL) {
+        return ScanLogFile(scanArg, format, scanFlags, phases);
+    }
+
+    if (historyArg != NULL) {
+        return QueryHistoryFile(historyArg, query, format, phases);
+    }
+
+    if (searchArg != NULL) {
+        return SearchDatabase(searchArg, format, top, phases);
+    }
+
+    if (nearArg != NULL) {
+        return ListNearestCodes(nearArg, format, top, phases);
+    }
+
+    if (nameArg != NULL) {
+        return LookUpName(nameArg, format, top, phases);
+    }
+
+    UsePhaseStats(phases);
+
+    if (errorArg != NULL) {
+        return DecodeErrorArgument(errorStatus, errorCode);
+    }
+
+    if (testMode) {
+        return ShowRandomError();
+    }
+
+    PrintUsage();
+    return RETURN_OK;
+}
+
+/*
+ * Look up and print a single error code argument, already parsed in main
+ */
+static int DecodeErrorArgument(enum HexStatus status, ULONG guruCode)
+{
+    if (status != HEX_OK) {
+        printf("Error: Invalid error code format. Error code must be exactly 8 hexadecimal digits.\n");
+        printf("Example: 8000000B or 0x8000000B\n");
+        return RETURN_FAIL;
+    }
+
+    return PrintErrorCode(guruCode);
+}
+
+/*
+ * Batch mode - decode a file of codes, one per line, to stdout
+ * Returns RETURN_WARN if any line was not an alert code
+ */
+static int DecodeBatchFile(const char *fromArg, ULONG format, ULONG threads, struct PhaseStats *phases)
+{
+    struct BatchStats stats;
+    FILE *input;
+    BOOL success;
+
+    input = OpenInput(fromArg);
+    if (input == NULL) {
+        return RETURN_FAIL;
+    }
+
+    if (phases != NULL) {
+        BeginPhase(phases, PHASE_BATCH);
+    }
+    success = ParallelDecodeBatch(input, stdout, format, threads, &stats);
+    if (phases != NULL) {
+        EndPhase(phases, PHASE_BATCH, stats.lines);
+    }
+
+    if (input != stdin) {
+        fclose(input);
+    }
+
+    if (!success) {
+        fprintf(stderr, "Error: Batch decoding failed after %lu lines\n", (unsigned long)stats.lines);
+        return RETURN_FAIL;
+    }
+
+    return (stats.invalid > 0) ? RETURN_WARN : RETURN_OK;
+}
+
+/*
+ * Scan mode - find the alerts in a log and decode each to stdout
+ * Returns RETURN_WARN if the log holds no alerts
+ */
+static int ScanLogFile(const char *scanArg, ULONG format, ULONG flags, struct PhaseStats *phases)
+{
+    FILE *input;
+    ULONG hits;
+    BOOL success;
+
+    input = OpenInput(scanArg);
+    if (input == NULL) {
+        return RETURN_FAIL;
+    }
+
+    if (phases != NULL) {
+        BeginPhase(phases, PHASE_BATCH);
+    }
+    success = ScanLogToRecords(input, stdout, format, flags, &hits);
+    if (phases != NULL) {
+        EndPhase(phases, PHASE_BATCH, hits);
+    }
+
+    if (input != stdin) {
+        fclose(input);
+    }
+
+    if (!success) {
+        fprintf(stderr, "Error: Log scan failed after %lu alerts\n", (unsigned long)hits);
+        return RETURN_FAIL;
+    }
+
+    return (hits == 0) ? RETURN_WARN : RETURN_OK;
+}
+
+/*
+ * Summary mode - count the codes of a FROM file or the alerts of a SCAN
+ * log and write the report to stdout
+ * Returns RETURN_WARN if a FROM line was not an alert code or a log
+ * holds no alerts.
+ */
+static int SummarizeInput(const char *fromArg, const char *scanArg, ULONG format, ULONG flags, ULONG threads,
+                          ULONG top, struct PhaseStats *phases)
+{
+    struct AlertSummary *summary;
+    struct BatchStats stats;
+    FILE *input;
+    ULONG hits;
+    BOOL success;
+    int result;
+
+    summary = AllocAlertSummary();
+    if (summary == NULL) {
+        fprintf(stderr, "Error: Out of memory\n");
+        return RETURN_FAIL;
+    }
+
+    input = OpenInput((fromArg != NULL) ? fromArg : scanArg);
+    if (input == NULL) {
+        FreeAlertSummary(summary);
+        return RETURN_FAIL;
+    }
+
+    result = RETURN_OK;
+    if (phases != NULL) {
+        BeginPhase(phases, PHASE_BATCH);
+    }
+    if (fromArg != NULL) {
+        success = ParallelSummarizeBatch(input, threads, summary, &stats);
+        if (phases != NULL) {
+            EndPhase(phases, PHASE_BATCH, stats.lines);
+        }
+        if (!success) {
+            fprintf(stderr, "Error: Batch summary failed after %lu lines\n", (unsigned long)stats.lines);
+        } else if (stats.invalid > 0) {
+            result = RETURN_WARN;
+        }
+    } else {
+        success = ScanLogToSummary(input, flags, summary, &hits);
+        if (phases != NULL) {
+            EndPhase(phases, PHASE_BATCH, hits);
+        }
+        if (!success) {
+            fprintf(stderr, "Error: Log scan failed after %lu alerts\n", (unsigned long)hits);
+        } else if (hits == 0) {
+            result = RETURN_WARN;
+        }
+    }
+
+    if (input != stdin) {
+        fclose(input);
+    }
+
+    if (success && !WriteSummaryReport(stdout, format, summary, top)) {
+        fprintf(stderr, "Error: Cannot write the summary\n");
+        success = FALSE;
+    }
+    FreeAlertSummary(summary);
+
+    return success ? result : RETURN_FAIL;
+}
+
+/*
+ * History mode - decode the crash history records matching a query to stdout
+ * Returns RETURN_WARN if no record matches
+ */
+static int QueryHistoryFile(const char *historyArg, const struct HistoryQuery *query, ULONG format,
+                            struct PhaseStats *phases)
+{
+    struct HistoryQueryStats stats;
+    ULONG error;
+
+    if (phases != NULL) {
+        BeginPhase(phases, PHASE_BATCH);
+    }
+    error = QueryHistoryToRecords(historyArg, query, stdout, format, &stats);
+    if (phases != NULL) {
+        EndPhase(phases, PHASE_BATCH, stats.matches);
+    }
+    if (error != HISTORY_OK) {
+        fprintf(stderr, "Error: Cannot query %s: %s\n", historyArg, HistoryErrorText(error));
+        return RETURN_FAIL;
+    }
+
+    return (stats.matches == 0) ? RETURN_WARN : RETURN_OK;
+}
+
+/*
+ * Search mode - write the entries best matching the words of a query to stdout
+ * Returns RETURN_WARN if nothing matches
+ */
+static int SearchDatabase(const char *searchArg, ULONG format, ULONG top, struct PhaseStats *phases)
+{
+    struct SearchIndex index;
+    struct SearchTotals totals;
+    BOOL ok;
+
+    if (!ActiveSearchIndex(&index)) {
+        fprintf(stderr, "Error: The database has no search index. Write it again with genidb.\n");
+        return RETURN_FAIL;
+    }
+
+    if (phases != NULL) {
+        BeginPhase(phases, PHASE_LOOKUP);
+    }
+    ok = WriteSearchResults(stdout, format, searchArg, top, &totals);
+    if (phases != NULL) {
+        EndPhase(phases, PHASE_LOOKUP, totals.matches);
+    }
+    if (!ok) {
+        fprintf(stderr, "Error: Cannot write the search results\n");
+        return RETURN_FAIL;
+    }
+    if (totals.terms == 0) {
+        fprintf(stderr, "Error: SEARCH needs a word of two or more letters or digits that is not too common.\n");
+        return RETURN_FAIL;
+    }
+
+    return (totals.matches == 0) ? RETURN_WARN : RETURN_OK;
+}
+
+/*
+ * Near mode - write the known codes closest to a mistyped or corrupt code to stdout
+ * Returns RETURN_WARN if no code is close enough
+ */
+static int ListNearestCodes(const char *nearArg, ULONG format, ULONG top, struct PhaseStats *phases)
+{
+    ULONG code;
+    ULONG found;
+    BOOL ok;
+
+    if (ParseHexCode(nearArg, &code) != HEX_OK) {
+        printf("Error: Invalid error code format. Error code must be exactly 8 hexadecimal digits.\n");
+        printf("Example: 8000000B or 0x8000000B\n");
+        return RETURN_FAIL;
+    }
+
+    if (phases != NULL) {
+        BeginPhase(phases, PHASE_LOOKUP);
+    }
+    ok = WriteNearestCodes(stdout, format, code, top, &found);
+    if (phases != NULL) {
+        EndPhase(phases, PHASE_LOOKUP, found);
+    }
+    if (!ok) {
+        fprintf(stderr, "Error: Cannot write the near codes\n");
+        return RETURN_FAIL;
+    }
+
+    return (found == 0) ? RETURN_WARN : RETURN_OK;
+}
+
+/*
+ * Name mode - write the entries whose names contain a word starting with a query to stdout
+ * Returns RETURN_WARN if nothing matches
+ */
+static int LookUpName(const char *nameArg, ULONG format, ULONG top, struct PhaseStats *phases)
+{
+    struct NameIndex index;
+    ULONG found;
+    BOOL ok;
+
+    if (!ActiveNameIndex(&index)) {
+        fprintf(stderr, "Error: The database has no name index. Write it again with genidb.\n");
+        return RETURN_FAIL;
+    }
+    if (nameArg[strspn(nameArg, " \t")] == '\0') {
+        fprintf(stderr, "Error: NAME needs the start of a word in an alert's name.\n");
+        return RETURN_FAIL;
+    }
+
+    if (phases != NULL) {
+        BeginPhase(phases, PHASE_LOOKUP);
+    }
+    ok = WriteNameResults(stdout, format, nameArg, top, &found);
+    if (phases != NULL) {
+        EndPhase(phases, PHASE_LOOKUP, found);
+    }
+    if (!ok) {
+        fprintf(stderr, "Error: Cannot write the names found\n");
+        return RETURN_FAIL;
+    }
+
+    return (found == 0) ? RETURN_WARN : RETURN_OK;
+}
+
+/*
+ * Daemon mode - keep the database loaded and answer clients at a socket
+ * Runs until SIGINT or SIGTERM; SIGHUP reloads the DATABASE file.  With
+ * STATS the database record goes to stderr when it stops.
+ */
+static int ServeLookups(const char *daemonArg, const char *databaseArg, ULONG format, struct PhaseStats *phases)
+{
+    ULONG error;
+
+    error = RunDaemon(daemonArg, format, databaseArg, (phases != NULL) ? stderr : NULL);
+    if (error != DAEMON_OK) {
+        fprintf(stderr, "Error: Cannot serve at %s: %s\n", daemonArg, DaemonErrorText(error));
+        return RETURN_FAIL;
+    }
+
+    return RETURN_OK;
+}
+
+/*
+ * Client mode - have the daemon at a socket decode a code or the FROM input to stdout
+ * With neither, codes are read from stdin.  Returns RETURN_WARN if any
+ * line was not an alert code, as FROM does.
+ */
+static int AskDaemon(const char *connectArg, const char *fromArg, const char *codes, ULONG format)
+{
+    FILE *input;
+    ULONG invalid;
+    ULONG error;
+
+    input = NULL;
+    if (fromArg != NULL || codes == NULL) {
+        input = OpenInput((fromArg != NULL) ? fromArg : "-");
+        if (input == NULL) {
+            return RETURN_FAIL;
+        }
+    }
+
+    error = RunDaemonClient(connectArg, format, input, codes, stdout, &invalid);
+
+    if (input != NULL && input != stdin) {
+        fclose(input);
+    }
+
+    if (error != DAEMON_OK) {
+        fprintf(stderr, "Error: Cannot decode through %s: %s\n", connectArg, DaemonErrorText(error));
+        return RETURN_FAIL;
+    }
+
+    return (invalid > 0) ? RETURN_WARN : RETURN_OK;
+}
+
+/*
+ * Ring mode - decode what local producers post to an alert ring to stdout
+ * Runs until SIGINT or SIGTERM.  With SUMMARY the report is written then
+ * instead of the records.
+ * Returns RETURN_WARN if producers had to drop records.
+ */
+static int DecodeRing(const char *ringArg, ULONG format, BOOL summarize, ULONG top, struct PhaseStats *phases)
+{
+    struct AlertSummary *summary;
+    struct RingTotals totals;
+    ULONG error;
+    BOOL success;
+
+    summary = NULL;
+    if (summarize) {
+        summary = AllocAlertSummary();
+        if (summary == NULL) {
+            fprintf(stderr, "Error: Out of memory\n");
+            return RETURN_FAIL;
+        }
+    }
+
+    if (phases != NULL) {
+        BeginPhase(phases, PHASE_BATCH);
+    }
+    error = DecodeAlertRing(ringArg, 0, stdout, format, summary, &totals);
+    if (phases != NULL) {
+        EndPhase(phases, PHASE_BATCH, totals.alerts);
+    }
+
+    success = (error == RING_OK);
+    if (!success) {
+        fprintf(stderr, "Error: Cannot decode the ring %s: %s\n", ringArg, RingErrorText(error));
+    } else if (summary != NULL && !WriteSummaryReport(stdout, format, summary, top)) {
+        fprintf(stderr, "Error: Cannot write the summary\n");
+        success = FALSE;
+    }
+    if (summary != NULL) {
+        FreeAlertSummary(summary);
+    }
+
+    if (!success) {
+        return RETURN_FAIL;
+    }
+    if (totals.dropped > 0) {
+        fprintf(stderr, "Warning: The ring was full - producers dropped %lu alerts\n", (unsigned long)totals.dropped);
+        return RETURN_WARN;
+    }
+
+    return RETURN_OK;
+}
+
+/*
+ * Open a FROM or SCAN input - "-" and "*" mean stdin
+ */
+static FILE *OpenInput(const char *name)
+{
+    FILE *input;
+
+    if (strcmp(name, "-") == 0 || strcmp(name, "*") == 0) {
+        return stdin;
+    }
+
+    input = fopen(name, "rb");
+    if (input == NULL) {
+        fprintf(stderr, "Error: Cannot open %s\n", name);
+    }
+
+    return input;
+}
+
+/*
+ * Look up and print a single error code
+ * Codes missing from the database are decoded from their structure, and
+ * the known codes they could be a mistyped copy of are listed.
+ */
+static int PrintErrorCode(ULONG guruCode)
+{
+    char insightText[INSIGHT_MAX_LENGTH];
+    struct AlertDecoding decoding;
+    struct NearMatch hints[NEAR_HINTS];
+    struct ErrorView view;
+    ULONG count;
+    ULONG i;
+
+    DecodeAlertInto(guruCode, &decoding, insightText, sizeof(insightText));
+
+    printf("Error Code: 0x%08lX\nError: %s\n%s\n",
+           (unsigned long)guruCode, decoding.description, insightText);
+
+    if (decoding.match != ALERT_MATCH_EXACT) {
+        count = FindNearestCodes(guruCode, NEAR_MAX_DIGITS, hints, NEAR_HINTS);
+        if (count > 0) {
+            printf("Did you mean:\n");
+        }
+        for (i = 0; i < count; i++) {
+            InsightEntryView(hints[i].entry, &view);
+            printf("  0x%08lX  %s\n", (unsigned long)view.code, view.description);
+        }
+    }
+
+    return RETURN_OK;
+}
+
+/*
+ * GURU mode - print a random error from the database
+ */
+static int ShowRandomError(VOID)
+{
+    const struct ErrorInfo *entry;
+
+    srand((unsigned int)time(NULL));
+    entry = InsightEntryAt((ULONG)rand() % InsightEntryCount());
+
+    return PrintErrorCode(entry->code);
+}
+
+/*
+ * Print the argument template
+ */
+static VOID PrintUsage(VOID)
+{
+    printf("Usage: Insight [ERROR=]<code> [GURU] [ENGINE=binary|eytzinger|perfect|subsystem]\n");
+    printf("       Insight FROM=<file>|- [FORMAT=tsv|json] [THREADS=<n>] [ENGINE=...]\n");
+    printf("       Insight SCAN=<log>|- [STRICT] [FORMAT=tsv|json] [ENGINE=...]\n");
+    printf("       Insight FROM=<file>|- | SCAN=<log>|- SUMMARY [TOP=<n>] [FORMAT=tsv|json] [THREADS=<n>]\n");
+    printf("       Insight HISTORY[=<file>] [SINCE=<time>] [UNTIL=<time>] [CODE=81xxxxxx] [DEADEND] [FORMAT=...]\n");
+    printf("       Insight SEARCH=<words> [TOP=<n>] [FORMAT=tsv|json]\n");
+    printf("       Insight NEAR=<code> [TOP=<n>] [FORMAT=tsv|json]\n");
+    printf("       Insight NAME=<name> [TOP=<n>] [FORMAT=tsv|json]\n");
+    printf("       Insight DAEMON=<socket> [DATABASE=<file.idb>] [FORMAT=tsv|json]\n");
+    printf("       Insight CONNECT=<socket> [<code> | FROM=<file>|-] [FORMAT=tsv|json]\n");
+    printf("       Insight RING=<file> [SUMMARY [TOP=<n>]] [FORMAT=tsv|json]\n");
+    printf("       DATABASE=<file.idb> loads the error database from a file\n");
+    printf("       STATS writes the time spent in each phase to stderr\n");
+    printf("Example: Insight 8000000B\n");
+}
@@ -0,0 +1,74 @@
+/*
+ * libinsight - Guru Meditation Decoding Library
+ *
+ * Database introspection helpers exported by libinsight.  The lookup and
+ * expansion functions themselves live in error_codes.c.
+ *
+ * After meditiation comes... Insight
+ *
+ * Copyright (c) 2025-26 amigazen project
+ * Licensed under BSD 2-Clause License
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <stdio.h>
+#include "libinsight.h"
+
+/*
+ * Return the library version string
+ */
+CONST_STRPTR InsightVersionString(VOID)
+{
+    return "libinsight 47.7";
+}
+
+/*
+ * Return the number of compiled-in database entries, excluding the end marker
+ */
+ULONG InsightEntryCount(VOID)
+{
+    return ERROR_TABLE_SIZE - 1;
+}
+
+/*
+ * Return the raw (unexpanded) compiled-in database entry at the given index
+ * Returns NULL when the index is out of range
+ */
+const struct ErrorInfo *InsightEntryAt(ULONG index)
+{
+    if (index >= InsightEntryCount()) {
+        return NULL;
+    }
+
+    return &errorTable[index];
+}
+
+/*
+ * Check whether an error code has an entry in the active database
+ * without expanding or allocating anything
+ */
+BOOL InsightIsKnownCode(ULONG errorCode)
+{
+    return (BOOL)(FindInsightIndex(errorCode) != LOOKUP_NOT_FOUND);
+}
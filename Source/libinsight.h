@@ -0,0 +1,72 @@
+/*
+ * libinsight - Guru Meditation Decoding Library
+ *
+ * Public C interface of libinsight, the portable decoding core shared by
+ * the Amiga Insight executable and host tools.  Include this header rather
+ * than error_codes.h when linking against libinsight.
+ *
+ * After meditiation comes... Insight
+ *
+ * Copyright (c) 2025-26 amigazen project
+ * Licensed under BSD 2-Clause License
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef LIBINSIGHT_H
+#define LIBINSIGHT_H
+
+#include "platform.h"
+#include "error_codes.h"
+#include "hexparse.h"
+#include "lookup.h"
+#include "decompose.h"
+#include "idb.h"
+#include "history.h"
+#include "histquery.h"
+#include "summary.h"
+#include "search.h"
+#include "nearest.h"
+#include "names.h"
+#include "phase.h"
+#include "wordwrap.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Library version - follows the Insight executable version */
+#define INSIGHT_LIB_VERSION  47
+#define INSIGHT_LIB_REVISION 7
+
+/* Function declarations */
+CONST_STRPTR InsightVersionString(VOID);
+ULONG InsightEntryCount(VOID);
+const struct ErrorInfo *InsightEntryAt(ULONG index);
+BOOL InsightIsKnownCode(ULONG errorCode);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* LIBINSIGHT_H */
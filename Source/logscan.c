@@ -0,0 +1,532 @@
+/*
+ * Log Scanner
+ *
+ * Finds alert codes in free-form logs in a single pass.  Each 16-byte chunk
+ * is turned into a mask of hex digits and a mask of interesting bytes
+ * (newlines and the first letter of the alert texts) - with SSE2 where the
+ * compiler offers it, from a byte class table elsewhere.  Runs of exactly
+ * eight hex digits fall out of the hex mask with a few shifts, so the
+ * scalar code only looks at candidate positions.
+ *
+ * After meditiation comes... Insight
+ *
+ * Copyright (c) 2025-26 amigazen project
+ * Licensed under BSD 2-Clause License
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "hexparse.h"
+#include "summary.h"
+#include "batch.h"
+#include "logscan.h"
+
+#if defined(__SSE2__) && !defined(INSIGHT_NO_SIMD)
+#include <emmintrin.h>
+#define SCAN_SSE2 1
+#endif
+
+/* Byte classes */
+#define CLASS_HEX   0x01  /* 0-9, a-f, A-F */
+#define CLASS_EVENT 0x02  /* Newline or the first letter of an alert text */
+#define CLASS_WORD  0x04  /* Letters and digits - a code must not touch one */
+
+/* Bytes examined per mask */
+#define CHUNK_SIZE 16
+
+static const UBYTE byteClass[256] = {
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x06, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04,
+    0x04, 0x04, 0x06, 0x06, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x05, 0x05, 0x05, 0x05, 0x05, 0x05, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04,
+    0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00
+};
+
+/* Alert texts recognised in the log, with the kind they announce */
+static const struct {
+    CONST_STRPTR text;
+    ULONG length;
+    ULONG kind;
+} alertTexts[] = {
+    { "Guru Meditation",   15, SCAN_KIND_GURU },
+    { "Software Failure",  16, SCAN_KIND_SOFTWARE_FAILURE },
+    { "Recoverable Alert", 17, SCAN_KIND_RECOVERABLE }
+};
+
+#define ALERT_TEXTS (sizeof(alertTexts) / sizeof(alertTexts[0]))
+
+/* Kind names, indexed by SCAN_KIND_xxx */
+static const CONST_STRPTR kindNames[SCAN_KINDS] = {
+    "bare", "guru", "software-failure", "recoverable"
+};
+
+/* Forward declarations */
+static VOID ChunkMasks(const UBYTE *chunk, ULONG *hexMask, ULONG *eventMask);
+static BOOL ScanChunk(struct LogScanner *scanner, const char *text, ULONG length, ULONG base,
+                      ULONG window, ULONG events, ULONG *skipUntil);
+static VOID MatchAlertText(struct LogScanner *scanner, const char *text, ULONG length, ULONG pos);
+static BOOL ReportCode(struct LogScanner *scanner, const char *text, ULONG length, ULONG pos, ULONG *skipUntil);
+static BOOL ParseHexField(const char *text, ULONG length, ULONG pos, ULONG *value);
+static BOOL WriteHitRecord(const struct AlertHit *hit, APTR userData);
+static BOOL CountHit(const struct AlertHit *hit, APTR userData);
+
+/*
+ * Prepare a scanner
+ * report is called for every alert found; returning FALSE stops the scan.
+ */
+VOID InitLogScanner(struct LogScanner *scanner, ULONG flags,
+                    BOOL (*report)(const struct AlertHit *hit, APTR userData), APTR userData)
+{
+    scanner->flags = flags;
+    scanner->line = 1;
+    scanner->guruLine = 0;
+    scanner->pendingKind = SCAN_KIND_BARE;
+    scanner->pendingLine = 0;
+    scanner->hits = 0;
+    scanner->report = report;
+    scanner->userData = userData;
+}
+
+/*
+ * Scan a block of log text
+ * Blocks should end at a line boundary - a code split across two calls
+ * is not found.  Returns FALSE if the report callback stopped the scan.
+ */
+BOOL ScanLogBuffer(struct LogScanner *scanner, const char *text, ULONG length)
+{
+    UBYTE tail[CHUNK_SIZE];
+    ULONG base;
+    ULONG hexMask;
+    ULONG eventMask;
+    ULONG previousHex;
+    ULONG previousEvents;
+    ULONG skipUntil;
+    ULONG window;
+    ULONG carry;
+
+    previousHex = 0;
+    previousEvents = 0;
+    carry = 0;
+    skipUntil = 0;
+
+    /*
+     * Each step computes the masks of the chunk at base and then handles the
+     * chunk before it, so a run starting near the end of a chunk can be
+     * checked against the bytes that follow.  One extra step flushes the
+     * last chunk against an empty one.
+     */
+    for (base = 0; base < length + CHUNK_SIZE; base += CHUNK_SIZE) {
+        if (base + CHUNK_SIZE <= length) {
+            ChunkMasks((const UBYTE *)text + base, &hexMask, &eventMask);
+        } else if (base < length) {
+            memset(tail, 0, sizeof(tail));
+            memcpy(tail, text + base, length - base);
+            ChunkMasks(tail, &hexMask, &eventMask);
+        } else {
+            hexMask = 0;
+            eventMask = 0;
+        }
+
+        if (base > 0) {
+            /* Bit 31 carries the byte before the chunk instead - runs never look that far */
+            window = previousHex | ((hexMask & 0x7FFF) << CHUNK_SIZE);
+            if (!ScanChunk(scanner, text, length, base - CHUNK_SIZE,
+                           window | carry, previousEvents, &skipUntil)) {
+                return FALSE;
+            }
+            carry = (previousHex >> (CHUNK_SIZE - 1)) << 31;
+        }
+
+        previousHex = hexMask;
+        previousEvents = eventMask;
+    }
+
+    return TRUE;
+}
+
+/*
+ * Scan a whole stream in large blocks, cut at line boundaries
+ * Returns FALSE on a read error or if the report callback stopped the scan.
+ */
+BOOL ScanLogStream(struct LogScanner *scanner, FILE *input)
+{
+    char *buffer;
+    ULONG end;
+    ULONG cut;
+    ULONG got;
+    BOOL success;
+
+    buffer = (char *)malloc(SCAN_BUFFER_SIZE);
+    if (buffer == NULL) {
+        return FALSE;
+    }
+
+    end = 0;
+    success = TRUE;
+
+    for (;;) {
+        got = (ULONG)fread(buffer + end, 1, SCAN_BUFFER_SIZE - end, input);
+        end += got;
+        if (got == 0) {
+            if (ferror(input)) {
+                success = FALSE;
+            } else if (end > 0) {
+                success = ScanLogBuffer(scanner, buffer, end);
+            }
+            break;
+        }
+
+        /* Scan up to the last complete line; a full block with no newline goes as is */
+        cut = end;
+        while (cut > 0 && buffer[cut - 1] != '\n') {
+            cut--;
+        }
+        if (cut == 0) {
+            if (end < SCAN_BUFFER_SIZE) {
+                continue;
+            }
+            cut = end;
+        }
+
+        if (!ScanLogBuffer(scanner, buffer, cut)) {
+            success = FALSE;
+            break;
+        }
+        memmove(buffer, buffer + cut, end - cut);
+        end -= cut;
+    }
+
+    free(buffer);
+
+    return success;
+}
+
+/*
+ * Scan a log and write a decoded record for every alert found
+ * Records are written in BATCH_FORMAT_xxx format with the line, kind and
+ * task of each hit.  Returns FALSE on a read or write error.
+ */
+BOOL ScanLogToRecords(FILE *input, FILE *output, ULONG format, ULONG flags, ULONG *hits)
+{
+    struct LogScanner scanner;
+    struct BatchWriter writer;
+    BOOL success;
+
+    if (!OpenBatchWriter(&writer, output, format)) {
+        return FALSE;
+    }
+
+    InitLogScanner(&scanner, flags, WriteHitRecord, &writer);
+    success = ScanLogStream(&scanner, input);
+    if (!CloseBatchWriter(&writer)) {
+        success = FALSE;
+    }
+
+    *hits = scanner.hits;
+    return success;
+}
+
+/*
+ * Scan a log and count every alert found in a summary
+ * The counts are added to what summary already holds.  Returns FALSE on
+ * a read error.
+ */
+BOOL ScanLogToSummary(FILE *input, ULONG flags, struct AlertSummary *summary, ULONG *hits)
+{
+    struct LogScanner scanner;
+    BOOL success;
+
+    InitLogScanner(&scanner, flags, CountHit, summary);
+    success = ScanLogStream(&scanner, input);
+
+    *hits = scanner.hits;
+    return success;
+}
+
+/*
+ * Name of a hit kind, as used in scan output
+ */
+CONST_STRPTR AlertKindName(ULONG kind)
+{
+    if (kind >= SCAN_KINDS) {
+        return "unknown";
+    }
+
+    return kindNames[kind];
+}
+
+/*
+ * Build the hex digit and event masks of one chunk - bit n is byte n
+ */
+static VOID ChunkMasks(const UBYTE *chunk, ULONG *hexMask, ULONG *eventMask)
+{
+#ifdef SCAN_SSE2
+    __m128i bytes;
+    __m128i lower;
+    __m128i hex;
+    __m128i events;
+
+    bytes = _mm_loadu_si128((const __m128i *)chunk);
+
+    /* Signed compares - bytes above 0x7F are negative and never match */
+    hex = _mm_and_si128(_mm_cmpgt_epi8(bytes, _mm_set1_epi8('0' - 1)),
+                        _mm_cmplt_epi8(bytes, _mm_set1_epi8('9' + 1)));
+    lower = _mm_or_si128(bytes, _mm_set1_epi8(0x20));
+    hex = _mm_or_si128(hex, _mm_and_si128(_mm_cmpgt_epi8(lower, _mm_set1_epi8('a' - 1)),
+                                          _mm_cmplt_epi8(lower, _mm_set1_epi8('f' + 1))));
+
+    events = _mm_or_si128(_mm_cmpeq_epi8(bytes, _mm_set1_epi8('\n')),
+                          _mm_cmpeq_epi8(bytes, _mm_set1_epi8('G')));
+    events = _mm_or_si128(events, _mm_cmpeq_epi8(bytes, _mm_set1_epi8('S')));
+    events = _mm_or_si128(events, _mm_cmpeq_epi8(bytes, _mm_set1_epi8('R')));
+
+    *hexMask = (ULONG)_mm_movemask_epi8(hex);
+    *eventMask = (ULONG)_mm_movemask_epi8(events);
+#else
+    ULONG hex;
+    ULONG events;
+    ULONG i;
+    UBYTE c;
+
+    hex = 0;
+    events = 0;
+    for (i = 0; i < CHUNK_SIZE; i++) {
+        c = byteClass[chunk[i]];
+        hex |= (ULONG)(c & CLASS_HEX) << i;
+        events |= (ULONG)((c & CLASS_EVENT) >> 1) << i;
+    }
+
+    *hexMask = hex;
+    *eventMask = events;
+#endif
+}
+
+/*
+ * Handle the events and code candidates of one chunk, in order
+ * window holds the hex mask of this chunk and the next, plus bit 31 set
+ * if the byte before this chunk is a hex digit.
+ */
+static BOOL ScanChunk(struct LogScanner *scanner, const char *text, ULONG length, ULONG base,
+                      ULONG window, ULONG events, ULONG *skipUntil)
+{
+    ULONG runs;
+    ULONG starts;
+    ULONG bit;
+    ULONG pos;
+    ULONG before;
+
+    /* Bit n of runs is set when bytes n to n+7 are all hex digits */
+    runs = window & (window >> 1);
+    runs &= runs >> 2;
+    runs &= runs >> 4;
+
+    /* Keep runs of exactly eight: no hex digit just before or just after */
+    before = (window << 1) | (window >> 31);
+    starts = runs & ~before & ~(window >> 8) & 0xFFFF;
+
+    events = (events | starts) & 0xFFFF;
+    while (events != 0) {
+#if defined(__GNUC__)
+        bit = (ULONG)__builtin_ctz(events);
+#else
+        bit = 0;
+        while ((events & (1UL << bit)) == 0) {
+            bit++;
+        }
+#endif
+        events &= events - 1;
+        pos = base + bit;
+
+        if (text[pos] == '\n') {
+            scanner->line++;
+        } else if ((starts & (1UL << bit)) != 0) {
+            if (pos >= *skipUntil && !ReportCode(scanner, text, length, pos, skipUntil)) {
+                return FALSE;
+            }
+        } else {
+            MatchAlertText(scanner, text, length, pos);
+        }
+    }
+
+    return TRUE;
+}
+
+/*
+ * Check for an alert text at an event byte and remember what it announces
+ */
+static VOID MatchAlertText(struct LogScanner *scanner, const char *text, ULONG length, ULONG pos)
+{
+    ULONG i;
+
+    for (i = 0; i < ALERT_TEXTS; i++) {
+        if (text[pos] == alertTexts[i].text[0] && pos + alertTexts[i].length <= length &&
+            memcmp(text + pos, alertTexts[i].text, alertTexts[i].length) == 0) {
+            if (alertTexts[i].kind == SCAN_KIND_GURU) {
+                scanner->guruLine = scanner->line;
+            } else {
+                /* The code may follow on the same line or the next one */
+                scanner->pendingKind = alertTexts[i].kind;
+                scanner->pendingLine = scanner->line;
+            }
+            return;
+        }
+    }
+}
+
+/*
+ * Classify and report the code candidate at pos, with its task word
+ */
+static BOOL ReportCode(struct LogScanner *scanner, const char *text, ULONG length, ULONG pos, ULONG *skipUntil)
+{
+    struct AlertHit hit;
+    ULONG next;
+    ULONG separator;
+
+    /* A code must stand alone - allow #, $ and 0x in front of it */
+    if (pos > 0 && (byteClass[(UBYTE)text[pos - 1]] & CLASS_WORD) != 0) {
+        if (!(pos >= 2 && (text[pos - 1] == 'x' || text[pos - 1] == 'X') && text[pos - 2] == '0' &&
+              (pos == 2 || (byteClass[(UBYTE)text[pos - 3]] & CLASS_WORD) == 0))) {
+            return TRUE;
+        }
+    }
+    if (!ParseHexField(text, length, pos, &hit.code)) {
+        return TRUE;
+    }
+
+    if (pos > 0 && text[pos - 1] == '#' && scanner->guruLine == scanner->line) {
+        hit.kind = SCAN_KIND_GURU;
+    } else if (scanner->pendingKind != SCAN_KIND_BARE && scanner->line <= scanner->pendingLine + 1) {
+        hit.kind = scanner->pendingKind;
+    } else if ((scanner->flags & SCAN_STRICT) == 0) {
+        hit.kind = SCAN_KIND_BARE;
+    } else {
+        return TRUE;
+    }
+    scanner->pendingKind = SCAN_KIND_BARE;
+
+    /* Task word: ".YYYYYYYY" straight after, or "Task: YYYYYYYY" further on */
+    next = pos + 8;
+    hit.hasTask = FALSE;
+    if (next < length && text[next] == '.' && ParseHexField(text, length, next + 1, &hit.task)) {
+        hit.hasTask = TRUE;
+        next += 9;
+    } else {
+        while (next < length && (text[next] == ' ' || text[next] == '\t')) {
+            next++;
+        }
+        if (next + 4 <= length && (text[next] | 0x20) == 't' && (text[next + 1] | 0x20) == 'a' &&
+            (text[next + 2] | 0x20) == 's' && (text[next + 3] | 0x20) == 'k') {
+            next += 4;
+            separator = next;
+            while (next < length && (text[next] == ':' || text[next] == ' ' || text[next] == '\t')) {
+                next++;
+            }
+            if (next == separator) {
+                /* "Task" must be followed by a colon or space */
+                next = length;
+            } else if (next + 2 <= length && text[next] == '0' && (text[next + 1] | 0x20) == 'x') {
+                next += 2;
+            } else if (next < length && text[next] == '$') {
+                next++;
+            }
+            if (ParseHexField(text, length, next, &hit.task)) {
+                hit.hasTask = TRUE;
+                next += 8;
+            }
+        }
+    }
+    if (hit.hasTask) {
+        /* The task word is not a code of its own */
+        *skipUntil = next;
+    } else {
+        hit.task = 0;
+    }
+
+    hit.line = scanner->line;
+    scanner->hits++;
+
+    return scanner->report(&hit, scanner->userData);
+}
+
+/*
+ * Parse exactly eight hex digits at pos that are not followed by a letter or digit
+ */
+static BOOL ParseHexField(const char *text, ULONG length, ULONG pos, ULONG *value)
+{
+    if (pos + 8 > length) {
+        return FALSE;
+    }
+    if (pos + 8 < length && (byteClass[(UBYTE)text[pos + 8]] & CLASS_WORD) != 0) {
+        return FALSE;
+    }
+
+    return (ParseHexSpan(text + pos, 8, value) == HEX_OK);
+}
+
+/*
+ * Report callback for ScanLogToRecords - decode the hit into the writer
+ */
+static BOOL WriteHitRecord(const struct AlertHit *hit, APTR userData)
+{
+    struct BatchWriter *writer;
+    struct RecordSource source;
+
+    writer = (struct BatchWriter *)userData;
+
+    source.line = hit->line;
+    source.time = NULL;
+    source.kind = AlertKindName(hit->kind);
+    source.hasProducer = FALSE;
+    source.producer = 0;
+    source.hasTask = hit->hasTask;
+    source.task = hit->task;
+    source.taskName = NULL;
+    WriteSourcedAlertRecord(writer, hit->code, &source);
+
+    /* Stop scanning once the output is gone */
+    return (BOOL)!writer->failed;
+}
+
+/*
+ * Report callback for ScanLogToSummary - count the hit's code
+ */
+static BOOL CountHit(const struct AlertHit *hit, APTR userData)
+{
+    CountAlertCode((struct AlertSummary *)userData, hit->code);
+
+    return TRUE;
+}
@@ -0,0 +1,95 @@
+/*
+ * Log Scanner
+ *
+ * Streams alert codes through the decoder.  Lines are split straight out
+ * of large input blocks and records are formatted into a large output
+ * buffer, so there is one read and one write per block instead of one per
+ * code.
+ *
+ * After meditiation comes... Insight
+ *
+ * Copyright (c) 2025-26 amigazen project
+ * Licensed under BSD 2-Clause License
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef LOGSCAN_H
+#define LOGSCAN_H
+
+#include <stdio.h>
+#include "platform.h"
+#include "summary.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* How an alert appeared in the log */
+#define SCAN_KIND_BARE             0  /* 8-digit hex with no alert text around it */
+#define SCAN_KIND_GURU             1  /* Guru Meditation #XXXXXXXX.YYYYYYYY */
+#define SCAN_KIND_SOFTWARE_FAILURE 2  /* Code on or after a Software Failure line */
+#define SCAN_KIND_RECOVERABLE      3  /* Code on or after a Recoverable Alert line */
+#define SCAN_KINDS                 4
+
+/* Scanner flags */
+#define SCAN_STRICT  0x0001  /* Ignore bare hex - only codes with alert text */
+
+/* Size of the blocks read by ScanLogStream */
+#define SCAN_BUFFER_SIZE 262144
+
+/* An alert found in the log */
+struct AlertHit {
+    ULONG code;
+    ULONG task;        /* Task or address word, if hasTask */
+    BOOL hasTask;
+    ULONG kind;        /* SCAN_KIND_xxx */
+    ULONG line;        /* 1-based line number */
+};
+
+/* Scanner state - carried across ScanLogBuffer calls */
+struct LogScanner {
+    ULONG flags;
+    ULONG line;
+    ULONG guruLine;        /* Line with the last Guru Meditation text */
+    ULONG pendingKind;     /* Alert text waiting for its code */
+    ULONG pendingLine;
+    ULONG hits;
+    BOOL (*report)(const struct AlertHit *hit, APTR userData);
+    APTR userData;
+};
+
+/* Function declarations */
+VOID InitLogScanner(struct LogScanner *scanner, ULONG flags,
+                    BOOL (*report)(const struct AlertHit *hit, APTR userData), APTR userData);
+BOOL ScanLogBuffer(struct LogScanner *scanner, const char *text, ULONG length);
+BOOL ScanLogStream(struct LogScanner *scanner, FILE *input);
+CONST_STRPTR AlertKindName(ULONG kind);
+BOOL ScanLogToRecords(FILE *input, FILE *output, ULONG format, ULONG flags, ULONG *hits);
+BOOL ScanLogToSummary(FILE *input, ULONG flags, struct AlertSummary *summary, ULONG *hits);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* LOGSCAN_H */
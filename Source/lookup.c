@@ -0,0 +1,245 @@
+/*
+ * Error Code Lookup Engines
+ *
+ * Implements the lookup engines declared in lookup.h on top of the search
+ * structures generated into lookup_tables.c.
+ *
+ * After meditiation comes... Insight
+ *
+ * Copyright (c) 2025-26 amigazen project
+ * Licensed under BSD 2-Clause License
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "error_codes.h"
+#include "lookup.h"
+#include "lookup_hash.h"
+
+/* Forward declarations */
+static LONG BinaryLookup(ULONG errorCode);
+static LONG EytzingerLookup(ULONG errorCode);
+static LONG PerfectLookup(ULONG errorCode);
+static LONG SubsystemLookup(ULONG errorCode);
+
+/* Engine dispatch table, indexed by LOOKUP_xxx */
+static const struct {
+    CONST_STRPTR name;
+    LONG (*lookup)(ULONG errorCode);
+} lookupEngines[LOOKUP_ENGINES] = {
+    { "binary",    BinaryLookup },
+    { "eytzinger", EytzingerLookup },
+    { "perfect",   PerfectLookup },
+    { "subsystem", SubsystemLookup }
+};
+
+/* Currently selected engine */
+static ULONG currentEngine = INSIGHT_DEFAULT_LOOKUP;
+
+/*
+ * Look up an error code with the current engine
+ * Returns the index into errorTable or LOOKUP_NOT_FOUND
+ */
+LONG LookupErrorIndex(ULONG errorCode)
+{
+    return lookupEngines[currentEngine].lookup(errorCode);
+}
+
+/*
+ * Look up an error code with a specific engine
+ */
+LONG LookupWithEngine(ULONG engine, ULONG errorCode)
+{
+    if (engine >= LOOKUP_ENGINES) {
+        return LOOKUP_NOT_FOUND;
+    }
+
+    return lookupEngines[engine].lookup(errorCode);
+}
+
+/*
+ * Select the engine used by LookupErrorIndex and GainInsight
+ */
+BOOL SetLookupEngine(ULONG engine)
+{
+    if (engine >= LOOKUP_ENGINES) {
+        return FALSE;
+    }
+
+    currentEngine = engine;
+    return TRUE;
+}
+
+/*
+ * Return the currently selected engine
+ */
+ULONG GetLookupEngine(VOID)
+{
+    return currentEngine;
+}
+
+/*
+ * Return the name of an engine, or NULL if out of range
+ */
+CONST_STRPTR LookupEngineName(ULONG engine)
+{
+    if (engine >= LOOKUP_ENGINES) {
+        return NULL;
+    }
+
+    return lookupEngines[engine].name;
+}
+
+/*
+ * Find an engine by name
+ * Returns the engine identifier or -1 if no engine has that name
+ */
+LONG FindLookupEngine(CONST_STRPTR name)
+{
+    ULONG i;
+
+    if (name == NULL) {
+        return -1;
+    }
+
+    for (i = 0; i < LOOKUP_ENGINES; i++) {
+        if (strcmp(lookupEngines[i].name, name) == 0) {
+            return (LONG)i;
+        }
+    }
+
+    return -1;
+}
+
+/*
+ * Binary search over the errorTable records themselves
+ * Each probe touches a full ErrorInfo record
+ */
+static LONG BinaryLookup(ULONG errorCode)
+{
+    ULONG left;
+    ULONG right;
+    ULONG mid;
+
+    left = 0;
+    right = lookupTableSize;
+
+    while (left < right) {
+        mid = left + ((right - left) / 2);
+
+        if (errorTable[mid].code == errorCode) {
+            return (LONG)mid;
+        } else if (errorTable[mid].code < errorCode) {
+            left = mid + 1;
+        } else {
+            right = mid;
+        }
+    }
+
+    return LOOKUP_NOT_FOUND;
+}
+
+/*
+ * Branchless search over the packed code column in Eytzinger (BFS) order
+ * The first probes all fall in the same few cache lines at the top of
+ * the implicit tree, and the loop body has no data dependent branch.
+ */
+static LONG EytzingerLookup(ULONG errorCode)
+{
+    ULONG k;
+
+    k = 1;
+    while (k <= lookupTableSize) {
+        k = (k << 1) + (eytzingerCodes[k] < errorCode);
+    }
+
+    /* Undo the trailing right turns to find the lower bound */
+#if defined(__GNUC__)
+    k >>= __builtin_ffs(~k);
+#else
+    while (k & 1) {
+        k >>= 1;
+    }
+    k >>= 1;
+#endif
+
+    if (k != 0 && eytzingerCodes[k] == errorCode) {
+        return (LONG)eytzingerIndex[k];
+    }
+
+    return LOOKUP_NOT_FOUND;
+}
+
+/*
+ * Minimal perfect hash - one bucket seed and one slot probe per lookup
+ */
+static LONG PerfectLookup(ULONG errorCode)
+{
+    ULONG bucket;
+    ULONG slot;
+
+    if (lookupTableSize == 0) {
+        return LOOKUP_NOT_FOUND;
+    }
+
+    bucket = LookupHash(errorCode, 0) % perfectBucketCount;
+    slot = LookupHash(errorCode, perfectSeeds[bucket]) % lookupTableSize;
+
+    if (perfectCodes[slot] == errorCode) {
+        return (LONG)perfectIndex[slot];
+    }
+
+    return LOOKUP_NOT_FOUND;
+}
+
+/*
+ * Two-level index - the subsystem byte selects a dense range of the
+ * packed code column, which is then binary searched
+ */
+static LONG SubsystemLookup(ULONG errorCode)
+{
+    ULONG subsystem;
+    ULONG left;
+    ULONG right;
+    ULONG mid;
+
+    subsystem = errorCode >> 24;
+    left = subsystemFirst[subsystem];
+    right = subsystemFirst[subsystem + 1];
+
+    while (left < right) {
+        mid = left + ((right - left) / 2);
+
+        if (packedCodes[mid] == errorCode) {
+            return (LONG)mid;
+        } else if (packedCodes[mid] < errorCode) {
+            left = mid + 1;
+        } else {
+            right = mid;
+        }
+    }
+
+    return LOOKUP_NOT_FOUND;
+}
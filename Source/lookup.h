@@ -0,0 +1,84 @@
+/*
+ * Error Code Lookup Engines
+ *
+ * Selectable lookup engines for GainInsight.  Every engine maps an error
+ * code to its index in errorTable[]; the engines differ only in the layout
+ * of the search structures, which are generated at build time by gentables
+ * into lookup_tables.c.
+ *
+ * After meditiation comes... Insight
+ *
+ * Copyright (c) 2025-26 amigazen project
+ * Licensed under BSD 2-Clause License
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef LOOKUP_H
+#define LOOKUP_H
+
+#include "platform.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Lookup engine identifiers */
+#define LOOKUP_BINARY     0  /* Binary search over errorTable records */
+#define LOOKUP_EYTZINGER  1  /* Branchless search over packed codes in Eytzinger order */
+#define LOOKUP_PERFECT    2  /* Minimal perfect hash generated at build time */
+#define LOOKUP_SUBSYSTEM  3  /* Two-level index keyed by the subsystem byte */
+#define LOOKUP_ENGINES    4
+
+/* Engine used until SetLookupEngine() is called */
+#ifndef INSIGHT_DEFAULT_LOOKUP
+#define INSIGHT_DEFAULT_LOOKUP LOOKUP_EYTZINGER
+#endif
+
+/* Returned by the lookup functions when the code is not in the table */
+#define LOOKUP_NOT_FOUND (-1L)
+
+/* Generated tables - see gentables.c */
+extern const ULONG lookupTableSize;
+extern const ULONG packedCodes[];
+extern const ULONG eytzingerCodes[];
+extern const UWORD eytzingerIndex[];
+extern const UWORD subsystemFirst[];
+extern const ULONG perfectBucketCount;
+extern const ULONG perfectSeeds[];
+extern const ULONG perfectCodes[];
+extern const UWORD perfectIndex[];
+
+/* Function declarations */
+LONG LookupErrorIndex(ULONG errorCode);
+LONG LookupWithEngine(ULONG engine, ULONG errorCode);
+BOOL SetLookupEngine(ULONG engine);
+ULONG GetLookupEngine(VOID);
+CONST_STRPTR LookupEngineName(ULONG engine);
+LONG FindLookupEngine(CONST_STRPTR name);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* LOOKUP_H */
@@ -0,0 +1,97 @@
+/*
+ * Name Text
+ *
+ * Where names are indexed and how they compare.  gentables sorts the NAME
+ * index with these rules and the runtime searches it with them, so they
+ * live here rather than in either file.
+ *
+ * After meditiation comes... Insight
+ *
+ * Copyright (c) 2025-26 amigazen project
+ * Licensed under BSD 2-Clause License
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef NAME_TEXT_H
+#define NAME_TEXT_H
+
+#include "platform.h"
+
+/* ASCII letters fold to lower case; everything else compares as is */
+#define NAME_FOLD(c) ((UBYTE)(((c) >= 'A' && (c) <= 'Z') ? (c) - 'A' + 'a' : (c)))
+
+#define NAME_IS_LOWER(c) ((c) >= 'a' && (c) <= 'z')
+#define NAME_IS_UPPER(c) ((c) >= 'A' && (c) <= 'Z')
+#define NAME_IS_DIGIT(c) ((c) >= '0' && (c) <= '9')
+#define NAME_IS_ALNUM(c) (NAME_IS_LOWER(c) || NAME_IS_UPPER(c) || NAME_IS_DIGIT(c))
+
+/*
+ * Whether a word or a word part starts at offset in a name
+ * That is a letter or digit after anything else, a capital after a small
+ * letter ("MakeVPort"), or a change between letters and digits ("LVO12").
+ */
+static BOOL IsNameStart(CONST_STRPTR name, ULONG offset)
+{
+    UBYTE c;
+    UBYTE previous;
+
+    c = (UBYTE)name[offset];
+    if (!NAME_IS_ALNUM(c)) {
+        return FALSE;
+    }
+    if (offset == 0) {
+        return TRUE;
+    }
+
+    previous = (UBYTE)name[offset - 1];
+
+    return (BOOL)(!NAME_IS_ALNUM(previous) ||
+                  (NAME_IS_LOWER(previous) && NAME_IS_UPPER(c)) ||
+                  (NAME_IS_DIGIT(previous) != NAME_IS_DIGIT(c)));
+}
+
+/*
+ * Compare name text with a query, ignoring case
+ * With prefix set the comparison ends with the query, so text that
+ * starts with it compares equal.  Returns <0, 0 or >0 like strcmp.
+ */
+static int CompareNameText(CONST_STRPTR text, CONST_STRPTR query, BOOL prefix)
+{
+    const UBYTE *a;
+    const UBYTE *b;
+
+    a = (const UBYTE *)text;
+    b = (const UBYTE *)query;
+    while (*b != '\0' && NAME_FOLD(*a) == NAME_FOLD(*b)) {
+        a++;
+        b++;
+    }
+    if (*b == '\0' && prefix) {
+        return 0;
+    }
+
+    return (int)NAME_FOLD(*a) - (int)NAME_FOLD(*b);
+}
+
+#endif /* NAME_TEXT_H */
@@ -0,0 +1,281 @@
+/*
+ * Insight Names
+ *
+ * A query is matched against the indexed word starts with two binary
+ * searches, which bound the run of places whose text begins with it.  The
+ * run is then read in order and each entry is kept once, names that start
+ * with the query first and then in code order.  A query uses no heap and
+ * reads the descriptions in place.
+ *
+ * After meditiation comes... Insight
+ *
+ * Copyright (c) 2025-26 amigazen project
+ * Licensed under BSD 2-Clause License
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <string.h>
+#include "platform.h"
+#include "error_codes.h"
+#include "idb.h"
+#include "names.h"
+#include "name_text.h"
+
+/* Forward declarations */
+static VOID ReadPlace(const struct NameIndex *index, ULONG place, ULONG *entry, ULONG *offset);
+static CONST_STRPTR NameText(const struct NameIndex *index, ULONG entry);
+static ULONG FindPlace(const struct NameIndex *index, CONST_STRPTR name, BOOL after);
+static BOOL RanksBefore(const struct NameHit *a, const struct NameHit *b);
+
+/*
+ * Describe an index image from its header
+ * The records are trusted unless CheckNameIndex has been run.  Returns
+ * FALSE if the image is malformed.
+ */
+BOOL OpenNameIndex(struct NameIndex *index, const UBYTE *data, ULONG size, const struct InsightDatabase *database)
+{
+    if (data == NULL || size < NAME_HEADER_SIZE || IdbGetLong(data) != size) {
+        return FALSE;
+    }
+
+    index->data = data;
+    index->size = size;
+    index->entryCount = IdbGetLong(data + 4);
+    index->count = IdbGetLong(data + 8);
+    index->records = data + NAME_HEADER_SIZE;
+    index->database = database;
+
+    return (BOOL)(index->count == (size - NAME_HEADER_SIZE) / NAME_RECORD_SIZE &&
+                  (size - NAME_HEADER_SIZE) % NAME_RECORD_SIZE == 0);
+}
+
+/*
+ * Check every place of an index against its database's descriptions
+ * Each must name a real entry and a word start inside its description,
+ * and the places must be in order.  Used on untrusted images, such as
+ * .idb files, once when they are opened.
+ */
+BOOL CheckNameIndex(const struct NameIndex *index)
+{
+    CONST_STRPTR previous;
+    CONST_STRPTR text;
+    ULONG previousEntry;
+    ULONG entryCount;
+    ULONG entry;
+    ULONG offset;
+    ULONG place;
+    int order;
+
+    entryCount = (index->database != NULL) ? index->database->entryCount : ERROR_TABLE_SIZE - 1;
+    if (index->entryCount != entryCount) {
+        return FALSE;
+    }
+
+    previous = NULL;
+    previousEntry = 0;
+    for (place = 0; place < index->count; place++) {
+        ReadPlace(index, place, &entry, &offset);
+        if (entry >= entryCount) {
+            return FALSE;
+        }
+        text = NameText(index, entry);
+        if (offset >= strlen(text) || !IsNameStart(text, offset)) {
+            return FALSE;
+        }
+        text += offset;
+
+        if (previous != NULL) {
+            order = CompareNameText(previous, text, FALSE);
+            if (order > 0 || (order == 0 && previousEntry >= entry)) {
+                return FALSE;
+            }
+        }
+        previous = text;
+        previousEntry = entry;
+    }
+
+    return TRUE;
+}
+
+/*
+ * Describe the index of the database lookups are served from
+ * Returns FALSE if that database was written without one.
+ */
+BOOL ActiveNameIndex(struct NameIndex *index)
+{
+    struct InsightDatabase *database;
+
+    database = ActiveInsightDatabase();
+    if (database != NULL) {
+        return OpenNameIndex(index, database->nameIndex, database->nameIndexSize, database);
+    }
+
+    return OpenNameIndex(index, nameIndex, nameIndexSize, NULL);
+}
+
+/*
+ * Find the entries whose names contain a word starting with name
+ * Case is ignored, and name may run on over several words ("free tw").
+ * Names that start with it come first, then the rest, each in entry
+ * order, and the first maxHits are stored in hits.  Returns the number
+ * stored.
+ */
+ULONG QueryNameIndex(const struct NameIndex *index, CONST_STRPTR name, struct NameHit *hits, ULONG maxHits)
+{
+    struct NameHit hit;
+    ULONG first;
+    ULONG last;
+    ULONG found;
+    ULONG place;
+    ULONG slot;
+    ULONG i;
+
+    while (*name == ' ' || *name == '\t') {
+        name++;
+    }
+    if (*name == '\0' || maxHits == 0) {
+        return 0;
+    }
+
+    first = FindPlace(index, name, FALSE);
+    last = FindPlace(index, name, TRUE);
+
+    found = 0;
+    for (place = first; place < last; place++) {
+        ReadPlace(index, place, &hit.entry, &hit.offset);
+
+        /* An entry can match at several words - keep its best place only */
+        i = 0;
+        while (i < found && hits[i].entry != hit.entry) {
+            i++;
+        }
+        if (i < found) {
+            if (!RanksBefore(&hit, &hits[i])) {
+                continue;
+            }
+            memmove(&hits[i], &hits[i + 1], (found - i - 1) * sizeof(struct NameHit));
+            found--;
+        } else if (found == maxHits) {
+            if (!RanksBefore(&hit, &hits[found - 1])) {
+                continue;
+            }
+            found--;
+        }
+
+        slot = found;
+        while (slot > 0 && RanksBefore(&hit, &hits[slot - 1])) {
+            hits[slot] = hits[slot - 1];
+            slot--;
+        }
+        hits[slot] = hit;
+        found++;
+    }
+
+    return found;
+}
+
+/*
+ * Query the active database's index - see QueryNameIndex
+ * Returns 0 if it has none.
+ */
+ULONG FindInsightNames(CONST_STRPTR name, struct NameHit *hits, ULONG maxHits)
+{
+    struct NameIndex index;
+
+    if (!ActiveNameIndex(&index)) {
+        return 0;
+    }
+
+    return QueryNameIndex(&index, name, hits, maxHits);
+}
+
+/*
+ * Read the entry and description offset of an indexed place
+ */
+static VOID ReadPlace(const struct NameIndex *index, ULONG place, ULONG *entry, ULONG *offset)
+{
+    const UBYTE *record;
+
+    record = index->records + place * NAME_RECORD_SIZE;
+    *entry = ((ULONG)record[0] << 8) | (ULONG)record[1];
+    *offset = record[2];
+}
+
+/*
+ * The description of an entry in the index's database
+ */
+static CONST_STRPTR NameText(const struct NameIndex *index, ULONG entry)
+{
+    struct ErrorView view;
+
+    if (index->database != NULL) {
+        IdbEntryView(index->database, entry, &view);
+        return view.description;
+    }
+
+    return errorTable[entry].description;
+}
+
+/*
+ * Binary search for the first place whose text does not start before
+ * name, or with after set, the first that sorts after every text
+ * starting with name
+ */
+static ULONG FindPlace(const struct NameIndex *index, CONST_STRPTR name, BOOL after)
+{
+    ULONG low;
+    ULONG high;
+    ULONG middle;
+    ULONG entry;
+    ULONG offset;
+    int order;
+
+    low = 0;
+    high = index->count;
+    while (low < high) {
+        middle = low + (high - low) / 2;
+        ReadPlace(index, middle, &entry, &offset);
+        order = CompareNameText(NameText(index, entry) + offset, name, TRUE);
+        if (order < 0 || (after && order == 0)) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+
+    return low;
+}
+
+/*
+ * Whether a hit ranks strictly before another - names that start with
+ * the query first, then entry order
+ */
+static BOOL RanksBefore(const struct NameHit *a, const struct NameHit *b)
+{
+    if ((a->offset == 0) != (b->offset == 0)) {
+        return (BOOL)(a->offset == 0);
+    }
+
+    return (BOOL)(a->entry < b->entry);
+}
@@ -0,0 +1,93 @@
+/*
+ * Insight Names
+ *
+ * Reverse lookup from an alert's name to its code.  gentables builds a
+ * sorted index of every place a word starts in the descriptions, so a
+ * query finds the names containing a word that begins with it by binary
+ * search, as fast as it is typed.  Like the SEARCH index it is stored as
+ * big-endian bytes, compiled in and carried in .idb files.
+ *
+ * After meditiation comes... Insight
+ *
+ * Copyright (c) 2025-26 amigazen project
+ * Licensed under BSD 2-Clause License
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef NAMES_H
+#define NAMES_H
+
+#include "platform.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct InsightDatabase;
+
+/*
+ * Index layout - a header of ULONGs, then one record per indexed place:
+ *   size, entry count, place count
+ *   per place: entry (UWORD), offset of a word start in its description (UBYTE)
+ * Places are in the order of the description text from the word on,
+ * compared without regard to case (see name_text.h), then in entry order.
+ */
+#define NAME_HEADER_SIZE 12
+#define NAME_RECORD_SIZE 3
+
+/* Results TOP asks for when it is not given */
+#define NAME_TOP_DEFAULT 10
+
+/* Index view - the descriptions come from database, or errorTable if it is NULL */
+struct NameIndex {
+    const UBYTE *data;
+    ULONG size;
+    ULONG entryCount;
+    ULONG count;
+    const UBYTE *records;
+    const struct InsightDatabase *database;
+};
+
+/* One matching entry */
+struct NameHit {
+    ULONG entry;        /* Database entry index */
+    ULONG offset;       /* Where in the description the match starts, 0 if it starts the name */
+};
+
+/* Generated index - see gentables.c */
+extern const ULONG nameIndexSize;
+extern const UBYTE nameIndex[];
+
+/* Function declarations */
+BOOL OpenNameIndex(struct NameIndex *index, const UBYTE *data, ULONG size, const struct InsightDatabase *database);
+BOOL CheckNameIndex(const struct NameIndex *index);
+BOOL ActiveNameIndex(struct NameIndex *index);
+ULONG QueryNameIndex(const struct NameIndex *index, CONST_STRPTR name, struct NameHit *hits, ULONG maxHits);
+ULONG FindInsightNames(CONST_STRPTR name, struct NameHit *hits, ULONG maxHits);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* NAMES_H */
@@ -0,0 +1,362 @@
+/*
+ * Insight Nearest Codes
+ *
+ * Codes are compared four bits at a time.  The XOR of two codes is folded
+ * so that each differing digit, and each pair of swapped neighbours,
+ * leaves one bit, and the bits are summed to bound the distance without
+ * a loop.  On x86 this runs over four codes per SSE2 register, or eight
+ * per AVX2 register, straight from the packed code column - the
+ * compiled-in packedCodes or the codes section of a .idb file.  Only the
+ * codes within the bound are scored exactly and ranked.
+ *
+ * After meditiation comes... Insight
+ *
+ * Copyright (c) 2025-26 amigazen project
+ * Licensed under BSD 2-Clause License
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <stddef.h>
+#include "platform.h"
+#include "lookup.h"
+#include "idb.h"
+#include "nearest.h"
+
+#if defined(INSIGHT_NO_SIMD)
+/* Scalar build - the vector paths are checked against it */
+#elif defined(__AVX2__)
+#include <immintrin.h>
+#define NEAR_CODES_PER_STEP 8
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#define NEAR_CODES_PER_STEP 4
+#endif
+
+/* One query in progress */
+struct NearSearch {
+    ULONG code;
+    ULONG maxDigits;
+    struct NearMatch *matches;
+    ULONG maxMatches;
+    ULONG found;
+};
+
+/* Forward declarations */
+static ULONG DigitBound(ULONG a, ULONG b, BOOL *exact);
+static VOID ConsiderCode(struct NearSearch *search, ULONG entry, ULONG code);
+static BOOL NearerThan(const struct NearMatch *a, const struct NearMatch *b);
+
+/*
+ * Number of hex digits that must change to turn one code into the other
+ * A swap of two neighbouring digits counts as one change, so 81000005
+ * is one from 81000050 and two from 81000500.
+ */
+ULONG HexDigitDistance(ULONG a, ULONG b)
+{
+    ULONG distance;
+    LONG shift;
+    ULONG digitA;
+    ULONG digitB;
+    BOOL exact;
+
+    distance = DigitBound(a, b, &exact);
+    if (exact) {
+        return distance;
+    }
+
+    /* Pair off swapped neighbours from the top digit down - taking the first pair found is optimal */
+    distance = 0;
+    shift = 28;
+    while (shift >= 0) {
+        digitA = (a >> shift) & 0x0F;
+        digitB = (b >> shift) & 0x0F;
+        if (digitA != digitB) {
+            distance++;
+            if (shift >= 4 &&
+                digitA == ((b >> (shift - 4)) & 0x0F) &&
+                digitB == ((a >> (shift - 4)) & 0x0F)) {
+                shift -= 4;
+            }
+        }
+        shift -= 4;
+    }
+
+    return distance;
+}
+
+/*
+ * Number of bits that differ between two codes
+ */
+ULONG CodeBitDistance(ULONG a, ULONG b)
+{
+    ULONG x;
+
+    x = a ^ b;
+    x = x - ((x >> 1) & 0x55555555UL);
+    x = (x & 0x33333333UL) + ((x >> 2) & 0x33333333UL);
+    x = (x + (x >> 4)) & 0x0F0F0F0FUL;
+    x = x + (x >> 8);
+    x = x + (x >> 16);
+
+    return x & 0x3F;
+}
+
+/*
+ * Find the database codes closest to one that may be mistyped or corrupt
+ * Codes within maxDigits of code by HexDigitDistance are ranked by that
+ * distance, then by CodeBitDistance, then in code order, and the first
+ * maxMatches are stored in matches.  The code itself comes first if it
+ * is known.  Searches the active database.  Returns the number stored.
+ */
+ULONG FindNearestCodes(ULONG code, ULONG maxDigits, struct NearMatch *matches, ULONG maxMatches)
+{
+    struct InsightDatabase *database;
+    struct NearSearch search;
+    const UBYTE *column;
+    ULONG count;
+    ULONG candidate;
+    ULONG i;
+    BOOL exact;
+#if defined(NEAR_CODES_PER_STEP)
+    ULONG mask;
+    ULONG k;
+#endif
+
+    if (maxMatches == 0) {
+        return 0;
+    }
+
+    search.code = code;
+    search.maxDigits = maxDigits;
+    search.matches = matches;
+    search.maxMatches = maxMatches;
+    search.found = 0;
+
+    /* .idb codes are big-endian, the compiled-in ones native */
+    database = ActiveInsightDatabase();
+    if (database != NULL) {
+        column = database->codes;
+        count = database->entryCount;
+    } else {
+        column = (const UBYTE *)packedCodes;
+        count = lookupTableSize;
+    }
+
+    i = 0;
+
+#if defined(NEAR_CODES_PER_STEP) && NEAR_CODES_PER_STEP == 8
+    {
+        __m256i key;
+        __m256i keyShifted;
+        __m256i bound;
+        __m256i lowBits;
+        __m256i pairBits;
+        __m256i byteMask;
+        __m256i codes;
+        __m256i differ;
+        __m256i swapped;
+        __m256i x;
+
+        key = _mm256_set1_epi32((int)code);
+        keyShifted = _mm256_set1_epi32((int)(code >> 4));
+        bound = _mm256_set1_epi32((int)maxDigits + 1);
+        lowBits = _mm256_set1_epi32(0x11111111);
+        pairBits = _mm256_set1_epi32(0x01111111);
+        byteMask = _mm256_set1_epi32(0x0000FF00);
+        for (; i + 8 <= count; i += 8) {
+            codes = _mm256_loadu_si256((const __m256i *)(column + i * 4));
+            if (database != NULL) {
+                codes = _mm256_or_si256(_mm256_or_si256(_mm256_slli_epi32(codes, 24), _mm256_srli_epi32(codes, 24)),
+                                        _mm256_or_si256(_mm256_slli_epi32(_mm256_and_si256(codes, byteMask), 8),
+                                                        _mm256_and_si256(_mm256_srli_epi32(codes, 8), byteMask)));
+            }
+
+            /* One bit per differing digit, and per neighbouring pair that is swapped */
+            x = _mm256_xor_si256(codes, key);
+            x = _mm256_or_si256(x, _mm256_srli_epi32(x, 1));
+            differ = _mm256_and_si256(_mm256_or_si256(x, _mm256_srli_epi32(x, 2)), lowBits);
+            x = _mm256_or_si256(_mm256_xor_si256(key, _mm256_srli_epi32(codes, 4)),
+                                _mm256_xor_si256(keyShifted, codes));
+            x = _mm256_or_si256(x, _mm256_srli_epi32(x, 1));
+            swapped = _mm256_andnot_si256(_mm256_or_si256(x, _mm256_srli_epi32(x, 2)),
+                                          _mm256_and_si256(differ, pairBits));
+
+            /* Digits less swaps is at most the distance - sum the bits left */
+            x = _mm256_xor_si256(differ, swapped);
+            x = _mm256_add_epi32(x, _mm256_srli_epi32(x, 4));
+            x = _mm256_add_epi32(x, _mm256_srli_epi32(x, 8));
+            x = _mm256_add_epi32(x, _mm256_srli_epi32(x, 16));
+            x = _mm256_and_si256(x, _mm256_set1_epi32(0x0F));
+            mask = (ULONG)_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(bound, x)));
+            for (k = 0; mask != 0; k++, mask >>= 1) {
+                if (mask & 1) {
+                    candidate = (database != NULL) ? IdbGetLong(column + (i + k) * 4) : packedCodes[i + k];
+                    ConsiderCode(&search, i + k, candidate);
+                }
+            }
+        }
+    }
+#elif defined(NEAR_CODES_PER_STEP) && NEAR_CODES_PER_STEP == 4
+    {
+        __m128i key;
+        __m128i keyShifted;
+        __m128i bound;
+        __m128i lowBits;
+        __m128i pairBits;
+        __m128i byteMask;
+        __m128i codes;
+        __m128i differ;
+        __m128i swapped;
+        __m128i x;
+
+        key = _mm_set1_epi32((int)code);
+        keyShifted = _mm_set1_epi32((int)(code >> 4));
+        bound = _mm_set1_epi32((int)maxDigits + 1);
+        lowBits = _mm_set1_epi32(0x11111111);
+        pairBits = _mm_set1_epi32(0x01111111);
+        byteMask = _mm_set1_epi32(0x0000FF00);
+        for (; i + 4 <= count; i += 4) {
+            codes = _mm_loadu_si128((const __m128i *)(column + i * 4));
+            if (database != NULL) {
+                codes = _mm_or_si128(_mm_or_si128(_mm_slli_epi32(codes, 24), _mm_srli_epi32(codes, 24)),
+                                     _mm_or_si128(_mm_slli_epi32(_mm_and_si128(codes, byteMask), 8),
+                                                  _mm_and_si128(_mm_srli_epi32(codes, 8), byteMask)));
+            }
+
+            /* One bit per differing digit, and per neighbouring pair that is swapped */
+            x = _mm_xor_si128(codes, key);
+            x = _mm_or_si128(x, _mm_srli_epi32(x, 1));
+            differ = _mm_and_si128(_mm_or_si128(x, _mm_srli_epi32(x, 2)), lowBits);
+            x = _mm_or_si128(_mm_xor_si128(key, _mm_srli_epi32(codes, 4)), _mm_xor_si128(keyShifted, codes));
+            x = _mm_or_si128(x, _mm_srli_epi32(x, 1));
+            swapped = _mm_andnot_si128(_mm_or_si128(x, _mm_srli_epi32(x, 2)), _mm_and_si128(differ, pairBits));
+
+            /* Digits less swaps is at most the distance - sum the bits left */
+            x = _mm_xor_si128(differ, swapped);
+            x = _mm_add_epi32(x, _mm_srli_epi32(x, 4));
+            x = _mm_add_epi32(x, _mm_srli_epi32(x, 8));
+            x = _mm_add_epi32(x, _mm_srli_epi32(x, 16));
+            x = _mm_and_si128(x, _mm_set1_epi32(0x0F));
+            mask = (ULONG)_mm_movemask_ps(_mm_castsi128_ps(_mm_cmplt_epi32(x, bound)));
+            for (k = 0; mask != 0; k++, mask >>= 1) {
+                if (mask & 1) {
+                    candidate = (database != NULL) ? IdbGetLong(column + (i + k) * 4) : packedCodes[i + k];
+                    ConsiderCode(&search, i + k, candidate);
+                }
+            }
+        }
+    }
+#endif
+
+    /* Scalar loop for the remaining codes, or all of them */
+    for (; i < count; i++) {
+        candidate = (database != NULL) ? IdbGetLong(column + i * 4) : packedCodes[i];
+        if (DigitBound(code, candidate, &exact) <= maxDigits) {
+            ConsiderCode(&search, i, candidate);
+        }
+    }
+
+    return search.found;
+}
+
+/*
+ * A lower bound on HexDigitDistance, without a loop
+ * Each digit is folded into its low bit to mark the digits that differ
+ * and the neighbours that are swapped.  A swap can fix two digits, so
+ * the distance is at least the differing digits less the swaps.  Bits
+ * are summed into the bottom digit - at most 8, so nothing carries.
+ * exact is set unless two swaps share a digit, when only one can be made.
+ */
+static ULONG DigitBound(ULONG a, ULONG b, BOOL *exact)
+{
+    ULONG differ;
+    ULONG swapped;
+    ULONG x;
+
+    x = a ^ b;
+    x |= x >> 1;
+    differ = (x | (x >> 2)) & 0x11111111UL;
+    x = (a ^ (b >> 4)) | ((a >> 4) ^ b);
+    x |= x >> 1;
+    swapped = ~(x | (x >> 2)) & differ & 0x01111111UL;
+    *exact = (BOOL)((swapped & (swapped >> 4)) == 0);
+
+    x = differ ^ swapped;
+    x += x >> 4;
+    x += x >> 8;
+    x += x >> 16;
+
+    return x & 0x0F;
+}
+
+/*
+ * Score a code that passed the digit bound and keep it if it ranks
+ * Codes arrive in ascending order, so a tie keeps the code already held.
+ */
+static VOID ConsiderCode(struct NearSearch *search, ULONG entry, ULONG code)
+{
+    struct NearMatch match;
+    ULONG digits;
+    ULONG slot;
+
+    digits = HexDigitDistance(search->code, code);
+    if (digits > search->maxDigits) {
+        return;
+    }
+    if (search->found == search->maxMatches && digits > search->matches[search->found - 1].digits) {
+        return;
+    }
+
+    match.entry = entry;
+    match.code = code;
+    match.digits = (UWORD)digits;
+    match.bits = (UWORD)CodeBitDistance(search->code, code);
+
+    if (search->found == search->maxMatches) {
+        if (!NearerThan(&match, &search->matches[search->found - 1])) {
+            return;
+        }
+        search->found--;
+    }
+
+    slot = search->found;
+    while (slot > 0 && NearerThan(&match, &search->matches[slot - 1])) {
+        search->matches[slot] = search->matches[slot - 1];
+        slot--;
+    }
+    search->matches[slot] = match;
+    search->found++;
+}
+
+/*
+ * Whether a match ranks strictly before another
+ */
+static BOOL NearerThan(const struct NearMatch *a, const struct NearMatch *b)
+{
+    if (a->digits != b->digits) {
+        return (BOOL)(a->digits < b->digits);
+    }
+
+    return (BOOL)(a->bits < b->bits);
+}
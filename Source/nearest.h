@@ -0,0 +1,73 @@
+/*
+ * Insight Nearest Codes
+ *
+ * Closest known codes for a code that is not in the database.  A code
+ * copied by hand from a frozen screen usually has a digit misread or two
+ * digits swapped, and one read from a failing memory cell has a few bits
+ * flipped.  Every database code is scored against it by hex digit edit
+ * distance and by bit distance, and the closest are returned.
+ *
+ * After meditiation comes... Insight
+ *
+ * Copyright (c) 2025-26 amigazen project
+ * Licensed under BSD 2-Clause License
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef NEAREST_H
+#define NEAREST_H
+
+#include "platform.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Largest digit distance a match may have */
+#define NEAR_MAX_DIGITS 2
+
+/* Matches NEAR asks for when TOP is not given */
+#define NEAR_TOP_DEFAULT 5
+
+/* Matches listed under an unknown ERROR code */
+#define NEAR_HINTS 3
+
+/* One known code close to the one asked for */
+struct NearMatch {
+    ULONG entry;        /* Database entry index */
+    ULONG code;
+    UWORD digits;       /* Hex digits changed, a swap of two neighbours counting once */
+    UWORD bits;         /* Bits that differ */
+};
+
+/* Function declarations */
+ULONG HexDigitDistance(ULONG a, ULONG b);
+ULONG CodeBitDistance(ULONG a, ULONG b);
+ULONG FindNearestCodes(ULONG code, ULONG maxDigits, struct NearMatch *matches, ULONG maxMatches);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* NEAREST_H */
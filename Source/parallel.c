@@ -0,0 +1,582 @@
+/*
+ * Parallel Batch Decoding
+ *
+ * The calling thread reads the input and writes the output; worker threads
+ * only decode.  Each chunk is a run of whole lines read into its own
+ * buffer, decoded by DecodeBatchText into a memory BatchWriter and written
+ * out once every earlier chunk has been.  Chunks are dealt round robin to
+ * per-worker queues; a worker with an empty queue steals from the next
+ * busy one.  At most PARALLEL_CHUNKS_PER_THREAD chunks per worker are in
+ * flight, and their buffers are reused for the whole run.  When
+ * summarising, each worker counts into its own AlertSummary instead and
+ * the caller merges them once the workers have finished.
+ *
+ * After meditiation comes... Insight
+ *
+ * Copyright (c) 2025-26 amigazen project
+ * Licensed under BSD 2-Clause License
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <unistd.h>
+#include "summary.h"
+#include "batch.h"
+#include "parallel.h"
+
+/* A run of whole input lines and the records decoded from it */
+struct BatchChunk {
+    char *text;
+    ULONG length;
+    ULONG capacity;
+    ULONG overlong;                 /* Bytes at the start of text cut from a line too long to be a code */
+    BOOL done;                      /* Decoded - guarded by the pool lock */
+    struct BatchWriter writer;      /* Memory writer holding the records */
+    struct BatchStats stats;
+};
+
+/* A worker's own queue of chunks, which idle workers steal from */
+struct WorkQueue {
+    pthread_mutex_t lock;
+    struct BatchChunk **slots;      /* Ring of window entries */
+    ULONG head;
+    ULONG count;
+};
+
+/* State shared by the reader and the workers */
+struct DecodePool {
+    pthread_mutex_t lock;
+    pthread_cond_t workReady;       /* A chunk was queued or the input ended */
+    pthread_cond_t chunkDone;       /* A worker finished a chunk */
+    ULONG queued;                   /* Chunks queued and not yet taken */
+    BOOL finished;                  /* No more chunks will be queued */
+    ULONG threads;
+    ULONG window;                   /* Chunks in flight at most */
+    struct WorkQueue *queues;
+    struct AlertSummary **partials; /* Each worker's counts when summarising, else NULL */
+};
+
+/* What each worker thread is started with */
+struct WorkerStart {
+    struct DecodePool *pool;
+    ULONG id;
+};
+
+/* Forward declarations */
+static BOOL RunParallelBatch(FILE *input, FILE *output, ULONG format, ULONG threads,
+                             struct AlertSummary *summary, struct BatchStats *stats);
+static VOID *DecodeWorker(VOID *argument);
+static struct BatchChunk *TakeChunk(struct DecodePool *pool, ULONG id);
+static VOID QueueChunk(struct DecodePool *pool, ULONG id, struct BatchChunk *chunk);
+static BOOL ReadChunk(struct BatchChunk *chunk, FILE *input, char **carry, ULONG *carryLength,
+                      BOOL *skipping, BOOL *endOfInput);
+static BOOL WriteChunk(struct DecodePool *pool, struct BatchChunk *chunk, FILE *output, struct BatchStats *stats);
+static BOOL GrowChunk(struct BatchChunk *chunk, ULONG needed);
+
+/*
+ * Number of decoding threads to use when none is given - one per CPU
+ */
+ULONG ParallelThreadCount(VOID)
+{
+    long count;
+
+    count = sysconf(_SC_NPROCESSORS_ONLN);
+    if (count < 1) {
+        return 1;
+    }
+    if (count > PARALLEL_MAX_THREADS) {
+        return PARALLEL_MAX_THREADS;
+    }
+
+    return (ULONG)count;
+}
+
+/*
+ * Decode every line of input on a pool of threads
+ * threads 0 means ParallelThreadCount(); one thread is plain DecodeBatch.
+ * The records and stats are the same as DecodeBatch gives.
+ */
+BOOL ParallelDecodeBatch(FILE *input, FILE *output, ULONG format, ULONG threads, struct BatchStats *stats)
+{
+    return RunParallelBatch(input, output, format, threads, NULL, stats);
+}
+
+/*
+ * Count every line of input in a summary on a pool of threads
+ * Each worker counts into its own summary and they are merged into
+ * summary at the end, adding to what it already holds.  The subsystem
+ * counts are exact; once more distinct codes than SUMMARY_SLOTS are seen
+ * the heavy hitter counts depend on how the chunks fell to the workers,
+ * but stay within the same bounds as SummarizeBatch.
+ */
+BOOL ParallelSummarizeBatch(FILE *input, ULONG threads, struct AlertSummary *summary, struct BatchStats *stats)
+{
+    return RunParallelBatch(input, NULL, BATCH_FORMAT_TSV, threads, summary, stats);
+}
+
+/*
+ * Decode every line of input on a pool of threads, writing records to
+ * output, or counting them in summary when it is set
+ */
+static BOOL RunParallelBatch(FILE *input, FILE *output, ULONG format, ULONG threads,
+                             struct AlertSummary *summary, struct BatchStats *stats)
+{
+    struct DecodePool pool;
+    struct BatchChunk *chunks;
+    struct WorkerStart *starts;
+    pthread_t *workers;
+    char *carry;
+    ULONG carryLength;
+    ULONG started;
+    ULONG nextRead;
+    ULONG nextWrite;
+    ULONG i;
+    BOOL skipping;
+    BOOL endOfInput;
+    BOOL poolReady;
+    BOOL success;
+
+    if (threads == 0) {
+        threads = ParallelThreadCount();
+    }
+    if (threads > PARALLEL_MAX_THREADS) {
+        threads = PARALLEL_MAX_THREADS;
+    }
+    if (threads <= 1 || format >= BATCH_FORMATS) {
+        return (summary != NULL) ? SummarizeBatch(input, summary, stats) : DecodeBatch(input, output, format, stats);
+    }
+
+    memset(stats, 0, sizeof(struct BatchStats));
+    memset(&pool, 0, sizeof(pool));
+    pool.threads = threads;
+    pool.window = threads * PARALLEL_CHUNKS_PER_THREAD;
+
+    chunks = (struct BatchChunk *)calloc(pool.window, sizeof(struct BatchChunk));
+    pool.queues = (struct WorkQueue *)calloc(threads, sizeof(struct WorkQueue));
+    starts = (struct WorkerStart *)calloc(threads, sizeof(struct WorkerStart));
+    workers = (pthread_t *)calloc(threads, sizeof(pthread_t));
+    carry = NULL;
+    success = (chunks != NULL && pool.queues != NULL && starts != NULL && workers != NULL);
+
+    for (i = 0; success && i < pool.window; i++) {
+        chunks[i].text = (char *)malloc(BATCH_BUFFER_SIZE);
+        chunks[i].capacity = BATCH_BUFFER_SIZE;
+        if (chunks[i].text == NULL || !OpenBatchWriter(&chunks[i].writer, NULL, format)) {
+            success = FALSE;
+        }
+    }
+    if (success && summary != NULL) {
+        pool.partials = (struct AlertSummary **)calloc(threads, sizeof(struct AlertSummary *));
+        success = (pool.partials != NULL);
+        for (i = 0; success && i < threads; i++) {
+            pool.partials[i] = AllocAlertSummary();
+            if (pool.partials[i] == NULL) {
+                success = FALSE;
+            }
+        }
+    }
+    for (i = 0; success && i < threads; i++) {
+        pool.queues[i].slots = (struct BatchChunk **)malloc(pool.window * sizeof(struct BatchChunk *));
+        if (pool.queues[i].slots == NULL) {
+            success = FALSE;
+        }
+    }
+
+    started = 0;
+    poolReady = success;
+    if (poolReady) {
+        pthread_mutex_init(&pool.lock, NULL);
+        pthread_cond_init(&pool.workReady, NULL);
+        pthread_cond_init(&pool.chunkDone, NULL);
+        for (i = 0; i < threads; i++) {
+            pthread_mutex_init(&pool.queues[i].lock, NULL);
+        }
+
+        for (i = 0; i < threads; i++) {
+            starts[i].pool = &pool;
+            starts[i].id = i;
+            if (pthread_create(&workers[i], NULL, DecodeWorker, &starts[i]) != 0) {
+                break;
+            }
+            started++;
+        }
+    }
+
+    if (started > 0) {
+        /* Workers that failed to start still own a queue - deal only to the others */
+        carryLength = 0;
+        nextRead = 0;
+        nextWrite = 0;
+        skipping = FALSE;
+        endOfInput = FALSE;
+
+        while (!endOfInput) {
+            if (nextRead - nextWrite == pool.window) {
+                /* Window full - the oldest chunk's buffers are needed again */
+                if (!WriteChunk(&pool, &chunks[nextWrite % pool.window], output, stats)) {
+                    success = FALSE;
+                }
+                nextWrite++;
+            }
+
+            if (!ReadChunk(&chunks[nextRead % pool.window], input, &carry, &carryLength, &skipping, &endOfInput)) {
+                success = FALSE;
+                break;
+            }
+            if (chunks[nextRead % pool.window].length > 0) {
+                QueueChunk(&pool, nextRead % started, &chunks[nextRead % pool.window]);
+                nextRead++;
+            }
+        }
+
+        pthread_mutex_lock(&pool.lock);
+        pool.finished = TRUE;
+        pthread_cond_broadcast(&pool.workReady);
+        pthread_mutex_unlock(&pool.lock);
+
+        while (nextWrite < nextRead) {
+            if (!WriteChunk(&pool, &chunks[nextWrite % pool.window], output, stats)) {
+                success = FALSE;
+            }
+            nextWrite++;
+        }
+
+        for (i = 0; i < started; i++) {
+            pthread_join(workers[i], NULL);
+        }
+
+        for (i = 0; summary != NULL && i < started; i++) {
+            if (!MergeAlertSummary(summary, pool.partials[i])) {
+                success = FALSE;
+            }
+        }
+        if (output != NULL && fflush(output) != 0) {
+            success = FALSE;
+        }
+    }
+
+    if (success && started == 0) {
+        /* No threads at all - nothing has been read yet, so decode here */
+        success = (summary != NULL) ? SummarizeBatch(input, summary, stats)
+                                    : DecodeBatch(input, output, format, stats);
+    } else if (started == 0) {
+        success = FALSE;
+    }
+
+    if (poolReady) {
+        for (i = 0; i < threads; i++) {
+            pthread_mutex_destroy(&pool.queues[i].lock);
+        }
+        pthread_cond_destroy(&pool.chunkDone);
+        pthread_cond_destroy(&pool.workReady);
+        pthread_mutex_destroy(&pool.lock);
+    }
+    for (i = 0; chunks != NULL && i < pool.window; i++) {
+        free(chunks[i].text);
+        free(chunks[i].writer.buffer);
+    }
+    for (i = 0; pool.queues != NULL && i < threads; i++) {
+        free(pool.queues[i].slots);
+    }
+    for (i = 0; pool.partials != NULL && i < threads; i++) {
+        FreeAlertSummary(pool.partials[i]);
+    }
+    free(carry);
+    free(chunks);
+    free(pool.queues);
+    free(pool.partials);
+    free(starts);
+    free(workers);
+
+    return success;
+}
+
+/*
+ * Worker thread - decode chunks until the input has ended and every
+ * queue is empty
+ */
+static VOID *DecodeWorker(VOID *argument)
+{
+    struct WorkerStart *start;
+    struct DecodePool *pool;
+    struct BatchChunk *chunk;
+    BOOL finished;
+
+    start = (struct WorkerStart *)argument;
+    pool = start->pool;
+
+    for (;;) {
+        chunk = TakeChunk(pool, start->id);
+        if (chunk == NULL) {
+            pthread_mutex_lock(&pool->lock);
+            while (pool->queued == 0 && !pool->finished) {
+                pthread_cond_wait(&pool->workReady, &pool->lock);
+            }
+            finished = (pool->queued == 0 && pool->finished);
+            pthread_mutex_unlock(&pool->lock);
+            if (finished) {
+                break;
+            }
+            continue;
+        }
+
+        chunk->writer.used = 0;
+        chunk->writer.summary = (pool->partials != NULL) ? pool->partials[start->id] : NULL;
+        memset(&chunk->stats, 0, sizeof(struct BatchStats));
+        if (chunk->overlong > 0) {
+            WriteOverlongRecord(&chunk->writer, chunk->text, chunk->overlong, &chunk->stats);
+        }
+        DecodeBatchText(&chunk->writer, chunk->text + chunk->overlong, chunk->length - chunk->overlong, &chunk->stats);
+
+        pthread_mutex_lock(&pool->lock);
+        chunk->done = TRUE;
+        pthread_cond_signal(&pool->chunkDone);
+        pthread_mutex_unlock(&pool->lock);
+    }
+
+    return NULL;
+}
+
+/*
+ * Take the oldest chunk from a worker's own queue, or failing that steal
+ * the oldest from the next queue that has one
+ * Returns NULL if every queue is empty
+ */
+static struct BatchChunk *TakeChunk(struct DecodePool *pool, ULONG id)
+{
+    struct WorkQueue *queue;
+    struct BatchChunk *chunk;
+    ULONG i;
+
+    chunk = NULL;
+    for (i = 0; chunk == NULL && i < pool->threads; i++) {
+        queue = &pool->queues[(id + i) % pool->threads];
+
+        pthread_mutex_lock(&queue->lock);
+        if (queue->count > 0) {
+            chunk = queue->slots[queue->head];
+            queue->head = (queue->head + 1) % pool->window;
+            queue->count--;
+        }
+        pthread_mutex_unlock(&queue->lock);
+    }
+
+    if (chunk != NULL) {
+        pthread_mutex_lock(&pool->lock);
+        pool->queued--;
+        pthread_mutex_unlock(&pool->lock);
+    }
+
+    return chunk;
+}
+
+/*
+ * Hand a chunk to a worker's queue and wake a sleeping worker
+ * queued is raised first so it never undercounts the queues
+ */
+static VOID QueueChunk(struct DecodePool *pool, ULONG id, struct BatchChunk *chunk)
+{
+    struct WorkQueue *queue;
+
+    chunk->done = FALSE;
+
+    pthread_mutex_lock(&pool->lock);
+    pool->queued++;
+    pthread_mutex_unlock(&pool->lock);
+
+    queue = &pool->queues[id];
+    pthread_mutex_lock(&queue->lock);
+    queue->slots[(queue->head + queue->count) % pool->window] = chunk;
+    queue->count++;
+    pthread_mutex_unlock(&queue->lock);
+
+    pthread_mutex_lock(&pool->lock);
+    pthread_cond_signal(&pool->workReady);
+    pthread_mutex_unlock(&pool->lock);
+}
+
+/*
+ * Fill a chunk with whole lines
+ * Starts with the partial line left by the previous chunk and reads a
+ * block behind it; the partial line at the end is kept back in carry.
+ * A line of a block or more is cut to its first block, to be reported
+ * as invalid, and the rest of it is skipped - as DecodeBatch does - so
+ * the chunk never grows past a block more than the carry.  At the end
+ * of input the chunk takes everything left.  Returns FALSE on a read or
+ * allocation error.
+ */
+static BOOL ReadChunk(struct BatchChunk *chunk, FILE *input, char **carry, ULONG *carryLength,
+                      BOOL *skipping, BOOL *endOfInput)
+{
+    char *saved;
+    char *newline;
+    ULONG size;
+    ULONG wanted;
+    ULONG got;
+    ULONG last;
+    ULONG blank;
+
+    /* A reused chunk may hold more - it is only filled to this */
+    size = *carryLength + BATCH_BUFFER_SIZE;
+    if (!GrowChunk(chunk, size)) {
+        return FALSE;
+    }
+    if (*carryLength > 0) {
+        memcpy(chunk->text, *carry, *carryLength);
+    }
+    chunk->length = *carryLength;
+    chunk->overlong = 0;
+    *carryLength = 0;
+
+    for (;;) {
+        wanted = size - chunk->length;
+        got = (ULONG)fread(chunk->text + chunk->length, 1, wanted, input);
+
+        if (got < wanted) {
+            /* fread only comes up short at the end of input or on an error */
+            *endOfInput = TRUE;
+            if (ferror(input)) {
+                return FALSE;
+            }
+        }
+
+        if (*skipping) {
+            /* Tail of an overlong line that was already reported */
+            newline = (char *)memchr(chunk->text + chunk->length, '\n', got);
+            if (newline != NULL) {
+                got -= (ULONG)(newline - (chunk->text + chunk->length)) + 1;
+                memmove(chunk->text + chunk->length, newline + 1, got);
+                *skipping = FALSE;
+            } else {
+                got = 0;
+            }
+        }
+        chunk->length += got;
+
+        if (*endOfInput || chunk->length == size) {
+            break;
+        }
+    }
+
+    /*
+     * The carry is shorter than a block, so only the first line can be a
+     * block or more long.  An all blank block of it is just dropped.
+     */
+    while (chunk->length >= BATCH_BUFFER_SIZE && memchr(chunk->text, '\n', BATCH_BUFFER_SIZE) == NULL) {
+        blank = 0;
+        while (blank < BATCH_BUFFER_SIZE && (chunk->text[blank] == ' ' || chunk->text[blank] == '\t')) {
+            blank++;
+        }
+        if (blank < BATCH_BUFFER_SIZE) {
+            chunk->overlong = BATCH_BUFFER_SIZE;
+            newline = (char *)memchr(chunk->text + BATCH_BUFFER_SIZE, '\n', chunk->length - BATCH_BUFFER_SIZE);
+            if (newline != NULL) {
+                /* The lines after it follow the cut block */
+                chunk->length -= (ULONG)(newline + 1 - chunk->text);
+                memmove(chunk->text + BATCH_BUFFER_SIZE, newline + 1, chunk->length);
+                chunk->length += BATCH_BUFFER_SIZE;
+            } else {
+                chunk->length = BATCH_BUFFER_SIZE;
+                *skipping = !*endOfInput;
+            }
+            break;
+        }
+
+        chunk->length -= BATCH_BUFFER_SIZE;
+        memmove(chunk->text, chunk->text + BATCH_BUFFER_SIZE, chunk->length);
+    }
+
+    if (*endOfInput) {
+        return TRUE;
+    }
+
+    last = chunk->length;
+    while (last > chunk->overlong && chunk->text[last - 1] != '\n') {
+        last--;
+    }
+    if (last < chunk->length) {
+        saved = (char *)realloc(*carry, chunk->length - last);
+        if (saved == NULL) {
+            return FALSE;
+        }
+        *carry = saved;
+        *carryLength = chunk->length - last;
+        memcpy(*carry, chunk->text + last, *carryLength);
+        chunk->length = last;
+    }
+
+    return TRUE;
+}
+
+/*
+ * Wait for a chunk to be decoded, write its records and add its totals
+ * Returns FALSE if decoding ran out of memory or the write failed
+ */
+static BOOL WriteChunk(struct DecodePool *pool, struct BatchChunk *chunk, FILE *output, struct BatchStats *stats)
+{
+    pthread_mutex_lock(&pool->lock);
+    while (!chunk->done) {
+        pthread_cond_wait(&pool->chunkDone, &pool->lock);
+    }
+    pthread_mutex_unlock(&pool->lock);
+
+    stats->lines += chunk->stats.lines;
+    stats->exact += chunk->stats.exact;
+    stats->decoded += chunk->stats.decoded;
+    stats->invalid += chunk->stats.invalid;
+
+    if (chunk->writer.failed) {
+        return FALSE;
+    }
+    if (chunk->writer.used > 0 && fwrite(chunk->writer.buffer, 1, chunk->writer.used, output) != chunk->writer.used) {
+        return FALSE;
+    }
+
+    return TRUE;
+}
+
+/*
+ * Make a chunk's text buffer hold at least needed bytes
+ */
+static BOOL GrowChunk(struct BatchChunk *chunk, ULONG needed)
+{
+    char *text;
+
+    if (chunk->capacity >= needed) {
+        return TRUE;
+    }
+
+    text = (char *)realloc(chunk->text, needed);
+    if (text == NULL) {
+        return FALSE;
+    }
+
+    chunk->text = text;
+    chunk->capacity = needed;
+
+    return TRUE;
+}
@@ -0,0 +1,65 @@
+/*
+ * Parallel Batch Decoding
+ *
+ * Decodes large batch inputs on several threads.  The input is cut into
+ * chunks of whole lines that a pool of workers decodes, each worker taking
+ * from its own queue and stealing from the others when it runs dry.  The
+ * records of each chunk are written out in input order, so the output is
+ * the same as DecodeBatch.  Host builds only - it needs POSIX threads.
+ *
+ * After meditiation comes... Insight
+ *
+ * Copyright (c) 2025-26 amigazen project
+ * Licensed under BSD 2-Clause License
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef PARALLEL_H
+#define PARALLEL_H
+
+#include <stdio.h>
+#include "platform.h"
+#include "summary.h"
+#include "batch.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Most decoding threads one batch uses */
+#define PARALLEL_MAX_THREADS 256
+
+/* Chunks in flight per thread - bounds the output held for reordering */
+#define PARALLEL_CHUNKS_PER_THREAD 4
+
+/* Function declarations */
+ULONG ParallelThreadCount(VOID);
+BOOL ParallelDecodeBatch(FILE *input, FILE *output, ULONG format, ULONG threads, struct BatchStats *stats);
+BOOL ParallelSummarizeBatch(FILE *input, ULONG threads, struct AlertSummary *summary, struct BatchStats *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* PARALLEL_H */
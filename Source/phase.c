@@ -0,0 +1,270 @@
+/*
+ * Phase Statistics
+ *
+ * A phase is timed from BeginPhase to EndPhase on the stats' clock, in
+ * microseconds.  With no clock given, StartPhaseStats uses the system one:
+ * timer.device's GetSysTime on the Amiga, CLOCK_MONOTONIC on hosts.
+ * Times are 32 bits, so one phase can run for about 71 minutes before its
+ * total stops counting.
+ *
+ * After meditiation comes... Insight
+ *
+ * Copyright (c) 2025-26 amigazen project
+ * Licensed under BSD 2-Clause License
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "platform.h"
+#ifdef INSIGHT_AMIGA
+#include <exec/io.h>
+#include <devices/timer.h>
+#include <proto/exec.h>
+#include <proto/timer.h>
+#else
+#include <time.h>
+#endif
+#include "batch.h"
+#include "phase.h"
+
+/* Saturated time, for phases too long to count in microseconds */
+#define PHASE_TIME_LIMIT 0xFFFFFFFFUL
+
+/* Statistics the core adds to - set with UsePhaseStats */
+struct PhaseStats *activePhaseStats = NULL;
+
+#ifdef INSIGHT_AMIGA
+/* timer.device, opened while StartPhaseStats has the system clock in use */
+struct Device *TimerBase = NULL;
+static struct timerequest timerRequest;
+#endif
+
+/* Phase names, indexed by PHASE_xxx */
+static const CONST_STRPTR phaseNames[PHASE_COUNT] = {
+    "arguments",
+    "libraries",
+    "application",
+    "lastalert",
+    "lookup",
+    "expansion",
+    "wordwrap",
+    "requester",
+    "batch"
+};
+
+/* Forward declarations */
+static VOID SystemClock(struct PhaseTime *now, APTR clockData);
+static ULONG MicrosBetween(const struct PhaseTime *start, const struct PhaseTime *end);
+
+/*
+ * Clear the statistics and start the run's clock
+ * A NULL clock uses the system clock.  Returns FALSE if that cannot be
+ * opened, in which case nothing needs stopping.
+ */
+BOOL StartPhaseStats(struct PhaseStats *stats, PhaseClock clock, APTR clockData)
+{
+    memset(stats, 0, sizeof(*stats));
+
+    if (clock == NULL) {
+#ifdef INSIGHT_AMIGA
+        if (TimerBase == NULL) {
+            if (OpenDevice(TIMERNAME, UNIT_MICROHZ, (struct IORequest *)&timerRequest, 0) != 0) {
+                return FALSE;
+            }
+            TimerBase = timerRequest.tr_node.io_Device;
+        }
+#endif
+        clock = SystemClock;
+        clockData = NULL;
+    }
+
+    stats->clock = clock;
+    stats->clockData = clockData;
+    stats->clock(&stats->origin, stats->clockData);
+
+    return TRUE;
+}
+
+/*
+ * Stop using the statistics, closing the system clock if they had it
+ * The counts stay readable.
+ */
+VOID StopPhaseStats(struct PhaseStats *stats)
+{
+    if (activePhaseStats == stats) {
+        activePhaseStats = NULL;
+    }
+
+#ifdef INSIGHT_AMIGA
+    if (stats->clock == SystemClock && TimerBase != NULL) {
+        CloseDevice((struct IORequest *)&timerRequest);
+        TimerBase = NULL;
+    }
+#endif
+}
+
+/*
+ * Choose the statistics the core times lookup and expansion into
+ * NULL stops it.  The core does not lock them, so only set this around
+ * work on one thread.
+ */
+VOID UsePhaseStats(struct PhaseStats *stats)
+{
+    activePhaseStats = stats;
+}
+
+/*
+ * Note the start of a phase
+ */
+VOID BeginPhase(struct PhaseStats *stats, ULONG phase)
+{
+    if (phase < PHASE_COUNT) {
+        stats->clock(&stats->started[phase], stats->clockData);
+    }
+}
+
+/*
+ * Add the time since BeginPhase, and the work done, to a phase
+ */
+VOID EndPhase(struct PhaseStats *stats, ULONG phase, ULONG items)
+{
+    struct PhaseCounter *counter;
+    struct PhaseTime now;
+    ULONG micros;
+
+    if (phase >= PHASE_COUNT) {
+        return;
+    }
+
+    stats->clock(&now, stats->clockData);
+    micros = MicrosBetween(&stats->started[phase], &now);
+
+    counter = &stats->phases[phase];
+    counter->calls++;
+    counter->micros = (counter->micros > PHASE_TIME_LIMIT - micros) ? PHASE_TIME_LIMIT : counter->micros + micros;
+    if (micros > counter->longest) {
+        counter->longest = micros;
+    }
+    counter->items += items;
+}
+
+/*
+ * Microseconds since StartPhaseStats
+ */
+ULONG PhaseElapsed(const struct PhaseStats *stats)
+{
+    struct PhaseTime now;
+
+    stats->clock(&now, stats->clockData);
+
+    return MicrosBetween(&stats->origin, &now);
+}
+
+/*
+ * Name of a phase, as used in reports
+ */
+CONST_STRPTR PhaseName(ULONG phase)
+{
+    return (phase < PHASE_COUNT) ? phaseNames[phase] : "unknown";
+}
+
+/*
+ * Write every phase and the time since StartPhaseStats
+ * TSV records are "phase <name> <calls> <microseconds> <longest> <items>"
+ * and "elapsed <microseconds>"; JSON gives the same fields by name.
+ * Returns FALSE if the output could not be written.
+ */
+BOOL WritePhaseReport(FILE *output, ULONG format, const struct PhaseStats *stats)
+{
+    const struct PhaseCounter *counter;
+    ULONG phase;
+
+    for (phase = 0; phase < PHASE_COUNT; phase++) {
+        counter = &stats->phases[phase];
+        if (format == BATCH_FORMAT_JSON) {
+            fprintf(output, "{\"stats\":\"phase\",\"phase\":\"%s\",\"calls\":%lu,\"microseconds\":%lu,"
+                            "\"longest\":%lu,\"items\":%lu}\n",
+                    phaseNames[phase], (unsigned long)counter->calls, (unsigned long)counter->micros,
+                    (unsigned long)counter->longest, (unsigned long)counter->items);
+        } else {
+            fprintf(output, "phase\t%s\t%lu\t%lu\t%lu\t%lu\n", phaseNames[phase], (unsigned long)counter->calls,
+                    (unsigned long)counter->micros, (unsigned long)counter->longest, (unsigned long)counter->items);
+        }
+    }
+
+    if (format == BATCH_FORMAT_JSON) {
+        fprintf(output, "{\"stats\":\"elapsed\",\"microseconds\":%lu}\n", (unsigned long)PhaseElapsed(stats));
+    } else {
+        fprintf(output, "elapsed\t%lu\n", (unsigned long)PhaseElapsed(stats));
+    }
+
+    return (BOOL)(fflush(output) == 0 && !ferror(output));
+}
+
+/*
+ * Read the system clock
+ */
+static VOID SystemClock(struct PhaseTime *now, APTR clockData)
+{
+#ifdef INSIGHT_AMIGA
+    struct timeval time;
+
+    GetSysTime(&time);
+    now->seconds = time.tv_secs;
+    now->micros = time.tv_micro;
+#else
+    struct timespec time;
+
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    now->seconds = (ULONG)time.tv_sec;
+    now->micros = (ULONG)(time.tv_nsec / 1000);
+#endif
+}
+
+/*
+ * Microseconds from start to end, saturated at PHASE_TIME_LIMIT
+ */
+static ULONG MicrosBetween(const struct PhaseTime *start, const struct PhaseTime *end)
+{
+    ULONG seconds;
+    LONG micros;
+
+    if (end->seconds < start->seconds ||
+        (end->seconds == start->seconds && end->micros < start->micros)) {
+        return 0;
+    }
+
+    seconds = end->seconds - start->seconds;
+    micros = (LONG)end->micros - (LONG)start->micros;
+    if (micros < 0) {
+        seconds--;
+        micros += 1000000;
+    }
+    if (seconds > (PHASE_TIME_LIMIT - (ULONG)micros) / 1000000) {
+        return PHASE_TIME_LIMIT;
+    }
+
+    return seconds * 1000000 + (ULONG)micros;
+}
@@ -0,0 +1,109 @@
+/*
+ * Phase Statistics
+ *
+ * Times the phases of an Insight run for STATS.  Each phase keeps a call
+ * count, the total and longest time and a count of what it worked on, read
+ * from a clock the caller can replace.  The front ends time their own
+ * phases; the core times lookup and expansion itself through
+ * activePhaseStats, which is NULL unless a front end asks for it.
+ *
+ * After meditiation comes... Insight
+ *
+ * Copyright (c) 2025-26 amigazen project
+ * Licensed under BSD 2-Clause License
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef PHASE_H
+#define PHASE_H
+
+#include <stdio.h>
+#include "platform.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Phases of a run */
+#define PHASE_ARGUMENTS   0  /* Reading and checking the arguments */
+#define PHASE_LIBRARIES   1  /* InitializeLibraries */
+#define PHASE_APPLICATION 2  /* InitializeApplication */
+#define PHASE_LAST_ALERT  3  /* ParseLastAlert */
+#define PHASE_LOOKUP      4  /* Finding a code in the database */
+#define PHASE_EXPANSION   5  /* Writing the insight text - items are characters */
+#define PHASE_WORD_WRAP   6  /* Fitting the text to the screen - items are characters */
+#define PHASE_REQUESTER   7  /* Building and showing the requester, until it is closed */
+#define PHASE_BATCH       8  /* FROM, SCAN, SUMMARY or HISTORY input - items are lines, alerts or records */
+#define PHASE_COUNT       9
+
+/* A clock reading */
+struct PhaseTime {
+    ULONG seconds;
+    ULONG micros;
+};
+
+/* Time source - fills in the current time, which need only move forwards */
+typedef VOID (*PhaseClock)(struct PhaseTime *now, APTR clockData);
+
+/* Totals for one phase */
+struct PhaseCounter {
+    ULONG calls;
+    ULONG micros;                    /* Total time */
+    ULONG longest;                   /* Longest single call */
+    ULONG items;                     /* Work done, counted by the phase */
+};
+
+/* Statistics for one run - owned by the caller */
+struct PhaseStats {
+    PhaseClock clock;
+    APTR clockData;
+    struct PhaseTime origin;         /* When StartPhaseStats was called */
+    struct PhaseTime started[PHASE_COUNT];
+    struct PhaseCounter phases[PHASE_COUNT];
+};
+
+/* Statistics the core adds its lookup and expansion times to, or NULL */
+extern struct PhaseStats *activePhaseStats;
+
+/* Time a core phase when a front end has asked for statistics */
+#define BEGIN_PHASE(phase) \
+    do { if (activePhaseStats != NULL) BeginPhase(activePhaseStats, (phase)); } while (0)
+#define END_PHASE(phase, items) \
+    do { if (activePhaseStats != NULL) EndPhase(activePhaseStats, (phase), (items)); } while (0)
+
+/* Function declarations */
+BOOL StartPhaseStats(struct PhaseStats *stats, PhaseClock clock, APTR clockData);
+VOID StopPhaseStats(struct PhaseStats *stats);
+VOID UsePhaseStats(struct PhaseStats *stats);
+VOID BeginPhase(struct PhaseStats *stats, ULONG phase);
+VOID EndPhase(struct PhaseStats *stats, ULONG phase, ULONG items);
+ULONG PhaseElapsed(const struct PhaseStats *stats);
+CONST_STRPTR PhaseName(ULONG phase);
+BOOL WritePhaseReport(FILE *output, ULONG format, const struct PhaseStats *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* PHASE_H */
@@ -0,0 +1,79 @@
+/*
+ * Platform Abstraction for the Insight Decoding Core
+ *
+ * The decoding core (error_codes.c and libinsight.c) is shared between the
+ * Amiga Insight executable and the host build of libinsight.  On the Amiga
+ * the Exec types come straight from the NDK; everywhere else this header
+ * provides equivalent definitions so the same sources compile unchanged.
+ *
+ * After meditiation comes... Insight
+ *
+ * Copyright (c) 2025-26 amigazen project
+ * Licensed under BSD 2-Clause License
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef PLATFORM_H
+#define PLATFORM_H
+
+/* SAS/C defines AMIGA, GCC for m68k-amigaos defines __amigaos__ */
+#if defined(AMIGA) || defined(__amigaos__)
+#define INSIGHT_AMIGA 1
+#endif
+
+#ifdef INSIGHT_AMIGA
+
+#include <exec/types.h>
+
+#else /* host build */
+
+#include <stdint.h>
+
+/* Exec-compatible types - ULONG must stay 32 bits wide on LP64 hosts */
+typedef uint32_t ULONG;
+typedef int32_t  LONG;
+typedef uint16_t UWORD;
+typedef int16_t  WORD;
+typedef uint8_t  UBYTE;
+typedef int8_t   BYTE;
+typedef short    BOOL;
+typedef void    *APTR;
+typedef char    *STRPTR;
+typedef const char *CONST_STRPTR;
+
+#ifndef VOID
+#define VOID void
+#endif
+
+#ifndef TRUE
+#define TRUE  1
+#endif
+
+#ifndef FALSE
+#define FALSE 0
+#endif
+
+#endif /* INSIGHT_AMIGA */
+
+#endif /* PLATFORM_H */
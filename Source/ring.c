@@ -0,0 +1,425 @@
+/*
+ * Insight Alert Ring
+ *
+ * Both sides map the same file.  Producers claim slots by compare and
+ * swap on head and publish them through each slot's sequence word, so they
+ * never take a lock or make a system call; the consumer alone moves tail.
+ * This file has no other dependencies, so it also builds on its own as the
+ * producer library.
+ *
+ * After meditiation comes... Insight
+ *
+ * Copyright (c) 2025-26 amigazen project
+ * Licensed under BSD 2-Clause License
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include "ring.h"
+
+/* Bytes in front of the slots */
+#define RING_HEADER_SIZE ((ULONG)sizeof(struct AlertRingHeader))
+
+static const CONST_STRPTR errorTexts[] = {
+    "no error",
+    "the ring file cannot be created, opened or mapped",
+    "not an alert ring of this version",
+    "another consumer has the ring open",
+    "out of memory",
+    "the ring is full",
+    "the consumer has closed the ring",
+    "the records cannot be written"
+};
+
+/* Forward declarations */
+static struct AlertRing *MapRing(int file, ULONG size, ULONG *error);
+static ULONG CheckRing(const struct AlertRing *ring, ULONG size);
+static ULONG ReplaceStaleRing(CONST_STRPTR path);
+static LONG RingDistance(ULONG sequence, ULONG position);
+
+/*
+ * Open a ring a consumer has created, to post records to it
+ * producer is written into every record posted through this handle, so
+ * the consumer can tell emulator instances apart.  Returns NULL with
+ * the reason in *error (which may be NULL).
+ */
+struct AlertRing *OpenAlertRing(CONST_STRPTR path, ULONG producer, ULONG *error)
+{
+    struct AlertRing *ring;
+    struct stat status;
+    ULONG failure;
+    int file;
+
+    ring = NULL;
+    failure = RING_ERROR_OPEN;
+    file = open(path, O_RDWR);
+    if (file >= 0) {
+        if (fstat(file, &status) == 0 && status.st_size >= (off_t)RING_HEADER_SIZE &&
+            (uint64_t)status.st_size <= RING_HEADER_SIZE + (uint64_t)RING_MAX_SLOTS * sizeof(struct AlertRingSlot)) {
+            ring = MapRing(file, (ULONG)status.st_size, &failure);
+        } else {
+            failure = RING_ERROR_FORMAT;
+        }
+        close(file);
+    }
+
+    if (ring != NULL) {
+        failure = CheckRing(ring, ring->size);
+        if (failure == RING_OK && (__atomic_load_n(&ring->header->consumer, __ATOMIC_ACQUIRE) == 0 ||
+                                   (__atomic_load_n(&ring->header->head, __ATOMIC_RELAXED) & RING_CLOSED) != 0)) {
+            failure = RING_ERROR_CLOSED;
+        }
+        if (failure != RING_OK) {
+            CloseAlertRing(ring);
+            ring = NULL;
+        } else {
+            ring->producer = producer;
+        }
+    }
+
+    if (error != NULL) {
+        *error = failure;
+    }
+    return ring;
+}
+
+/*
+ * Post one record to the ring
+ * Returns RING_OK, RING_ERROR_FULL if every slot is waiting for the
+ * consumer - the record is dropped and counted - or RING_ERROR_CLOSED.
+ * A record posted with RING_OK is always taken, even if the consumer is
+ * stopping at the same time.
+ */
+ULONG PostAlert(struct AlertRing *ring, ULONG code, ULONG task)
+{
+    struct AlertRingHeader *header = ring->header;
+    struct AlertRingSlot *slot;
+    ULONG position;
+    ULONG sequence;
+    LONG difference;
+
+    position = __atomic_load_n(&header->head, __ATOMIC_RELAXED);
+    for (;;) {
+        if ((position & RING_CLOSED) != 0) {
+            return RING_ERROR_CLOSED;
+        }
+        slot = &ring->slots[position & ring->mask];
+        sequence = __atomic_load_n(&slot->sequence, __ATOMIC_ACQUIRE);
+        difference = RingDistance(sequence, position);
+        if (difference == 0) {
+            /* On failure position is reloaded with the head another producer moved or the consumer closed */
+            if (__atomic_compare_exchange_n(&header->head, &position, (position + 1) & RING_POSITIONS, TRUE,
+                                            __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+                break;
+            }
+        } else if (difference < 0) {
+            /* The slot still holds the record from one lap ago */
+            __atomic_fetch_add(&header->dropped, 1, __ATOMIC_RELAXED);
+            return RING_ERROR_FULL;
+        } else {
+            position = __atomic_load_n(&header->head, __ATOMIC_RELAXED);
+        }
+    }
+
+    slot->code = code;
+    slot->task = task;
+    slot->producer = ring->producer;
+    __atomic_store_n(&slot->sequence, (position + 1) & RING_POSITIONS, __ATOMIC_RELEASE);
+
+    return RING_OK;
+}
+
+/*
+ * Close a ring
+ * The consumer's close stops the ring, if StopAlertRing has not, and
+ * removes the file; a producer's close only unmaps it.
+ */
+VOID CloseAlertRing(struct AlertRing *ring)
+{
+    if (ring == NULL) {
+        return;
+    }
+
+    if (ring->path != NULL) {
+        StopAlertRing(ring);
+        __atomic_store_n(&ring->header->consumer, 0, __ATOMIC_RELEASE);
+        unlink(ring->path);
+        free(ring->path);
+    }
+
+    munmap(ring->header, ring->size);
+    free(ring);
+}
+
+/*
+ * Create a ring of slots records at path and become its consumer
+ * slots is rounded up to a power of two, RING_DEFAULT_SLOTS if 0.  A
+ * ring file left by a consumer that is no longer running is replaced;
+ * one whose consumer is alive, or any other kind of file, is not.
+ * Returns NULL with the reason in *error (which may be NULL).
+ */
+struct AlertRing *CreateAlertRing(CONST_STRPTR path, ULONG slots, ULONG *error)
+{
+    struct AlertRing *ring;
+    struct AlertRingHeader *header;
+    ULONG slotCount;
+    ULONG failure;
+    ULONG size;
+    ULONG i;
+    int file;
+
+    if (slots == 0) {
+        slots = RING_DEFAULT_SLOTS;
+    }
+    slotCount = 1;
+    while (slotCount < slots && slotCount < RING_MAX_SLOTS) {
+        slotCount <<= 1;
+    }
+    size = RING_HEADER_SIZE + slotCount * (ULONG)sizeof(struct AlertRingSlot);
+
+    ring = NULL;
+    failure = RING_OK;
+    file = open(path, O_RDWR | O_CREAT | O_EXCL, 0666);
+    if (file < 0 && errno == EEXIST) {
+        failure = ReplaceStaleRing(path);
+        if (failure == RING_OK) {
+            file = open(path, O_RDWR | O_CREAT | O_EXCL, 0666);
+        }
+    }
+    if (failure == RING_OK && file < 0) {
+        failure = RING_ERROR_OPEN;
+    }
+
+    if (file >= 0) {
+        if (ftruncate(file, (off_t)size) == 0) {
+            ring = MapRing(file, size, &failure);
+        } else {
+            failure = RING_ERROR_OPEN;
+        }
+        close(file);
+    }
+
+    if (ring != NULL) {
+        ring->path = (char *)malloc(strlen(path) + 1);
+        if (ring->path == NULL) {
+            CloseAlertRing(ring);
+            ring = NULL;
+            failure = RING_ERROR_MEMORY;
+        } else {
+            strcpy(ring->path, path);
+        }
+    }
+    if (ring == NULL) {
+        if (file >= 0) {
+            unlink(path);
+        }
+    } else {
+        /* The file is zero filled; the magic goes in last, once the ring is ready */
+        header = ring->header;
+        header->version = RING_VERSION;
+        header->slotCount = slotCount;
+        header->consumer = (ULONG)getpid();
+        ring->mask = slotCount - 1;
+        for (i = 0; i < slotCount; i++) {
+            ring->slots[i].sequence = i;
+        }
+        __atomic_store_n(&header->magic, RING_MAGIC, __ATOMIC_RELEASE);
+    }
+
+    if (error != NULL) {
+        *error = failure;
+    }
+    return ring;
+}
+
+/*
+ * Take up to count records, oldest first, without waiting
+ * Each slot is freed for producers as soon as its record is copied out.
+ * Returns the number taken - 0 if the ring is empty.
+ */
+ULONG TakeAlerts(struct AlertRing *ring, struct RingAlert *alerts, ULONG count)
+{
+    struct AlertRingSlot *slot;
+    ULONG position;
+    ULONG taken;
+
+    position = ring->header->tail;
+    for (taken = 0; taken < count; taken++) {
+        slot = &ring->slots[position & ring->mask];
+        if (__atomic_load_n(&slot->sequence, __ATOMIC_ACQUIRE) != ((position + 1) & RING_POSITIONS)) {
+            break;
+        }
+        alerts[taken].code = slot->code;
+        alerts[taken].task = slot->task;
+        alerts[taken].producer = slot->producer;
+        __atomic_store_n(&slot->sequence, (position + ring->mask + 1) & RING_POSITIONS, __ATOMIC_RELEASE);
+        position = (position + 1) & RING_POSITIONS;
+    }
+    __atomic_store_n(&ring->header->tail, position, __ATOMIC_RELAXED);
+
+    return taken;
+}
+
+/*
+ * Close the ring to producers while the consumer still has it open
+ * Every later post returns RING_ERROR_CLOSED.  Records claimed before
+ * this are still taken by TakeAlerts, until AlertRingBacklog reaches 0.
+ */
+VOID StopAlertRing(struct AlertRing *ring)
+{
+    __atomic_fetch_or(&ring->header->head, RING_CLOSED, __ATOMIC_SEQ_CST);
+}
+
+/*
+ * Count the records claimed by producers and not yet taken
+ * Some may still be being filled in, so TakeAlerts can return fewer.
+ */
+ULONG AlertRingBacklog(const struct AlertRing *ring)
+{
+    ULONG head;
+
+    head = __atomic_load_n(&ring->header->head, __ATOMIC_ACQUIRE) & RING_POSITIONS;
+
+    return (head - ring->header->tail) & RING_POSITIONS;
+}
+
+/*
+ * Count the records producers have had to drop since the ring was created
+ */
+ULONG AlertRingDropped(const struct AlertRing *ring)
+{
+    return __atomic_load_n(&ring->header->dropped, __ATOMIC_RELAXED);
+}
+
+/*
+ * Describe a RING_xxx result
+ */
+CONST_STRPTR RingErrorText(ULONG error)
+{
+    if (error >= sizeof(errorTexts) / sizeof(errorTexts[0])) {
+        return "unknown error";
+    }
+
+    return errorTexts[error];
+}
+
+/*
+ * Map an open ring file shared and make a handle for it
+ * Returns NULL with the reason in *error.
+ */
+static struct AlertRing *MapRing(int file, ULONG size, ULONG *error)
+{
+    struct AlertRing *ring;
+    VOID *memory;
+
+    memory = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, file, 0);
+    if (memory == MAP_FAILED) {
+        *error = RING_ERROR_OPEN;
+        return NULL;
+    }
+
+    ring = (struct AlertRing *)calloc(1, sizeof(struct AlertRing));
+    if (ring == NULL) {
+        munmap(memory, size);
+        *error = RING_ERROR_MEMORY;
+        return NULL;
+    }
+    ring->header = (struct AlertRingHeader *)memory;
+    ring->slots = (struct AlertRingSlot *)((UBYTE *)memory + RING_HEADER_SIZE);
+    ring->size = size;
+
+    *error = RING_OK;
+    return ring;
+}
+
+/*
+ * Check a mapped ring's header against this build and the file size
+ * Sets the slot mask when it matches.  Returns RING_OK or RING_ERROR_FORMAT.
+ */
+static ULONG CheckRing(const struct AlertRing *ring, ULONG size)
+{
+    struct AlertRingHeader *header = ring->header;
+    ULONG slotCount;
+
+    if (__atomic_load_n(&header->magic, __ATOMIC_ACQUIRE) != RING_MAGIC || header->version != RING_VERSION) {
+        return RING_ERROR_FORMAT;
+    }
+
+    slotCount = header->slotCount;
+    if (slotCount == 0 || slotCount > RING_MAX_SLOTS || (slotCount & (slotCount - 1)) != 0 ||
+        size != RING_HEADER_SIZE + slotCount * (ULONG)sizeof(struct AlertRingSlot)) {
+        return RING_ERROR_FORMAT;
+    }
+
+    ((struct AlertRing *)ring)->mask = slotCount - 1;
+    return RING_OK;
+}
+
+/*
+ * Signed distance from a position to a slot sequence, both modulo 2^31
+ */
+static LONG RingDistance(ULONG sequence, ULONG position)
+{
+    return (LONG)((sequence - position) << 1) / 2;
+}
+
+/*
+ * Remove a ring file whose consumer has gone
+ * Returns RING_OK once it is removed, RING_ERROR_IN_USE if its consumer
+ * is still running, or RING_ERROR_FORMAT if the file is not a ring.
+ */
+static ULONG ReplaceStaleRing(CONST_STRPTR path)
+{
+    struct AlertRingHeader header;
+    ULONG failure;
+    int file;
+
+    file = open(path, O_RDONLY);
+    if (file < 0) {
+        return RING_ERROR_OPEN;
+    }
+    failure = RING_ERROR_FORMAT;
+    if (read(file, &header, sizeof(header)) == (ssize_t)sizeof(header) && header.magic == RING_MAGIC) {
+        failure = RING_OK;
+        if (header.consumer != 0 && (kill((pid_t)header.consumer, 0) == 0 || errno == EPERM)) {
+            failure = RING_ERROR_IN_USE;
+        }
+    }
+    close(file);
+
+    if (failure == RING_OK && unlink(path) != 0) {
+        failure = RING_ERROR_OPEN;
+    }
+
+    return failure;
+}
@@ -0,0 +1,132 @@
+/*
+ * Insight Alert Ring
+ *
+ * A ring of alert records in a shared memory file, for emulators and test
+ * harnesses on the same host to hand their alerts to Insight without a
+ * copy through a pipe or a system call.  Any number of processes post
+ * records; one Insight consumer takes them in order and decodes them in
+ * batches.  Posting never blocks: when the ring is full the record is
+ * counted as dropped.  Host builds only.
+ *
+ * After meditiation comes... Insight
+ *
+ * Copyright (c) 2025-26 amigazen project
+ * Licensed under BSD 2-Clause License
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef RING_H
+#define RING_H
+
+#include "platform.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Layout - a header of three cache lines, then the slots.  All words are
+ * ULONGs in the host's byte order.  Positions count modulo 2^31.  Slot i
+ * starts with sequence i; a producer claims position p by moving head from
+ * p to p + 1 while the sequence of slot p is p, fills it in and sets its
+ * sequence to p + 1.  The consumer takes the slot once its sequence is
+ * p + 1 and frees it for position p + slots by setting the sequence to
+ * that.  To stop, the consumer sets RING_CLOSED in head: a claim either
+ * moved head before that, and is taken, or fails on it.
+ */
+#define RING_MAGIC         0x494E5247UL   /* "INRG" */
+#define RING_VERSION       2              /* Producers and consumer must agree exactly */
+#define RING_CACHE_LINE    64
+#define RING_DEFAULT_SLOTS 65536          /* 1 MB of slots */
+#define RING_MAX_SLOTS     0x01000000UL   /* Slot counts are powers of two up to this */
+#define RING_CLOSED        0x80000000UL   /* In head once the consumer takes no more records */
+#define RING_POSITIONS     0x7FFFFFFFUL   /* Bits of head, tail and sequences that hold a position */
+
+/* Header - head, tail and the rest each have their own cache line */
+struct AlertRingHeader {
+    ULONG magic;
+    ULONG version;
+    ULONG slotCount;
+    ULONG consumer;                    /* Process ID of the consumer, 0 once it has closed the ring */
+    ULONG dropped;                     /* Records refused because the ring was full */
+    ULONG reserved[RING_CACHE_LINE / 4 - 5];
+    ULONG head;                        /* Next position a producer claims, and RING_CLOSED */
+    ULONG headPad[RING_CACHE_LINE / 4 - 1];
+    ULONG tail;                        /* Next position the consumer takes */
+    ULONG tailPad[RING_CACHE_LINE / 4 - 1];
+};
+
+/* One record, as SysBase->LastAlert holds it, with who posted it */
+struct AlertRingSlot {
+    ULONG sequence;
+    ULONG code;                        /* LastAlert[0] */
+    ULONG task;                        /* LastAlert[1] - the task or address that raised it */
+    ULONG producer;                    /* Chosen by the producer when it opened the ring */
+};
+
+/* An open ring - private to each process */
+struct AlertRing {
+    struct AlertRingHeader *header;
+    struct AlertRingSlot *slots;
+    ULONG mask;                        /* slotCount - 1 */
+    ULONG producer;
+    ULONG size;                        /* Bytes mapped */
+    char *path;                        /* Removed when the consumer closes, NULL for producers */
+};
+
+/* A record taken by the consumer */
+struct RingAlert {
+    ULONG code;
+    ULONG task;
+    ULONG producer;
+};
+
+/* Results */
+#define RING_OK           0
+#define RING_ERROR_OPEN   1   /* The file cannot be created, opened or mapped */
+#define RING_ERROR_FORMAT 2   /* Not a ring, another version, or a bad slot count */
+#define RING_ERROR_IN_USE 3   /* Another consumer has the ring open */
+#define RING_ERROR_MEMORY 4
+#define RING_ERROR_FULL   5   /* PostAlert - no free slot, the record was dropped */
+#define RING_ERROR_CLOSED 6   /* PostAlert - the consumer has gone, reopen the ring later */
+#define RING_ERROR_IO     7   /* DecodeAlertRing - the records could not be written */
+
+/* Function declarations - producers */
+struct AlertRing *OpenAlertRing(CONST_STRPTR path, ULONG producer, ULONG *error);
+ULONG PostAlert(struct AlertRing *ring, ULONG code, ULONG task);
+VOID CloseAlertRing(struct AlertRing *ring);
+
+/* Function declarations - the consumer */
+struct AlertRing *CreateAlertRing(CONST_STRPTR path, ULONG slots, ULONG *error);
+ULONG TakeAlerts(struct AlertRing *ring, struct RingAlert *alerts, ULONG count);
+VOID StopAlertRing(struct AlertRing *ring);
+ULONG AlertRingBacklog(const struct AlertRing *ring);
+ULONG AlertRingDropped(const struct AlertRing *ring);
+CONST_STRPTR RingErrorText(ULONG error);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* RING_H */
@@ -0,0 +1,209 @@
+/*
+ * Insight Ring Decoder
+ *
+ * Takes records from the ring up to RING_BATCH at a time.  Output is
+ * flushed whenever the ring runs empty, so a reader of the pipe sees each
+ * burst as soon as it is decoded, and the consumer then backs off from a
+ * microsecond up to a millisecond between polls.  Producers never wait for
+ * it either way.
+ *
+ * After meditiation comes... Insight
+ *
+ * Copyright (c) 2025-26 amigazen project
+ * Licensed under BSD 2-Clause License
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <signal.h>
+#include <time.h>
+#include "platform.h"
+#include "batch.h"
+#include "ring.h"
+#include "ringdecode.h"
+
+/* Set by SIGINT or SIGTERM */
+static volatile sig_atomic_t stopRequested;
+
+/* Forward declarations */
+static ULONG DecodeAlerts(struct BatchWriter *writer, struct AlertSummary *summary, const struct RingAlert *alerts,
+                          ULONG count, ULONG first);
+static VOID StopDecoding(int number);
+static double Now(VOID);
+
+/*
+ * Create the ring at path and decode what producers post until SIGINT or SIGTERM
+ * Records go to output, led by a running alert number, the producer and
+ * the task word; with summary set the codes are counted there instead.
+ * The signal closes the ring to producers, and every record posted
+ * before that is still decoded.  slots is as for CreateAlertRing.
+ * Returns RING_OK, the RING_ERROR_xxx the ring could not be created
+ * with, or RING_ERROR_IO if the records could not all be written.
+ */
+ULONG DecodeAlertRing(CONST_STRPTR path, ULONG slots, FILE *output, ULONG format, struct AlertSummary *summary,
+                      struct RingTotals *totals)
+{
+    struct AlertRing *ring;
+    struct BatchWriter writer;
+    struct RingAlert alerts[RING_BATCH];
+    struct sigaction action;
+    struct sigaction oldInterrupt;
+    struct sigaction oldTerminate;
+    struct timespec idle;
+    ULONG error;
+    ULONG taken;
+    double deadline;
+    BOOL stopping;
+
+    memset(totals, 0, sizeof(struct RingTotals));
+
+    if (!OpenBatchWriter(&writer, (summary != NULL) ? NULL : output, format)) {
+        return RING_ERROR_MEMORY;
+    }
+    ring = CreateAlertRing(path, slots, &error);
+    if (ring == NULL) {
+        CloseBatchWriter(&writer);
+        return error;
+    }
+
+    stopRequested = 0;
+    memset(&action, 0, sizeof(action));
+    sigemptyset(&action.sa_mask);
+    action.sa_handler = StopDecoding;
+    sigaction(SIGINT, &action, &oldInterrupt);
+    sigaction(SIGTERM, &action, &oldTerminate);
+
+    idle.tv_sec = 0;
+    idle.tv_nsec = 0;
+    deadline = 0.0;
+    stopping = FALSE;
+    for (;;) {
+        /* Checked before taking, so a ring that never runs empty still stops */
+        if (stopRequested && !stopping) {
+            StopAlertRing(ring);
+            stopping = TRUE;
+        }
+
+        taken = TakeAlerts(ring, alerts, RING_BATCH);
+        if (taken > 0) {
+            totals->alerts += DecodeAlerts(&writer, summary, alerts, taken, totals->alerts);
+            idle.tv_nsec = 0;
+            deadline = 0.0;
+            continue;
+        }
+
+        /* Closed - take what was claimed before, waiting for producers still filling slots in */
+        if (stopping) {
+            if (AlertRingBacklog(ring) == 0 || (deadline > 0.0 && Now() >= deadline)) {
+                break;
+            }
+            if (deadline == 0.0) {
+                deadline = Now() + (double)RING_CLAIM_WAIT_NS / 1e9;
+            }
+            idle.tv_nsec = 1000;
+            nanosleep(&idle, NULL);
+            continue;
+        }
+        if (idle.tv_nsec == 0) {
+            FlushBatchWriter(&writer);
+            if (summary == NULL) {
+                fflush(output);
+            }
+            idle.tv_nsec = 1000;
+        } else if (idle.tv_nsec < RING_IDLE_MAX_NS) {
+            idle.tv_nsec *= 2;
+            if (idle.tv_nsec > RING_IDLE_MAX_NS) {
+                idle.tv_nsec = RING_IDLE_MAX_NS;
+            }
+        }
+        nanosleep(&idle, NULL);
+    }
+
+    /* A claim still empty after the wait belongs to a producer that died posting it */
+    totals->dropped = AlertRingDropped(ring) + AlertRingBacklog(ring);
+    CloseAlertRing(ring);
+
+    sigaction(SIGINT, &oldInterrupt, NULL);
+    sigaction(SIGTERM, &oldTerminate, NULL);
+
+    if (!CloseBatchWriter(&writer)) {
+        return RING_ERROR_IO;
+    }
+
+    return RING_OK;
+}
+
+/*
+ * Write or count a batch of records taken from the ring
+ * first is the number of records before this batch.  Returns count.
+ */
+static ULONG DecodeAlerts(struct BatchWriter *writer, struct AlertSummary *summary, const struct RingAlert *alerts,
+                          ULONG count, ULONG first)
+{
+    struct RecordSource source;
+    ULONG i;
+
+    if (summary != NULL) {
+        for (i = 0; i < count; i++) {
+            CountAlertCode(summary, alerts[i].code);
+        }
+        return count;
+    }
+
+    source.time = NULL;
+    source.kind = NULL;
+    source.hasProducer = TRUE;
+    source.hasTask = TRUE;
+    source.taskName = NULL;
+    for (i = 0; i < count; i++) {
+        source.line = first + i + 1;
+        source.producer = alerts[i].producer;
+        source.task = alerts[i].task;
+        WriteSourcedAlertRecord(writer, alerts[i].code, &source);
+    }
+
+    return count;
+}
+
+/*
+ * Signal handler - stop after the ring is drained
+ */
+static VOID StopDecoding(int number)
+{
+    (VOID)number;
+    stopRequested = 1;
+}
+
+/*
+ * Monotonic clock in seconds
+ */
+static double Now(VOID)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return (double)now.tv_sec + (double)now.tv_nsec / 1e9;
+}
@@ -0,0 +1,70 @@
+/*
+ * Insight Ring Decoder
+ *
+ * The consumer side of the alert ring: creates the ring, takes what the
+ * producers post in batches and decodes it to records or a summary until
+ * it is told to stop.  Host builds only.
+ *
+ * After meditiation comes... Insight
+ *
+ * Copyright (c) 2025-26 amigazen project
+ * Licensed under BSD 2-Clause License
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef RINGDECODE_H
+#define RINGDECODE_H
+
+#include <stdio.h>
+#include "platform.h"
+#include "summary.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Records taken from the ring at a time */
+#define RING_BATCH 256
+
+/* Longest the consumer sleeps while the ring is empty, in nanoseconds */
+#define RING_IDLE_MAX_NS 1000000L
+
+/* Longest a stopping consumer waits for a claimed record to be filled in, in nanoseconds */
+#define RING_CLAIM_WAIT_NS 100000000L
+
+/* What a DecodeAlertRing run saw */
+struct RingTotals {
+    ULONG alerts;      /* Records taken and decoded or counted */
+    ULONG dropped;     /* Records producers could not post because the ring was full, or never filled in */
+};
+
+/* Function declarations */
+ULONG DecodeAlertRing(CONST_STRPTR path, ULONG slots, FILE *output, ULONG format, struct AlertSummary *summary,
+                      struct RingTotals *totals);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* RINGDECODE_H */
@@ -0,0 +1,537 @@
+/*
+ * Alert Ring Driver
+ *
+ * Test driver for the alert ring.  Forks PRODUCERS processes that each post
+ * ALERTS records through the producer library as fast as they can, the way
+ * instrumented emulators would, and times every post loop.  With INSIGHT=
+ * the consumer is that binary run with RING=, its records piped back and
+ * counted; without it the driver takes the records itself and checks each
+ * producer's arrive whole and in order.  With STOPAFTER= the consumer is
+ * stopped that many milliseconds in, while producers are still posting,
+ * and each producer ends when the ring closes.  Either way every record
+ * posted and not dropped must come out exactly once.  Results are ns per
+ * post, drops and alerts/s in TSV or JSON, and any lost, duplicated or
+ * failed record gives a non-zero exit.
+ *
+ * Usage: insight_ringdriver RING=<file> [INSIGHT=<binary>] [PRODUCERS=<n>]
+ *                           [ALERTS=<n>] [STOPAFTER=<ms>] [SEED=<n>] [FORMAT=tsv|json]
+ *
+ * After meditiation comes... Insight
+ *
+ * Copyright (c) 2025-26 amigazen project
+ * Licensed under BSD 2-Clause License
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <poll.h>
+#include <signal.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include "libinsight.h"
+#include "batch.h"
+#include "ring.h"
+#include "ringdecode.h"
+#include "hosttools.h"
+
+/* Defaults and limits */
+#define RINGDRIVER_DEFAULT_PRODUCERS 4
+#define RINGDRIVER_MAX_PRODUCERS     64
+#define RINGDRIVER_DEFAULT_ALERTS    1000000UL
+
+/* Codes cycled through by the producers - a power of two */
+#define RINGDRIVER_CODES 1024
+
+/* How long the consumer has to create the ring, in milliseconds */
+#define RINGDRIVER_START_WAIT 5000
+
+/* Consumer output read at a time */
+#define RINGDRIVER_BUFFER_SIZE 65536
+
+/* Insight return codes - anything above a warning is a failed run */
+#define RETURN_WARN 5
+
+/* What a producer sends back when it is done */
+struct ProducerResult {
+    ULONG producer;
+    ULONG posted;                    /* Records in the ring */
+    ULONG dropped;                   /* Refused because the ring was full */
+    ULONG error;                     /* RING_OK, or why the producer stopped early */
+    double seconds;                  /* Time in the post loop */
+};
+
+/* The records the driver took itself, for checking */
+struct DriverCheck {
+    ULONG lastTask[RINGDRIVER_MAX_PRODUCERS + 1];
+    ULONG taken;
+    ULONG bad;                       /* Records out of order, from no producer or with the wrong code */
+};
+
+static ULONG codes[RINGDRIVER_CODES];
+/* Forward declarations */
+static VOID RunProducer(CONST_STRPTR path, ULONG producer, ULONG alerts, BOOL untilClosed, int results);
+static pid_t StartInsight(CONST_STRPTR insight, CONST_STRPTR path, int *output);
+static BOOL WaitForRing(CONST_STRPTR path, pid_t consumer);
+static ULONG CountLines(int input, BOOL *closed);
+static VOID CheckAlerts(struct DriverCheck *check, const struct RingAlert *alerts, ULONG count);
+static double Now(VOID);
+
+int main(int argc, char *argv[])
+{
+    struct ProducerResult results[RINGDRIVER_MAX_PRODUCERS];
+    struct ProducerResult *result;
+    struct RingAlert taken[RING_BATCH];
+    struct DriverCheck check;
+    struct AlertRing *ring;
+    const char *path;
+    const char *insight;
+    const char *value;
+    pid_t producers[RINGDRIVER_MAX_PRODUCERS];
+    pid_t consumer;
+    ULONG producerCount;
+    ULONG running;
+    ULONG stopAfter;
+    ULONG alerts;
+    ULONG posted;
+    ULONG dropped;
+    ULONG decoded;
+    ULONG entries;
+    ULONG error;
+    ULONG i;
+    LONG format;
+    double start;
+    double seconds;
+    double attempts;
+    BOOL stopped;
+    BOOL closed;
+    BOOL failed;
+    int resultPipe[2];
+    int output;
+    int status;
+    int arg;
+
+    path = NULL;
+    insight = NULL;
+    producerCount = RINGDRIVER_DEFAULT_PRODUCERS;
+    alerts = RINGDRIVER_DEFAULT_ALERTS;
+    stopAfter = 0;
+    SeedRandom(1);
+    format = BATCH_FORMAT_TSV;
+
+    for (arg = 1; arg < argc; arg++) {
+        if (MatchKeyword(argv[arg], "RING", &value) && value != NULL) {
+            path = value;
+        } else if (MatchKeyword(argv[arg], "INSIGHT", &value) && value != NULL) {
+            insight = value;
+        } else if (MatchKeyword(argv[arg], "PRODUCERS", &value) && value != NULL && atol(value) > 0 &&
+                   atol(value) <= RINGDRIVER_MAX_PRODUCERS) {
+            producerCount = (ULONG)atol(value);
+        } else if (MatchKeyword(argv[arg], "ALERTS", &value) && value != NULL && atol(value) > 0) {
+            alerts = (ULONG)strtoul(value, NULL, 10);
+        } else if (MatchKeyword(argv[arg], "STOPAFTER", &value) && value != NULL && atol(value) > 0) {
+            stopAfter = (ULONG)strtoul(value, NULL, 10);
+        } else if (MatchKeyword(argv[arg], "SEED", &value) && value != NULL) {
+            SeedRandom((ULONG)strtoul(value, NULL, 10));
+        } else if (MatchKeyword(argv[arg], "FORMAT", &value) && value != NULL) {
+            format = FindBatchFormat(value);
+            if (format < 0) {
+                fprintf(stderr, "Error: Unknown output format. Use tsv or json.\n");
+                return EXIT_FAILURE;
+            }
+        } else {
+            path = NULL;
+            break;
+        }
+    }
+
+    if (path == NULL) {
+        fprintf(stderr, "Usage: insight_ringdriver RING=<file> [INSIGHT=<binary>] [PRODUCERS=<n>]\n"
+                        "                          [ALERTS=<n>] [STOPAFTER=<ms>] [SEED=<n>] [FORMAT=tsv|json]\n");
+        return EXIT_FAILURE;
+    }
+
+    /* Every producer cycles through the same codes, so the driver can check what it takes */
+    entries = InsightEntryCount();
+    for (i = 0; i < RINGDRIVER_CODES; i++) {
+        codes[i] = InsightEntryAt(NextRandom() % entries)->code;
+    }
+
+    ring = NULL;
+    consumer = 0;
+    output = -1;
+    if (insight != NULL) {
+        consumer = StartInsight(insight, path, &output);
+        if (consumer < 0 || !WaitForRing(path, consumer)) {
+            fprintf(stderr, "Error: %s did not create the ring %s\n", insight, path);
+            if (consumer > 0) {
+                kill(consumer, SIGTERM);
+                waitpid(consumer, NULL, 0);
+            }
+            return EXIT_FAILURE;
+        }
+    } else {
+        ring = CreateAlertRing(path, 0, &error);
+        if (ring == NULL) {
+            fprintf(stderr, "Error: Cannot create the ring %s: %s\n", path, RingErrorText(error));
+            return EXIT_FAILURE;
+        }
+    }
+    if (pipe(resultPipe) != 0) {
+        fprintf(stderr, "Error: Cannot make a pipe\n");
+        return EXIT_FAILURE;
+    }
+
+    start = Now();
+    running = 0;
+    for (i = 0; i < producerCount; i++) {
+        producers[i] = fork();
+        if (producers[i] == 0) {
+            close(resultPipe[0]);
+            if (output >= 0) {
+                close(output);
+            }
+            RunProducer(path, i + 1, alerts, (BOOL)(stopAfter > 0), resultPipe[1]);
+        }
+        if (producers[i] > 0) {
+            running++;
+        }
+    }
+    close(resultPipe[1]);
+
+    /* Consume until every producer is done, then drain what is left */
+    memset(&check, 0, sizeof(check));
+    decoded = 0;
+    stopped = FALSE;
+    closed = FALSE;
+    while (running > 0) {
+        if (stopAfter > 0 && !stopped && Now() - start >= (double)stopAfter / 1000.0) {
+            if (ring != NULL) {
+                StopAlertRing(ring);
+            } else {
+                kill(consumer, SIGINT);
+            }
+            stopped = TRUE;
+        }
+        if (ring != NULL) {
+            CheckAlerts(&check, taken, TakeAlerts(ring, taken, RING_BATCH));
+        } else {
+            decoded += CountLines(output, &closed);
+        }
+        for (i = 0; i < producerCount; i++) {
+            if (producers[i] > 0 && waitpid(producers[i], &status, WNOHANG) == producers[i]) {
+                producers[i] = 0;
+                running--;
+            }
+        }
+    }
+    if (ring != NULL) {
+        /* Every producer has exited, so every slot claimed has been filled in */
+        StopAlertRing(ring);
+        while (AlertRingBacklog(ring) > 0) {
+            CheckAlerts(&check, taken, TakeAlerts(ring, taken, RING_BATCH));
+        }
+        decoded = check.taken;
+        CloseAlertRing(ring);
+        status = 0;
+    } else {
+        if (!stopped) {
+            kill(consumer, SIGINT);
+        }
+        while (!closed) {
+            decoded += CountLines(output, &closed);
+        }
+        close(output);
+        if (waitpid(consumer, &status, 0) != consumer || !WIFEXITED(status)) {
+            status = -1;
+        } else {
+            status = WEXITSTATUS(status);
+        }
+    }
+    seconds = Now() - start;
+
+    memset(results, 0, sizeof(results));
+    for (i = 0; i < producerCount; i++) {
+        if (read(resultPipe[0], &results[i], sizeof(struct ProducerResult)) != (ssize_t)sizeof(struct ProducerResult)) {
+            results[i].producer = i + 1;
+            results[i].error = RING_ERROR_OPEN;
+        }
+    }
+    close(resultPipe[0]);
+
+    if (format == BATCH_FORMAT_JSON) {
+        printf("{\"ring\":\"%s\",\"consumer\":\"%s\",\"producers\":%lu,\"alerts\":%lu}\n", path,
+               (insight != NULL) ? insight : "driver", (unsigned long)producerCount, (unsigned long)alerts);
+    } else {
+        printf("# %s, consumer %s, %lu producers of %lu alerts\n", path, (insight != NULL) ? insight : "driver",
+               (unsigned long)producerCount, (unsigned long)alerts);
+        printf("# producer\tposted\tdropped\tseconds\tns/post\terror\n");
+    }
+
+    failed = FALSE;
+    posted = 0;
+    dropped = 0;
+    for (i = 0; i < producerCount; i++) {
+        result = &results[i];
+        posted += result->posted;
+        dropped += result->dropped;
+        if (result->seconds <= 0.0) {
+            result->seconds = 1e-9;
+        }
+        attempts = (double)result->posted + (double)result->dropped;
+        if (attempts < 1.0) {
+            attempts = 1.0;
+        }
+        if (format == BATCH_FORMAT_JSON) {
+            printf("{\"producer\":%lu,\"posted\":%lu,\"dropped\":%lu,\"seconds\":%.4f,\"nsPerPost\":%.1f,"
+                   "\"error\":%lu}\n",
+                   (unsigned long)result->producer, (unsigned long)result->posted, (unsigned long)result->dropped,
+                   result->seconds, result->seconds * 1e9 / attempts, (unsigned long)result->error);
+        } else {
+            printf("%lu\t%lu\t%lu\t%.4f\t%.1f\t%lu\n", (unsigned long)result->producer, (unsigned long)result->posted,
+                   (unsigned long)result->dropped, result->seconds, result->seconds * 1e9 / attempts,
+                   (unsigned long)result->error);
+        }
+        if (result->error != RING_OK) {
+            fprintf(stderr, "Error: Producer %lu stopped: %s\n", (unsigned long)result->producer,
+                    RingErrorText(result->error));
+            failed = TRUE;
+        }
+    }
+
+    if (seconds <= 0.0) {
+        seconds = 1e-9;
+    }
+    if (format == BATCH_FORMAT_JSON) {
+        printf("{\"posted\":%lu,\"dropped\":%lu,\"decoded\":%lu,\"seconds\":%.4f,\"alertsPerSecond\":%.0f,"
+               "\"status\":%d}\n",
+               (unsigned long)posted, (unsigned long)dropped, (unsigned long)decoded, seconds,
+               (double)decoded / seconds, status);
+    } else {
+        printf("# posted\tdropped\tdecoded\tseconds\talerts/s\tstatus\n");
+        printf("%lu\t%lu\t%lu\t%.4f\t%.0f\t%d\n", (unsigned long)posted, (unsigned long)dropped,
+               (unsigned long)decoded, seconds, (double)decoded / seconds, status);
+    }
+
+    if (status < 0 || status > RETURN_WARN) {
+        fprintf(stderr, "Error: The consumer failed with status %d\n", status);
+        failed = TRUE;
+    }
+    if (decoded != posted) {
+        fprintf(stderr, "Error: %lu alerts were posted but %lu decoded\n", (unsigned long)posted,
+                (unsigned long)decoded);
+        failed = TRUE;
+    }
+    if (check.bad > 0) {
+        fprintf(stderr, "Error: %lu alerts came out of order or changed\n", (unsigned long)check.bad);
+        failed = TRUE;
+    }
+
+    return failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+/*
+ * Producer process - post alerts records, send the result back and exit
+ * Record n of a producer has task word n and the code codes[n], so the
+ * consumer can tell whether it arrived whole and in order.  A full ring
+ * drops the record and carries on, as an instrumented emulator would.
+ * With untilClosed the ring closing ends the run instead of failing it.
+ */
+static VOID RunProducer(CONST_STRPTR path, ULONG producer, ULONG alerts, BOOL untilClosed, int results)
+{
+    struct ProducerResult result;
+    struct AlertRing *ring;
+    ULONG task;
+    ULONG error;
+    double start;
+
+    memset(&result, 0, sizeof(result));
+    result.producer = producer;
+
+    ring = OpenAlertRing(path, producer, &result.error);
+    if (ring != NULL) {
+        start = Now();
+        for (task = 1; task <= alerts; task++) {
+            error = PostAlert(ring, codes[task & (RINGDRIVER_CODES - 1)], task);
+            if (error == RING_OK) {
+                result.posted++;
+            } else if (error == RING_ERROR_FULL) {
+                result.dropped++;
+            } else if (error == RING_ERROR_CLOSED && untilClosed) {
+                break;
+            } else {
+                result.error = error;
+                break;
+            }
+        }
+        result.seconds = Now() - start;
+        CloseAlertRing(ring);
+    } else if (result.error == RING_ERROR_CLOSED && untilClosed) {
+        result.error = RING_OK;
+    }
+
+    if (write(results, &result, sizeof(result)) != (ssize_t)sizeof(result)) {
+        _exit(EXIT_FAILURE);
+    }
+    _exit(EXIT_SUCCESS);
+}
+
+/*
+ * Run Insight as the consumer of the ring with its records piped back
+ * Returns its process ID with the read end of the pipe in *output, or -1.
+ */
+static pid_t StartInsight(CONST_STRPTR insight, CONST_STRPTR path, int *output)
+{
+    char *arguments[3];
+    char ringArgument[1024];
+    int records[2];
+    pid_t pid;
+
+    if (pipe(records) != 0) {
+        return -1;
+    }
+    snprintf(ringArgument, sizeof(ringArgument), "RING=%s", path);
+    arguments[0] = (char *)insight;
+    arguments[1] = ringArgument;
+    arguments[2] = NULL;
+
+    pid = fork();
+    if (pid == 0) {
+        close(records[0]);
+        if (dup2(records[1], STDOUT_FILENO) < 0) {
+            _exit(127);
+        }
+        close(records[1]);
+        execv(arguments[0], arguments);
+        _exit(127);
+    }
+    close(records[1]);
+    if (pid < 0) {
+        close(records[0]);
+        return -1;
+    }
+
+    *output = records[0];
+    return pid;
+}
+
+/*
+ * Wait for a consumer to have the ring ready for producers
+ * Returns FALSE if it exits or takes longer than RINGDRIVER_START_WAIT.
+ */
+static BOOL WaitForRing(CONST_STRPTR path, pid_t consumer)
+{
+    struct AlertRing *ring;
+    struct timespec pause;
+    ULONG waited;
+
+    pause.tv_sec = 0;
+    pause.tv_nsec = 1000000L;
+    for (waited = 0; waited < RINGDRIVER_START_WAIT; waited++) {
+        ring = OpenAlertRing(path, 0, NULL);
+        if (ring != NULL) {
+            CloseAlertRing(ring);
+            return TRUE;
+        }
+        if (waitpid(consumer, NULL, WNOHANG) != 0) {
+            return FALSE;
+        }
+        nanosleep(&pause, NULL);
+    }
+
+    return FALSE;
+}
+
+/*
+ * Count the records the consumer has written, waiting up to a millisecond for some
+ * Sets *closed once the consumer has closed its output.
+ */
+static ULONG CountLines(int input, BOOL *closed)
+{
+    static char buffer[RINGDRIVER_BUFFER_SIZE];
+    struct pollfd wait;
+    ssize_t length;
+    ULONG lines;
+    char *position;
+
+    wait.fd = input;
+    wait.events = POLLIN;
+    if (poll(&wait, 1, 1) <= 0) {
+        return 0;
+    }
+
+    length = read(input, buffer, sizeof(buffer));
+    if (length <= 0) {
+        if (length == 0 || errno != EINTR) {
+            *closed = TRUE;
+        }
+        return 0;
+    }
+
+    lines = 0;
+    position = buffer;
+    while ((position = (char *)memchr(position, '\n', (size_t)(buffer + length - position))) != NULL) {
+        lines++;
+        position++;
+    }
+
+    return lines;
+}
+
+/*
+ * Check records the driver took against what their producers posted
+ */
+static VOID CheckAlerts(struct DriverCheck *check, const struct RingAlert *alerts, ULONG count)
+{
+    const struct RingAlert *alert;
+    ULONG i;
+
+    for (i = 0; i < count; i++) {
+        alert = &alerts[i];
+        if (alert->producer == 0 || alert->producer > RINGDRIVER_MAX_PRODUCERS ||
+            alert->task <= check->lastTask[alert->producer] ||
+            alert->code != codes[alert->task & (RINGDRIVER_CODES - 1)]) {
+            check->bad++;
+        } else {
+            check->lastTask[alert->producer] = alert->task;
+        }
+    }
+    check->taken += count;
+}
+
+/*
+ * Monotonic clock in seconds
+ */
+static double Now(VOID)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return (double)now.tv_sec + (double)now.tv_nsec / 1e9;
+}
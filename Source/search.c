@@ -0,0 +1,370 @@
+/*
+ * Insight Search
+ *
+ * A query is split into terms with the indexing rules, each term is found
+ * by a binary search of the term table, and their posting lists are merged
+ * in one pass in entry order.  Entries are ranked by how many query terms
+ * they hold, then by the sum of each term's weight times a saturated term
+ * frequency.  The best results are kept in the caller's array, so a query
+ * uses no heap and reads only the posting lists of its own terms.
+ *
+ * After meditiation comes... Insight
+ *
+ * Copyright (c) 2025-26 amigazen project
+ * Licensed under BSD 2-Clause License
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <string.h>
+#include "platform.h"
+#include "error_codes.h"
+#include "idb.h"
+#include "search.h"
+#include "search_terms.h"
+
+/* No more postings in a list */
+#define SEARCH_END 0xFFFFFFFFUL
+
+/* Position in one term's posting list during a merge */
+struct PostingCursor {
+    const UBYTE *next;
+    ULONG remaining;
+    ULONG entry;              /* Current entry, SEARCH_END when done */
+    ULONG frequency;
+    ULONG weight;
+};
+
+/* Forward declarations */
+static VOID NextPosting(struct PostingCursor *cursor);
+static BOOL RanksBefore(const struct SearchHit *a, const struct SearchHit *b);
+
+/*
+ * Describe an index image from its header
+ * Checks that the sections fit in size; the postings are trusted unless
+ * CheckSearchIndex has been run.  Returns FALSE if the image is malformed.
+ */
+BOOL OpenSearchIndex(struct SearchIndex *index, const UBYTE *data, ULONG size)
+{
+    ULONG available;
+
+    if (data == NULL || size < SEARCH_HEADER_SIZE || IdbGetLong(data) != size) {
+        return FALSE;
+    }
+
+    index->data = data;
+    index->size = size;
+    index->entryCount = IdbGetLong(data + 4);
+    index->termCount = IdbGetLong(data + 8);
+    index->postingBytes = IdbGetLong(data + 12);
+    index->poolSize = IdbGetLong(data + 16);
+
+    available = size - SEARCH_HEADER_SIZE;
+    if (index->termCount > available / SEARCH_TERM_RECORD) {
+        return FALSE;
+    }
+    available -= index->termCount * SEARCH_TERM_RECORD;
+    if (index->postingBytes > available || index->poolSize != available - index->postingBytes) {
+        return FALSE;
+    }
+
+    index->terms = data + SEARCH_HEADER_SIZE;
+    index->postings = index->terms + index->termCount * SEARCH_TERM_RECORD;
+    index->pool = (const char *)index->postings + index->postingBytes;
+
+    return TRUE;
+}
+
+/*
+ * Check every term and posting of an index for a database of entryCount
+ * entries.  Terms must be terminated inside the pool and in order, and
+ * each posting list must stay inside the postings, name real entries in
+ * ascending order and have no zero frequencies.  Used on untrusted
+ * images, such as .idb files, once when they are opened.
+ */
+BOOL CheckSearchIndex(const struct SearchIndex *index, ULONG entryCount)
+{
+    const UBYTE *record;
+    const UBYTE *posting;
+    const UBYTE *end;
+    const char *previous;
+    const char *name;
+    ULONG offset;
+    ULONG count;
+    ULONG entry;
+    ULONG gap;
+    ULONG shift;
+    ULONG i;
+    BOOL first;
+
+    if (index->entryCount != entryCount || (index->poolSize > 0 && index->pool[index->poolSize - 1] != '\0')) {
+        return FALSE;
+    }
+
+    end = index->postings + index->postingBytes;
+    previous = NULL;
+    for (i = 0; i < index->termCount; i++) {
+        record = index->terms + i * SEARCH_TERM_RECORD;
+
+        offset = IdbGetLong(record);
+        if (offset >= index->poolSize) {
+            return FALSE;
+        }
+        name = index->pool + offset;
+        if (previous != NULL && strcmp(previous, name) >= 0) {
+            return FALSE;
+        }
+        previous = name;
+
+        offset = IdbGetLong(record + 4);
+        count = IdbGetWord(record + 8);
+        if (offset > index->postingBytes || count == 0) {
+            return FALSE;
+        }
+
+        posting = index->postings + offset;
+        entry = 0;
+        first = TRUE;
+        while (count > 0) {
+            gap = 0;
+            shift = 0;
+            do {
+                if (posting >= end || shift > 21) {
+                    return FALSE;
+                }
+                gap |= (ULONG)(*posting & 0x7F) << shift;
+                shift += 7;
+            } while ((*posting++ & 0x80) != 0);
+
+            /* Only the first entry of a list can be 0 */
+            if (gap == 0 && !first) {
+                return FALSE;
+            }
+            entry += gap;
+            if (entry >= entryCount || posting >= end || *posting == 0) {
+                return FALSE;
+            }
+            posting++;
+            count--;
+            first = FALSE;
+        }
+    }
+
+    return TRUE;
+}
+
+/*
+ * Describe the index of the database lookups are served from
+ * Returns FALSE if that database was written without one.
+ */
+BOOL ActiveSearchIndex(struct SearchIndex *index)
+{
+    struct InsightDatabase *database;
+
+    database = ActiveInsightDatabase();
+    if (database != NULL) {
+        return OpenSearchIndex(index, database->searchIndex, database->searchIndexSize);
+    }
+
+    return OpenSearchIndex(index, searchIndex, searchIndexSize);
+}
+
+/*
+ * Find a term, already lowercased, in the term table
+ * Returns its record number or -1.
+ */
+LONG FindSearchTerm(const struct SearchIndex *index, CONST_STRPTR term)
+{
+    ULONG low;
+    ULONG high;
+    ULONG middle;
+    int order;
+
+    low = 0;
+    high = index->termCount;
+    while (low < high) {
+        middle = low + (high - low) / 2;
+        order = strcmp(index->pool + IdbGetLong(index->terms + middle * SEARCH_TERM_RECORD), term);
+        if (order == 0) {
+            return (LONG)middle;
+        }
+        if (order < 0) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+
+    return -1;
+}
+
+/*
+ * Find the entries matching a query, best first
+ * Up to maxHits results are written to hits; returns how many.  totals,
+ * which may be NULL, receives the number of usable query terms and of
+ * entries matching any of them.  Repeated and unknown terms still count
+ * towards the terms an entry could hold.
+ */
+ULONG QuerySearchIndex(const struct SearchIndex *index, CONST_STRPTR query, struct SearchHit *hits, ULONG maxHits,
+                       struct SearchTotals *totals)
+{
+    struct PostingCursor cursors[SEARCH_MAX_TERMS];
+    char terms[SEARCH_MAX_TERMS][SEARCH_TERM_SIZE];
+    char term[SEARCH_TERM_SIZE];
+    struct SearchHit hit;
+    const UBYTE *record;
+    ULONG termCount;
+    ULONG cursorCount;
+    ULONG hitCount;
+    ULONG matches;
+    ULONG entry;
+    ULONG i;
+    ULONG j;
+    LONG found;
+
+    termCount = 0;
+    cursorCount = 0;
+    while (termCount < SEARCH_MAX_TERMS && NextSearchTerm(&query, term) > 0) {
+        for (i = 0; i < termCount; i++) {
+            if (strcmp(terms[i], term) == 0) {
+                break;
+            }
+        }
+        if (i < termCount) {
+            continue;
+        }
+        strcpy(terms[termCount++], term);
+
+        found = FindSearchTerm(index, term);
+        if (found >= 0) {
+            record = index->terms + (ULONG)found * SEARCH_TERM_RECORD;
+            cursors[cursorCount].next = index->postings + IdbGetLong(record + 4);
+            cursors[cursorCount].remaining = IdbGetWord(record + 8);
+            cursors[cursorCount].weight = IdbGetWord(record + 10);
+            cursors[cursorCount].entry = 0;
+            NextPosting(&cursors[cursorCount]);
+            cursorCount++;
+        }
+    }
+
+    /* Merge the lists, scoring each entry as the lowest one comes up */
+    hitCount = 0;
+    matches = 0;
+    for (;;) {
+        entry = SEARCH_END;
+        for (i = 0; i < cursorCount; i++) {
+            if (cursors[i].entry < entry) {
+                entry = cursors[i].entry;
+            }
+        }
+        if (entry == SEARCH_END) {
+            break;
+        }
+
+        hit.entry = entry;
+        hit.score = 0;
+        hit.terms = 0;
+        for (i = 0; i < cursorCount; i++) {
+            if (cursors[i].entry == entry) {
+                hit.score += cursors[i].weight * cursors[i].frequency * (SEARCH_SATURATION + 1) /
+                             (cursors[i].frequency + SEARCH_SATURATION);
+                hit.terms++;
+                NextPosting(&cursors[i]);
+            }
+        }
+        matches++;
+
+        /* Insert into the best results so far - entries come in order, so ties keep the earlier one */
+        if (hitCount < maxHits || (maxHits > 0 && RanksBefore(&hit, &hits[maxHits - 1]))) {
+            j = (hitCount < maxHits) ? hitCount++ : maxHits - 1;
+            while (j > 0 && RanksBefore(&hit, &hits[j - 1])) {
+                hits[j] = hits[j - 1];
+                j--;
+            }
+            hits[j] = hit;
+        }
+    }
+
+    if (totals != NULL) {
+        totals->terms = termCount;
+        totals->matches = matches;
+    }
+
+    return hitCount;
+}
+
+/*
+ * Search the database lookups are served from
+ * A database file without an index matches nothing.
+ */
+ULONG SearchInsights(CONST_STRPTR query, struct SearchHit *hits, ULONG maxHits, struct SearchTotals *totals)
+{
+    struct SearchIndex index;
+
+    if (!ActiveSearchIndex(&index)) {
+        if (totals != NULL) {
+            totals->terms = 0;
+            totals->matches = 0;
+        }
+        return 0;
+    }
+
+    return QuerySearchIndex(&index, query, hits, maxHits, totals);
+}
+
+/*
+ * Step a cursor to its next posting, or to SEARCH_END
+ */
+static VOID NextPosting(struct PostingCursor *cursor)
+{
+    ULONG gap;
+    ULONG shift;
+
+    if (cursor->remaining == 0) {
+        cursor->entry = SEARCH_END;
+        return;
+    }
+
+    gap = 0;
+    shift = 0;
+    do {
+        gap |= (ULONG)(*cursor->next & 0x7F) << shift;
+        shift += 7;
+    } while ((*cursor->next++ & 0x80) != 0);
+
+    cursor->entry += gap;
+    cursor->frequency = *cursor->next++;
+    cursor->remaining--;
+}
+
+/*
+ * Ranking order - more query terms first, then the higher score
+ */
+static BOOL RanksBefore(const struct SearchHit *a, const struct SearchHit *b)
+{
+    if (a->terms != b->terms) {
+        return (BOOL)(a->terms > b->terms);
+    }
+
+    return (BOOL)(a->score > b->score);
+}
@@ -0,0 +1,116 @@
+/*
+ * Insight Search
+ *
+ * Full-text search over the descriptions and expanded insights.  gentables
+ * builds an inverted index at build time: a sorted term table, and for each
+ * term the entries that use it.  It is stored as big-endian bytes, so the
+ * same image is compiled in and carried in .idb files, and queries read it
+ * in place.
+ *
+ * After meditiation comes... Insight
+ *
+ * Copyright (c) 2025-26 amigazen project
+ * Licensed under BSD 2-Clause License
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef SEARCH_H
+#define SEARCH_H
+
+#include "platform.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Index layout - a header of ULONGs, then the term records, the posting
+ * lists and the term strings:
+ *   size, entry count, term count, posting bytes, pool size
+ *   per term: pool offset (ULONG), posting offset (ULONG),
+ *             entry count (UWORD), weight (UWORD)
+ *   per posting: entry as a gap from the previous one, 7 bits per byte
+ *                low first with the top bit set on all but the last,
+ *                then the entry's term frequency as one byte
+ * Terms are in strcmp order and each posting list in entry order.
+ */
+#define SEARCH_HEADER_SIZE 20
+#define SEARCH_TERM_RECORD 12
+
+/* Descriptions count this many times the insight text */
+#define SEARCH_DESCRIPTION_WEIGHT 4
+
+/* Term frequency saturation - a term repeated in one entry adds at most (K + 1) times its weight */
+#define SEARCH_SATURATION 2
+
+/* Terms used from one query - the rest are ignored */
+#define SEARCH_MAX_TERMS 8
+
+/* Results TOP asks for when it is not given */
+#define SEARCH_TOP_DEFAULT 10
+
+/* Index view - all pointers point into data */
+struct SearchIndex {
+    const UBYTE *data;
+    ULONG size;
+    ULONG entryCount;
+    ULONG termCount;
+    ULONG postingBytes;
+    ULONG poolSize;
+    const UBYTE *terms;
+    const UBYTE *postings;
+    const char *pool;
+};
+
+/* One matching entry */
+struct SearchHit {
+    ULONG entry;        /* Database entry index */
+    ULONG score;
+    ULONG terms;        /* Query terms the entry contains */
+};
+
+/* What a query matched */
+struct SearchTotals {
+    ULONG terms;        /* Usable terms in the query */
+    ULONG matches;      /* Entries containing any of them */
+};
+
+/* Generated index - see gentables.c */
+extern const ULONG searchIndexSize;
+extern const UBYTE searchIndex[];
+
+/* Function declarations */
+BOOL OpenSearchIndex(struct SearchIndex *index, const UBYTE *data, ULONG size);
+BOOL CheckSearchIndex(const struct SearchIndex *index, ULONG entryCount);
+BOOL ActiveSearchIndex(struct SearchIndex *index);
+LONG FindSearchTerm(const struct SearchIndex *index, CONST_STRPTR term);
+ULONG QuerySearchIndex(const struct SearchIndex *index, CONST_STRPTR query, struct SearchHit *hits, ULONG maxHits,
+                       struct SearchTotals *totals);
+ULONG SearchInsights(CONST_STRPTR query, struct SearchHit *hits, ULONG maxHits, struct SearchTotals *totals);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SEARCH_H */
@@ -0,0 +1,108 @@
+/*
+ * Search Terms
+ *
+ * Splits text into search terms.  gentables indexes the database with
+ * these rules and the runtime splits queries with them, so they live here
+ * rather than in either file.
+ *
+ * After meditiation comes... Insight
+ *
+ * Copyright (c) 2025-26 amigazen project
+ * Licensed under BSD 2-Clause License
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef SEARCH_TERMS_H
+#define SEARCH_TERMS_H
+
+#include <string.h>
+#include "platform.h"
+
+/* Longest term kept, with its terminator - longer words are cut to fit */
+#define SEARCH_TERM_SIZE 32
+
+/* Words too common to be worth indexing */
+static const char *const searchStopWords[] = {
+    "an", "and", "are", "as", "at", "be", "but", "by", "can", "for", "from",
+    "has", "have", "if", "in", "into", "is", "it", "its", "may", "no", "not",
+    "of", "on", "or", "so", "that", "the", "then", "this", "to", "was",
+    "when", "which", "will", "with", NULL
+};
+
+/*
+ * Read the next term from *cursor into term, which holds SEARCH_TERM_SIZE
+ * A term is a run of ASCII letters and digits, lowercased.  Single
+ * characters and stop words are skipped.  Returns the term's length, or 0
+ * at the end of the text.
+ */
+static ULONG NextSearchTerm(CONST_STRPTR *cursor, char *term)
+{
+    const UBYTE *text;
+    ULONG length;
+    ULONG i;
+    UBYTE c;
+
+    text = (const UBYTE *)*cursor;
+
+    for (;;) {
+        while (*text != '\0' && !((*text >= 'a' && *text <= 'z') || (*text >= 'A' && *text <= 'Z') ||
+                                  (*text >= '0' && *text <= '9'))) {
+            text++;
+        }
+        if (*text == '\0') {
+            *cursor = (CONST_STRPTR)text;
+            return 0;
+        }
+
+        length = 0;
+        for (;;) {
+            c = *text;
+            if (c >= 'A' && c <= 'Z') {
+                c = (UBYTE)(c - 'A' + 'a');
+            } else if (!((c >= 'a' && c <= 'z') || (c >= '0' && c <= '9'))) {
+                break;
+            }
+            if (length < SEARCH_TERM_SIZE - 1) {
+                term[length++] = (char)c;
+            }
+            text++;
+        }
+        term[length] = '\0';
+
+        if (length < 2) {
+            continue;
+        }
+        for (i = 0; searchStopWords[i] != NULL; i++) {
+            if (strcmp(term, searchStopWords[i]) == 0) {
+                break;
+            }
+        }
+        if (searchStopWords[i] == NULL) {
+            *cursor = (CONST_STRPTR)text;
+            return length;
+        }
+    }
+}
+
+#endif /* SEARCH_TERMS_H */
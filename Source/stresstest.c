@@ -0,0 +1,229 @@
+/*
+ * Decoding Stress Test
+ *
+ * Concurrency check for the reentrant decoding functions.  Decodes every
+ * database entry once on one thread with GainInsightInto,
+ * ExpandExplanationInto and WrapTextInto, then has THREADS threads decode
+ * them all again ROUNDS times, each starting at a different entry, and
+ * compares every result byte for byte with the single-threaded one.  Any
+ * difference gives a non-zero exit.  Build with -fsanitize=thread to have
+ * races reported as well as wrong output.
+ *
+ * Usage: insight_stress [THREADS=<n>] [ROUNDS=<n>]
+ *
+ * After meditiation comes... Insight
+ *
+ * Copyright (c) 2025-26 amigazen project
+ * Licensed under BSD 2-Clause License
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include "libinsight.h"
+#include "wordwrap.h"
+#include "hosttools.h"
+
+/* Defaults and limits */
+#define STRESS_DEFAULT_THREADS 8
+#define STRESS_MAX_THREADS     256
+#define STRESS_DEFAULT_ROUNDS  20
+
+/* Width the insight text is wrapped to, in pixels of the stand-in font */
+#define STRESS_WRAP_WIDTH 320
+
+/* What single-threaded decoding gave for one entry */
+struct StressExpected {
+    LONG length;                     /* GainInsightInto result */
+    char *insight;                   /* Expanded by GainInsightInto, and by ExpandExplanationInto */
+    char *wrapped;                   /* The insight after WrapTextInto */
+    ULONG wrappedLength;
+};
+
+/* One worker thread */
+struct StressWorker {
+    pthread_t thread;
+    ULONG first;                     /* Entry the thread starts each round at */
+    ULONG mismatches;
+};
+
+static struct StressExpected *expected;
+static ULONG entryCount;
+static ULONG rounds;
+
+/* Forward declarations */
+static BOOL DecodeExpected(VOID);
+static ULONG CheckEntry(struct GlyphMetrics *metrics, ULONG index, char *insight, char *wrapped);
+static VOID *RunWorker(VOID *arg);
+static ULONG StressGlyphWidth(UBYTE glyph, APTR font);
+
+int main(int argc, char *argv[])
+{
+    struct StressWorker *workers;
+    const char *value;
+    ULONG threads;
+    ULONG started;
+    ULONG mismatches;
+    ULONG i;
+    int arg;
+
+    threads = STRESS_DEFAULT_THREADS;
+    rounds = STRESS_DEFAULT_ROUNDS;
+    for (arg = 1; arg < argc; arg++) {
+        if (MatchKeyword(argv[arg], "THREADS", &value) && value != NULL && atol(value) > 0 &&
+            atol(value) <= STRESS_MAX_THREADS) {
+            threads = (ULONG)atol(value);
+        } else if (MatchKeyword(argv[arg], "ROUNDS", &value) && value != NULL && atol(value) > 0) {
+            rounds = (ULONG)strtoul(value, NULL, 10);
+        } else {
+            fprintf(stderr, "Usage: insight_stress [THREADS=<n>] [ROUNDS=<n>]\n");
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (!DecodeExpected()) {
+        fprintf(stderr, "Error: Out of memory\n");
+        return EXIT_FAILURE;
+    }
+
+    workers = (struct StressWorker *)calloc(threads, sizeof(struct StressWorker));
+    if (workers == NULL) {
+        fprintf(stderr, "Error: Out of memory\n");
+        return EXIT_FAILURE;
+    }
+
+    /* Spread the starting entries so threads hit different entries at the same time */
+    for (started = 0; started < threads; started++) {
+        workers[started].first = (ULONG)(((unsigned long long)started * entryCount) / threads);
+        if (pthread_create(&workers[started].thread, NULL, RunWorker, &workers[started]) != 0) {
+            fprintf(stderr, "Error: Cannot start thread %lu\n", (unsigned long)(started + 1));
+            break;
+        }
+    }
+
+    mismatches = 0;
+    for (i = 0; i < started; i++) {
+        pthread_join(workers[i].thread, NULL);
+        mismatches += workers[i].mismatches;
+    }
+    free(workers);
+
+    printf("%lu threads, %lu rounds of %lu entries, %lu mismatches\n", (unsigned long)started,
+           (unsigned long)rounds, (unsigned long)entryCount, (unsigned long)mismatches);
+
+    return (started == threads && mismatches == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+/*
+ * Decode every entry on this thread alone, as the reference
+ */
+static BOOL DecodeExpected(VOID)
+{
+    struct GlyphMetrics metrics;
+    struct StressExpected *entry;
+    char insight[INSIGHT_MAX_LENGTH];
+    char wrapped[INSIGHT_MAX_LENGTH];
+    ULONG i;
+
+    entryCount = InsightEntryCount();
+    expected = (struct StressExpected *)calloc(entryCount, sizeof(struct StressExpected));
+    if (expected == NULL) {
+        return FALSE;
+    }
+
+    InitGlyphMetrics(&metrics, StressGlyphWidth, NULL);
+    for (i = 0; i < entryCount; i++) {
+        entry = &expected[i];
+        entry->length = GainInsightInto(InsightEntryAt(i)->code, NULL, insight, sizeof(insight));
+        entry->wrappedLength = WrapTextInto(&metrics, insight, STRESS_WRAP_WIDTH, wrapped, sizeof(wrapped));
+        entry->insight = (char *)malloc(strlen(insight) + 1);
+        entry->wrapped = (char *)malloc(strlen(wrapped) + 1);
+        if (entry->insight == NULL || entry->wrapped == NULL) {
+            return FALSE;
+        }
+        strcpy(entry->insight, insight);
+        strcpy(entry->wrapped, wrapped);
+    }
+
+    return TRUE;
+}
+
+/*
+ * Decode one entry again and count how many results differ from the reference
+ */
+static ULONG CheckEntry(struct GlyphMetrics *metrics, ULONG index, char *insight, char *wrapped)
+{
+    const struct StressExpected *entry = &expected[index];
+    struct ErrorView view;
+    ULONG mismatches;
+
+    mismatches = 0;
+    if (GainInsightInto(InsightEntryAt(index)->code, &view, insight, INSIGHT_MAX_LENGTH) != entry->length ||
+        strcmp(insight, entry->insight) != 0) {
+        mismatches++;
+    }
+    if (ExpandExplanationInto(view.insight, insight, INSIGHT_MAX_LENGTH) != view.insightLength ||
+        strcmp(insight, entry->insight) != 0) {
+        mismatches++;
+    }
+    if (WrapTextInto(metrics, insight, STRESS_WRAP_WIDTH, wrapped, INSIGHT_MAX_LENGTH) != entry->wrappedLength ||
+        strcmp(wrapped, entry->wrapped) != 0) {
+        mismatches++;
+    }
+
+    return mismatches;
+}
+
+/*
+ * Worker thread - decode every entry rounds times, from its own first entry
+ * Each thread measures glyphs into its own metrics, as each requester does.
+ */
+static VOID *RunWorker(VOID *arg)
+{
+    struct StressWorker *worker = (struct StressWorker *)arg;
+    struct GlyphMetrics metrics;
+    char insight[INSIGHT_MAX_LENGTH];
+    char wrapped[INSIGHT_MAX_LENGTH];
+    ULONG round;
+    ULONG i;
+
+    InitGlyphMetrics(&metrics, StressGlyphWidth, NULL);
+    for (round = 0; round < rounds; round++) {
+        for (i = 0; i < entryCount; i++) {
+            worker->mismatches += CheckEntry(&metrics, (worker->first + i) % entryCount, insight, wrapped);
+        }
+    }
+
+    return NULL;
+}
+
+/*
+ * Stand-in proportional font - 4 pixel spaces, 5 to 8 pixel glyphs
+ */
+static ULONG StressGlyphWidth(UBYTE glyph, APTR font)
+{
+    return (glyph == ' ') ? 4 : 5 + (glyph & 3);
+}
@@ -0,0 +1,371 @@
+/*
+ * Alert Summaries
+ *
+ * Subsystem and deadend counts are plain arrays indexed from the code.
+ * The heavy hitters are a min-heap on count, so the code to evict when a
+ * new one arrives is always at the root, with an open addressed hash from
+ * code to heap position beside it.  Space-Saving gives a new code the
+ * evicted count as its starting count and remembers that as its error, so
+ * counts never understate and any code seen more than codes / SUMMARY_SLOTS
+ * times is always held.
+ *
+ * After meditiation comes... Insight
+ *
+ * Copyright (c) 2025-26 amigazen project
+ * Licensed under BSD 2-Clause License
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "summary.h"
+
+/* Spreads codes over the hash - Knuth's multiplicative constant */
+#define SUMMARY_HASH_MULTIPLIER 0x9E3779B1UL
+#define SUMMARY_HASH_MASK       (SUMMARY_HASH_SIZE - 1)
+
+/* Forward declarations */
+static ULONG HashSlot(ULONG alertCode);
+static ULONG FindSlot(const struct AlertSummary *summary, ULONG alertCode);
+static VOID RemoveSlot(struct AlertSummary *summary, ULONG hole);
+static VOID SwapHitters(struct AlertSummary *summary, ULONG a, ULONG b);
+static VOID SiftUp(struct AlertSummary *summary, ULONG index);
+static VOID SiftDown(struct AlertSummary *summary, ULONG index);
+static int CompareHitters(const VOID *a, const VOID *b);
+
+/*
+ * Allocate an empty summary
+ * Returns NULL if out of memory
+ */
+struct AlertSummary *AllocAlertSummary(VOID)
+{
+    struct AlertSummary *summary;
+
+    summary = (struct AlertSummary *)malloc(sizeof(struct AlertSummary));
+    if (summary != NULL) {
+        ResetAlertSummary(summary);
+    }
+
+    return summary;
+}
+
+/*
+ * Free a summary from AllocAlertSummary - NULL is allowed
+ */
+VOID FreeAlertSummary(struct AlertSummary *summary)
+{
+    free(summary);
+}
+
+/*
+ * Forget everything counted so far
+ */
+VOID ResetAlertSummary(struct AlertSummary *summary)
+{
+    memset(summary, 0, sizeof(struct AlertSummary));
+}
+
+/*
+ * Count one alert code
+ * A code not yet tracked takes a free counter, or when all are in use
+ * replaces the least counted code and carries on from its count.
+ */
+VOID CountAlertCode(struct AlertSummary *summary, ULONG alertCode)
+{
+    struct HeavyHitter *hitter;
+    ULONG slot;
+    ULONG index;
+
+    summary->codes++;
+    summary->subsystems[(alertCode >> 24) & (ALERT_SUBSYSTEMS - 1)][alertCode >> 31]++;
+
+    slot = FindSlot(summary, alertCode);
+    if (summary->hash[slot] != 0) {
+        index = summary->hash[slot] - 1;
+        summary->hitters[index].count++;
+        SiftDown(summary, index);
+        return;
+    }
+
+    if (summary->slots < SUMMARY_SLOTS) {
+        index = summary->slots++;
+        hitter = &summary->hitters[index];
+        hitter->code = alertCode;
+        hitter->count = 1;
+        hitter->error = 0;
+        summary->hash[slot] = (UWORD)(index + 1);
+        summary->home[index] = (UWORD)slot;
+        SiftUp(summary, index);
+        return;
+    }
+
+    /* Removing the evicted code can shift the new code's slot */
+    RemoveSlot(summary, summary->home[0]);
+    hitter = &summary->hitters[0];
+    hitter->code = alertCode;
+    hitter->error = hitter->count;
+    hitter->count++;
+    slot = FindSlot(summary, alertCode);
+    summary->hash[slot] = 1;
+    summary->home[0] = (UWORD)slot;
+    SiftDown(summary, 0);
+}
+
+/*
+ * Add the counts of another summary to this one
+ * A code missing from a full summary may have been evicted from it, so
+ * it is credited with that summary's smallest count, which it cannot
+ * have exceeded.  The SUMMARY_SLOTS highest counts are kept.  Returns
+ * FALSE if out of memory, leaving summary unchanged.
+ */
+BOOL MergeAlertSummary(struct AlertSummary *summary, const struct AlertSummary *other)
+{
+    struct HeavyHitter *merged;
+    struct HeavyHitter *hitter;
+    SUMMARYCOUNT floor;
+    SUMMARYCOUNT otherFloor;
+    ULONG count;
+    ULONG slot;
+    ULONG i;
+    ULONG j;
+
+    merged = (struct HeavyHitter *)malloc((summary->slots + other->slots + 1) * sizeof(struct HeavyHitter));
+    if (merged == NULL) {
+        return FALSE;
+    }
+
+    floor = (summary->slots == SUMMARY_SLOTS) ? summary->hitters[0].count : 0;
+    otherFloor = (other->slots == SUMMARY_SLOTS) ? other->hitters[0].count : 0;
+
+    count = 0;
+    for (i = 0; i < summary->slots; i++) {
+        hitter = &merged[count++];
+        *hitter = summary->hitters[i];
+        slot = FindSlot(other, hitter->code);
+        if (other->hash[slot] != 0) {
+            hitter->count += other->hitters[other->hash[slot] - 1].count;
+            hitter->error += other->hitters[other->hash[slot] - 1].error;
+        } else {
+            hitter->count += otherFloor;
+            hitter->error += otherFloor;
+        }
+    }
+    for (i = 0; i < other->slots; i++) {
+        if (summary->hash[FindSlot(summary, other->hitters[i].code)] == 0) {
+            hitter = &merged[count++];
+            *hitter = other->hitters[i];
+            hitter->count += floor;
+            hitter->error += floor;
+        }
+    }
+
+    summary->codes += other->codes;
+    summary->invalid += other->invalid;
+    for (i = 0; i < ALERT_SUBSYSTEMS; i++) {
+        summary->subsystems[i][0] += other->subsystems[i][0];
+        summary->subsystems[i][1] += other->subsystems[i][1];
+    }
+
+    /* Highest counts first - kept in reverse, ascending order is already a min-heap */
+    qsort(merged, count, sizeof(struct HeavyHitter), CompareHitters);
+    if (count > SUMMARY_SLOTS) {
+        count = SUMMARY_SLOTS;
+    }
+
+    memset(summary->hash, 0, sizeof(summary->hash));
+    summary->slots = count;
+    for (i = 0; i < count; i++) {
+        j = count - 1 - i;
+        summary->hitters[j] = merged[i];
+        slot = FindSlot(summary, merged[i].code);
+        summary->hash[slot] = (UWORD)(j + 1);
+        summary->home[j] = (UWORD)slot;
+    }
+
+    free(merged);
+
+    return TRUE;
+}
+
+/*
+ * Copy out the most counted codes, highest count first
+ * Equal counts are listed by code.  Returns the number copied, at most
+ * maximum.
+ */
+ULONG TopAlertCodes(const struct AlertSummary *summary, struct HeavyHitter *top, ULONG maximum)
+{
+    ULONG count;
+    ULONG i;
+    ULONG j;
+
+    count = 0;
+    for (i = 0; i < summary->slots; i++) {
+        if (count == maximum && (maximum == 0 || CompareHitters(&summary->hitters[i], &top[count - 1]) >= 0)) {
+            continue;
+        }
+
+        /* Insertion sort - maximum is a handful of report lines */
+        j = (count < maximum) ? count++ : count - 1;
+        while (j > 0 && CompareHitters(&summary->hitters[i], &top[j - 1]) < 0) {
+            top[j] = top[j - 1];
+            j--;
+        }
+        top[j] = summary->hitters[i];
+    }
+
+    return count;
+}
+
+/*
+ * Home slot of a code in the hash
+ */
+static ULONG HashSlot(ULONG alertCode)
+{
+    return (ULONG)(((alertCode * SUMMARY_HASH_MULTIPLIER) & 0xFFFFFFFFUL) >> (32 - SUMMARY_HASH_BITS));
+}
+
+/*
+ * Find the hash slot holding a code, or the empty slot where it belongs
+ * The hash is never more than half full, so there always is one.
+ */
+static ULONG FindSlot(const struct AlertSummary *summary, ULONG alertCode)
+{
+    ULONG slot;
+
+    slot = HashSlot(alertCode);
+    while (summary->hash[slot] != 0 && summary->hitters[summary->hash[slot] - 1].code != alertCode) {
+        slot = (slot + 1) & SUMMARY_HASH_MASK;
+    }
+
+    return slot;
+}
+
+/*
+ * Empty a hash slot, moving later entries of the probe run back into the
+ * hole so every entry stays reachable from its home slot
+ */
+static VOID RemoveSlot(struct AlertSummary *summary, ULONG hole)
+{
+    ULONG next;
+    ULONG home;
+
+    next = hole;
+    for (;;) {
+        next = (next + 1) & SUMMARY_HASH_MASK;
+        if (summary->hash[next] == 0) {
+            break;
+        }
+
+        /* Only an entry whose home is not between the hole and here can move */
+        home = HashSlot(summary->hitters[summary->hash[next] - 1].code);
+        if (((next - home) & SUMMARY_HASH_MASK) >= ((next - hole) & SUMMARY_HASH_MASK)) {
+            summary->hash[hole] = summary->hash[next];
+            summary->home[summary->hash[hole] - 1] = (UWORD)hole;
+            hole = next;
+        }
+    }
+
+    summary->hash[hole] = 0;
+}
+
+/*
+ * Exchange two heap entries and point their hash slots at the new places
+ */
+static VOID SwapHitters(struct AlertSummary *summary, ULONG a, ULONG b)
+{
+    struct HeavyHitter hitter;
+    UWORD home;
+
+    hitter = summary->hitters[a];
+    summary->hitters[a] = summary->hitters[b];
+    summary->hitters[b] = hitter;
+
+    home = summary->home[a];
+    summary->home[a] = summary->home[b];
+    summary->home[b] = home;
+
+    summary->hash[summary->home[a]] = (UWORD)(a + 1);
+    summary->hash[summary->home[b]] = (UWORD)(b + 1);
+}
+
+/*
+ * Move an entry towards the root while its count is below its parent's
+ */
+static VOID SiftUp(struct AlertSummary *summary, ULONG index)
+{
+    ULONG parent;
+
+    while (index > 0) {
+        parent = (index - 1) / 2;
+        if (summary->hitters[parent].count <= summary->hitters[index].count) {
+            break;
+        }
+        SwapHitters(summary, index, parent);
+        index = parent;
+    }
+}
+
+/*
+ * Move an entry away from the root while a child has a lower count
+ */
+static VOID SiftDown(struct AlertSummary *summary, ULONG index)
+{
+    ULONG child;
+
+    for (;;) {
+        child = index * 2 + 1;
+        if (child >= summary->slots) {
+            break;
+        }
+        if (child + 1 < summary->slots && summary->hitters[child + 1].count < summary->hitters[child].count) {
+            child++;
+        }
+        if (summary->hitters[index].count <= summary->hitters[child].count) {
+            break;
+        }
+        SwapHitters(summary, index, child);
+        index = child;
+    }
+}
+
+/*
+ * qsort order of heavy hitters - highest count first, then lowest code
+ */
+static int CompareHitters(const VOID *a, const VOID *b)
+{
+    const struct HeavyHitter *first;
+    const struct HeavyHitter *second;
+
+    first = (const struct HeavyHitter *)a;
+    second = (const struct HeavyHitter *)b;
+
+    if (first->count != second->count) {
+        return (first->count > second->count) ? -1 : 1;
+    }
+    if (first->code != second->code) {
+        return (first->code < second->code) ? -1 : 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,96 @@
+/*
+ * Alert Summaries
+ *
+ * Counts a stream of alert codes in constant memory.  Every code is
+ * counted exactly by subsystem and by deadend or recoverable, and the most
+ * frequent specific codes are tracked with the Space-Saving heavy hitter
+ * algorithm in SUMMARY_SLOTS counters, however many codes and however
+ * many distinct codes are fed in.  Summaries kept apart, such as one per
+ * decoding thread, merge into one at the end.
+ *
+ * After meditiation comes... Insight
+ *
+ * Copyright (c) 2025-26 amigazen project
+ * Licensed under BSD 2-Clause License
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef SUMMARY_H
+#define SUMMARY_H
+
+#include "platform.h"
+#include "decompose.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Heavy hitter counters - up to this many distinct codes are counted exactly */
+#define SUMMARY_SLOTS 1024
+
+/* Open addressed index from code to counter, a power of two above SUMMARY_SLOTS */
+#define SUMMARY_HASH_BITS 11
+#define SUMMARY_HASH_SIZE (1UL << SUMMARY_HASH_BITS)
+
+/* Codes listed in a report when no count is given */
+#define SUMMARY_TOP_DEFAULT 20
+
+/* Counts - 64 bits on hosts, which may be summarising far more than 4G codes */
+#ifdef INSIGHT_AMIGA
+typedef ULONG SUMMARYCOUNT;
+#else
+typedef uint64_t SUMMARYCOUNT;
+#endif
+
+/* A tracked code - the true count lies between count - error and count */
+struct HeavyHitter {
+    ULONG code;
+    SUMMARYCOUNT count;
+    SUMMARYCOUNT error;      /* Most that count can overstate */
+};
+
+/* Counts of a stream of codes - allocate with AllocAlertSummary, it is large */
+struct AlertSummary {
+    SUMMARYCOUNT codes;                                /* Codes counted */
+    SUMMARYCOUNT invalid;                              /* Input lines that were not a code */
+    SUMMARYCOUNT subsystems[ALERT_SUBSYSTEMS][2];      /* Codes by subsystem, [1] deadend */
+    ULONG slots;                                       /* Hitters in use */
+    struct HeavyHitter hitters[SUMMARY_SLOTS];         /* Min-heap on count */
+    UWORD home[SUMMARY_SLOTS];                         /* Hash slot of each hitter */
+    UWORD hash[SUMMARY_HASH_SIZE];                     /* Hitter index + 1, 0 if empty */
+};
+
+/* Function declarations */
+struct AlertSummary *AllocAlertSummary(VOID);
+VOID FreeAlertSummary(struct AlertSummary *summary);
+VOID ResetAlertSummary(struct AlertSummary *summary);
+VOID CountAlertCode(struct AlertSummary *summary, ULONG alertCode);
+BOOL MergeAlertSummary(struct AlertSummary *summary, const struct AlertSummary *other);
+ULONG TopAlertCodes(const struct AlertSummary *summary, struct HeavyHitter *top, ULONG maximum);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SUMMARY_H */
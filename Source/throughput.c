@@ -0,0 +1,348 @@
+/*
+ * Throughput Benchmark
+ *
+ * End-to-end throughput test for the host front end.  Runs the Insight
+ * binary over corpora written by gencorpus, the way it is used in
+ * practice: reading the file, scanning or decoding every line and
+ * formatting records to an output that is thrown away.  Each run is timed
+ * by wall clock and the best of REPEAT is kept, with the child's peak
+ * resident set size from wait4().  Results are MB/s and lines/s of input
+ * in TSV or JSON.  With MINIMUM= a run below that many MB/s, or one that
+ * fails, gives a non-zero exit, so the tool can gate a build.
+ *
+ * Usage: insight_throughput INSIGHT=<binary> [FROM=<batch corpus>]
+ *                           [SCAN=<log corpus>] [THREADS=<n>] [REPEAT=<n>]
+ *                           [FORMAT=tsv|json] [MINIMUM=<MB/s>]
+ *
+ * After meditiation comes... Insight
+ *
+ * Copyright (c) 2025-26 amigazen project
+ * Licensed under BSD 2-Clause License
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/time.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include "libinsight.h"
+#include "batch.h"
+#include "hosttools.h"
+
+/* Inputs */
+#define INPUT_FROM 0
+#define INPUT_SCAN 1
+#define INPUTS     2
+
+/* Defaults */
+#define THROUGHPUT_DEFAULT_REPEAT 3
+#define THROUGHPUT_MAX_REPEAT     100
+
+/* Corpus read block for counting lines */
+#define THROUGHPUT_BUFFER_SIZE 1048576
+
+/* Most arguments one run passes to Insight, with the terminating NULL */
+#define THROUGHPUT_MAX_ARGS 6
+
+/* Insight return codes - anything above a warning is a failed run */
+#define RETURN_WARN 5
+
+/* One way of running Insight over a corpus */
+struct ThroughputRun {
+    CONST_STRPTR name;
+    ULONG input;                     /* INPUT_xxx */
+    CONST_STRPTR option;             /* Extra argument, or NULL */
+};
+
+/* Best timing of a run */
+struct ThroughputResult {
+    double seconds;                  /* Fastest wall clock time */
+    long peakKilobytes;              /* Largest peak resident set */
+    int status;                      /* Worst exit status, -1 if Insight did not run or was killed */
+};
+
+static const struct ThroughputRun runs[] = {
+    { "from",         INPUT_FROM, NULL },
+    { "from-json",    INPUT_FROM, "FORMAT=json" },
+    { "from-summary", INPUT_FROM, "SUMMARY" },
+    { "scan",         INPUT_SCAN, NULL },
+    { "scan-strict",  INPUT_SCAN, "STRICT" },
+    { "scan-summary", INPUT_SCAN, "SUMMARY" }
+};
+
+#define RUN_COUNT (sizeof(runs) / sizeof(runs[0]))
+
+/* Forward declarations */
+static BOOL CountCorpus(const char *fileName, uint64_t *bytes, uint64_t *lines);
+static VOID MeasureRun(char *const arguments[], ULONG repeat, struct ThroughputResult *result);
+static double Now(VOID);
+
+int main(int argc, char *argv[])
+{
+    struct ThroughputResult result;
+    const struct ThroughputRun *run;
+    const char *corpus[INPUTS];
+    const char *insight;
+    const char *value;
+    char *arguments[THROUGHPUT_MAX_ARGS];
+    char inputArgument[1024];
+    char threadArgument[32];
+    uint64_t bytes[INPUTS];
+    uint64_t lines[INPUTS];
+    double minimum;
+    double megabytes;
+    ULONG threads;
+    ULONG repeat;
+    ULONG input;
+    ULONG count;
+    ULONG i;
+    LONG format;
+    BOOL failed;
+    int arg;
+
+    insight = NULL;
+    corpus[INPUT_FROM] = NULL;
+    corpus[INPUT_SCAN] = NULL;
+    format = BATCH_FORMAT_TSV;
+    threads = 0;
+    repeat = THROUGHPUT_DEFAULT_REPEAT;
+    minimum = 0.0;
+
+    for (arg = 1; arg < argc; arg++) {
+        if (MatchKeyword(argv[arg], "INSIGHT", &value) && value != NULL) {
+            insight = value;
+        } else if (MatchKeyword(argv[arg], "FROM", &value) && value != NULL) {
+            corpus[INPUT_FROM] = value;
+        } else if (MatchKeyword(argv[arg], "SCAN", &value) && value != NULL) {
+            corpus[INPUT_SCAN] = value;
+        } else if (MatchKeyword(argv[arg], "FORMAT", &value) && value != NULL) {
+            format = FindBatchFormat(value);
+            if (format < 0) {
+                fprintf(stderr, "Error: Unknown output format. Use tsv or json.\n");
+                return EXIT_FAILURE;
+            }
+        } else if (MatchKeyword(argv[arg], "THREADS", &value) && value != NULL) {
+            threads = (ULONG)strtoul(value, NULL, 10);
+        } else if (MatchKeyword(argv[arg], "REPEAT", &value) && value != NULL && atol(value) > 0 &&
+                   atol(value) <= THROUGHPUT_MAX_REPEAT) {
+            repeat = (ULONG)atol(value);
+        } else if (MatchKeyword(argv[arg], "MINIMUM", &value) && value != NULL) {
+            minimum = atof(value);
+        } else {
+            insight = NULL;
+            break;
+        }
+    }
+
+    if (insight == NULL || (corpus[INPUT_FROM] == NULL && corpus[INPUT_SCAN] == NULL)) {
+        fprintf(stderr, "Usage: insight_throughput INSIGHT=<binary> [FROM=<batch corpus>] [SCAN=<log corpus>]\n"
+                        "                          [THREADS=<n>] [REPEAT=<n>] [FORMAT=tsv|json] [MINIMUM=<MB/s>]\n");
+        return EXIT_FAILURE;
+    }
+
+    /* Counting lines also reads each corpus into the file cache, so runs time decoding rather than the disk */
+    for (input = 0; input < INPUTS; input++) {
+        if (corpus[input] != NULL && !CountCorpus(corpus[input], &bytes[input], &lines[input])) {
+            fprintf(stderr, "Error: Cannot read %s\n", corpus[input]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (format == BATCH_FORMAT_JSON) {
+        printf("{\"insight\":\"%s\",\"threads\":%lu,\"repeat\":%lu}\n", insight, (unsigned long)threads,
+               (unsigned long)repeat);
+    } else {
+        printf("# %s, threads %lu, best of %lu\n", insight, (unsigned long)threads, (unsigned long)repeat);
+        printf("# run\tbytes\tlines\tseconds\tMB/s\tlines/s\tpeak RSS KB\tstatus\n");
+    }
+    fflush(stdout);
+
+    failed = FALSE;
+    snprintf(threadArgument, sizeof(threadArgument), "THREADS=%lu", (unsigned long)threads);
+    for (i = 0; i < RUN_COUNT; i++) {
+        run = &runs[i];
+        if (corpus[run->input] == NULL) {
+            continue;
+        }
+
+        count = 0;
+        snprintf(inputArgument, sizeof(inputArgument), "%s=%s", run->input == INPUT_FROM ? "FROM" : "SCAN",
+                 corpus[run->input]);
+        arguments[count++] = (char *)insight;
+        arguments[count++] = inputArgument;
+        if (run->option != NULL) {
+            arguments[count++] = (char *)run->option;
+        }
+        if (run->input == INPUT_FROM) {
+            arguments[count++] = threadArgument;
+        }
+        arguments[count] = NULL;
+
+        MeasureRun(arguments, repeat, &result);
+
+        /* MB here is 2^20 bytes of input */
+        megabytes = (double)bytes[run->input] / 1048576.0;
+        if (result.seconds <= 0.0) {
+            result.seconds = 1e-9;
+        }
+        if (format == BATCH_FORMAT_JSON) {
+            printf("{\"run\":\"%s\",\"bytes\":%llu,\"lines\":%llu,\"seconds\":%.4f,\"mbPerSecond\":%.1f,"
+                   "\"linesPerSecond\":%.0f,\"peakRssKb\":%ld,\"status\":%d}\n",
+                   run->name, (unsigned long long)bytes[run->input], (unsigned long long)lines[run->input],
+                   result.seconds, megabytes / result.seconds, (double)lines[run->input] / result.seconds,
+                   result.peakKilobytes, result.status);
+        } else {
+            printf("%s\t%llu\t%llu\t%.4f\t%.1f\t%.0f\t%ld\t%d\n", run->name, (unsigned long long)bytes[run->input],
+                   (unsigned long long)lines[run->input], result.seconds, megabytes / result.seconds,
+                   (double)lines[run->input] / result.seconds, result.peakKilobytes, result.status);
+        }
+        fflush(stdout);
+
+        if (result.status < 0 || result.status > RETURN_WARN) {
+            fprintf(stderr, "Error: %s failed with status %d\n", run->name, result.status);
+            failed = TRUE;
+        } else if (megabytes / result.seconds < minimum) {
+            fprintf(stderr, "Error: %s ran at %.1f MB/s, below the minimum of %.1f\n", run->name,
+                    megabytes / result.seconds, minimum);
+            failed = TRUE;
+        }
+    }
+
+    return failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+/*
+ * Size a corpus and count its lines, a last line without a newline included
+ */
+static BOOL CountCorpus(const char *fileName, uint64_t *bytes, uint64_t *lines)
+{
+    FILE *file;
+    char *buffer;
+    char *position;
+    size_t length;
+    char last;
+
+    file = fopen(fileName, "rb");
+    buffer = (char *)malloc(THROUGHPUT_BUFFER_SIZE);
+    if (file == NULL || buffer == NULL) {
+        if (file != NULL) {
+            fclose(file);
+        }
+        free(buffer);
+        return FALSE;
+    }
+
+    *bytes = 0;
+    *lines = 0;
+    last = '\n';
+    while ((length = fread(buffer, 1, THROUGHPUT_BUFFER_SIZE, file)) > 0) {
+        *bytes += length;
+        position = buffer;
+        while ((position = (char *)memchr(position, '\n', (size_t)(buffer + length - position))) != NULL) {
+            (*lines)++;
+            position++;
+        }
+        last = buffer[length - 1];
+    }
+    if (last != '\n') {
+        (*lines)++;
+    }
+
+    free(buffer);
+    fclose(file);
+
+    return TRUE;
+}
+
+/*
+ * Run Insight repeat times with its output going to /dev/null
+ * Keeps the fastest time, the largest peak resident set and the worst
+ * exit status.
+ */
+static VOID MeasureRun(char *const arguments[], ULONG repeat, struct ThroughputResult *result)
+{
+    struct rusage usage;
+    double start;
+    double seconds;
+    pid_t pid;
+    int status;
+    int output;
+    ULONG i;
+
+    result->seconds = 0.0;
+    result->peakKilobytes = 0;
+    result->status = 0;
+
+    for (i = 0; i < repeat; i++) {
+        start = Now();
+        pid = fork();
+        if (pid == 0) {
+            output = open("/dev/null", O_WRONLY);
+            if (output < 0 || dup2(output, STDOUT_FILENO) < 0) {
+                _exit(127);
+            }
+            close(output);
+            execv(arguments[0], arguments);
+            _exit(127);
+        }
+        if (pid < 0 || wait4(pid, &status, 0, &usage) != pid) {
+            result->status = -1;
+            return;
+        }
+        seconds = Now() - start;
+
+        if (i == 0 || seconds < result->seconds) {
+            result->seconds = seconds;
+        }
+#ifdef __APPLE__
+        usage.ru_maxrss /= 1024;  /* Bytes on macOS, kilobytes elsewhere */
+#endif
+        if (usage.ru_maxrss > result->peakKilobytes) {
+            result->peakKilobytes = usage.ru_maxrss;
+        }
+        if (!WIFEXITED(status)) {
+            result->status = -1;
+        } else if (result->status >= 0 && WEXITSTATUS(status) > result->status) {
+            result->status = WEXITSTATUS(status);
+        }
+    }
+}
+
+/*
+ * Monotonic clock in seconds
+ */
+static double Now(VOID)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return (double)now.tv_sec + (double)now.tv_nsec / 1e9;
+}
@@ -0,0 +1,156 @@
+/*
+ * Word Wrap
+ *
+ * Wrapping is one greedy pass.  Every character is copied as it is read,
+ * and when a line grows past the width the last space on it becomes a
+ * newline.  Only spaces change, so the output is always exactly as long
+ * as the input: callers size it with strlen and can wrap in place.  A
+ * word wider than the whole line is left to overflow.
+ *
+ * After meditiation comes... Insight
+ *
+ * Copyright (c) 2025-26 amigazen project
+ * Licensed under BSD 2-Clause License
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "platform.h"
+#include "wordwrap.h"
+
+/* No space seen on the current line yet */
+#define WRAP_NO_BREAK 0xFFFFFFFFUL
+
+/*
+ * Use a measure function for a font and forget any widths already taken
+ * Call again whenever the font changes.
+ */
+VOID InitGlyphMetrics(struct GlyphMetrics *metrics, GlyphMeasure measure, APTR font)
+{
+    ULONG i;
+
+    metrics->measure = measure;
+    metrics->font = font;
+    for (i = 0; i < 256; i++) {
+        metrics->widths[i] = GLYPH_UNMEASURED;
+    }
+}
+
+/*
+ * Width of one glyph, measuring it the first time it is asked for
+ */
+ULONG GlyphWidth(struct GlyphMetrics *metrics, UBYTE glyph)
+{
+    ULONG width;
+
+    if (metrics->widths[glyph] == GLYPH_UNMEASURED) {
+        width = metrics->measure(glyph, metrics->font);
+        metrics->widths[glyph] = (UWORD)((width < GLYPH_UNMEASURED) ? width : GLYPH_UNMEASURED - 1);
+    }
+
+    return metrics->widths[glyph];
+}
+
+/*
+ * Wrap text to maxWidth pixels into a caller-supplied buffer
+ * The buffer may be the text itself.  Output is truncated to fit and always
+ * terminated when bufferSize > 0; returns the full wrapped length, which is
+ * strlen(text), excluding the terminator.
+ */
+ULONG WrapTextInto(struct GlyphMetrics *metrics, CONST_STRPTR text, ULONG maxWidth, STRPTR buffer, ULONG bufferSize)
+{
+    ULONG limit = (bufferSize > 0) ? bufferSize - 1 : 0;
+    ULONG lineWidth = 0;
+    ULONG breakAt = WRAP_NO_BREAK;
+    ULONG widthAtBreak = 0;
+    ULONG width;
+    ULONG i;
+    UBYTE c;
+
+    for (i = 0; text[i] != '\0'; i++) {
+        c = (UBYTE)text[i];
+        if (i < limit) {
+            buffer[i] = (char)c;
+        }
+
+        if (c == '\n') {
+            lineWidth = 0;
+            breakAt = WRAP_NO_BREAK;
+            continue;
+        }
+
+        if (c == WRAP_ESCAPE) {
+            /* Style codes such as ESC i draw nothing */
+            if (text[i + 1] != '\0') {
+                i++;
+                if (i < limit) {
+                    buffer[i] = text[i];
+                }
+            }
+            continue;
+        }
+
+        width = metrics->widths[c];
+        if (width == GLYPH_UNMEASURED) {
+            width = GlyphWidth(metrics, c);
+        }
+        lineWidth += width;
+
+        if (c == ' ') {
+            /* Trailing spaces may hang past the edge; the line breaks here later */
+            breakAt = i;
+            widthAtBreak = lineWidth;
+        } else if (lineWidth > maxWidth && breakAt != WRAP_NO_BREAK) {
+            if (breakAt < limit) {
+                buffer[breakAt] = '\n';
+            }
+            lineWidth -= widthAtBreak;
+            breakAt = WRAP_NO_BREAK;
+        }
+    }
+
+    if (bufferSize > 0) {
+        buffer[(i < limit) ? i : limit] = '\0';
+    }
+
+    return i;
+}
+
+/*
+ * Wrap text to maxWidth pixels into a new buffer of exactly its length
+ * Free the result with free().  Returns NULL if it cannot be allocated.
+ */
+STRPTR WrapText(struct GlyphMetrics *metrics, CONST_STRPTR text, ULONG maxWidth)
+{
+    ULONG size = strlen(text) + 1;
+    STRPTR wrapped;
+
+    wrapped = (STRPTR)malloc(size);
+    if (wrapped != NULL) {
+        WrapTextInto(metrics, text, maxWidth, wrapped, size);
+    }
+
+    return wrapped;
+}
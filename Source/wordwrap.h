@@ -0,0 +1,73 @@
+/*
+ * Word Wrap
+ *
+ * Wraps text to a width in pixels for the requester.  Each glyph is
+ * measured once per font through a GlyphMeasure function and kept in a
+ * table, so wrapping a message costs one table read per character rather
+ * than a font call per word.  The measure function is the only part that
+ * touches a font, so hosts can stub it for tests and benchmarks.
+ *
+ * After meditiation comes... Insight
+ *
+ * Copyright (c) 2025-26 amigazen project
+ * Licensed under BSD 2-Clause License
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef WORDWRAP_H
+#define WORDWRAP_H
+
+#include "platform.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Widths not yet measured */
+#define GLYPH_UNMEASURED 0xFFFF
+
+/* Requester escape - it and the character after it take no width */
+#define WRAP_ESCAPE 0x1B
+
+/* Width in pixels of one glyph in a font */
+typedef ULONG (*GlyphMeasure)(UBYTE glyph, APTR font);
+
+/* Glyph widths for one font, filled in as glyphs are first seen */
+struct GlyphMetrics {
+    GlyphMeasure measure;
+    APTR font;
+    UWORD widths[256];
+};
+
+/* Function declarations */
+VOID InitGlyphMetrics(struct GlyphMetrics *metrics, GlyphMeasure measure, APTR font);
+ULONG GlyphWidth(struct GlyphMetrics *metrics, UBYTE glyph);
+ULONG WrapTextInto(struct GlyphMetrics *metrics, CONST_STRPTR text, ULONG maxWidth, STRPTR buffer, ULONG bufferSize);
+STRPTR WrapText(struct GlyphMetrics *metrics, CONST_STRPTR text, ULONG maxWidth);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* WORDWRAP_H */